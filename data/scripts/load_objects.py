@@ -12,7 +12,7 @@ class TemplateProxy(object):
 		A class which uses the proxy pattern to delay loading of
 		python modules until they are used.
 	'''
-	__slots__ = ('file', 'create')
+	__slots__ = ('file', 'create', 'cache_prototype')
 	
 	def __init__(self, file):
 		'''
@@ -21,6 +21,7 @@ class TemplateProxy(object):
 		'''
 		self.file = file
 		self.create = None
+		self.cache_prototype = False
 	
 	def __call__(self, kernel):
 		'''
@@ -30,6 +31,10 @@ class TemplateProxy(object):
 		if self.create == None:
 			module = importlib.import_module(self.file)
 			self.create = module.create
+			# Only templates that build the same object on every call set
+			# cache_prototype = True, the server then clones the first object
+			# instead of calling create again. Anything randomized is left off.
+			self.cache_prototype = getattr(module, 'cache_prototype', False)
 		return self.create(kernel)
 
 templates = TemplateMap()
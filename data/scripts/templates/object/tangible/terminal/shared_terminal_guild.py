@@ -4,6 +4,11 @@
 
 from swgpy.object import *	
 
+# True when create builds the same object on every call. The server then clones
+# the first object instead of calling create again, so a template that randomizes
+# what it builds must set this to False.
+cache_prototype = True
+
 def create(kernel):
 	result = Tangible()
 
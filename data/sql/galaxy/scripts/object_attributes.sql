@@ -18,6 +18,7 @@ CREATE TABLE IF NOT EXISTS `object_attributes` (
   `attribute_id` int(11) unsigned DEFAULT NULL,
   `attribute_value` varchar(255) DEFAULT '',
   PRIMARY KEY (`id`),
+  UNIQUE KEY `UNQ_object_attributes_object_attribute` (`object_id`,`attribute_id`),
   KEY `FK_object_attributes_swganh_static.attributes` (`attribute_id`),
   CONSTRAINT `FK_object_attributes_swganh_static.attributes` FOREIGN KEY (`attribute_id`) REFERENCES `swganh_static`.`attributes` (`id`) ON DELETE NO ACTION ON UPDATE NO ACTION
 ) ENGINE=InnoDB AUTO_INCREMENT=32814 DEFAULT CHARSET=utf8 COMMENT='stores attributes for objects';
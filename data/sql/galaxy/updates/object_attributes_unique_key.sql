@@ -0,0 +1,25 @@
+-- --------------------------------------------------------
+-- Adds the unique (object_id, attribute_id) key the attribute upsert needs to
+-- an existing galaxy database. New installs get it from scripts/object_attributes.sql.
+--
+-- Earlier servers inserted a new row on every flush for attributes missing
+-- from swganh_static.attributes (attribute_id NULL), and sp_PersistAttribute
+-- could leave several rows per attribute. Those are removed first, keeping
+-- the newest row of each (object_id, attribute_id).
+-- --------------------------------------------------------
+
+/*!40101 SET @OLD_CHARACTER_SET_CLIENT=@@CHARACTER_SET_CLIENT */;
+/*!40101 SET NAMES utf8 */;
+
+DELETE FROM `object_attributes` WHERE `object_id` IS NULL OR `attribute_id` IS NULL;
+
+DELETE older FROM `object_attributes` older
+  JOIN `object_attributes` newer
+    ON newer.`object_id` = older.`object_id`
+   AND newer.`attribute_id` = older.`attribute_id`
+   AND newer.`id` > older.`id`;
+
+ALTER TABLE `object_attributes`
+  ADD UNIQUE KEY `UNQ_object_attributes_object_attribute` (`object_id`,`attribute_id`);
+
+/*!40101 SET CHARACTER_SET_CLIENT=@OLD_CHARACTER_SET_CLIENT */;
@@ -0,0 +1,11 @@
+DELIMITER $$
+
+DROP PROCEDURE IF EXISTS `sp_GetStaticDataVersion` $$
+CREATE PROCEDURE `sp_GetStaticDataVersion`()
+BEGIN
+    
+	SELECT version FROM static_data_version WHERE id = 1;
+
+END $$
+
+DELIMITER ;
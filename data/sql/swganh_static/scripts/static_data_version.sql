@@ -0,0 +1,28 @@
+-- --------------------------------------------------------
+-- Host:                         127.0.0.1
+-- Server version:               5.1.63-community - MySQL Community Server (GPL)
+-- Server OS:                    Win64
+-- HeidiSQL version:             7.0.0.4053
+-- --------------------------------------------------------
+
+/*!40101 SET @OLD_CHARACTER_SET_CLIENT=@@CHARACTER_SET_CLIENT */;
+/*!40101 SET NAMES utf8 */;
+/*!40014 SET FOREIGN_KEY_CHECKS=0 */;
+
+-- Dumping structure for table swganh_static.static_data_version
+-- Bump version whenever the static world changes, cached snapshots of it are
+-- thrown away when it no longer matches.
+DROP TABLE IF EXISTS `static_data_version`;
+CREATE TABLE IF NOT EXISTS `static_data_version` (
+  `id` int(11) unsigned NOT NULL DEFAULT '0',
+  `version` int(11) unsigned NOT NULL DEFAULT '1' COMMENT 'Static Data Version',
+  PRIMARY KEY (`id`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8 ROW_FORMAT=REDUNDANT;
+
+-- Dumping data for table swganh_static.static_data_version: ~1 rows (approximately)
+/*!40000 ALTER TABLE `static_data_version` DISABLE KEYS */;
+INSERT INTO `static_data_version` (`id`, `version`) VALUES
+	(1, 1);
+/*!40000 ALTER TABLE `static_data_version` ENABLE KEYS */;
+/*!40014 SET FOREIGN_KEY_CHECKS=1 */;
+/*!40101 SET CHARACTER_SET_CLIENT=@OLD_CHARACTER_SET_CLIENT */;
@@ -0,0 +1,186 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "swganh/string_interner.h"
+
+#include "swganh_core/object/object.h"
+
+using namespace std;
+using namespace swganh::object;
+
+namespace {
+
+    // Lookups made when measuring latency, spread over random objects.
+    const size_t LOOKUPS = 2000000;
+
+    // About what a piece of crafted armor carries.
+    const char* const FLOAT_ATTRIBUTES[] = {
+        "armor_effectiveness_kinetic", "armor_effectiveness_energy", "armor_effectiveness_blast", "condition"
+    };
+    const char* const INT_ATTRIBUTES[] = { "volume", "armor_rating", "sockets" };
+    const char* const STRING_ATTRIBUTES[] = { "crafter", "serial_number" };
+    const char* const FLAGS[] = { "no_trade", "equipped" };
+
+    atomic<uint64_t> heap_allocations(0);
+    atomic<uint64_t> heap_bytes(0);
+
+    double ElapsedMs(chrono::high_resolution_clock::time_point start_time)
+    {
+        return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start_time).count();
+    }
+
+    template<size_t N>
+    vector<string> Names(const char* const (&names)[N])
+    {
+        return vector<string>(names, names + N);
+    }
+
+}
+
+void* operator new(size_t size)
+{
+    ++heap_allocations;
+    heap_bytes += size;
+    if (void* ptr = malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t count = (argc == 2) ? static_cast<size_t>(atoi(argv[1])) : 500000;
+    if (count == 0)
+    {
+        cout << "Usage: " << argv[0] << " [objects]" << endl;
+        exit(0);
+    }
+
+    auto float_names = Names(FLOAT_ATTRIBUTES);
+    auto int_names = Names(INT_ATTRIBUTES);
+    auto string_names = Names(STRING_ATTRIBUTES);
+    auto flag_names = Names(FLAGS);
+
+    vector<shared_ptr<Object>> objects;
+    objects.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        objects.push_back(make_shared<Object>());
+    }
+
+    size_t attribute_count = float_names.size() + int_names.size() + string_names.size();
+    cout << "Loading " << count << " objects with " << attribute_count << " attributes and "
+         << flag_names.size() << " flags each\n" << endl;
+
+    // as the object factory does, every attribute set and then taken for persistence
+    uint64_t allocations_before = heap_allocations;
+    uint64_t bytes_before = heap_bytes;
+    auto start_time = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto& object = objects[i];
+        for (auto& name : float_names)
+        {
+            object->SetAttribute(name, static_cast<float>(i % 100));
+        }
+        for (auto& name : int_names)
+        {
+            object->SetAttribute(name, static_cast<int32_t>(i % 1000));
+        }
+        for (auto& name : string_names)
+        {
+            object->SetAttribute(name, wstring(L"Crafter Name"));
+        }
+        for (auto& name : flag_names)
+        {
+            object->SetFlag(name);
+        }
+        object->TakeChangedAttributes();
+    }
+    double load_ms = ElapsedMs(start_time);
+
+    cout << "   load: " << load_ms * 1000000.0 / count << " ns, "
+         << static_cast<double>(heap_allocations - allocations_before) / count << " heap allocations and "
+         << static_cast<double>(heap_bytes - bytes_before) / count << " bytes per object" << endl;
+
+    mt19937 generator(1234);
+    uniform_int_distribution<size_t> pick_object(0, count - 1);
+    uniform_int_distribution<size_t> pick_name(0, float_names.size() - 1);
+
+    vector<size_t> object_indexes(LOOKUPS), name_indexes(LOOKUPS);
+    for (size_t i = 0; i < LOOKUPS; ++i)
+    {
+        object_indexes[i] = pick_object(generator);
+        name_indexes[i] = pick_name(generator);
+    }
+
+    vector<uint32_t> float_ids;
+    for (auto& name : float_names)
+    {
+        float_ids.push_back(swganh::StringInterner::Hash(name));
+    }
+    uint32_t flag_id = swganh::StringInterner::Hash(flag_names[0]);
+
+    cout << "\nLookups on random objects\n" << endl;
+
+    float sum = 0.0f;
+    allocations_before = heap_allocations;
+    start_time = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < LOOKUPS; ++i)
+    {
+        sum += objects[object_indexes[i]]->GetAttribute<float>(float_names[name_indexes[i]]);
+    }
+    double name_ms = ElapsedMs(start_time);
+    double name_allocations = static_cast<double>(heap_allocations - allocations_before) / LOOKUPS;
+
+    start_time = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < LOOKUPS; ++i)
+    {
+        sum += boost::get<float>(objects[object_indexes[i]]->GetAttribute(float_ids[name_indexes[i]]));
+    }
+    double id_ms = ElapsedMs(start_time);
+
+    size_t flagged = 0;
+    start_time = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < LOOKUPS; ++i)
+    {
+        flagged += objects[object_indexes[i]]->HasFlag(flag_id);
+    }
+    double flag_ms = ElapsedMs(start_time);
+
+    cout << "   attribute by name: " << name_ms * 1000000.0 / LOOKUPS << " ns and "
+         << name_allocations << " heap allocations per lookup\n"
+         << "   attribute by id: " << id_ms * 1000000.0 / LOOKUPS << " ns per lookup\n"
+         << "   flag by id: " << flag_ms * 1000000.0 / LOOKUPS << " ns per lookup" << endl;
+
+    // keeps the lookups from being optimized away
+    if (sum < 0.0f || flagged != LOOKUPS)
+    {
+        cout << "\n   unexpected attribute values" << endl;
+        return 1;
+    }
+
+    return 0;
+}
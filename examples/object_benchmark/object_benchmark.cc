@@ -0,0 +1,162 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "swganh/pool_allocator.h"
+
+#include "swganh_core/object/object.h"
+#include "swganh_core/object/creature/creature.h"
+#include "swganh_core/object/tangible/tangible.h"
+#include "swganh_core/object/waypoint/waypoint.h"
+
+using namespace std;
+using namespace swganh::object;
+
+namespace {
+
+    // Objects each one is aware of when measuring awareness, about a crowded
+    // spatial cell.
+    const size_t AWARE_OBJECTS = 32;
+
+    atomic<uint64_t> heap_allocations(0);
+
+    double ElapsedMs(chrono::high_resolution_clock::time_point start_time)
+    {
+        return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start_time).count();
+    }
+
+    template<typename T>
+    void MeasureSpawns(const char* name, size_t count)
+    {
+        vector<shared_ptr<T>> objects;
+        objects.reserve(count);
+
+        // the first round fills the pool, the second one shows the steady state
+        for (int round = 0; round < 2; ++round)
+        {
+            uint64_t allocations_before = heap_allocations;
+            auto start_time = chrono::high_resolution_clock::now();
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                objects.push_back(swganh::MakePooled<T>());
+            }
+            objects.clear();
+
+            double elapsed_ms = ElapsedMs(start_time);
+            double allocations = static_cast<double>(heap_allocations - allocations_before) / count;
+
+            cout << "   " << name << (round == 0 ? " (cold)" : " (warm)") << ": "
+                 << sizeof(T) << " bytes, "
+                 << allocations << " heap allocations and "
+                 << elapsed_ms * 1000000.0 / count << " ns per spawn and despawn" << endl;
+        }
+    }
+
+}
+
+void* operator new(size_t size)
+{
+    ++heap_allocations;
+    if (void* ptr = malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t count = (argc == 2) ? static_cast<size_t>(atoi(argv[1])) : 100000;
+    if (count == 0)
+    {
+        cout << "Usage: " << argv[0] << " [objects]" << endl;
+        exit(0);
+    }
+
+    cout << "Spawning and despawning " << count << " objects of each type\n" << endl;
+
+    MeasureSpawns<Tangible>("tangible", count);
+    MeasureSpawns<Creature>("creature", count);
+    MeasureSpawns<Waypoint>("waypoint", count);
+
+    cout << "\nPools" << endl;
+    for (auto& pool : swganh::GetPoolStatistics())
+    {
+        cout << "   " << pool.block_size << " byte blocks: "
+             << pool.blocks_reserved << " reserved, "
+             << pool.allocations << " allocations from "
+             << pool.heap_allocations << " heap chunks" << endl;
+    }
+
+    // Every object aware of the same crowd, as in a busy spatial cell.
+    size_t object_count = min(count, static_cast<size_t>(10000));
+    vector<shared_ptr<Object>> crowd, objects;
+    for (size_t i = 0; i < AWARE_OBJECTS; ++i)
+    {
+        crowd.push_back(swganh::MakePooled<Tangible>());
+    }
+    for (size_t i = 0; i < object_count; ++i)
+    {
+        objects.push_back(swganh::MakePooled<Tangible>());
+    }
+
+    cout << "\nAwareness of " << AWARE_OBJECTS << " objects, " << object_count << " objects\n" << endl;
+
+    auto start_time = chrono::high_resolution_clock::now();
+    for (auto& object : objects)
+    {
+        for (auto& other : crowd)
+        {
+            object->__InternalAddAwareObject(other);
+        }
+    }
+    double add_ms = ElapsedMs(start_time);
+
+    uint64_t allocations_before = heap_allocations;
+    size_t visited = 0;
+    start_time = chrono::high_resolution_clock::now();
+    for (auto& object : objects)
+    {
+        object->__InternalViewAwareObjects([&visited] (shared_ptr<Object>) { ++visited; });
+    }
+    double view_ms = ElapsedMs(start_time);
+    double view_allocations = static_cast<double>(heap_allocations - allocations_before) / object_count;
+
+    start_time = chrono::high_resolution_clock::now();
+    for (auto& object : objects)
+    {
+        for (auto& other : crowd)
+        {
+            object->__InternalRemoveAwareObject(other);
+        }
+    }
+    double remove_ms = ElapsedMs(start_time);
+
+    double changes = static_cast<double>(object_count) * AWARE_OBJECTS;
+    cout << "   add: " << add_ms * 1000000.0 / changes << " ns per object\n"
+         << "   view: " << view_ms * 1000000.0 / object_count << " ns and "
+         << view_allocations << " heap allocations per view of " << visited / object_count << " objects\n"
+         << "   remove: " << remove_ms * 1000000.0 / changes << " ns per object" << endl;
+
+    return 0;
+}
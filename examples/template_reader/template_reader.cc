@@ -0,0 +1,193 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/any.hpp>
+
+#include "swganh/string_interner.h"
+#include "swganh/tre/resource_manager.h"
+#include "swganh/tre/tre_archive.h"
+#include "swganh/tre/visitors/objects/object_visitor.h"
+
+using namespace std;
+using namespace swganh::tre;
+
+namespace {
+
+    /// The attribute map every template held before, copied from its parents.
+    typedef map<string, shared_ptr<boost::any>> AggregatedAttributes;
+
+    const char* LOOKUP_KEYS[] = {
+        "appearanceFilename",
+        "arrangementDescriptorFilename",
+        "slotDescriptorFilename",
+        "collisionHeight",
+        "collisionLength",
+        "objectName"
+    };
+
+    const int LOOKUP_ROUNDS = 20;
+
+    bool IsObjectTemplate(const string& name)
+    {
+        return name.compare(0, 7, "object/") == 0 && name.size() > 4 && name.compare(name.size() - 4, 4, ".iff") == 0;
+    }
+
+    shared_ptr<boost::any> CopyValue(ObjectVisitor& visitor, uint32_t id)
+    {
+        try { return make_shared<boost::any>(visitor.attribute<string>(id)); } catch (const runtime_error&) {}
+        try { return make_shared<boost::any>(visitor.attribute<uint32_t>(id)); } catch (const runtime_error&) {}
+        try { return make_shared<boost::any>(visitor.attribute<float>(id)); } catch (const runtime_error&) {}
+        try { return make_shared<boost::any>(visitor.attribute<bool>(id)); } catch (const runtime_error&) {}
+        return make_shared<boost::any>(visitor.attribute<shared_ptr<ObjectVisitor::ClientString>>(id));
+    }
+
+    /// Size of a map built like the old aggregated attribute maps.
+    uint64_t AggregatedSize(const AggregatedAttributes& attributes)
+    {
+        uint64_t size = 0;
+        for (auto& attribute : attributes)
+        {
+            // map node, key and the shared boost::any holding the value
+            size += sizeof(AggregatedAttributes::value_type) + 4 * sizeof(void*) + sizeof(boost::any) + 4 * sizeof(void*)
+                + attribute.first.capacity();
+            if (attribute.second->type() == typeid(string))
+            {
+                size += boost::any_cast<const string&>(*attribute.second).capacity();
+            }
+        }
+        return size;
+    }
+
+    double ElapsedMs(chrono::high_resolution_clock::time_point start_time)
+    {
+        return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start_time).count();
+    }
+
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2)
+    {
+        cout << "Usage: " << argv[0] << " <path to swg live file>" << endl;
+        exit(0);
+    }
+
+    auto archive = make_shared<TreArchive>(string(argv[1]));
+    ResourceManager manager(archive);
+
+    vector<string> template_names;
+    for (auto& name : archive->GetAvailableResources())
+    {
+        if (IsObjectTemplate(name))
+        {
+            template_names.push_back(name);
+        }
+    }
+
+    cout << "Loading " << template_names.size() << " object templates\n" << endl;
+
+    auto start_time = chrono::high_resolution_clock::now();
+
+    vector<shared_ptr<ObjectVisitor>> templates;
+    for (auto& name : template_names)
+    {
+        try
+        {
+            auto visitor = manager.GetResourceByName<ObjectVisitor>(name);
+            visitor->load_aggregate_data(&manager);
+            templates.push_back(visitor);
+        }
+        catch (const exception& e)
+        {
+            cout << "   skipped " << name << ": " << e.what() << endl;
+        }
+    }
+
+    cout << "   load and link: " << ElapsedMs(start_time) << " ms" << endl;
+
+    // Rebuild the maps every template used to hold for comparison.
+    auto& interner = swganh::StringInterner::getInstance();
+    vector<AggregatedAttributes> aggregated(templates.size());
+    uint64_t flat_bytes = 0, aggregated_bytes = 0, resolved_attributes = 0;
+    for (size_t i = 0; i < templates.size(); ++i)
+    {
+        flat_bytes += templates[i]->Size();
+        for (auto id : templates[i]->attribute_ids())
+        {
+            aggregated[i].insert(make_pair(interner.Lookup(id), CopyValue(*templates[i], id)));
+        }
+        resolved_attributes += aggregated[i].size();
+        aggregated_bytes += AggregatedSize(aggregated[i]);
+    }
+
+    cout << "   resolved attributes: " << resolved_attributes << "\n"
+         << "   flat storage: " << flat_bytes / 1024 << " KB\n"
+         << "   aggregated maps: " << aggregated_bytes / 1024 << " KB\n" << endl;
+
+    vector<string> keys(begin(LOOKUP_KEYS), end(LOOKUP_KEYS));
+    uint64_t lookups = 0, found = 0;
+
+    start_time = chrono::high_resolution_clock::now();
+    for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+    {
+        for (auto& visitor : templates)
+        {
+            for (auto& key : keys)
+            {
+                ++lookups;
+                found += visitor->has_attribute(key) ? 1 : 0;
+            }
+        }
+    }
+    double flat_ms = ElapsedMs(start_time);
+
+    vector<uint32_t> key_ids;
+    for (auto& key : keys)
+    {
+        key_ids.push_back(ObjectVisitor::AttributeId(key));
+    }
+
+    uint64_t id_found = 0;
+    start_time = chrono::high_resolution_clock::now();
+    for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+    {
+        for (auto& visitor : templates)
+        {
+            for (auto key_id : key_ids)
+            {
+                id_found += visitor->has_attribute(key_id) ? 1 : 0;
+            }
+        }
+    }
+    double id_ms = ElapsedMs(start_time);
+
+    uint64_t map_found = 0;
+    start_time = chrono::high_resolution_clock::now();
+    for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+    {
+        for (auto& attributes : aggregated)
+        {
+            for (auto& key : keys)
+            {
+                map_found += attributes.find(key) != attributes.end() ? 1 : 0;
+            }
+        }
+    }
+    double map_ms = ElapsedMs(start_time);
+
+    cout << "   " << lookups << " lookups, " << found << " found (" << id_found << " by id, " << map_found << " in the maps)\n"
+         << "   flat storage by name: " << flat_ms * 1000000.0 / lookups << " ns per lookup\n"
+         << "   flat storage by id: " << id_ms * 1000000.0 / lookups << " ns per lookup\n"
+         << "   aggregated maps: " << map_ms * 1000000.0 / lookups << " ns per lookup" << endl;
+
+    return 0;
+}
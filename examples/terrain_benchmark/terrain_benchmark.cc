@@ -0,0 +1,158 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/io_service.hpp>
+
+#include "swganh/app/swganh_kernel.h"
+#include "swganh/tre/resource_manager.h"
+#include "swganh/tre/tre_archive.h"
+#include "swganh/tre/visitors/terrain/terrain_visitor.h"
+#include "swganh/tre/visitors/terrain/detail/header.h"
+
+#include "swganh_core/terrain/height_sampler.h"
+#include "swganh_core/terrain/terrain_scene.h"
+#include "swganh_core/terrain/terrain_service.h"
+
+using namespace std;
+using namespace swganh::tre;
+using namespace swganh::terrain;
+
+namespace {
+
+    // Points are evaluated in batches about the size of a height cache tile.
+    const size_t BATCH_SIZE = 4096;
+
+    // Height and water queries each thread makes per point when measuring scaling.
+    const int QUERY_ROUNDS = 4;
+
+    double ElapsedMs(chrono::high_resolution_clock::time_point start_time)
+    {
+        return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start_time).count();
+    }
+
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3 || argc > 4)
+    {
+        cout << "Usage: " << argv[0] << " <path to swg live file> <terrain file> [million points]" << endl;
+        exit(0);
+    }
+
+    double millions = (argc == 4) ? atof(argv[3]) : 1.0;
+    size_t point_count = static_cast<size_t>(millions * 1000000.0);
+
+    auto archive = make_shared<TreArchive>(string(argv[1]));
+    ResourceManager manager(archive);
+
+    auto terrain = manager.GetResourceByName<TerrainVisitor>(string(argv[2]), false);
+    HeightSampler sampler(terrain);
+
+    float half_width = terrain->GetHeader()->map_width / 2.0f;
+
+    mt19937 generator(1234);
+    uniform_real_distribution<float> coordinate(-half_width, half_width);
+
+    vector<float> x(point_count), z(point_count);
+    for (size_t i = 0; i < point_count; ++i)
+    {
+        x[i] = coordinate(generator);
+        z[i] = coordinate(generator);
+    }
+
+    cout << "Sampling " << point_count << " points of " << argv[2] << "\n" << endl;
+
+    vector<float> scalar_heights(point_count), batch_heights(point_count);
+
+    auto start_time = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < point_count; ++i)
+    {
+        scalar_heights[i] = sampler.GetHeight(x[i], z[i]);
+    }
+    double scalar_ms = ElapsedMs(start_time);
+
+    start_time = chrono::high_resolution_clock::now();
+    for (size_t first = 0; first < point_count; first += BATCH_SIZE)
+    {
+        size_t count = min(BATCH_SIZE, point_count - first);
+        sampler.GetHeights(&x[first], &z[first], count, &batch_heights[first]);
+    }
+    double batch_ms = ElapsedMs(start_time);
+
+    cout << "   scalar: " << scalar_ms / millions << " ms per million points\n"
+         << "   batched: " << batch_ms / millions << " ms per million points\n"
+         << "   speedup: " << scalar_ms / batch_ms << "x" << endl;
+
+#if !defined(__FAST_MATH__) && !defined(__FMA__)
+    // Without fast math both paths do the same arithmetic in the same order.
+    if (memcmp(scalar_heights.data(), batch_heights.data(), point_count * sizeof(float)) != 0)
+    {
+        cout << "\n   batched heights differ from the scalar heights" << endl;
+        return 1;
+    }
+#endif
+
+    // Queries through the terrain service from more and more threads at once.
+    boost::asio::io_service io_service;
+    swganh::app::SwganhKernel kernel(io_service);
+    TerrainService service(&kernel);
+    service.AddScene(1, make_shared<TerrainScene>(terrain, 64.0f, 2.0f, 0));
+
+    uint32_t max_threads = max(thread::hardware_concurrency(), 1u);
+    size_t points_per_thread = min(point_count, static_cast<size_t>(100000));
+
+    cout << "\nQuerying the terrain service, " << points_per_thread * QUERY_ROUNDS * 2 << " queries per thread\n" << endl;
+
+    // powers of two up to the number of cores, then every core
+    vector<uint32_t> thread_counts;
+    for (uint32_t thread_count = 1; thread_count < max_threads; thread_count *= 2)
+    {
+        thread_counts.push_back(thread_count);
+    }
+    thread_counts.push_back(max_threads);
+
+    for (auto thread_count : thread_counts)
+    {
+        start_time = chrono::high_resolution_clock::now();
+
+        vector<thread> threads;
+        for (uint32_t t = 0; t < thread_count; ++t)
+        {
+            threads.push_back(thread([&, t] {
+                size_t first = (t * points_per_thread) % (point_count - points_per_thread + 1);
+                for (int round = 0; round < QUERY_ROUNDS; ++round)
+                {
+                    for (size_t i = first; i < first + points_per_thread; ++i)
+                    {
+                        service.GetHeight(1, x[i], z[i]);
+                        service.GetWaterHeight(1, x[i], z[i]);
+                    }
+                }
+            }));
+        }
+
+        for (auto& worker : threads)
+        {
+            worker.join();
+        }
+
+        double elapsed_ms = ElapsedMs(start_time);
+        double queries = static_cast<double>(thread_count) * points_per_thread * QUERY_ROUNDS * 2;
+
+        cout << "   " << thread_count << " threads: " << queries / elapsed_ms / 1000.0 << " million queries per second" << endl;
+    }
+
+    return 0;
+}
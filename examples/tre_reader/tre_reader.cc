@@ -2,33 +2,108 @@
 // See file LICENSE or go to http://swganh.com/LICENSE
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "swganh/tre/tre_reader.h"
 
 using namespace std;
 using namespace swganh::tre;
 
+namespace {
+
+    /**
+     * Reads every resource of the archive once per thread and returns the time
+     * it took in milliseconds.
+     */
+    double BenchmarkReads(TreReader& reader, const vector<string>& resource_names, int thread_count, uint64_t& bytes_read)
+    {
+        atomic<uint64_t> total_bytes(0);
+        vector<thread> threads;
+
+        auto start_time = chrono::high_resolution_clock::now();
+
+        for (int i = 0; i < thread_count; ++i)
+        {
+            threads.push_back(thread([&reader, &resource_names, &total_bytes, i] () {
+                vector<char> scratch;
+                uint64_t bytes = 0;
+
+                // every thread starts somewhere else so they do not walk the file in lock step
+                size_t count = resource_names.size();
+                for (size_t j = 0; j < count; ++j)
+                {
+                    auto view = reader.GetResourceView(resource_names[(j + i * count / 16) % count], scratch);
+                    bytes += view.size;
+                }
+
+                total_bytes += bytes;
+            }));
+        }
+
+        for (auto& worker : threads)
+        {
+            worker.join();
+        }
+
+        bytes_read = total_bytes;
+        return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start_time).count();
+    }
+
+    void PrintResult(const string& name, double elapsed_ms, uint64_t bytes_read)
+    {
+        cout << "   " << name << ": " << elapsed_ms << " ms, "
+             << (bytes_read / (1024.0 * 1024.0)) / (elapsed_ms / 1000.0) << " MB/s" << endl;
+    }
+
+}
+
 int main(int argc, char *argv[])
 {
-    if (argc != 2)
+    if (argc < 2 || argc > 3)
     {
-        cout << "Usage: " << argv[0] << " <path to tre file>" << endl;
+        cout << "Usage: " << argv[0] << " <path to tre file> [threads]" << endl;
         exit(0);
     }
 
-    string resource_name(argv[1]);
+    string tre_filename(argv[1]);
+    int thread_count = (argc == 3) ? max(1, atoi(argv[2])) : 16;
+
+    TreReader stream_reader(tre_filename, TreReader::STREAM);
+    TreReader mapped_reader(tre_filename);
+
+    cout << "Loaded resource from archive:\n\n"
+         << "   Name: " << tre_filename << "\n"
+         << "   File Count: " << mapped_reader.GetResourceCount() << "\n" << endl;
+
+    cout << "Finished indexing\n" << endl;
 
+    auto resource_names = mapped_reader.GetResourceNames();
+    if (resource_names.empty())
     {
-        TreReader tre_reader(resource_name);
+        return 0;
+    }
+
+    cout << "Reading every resource from " << thread_count << " threads:\n" << endl;
 
-        cout << "Loaded resource from archive:\n\n"
-             << "   Name: " << resource_name << "\n"
-             << "   File Count: " << tre_reader.GetResourceCount() << "\n" << endl;
+    uint64_t bytes_read;
+    double elapsed_ms = BenchmarkReads(stream_reader, resource_names, thread_count, bytes_read);
+    PrintResult("stream", elapsed_ms, bytes_read);
 
-        cout << "Finished indexing\n" << endl;
+    if (mapped_reader.GetBackend() == TreReader::MEMORY_MAPPED)
+    {
+        elapsed_ms = BenchmarkReads(mapped_reader, resource_names, thread_count, bytes_read);
+        PrintResult("memory mapped", elapsed_ms, bytes_read);
+    }
+    else
+    {
+        cout << "   memory mapped: unavailable, the file could not be mapped" << endl;
     }
 
     return 0;
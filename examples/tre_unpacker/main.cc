@@ -1,8 +1,11 @@
 // This file is part of SWGANH which is released under the MIT license.
 // See file LICENSE or go to http://swganh.com/LICENSE
 
+#include <algorithm>
 #include <cmath>
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -11,22 +14,20 @@
 #include <boost/filesystem.hpp>
 #include <boost/thread/thread.hpp>
 
-#include "anh/utilities.h"
+#include "swganh/utilities.h"
+#include "swganh/tre/resource_extractor.h"
 #include "swganh/tre/tre_archive.h"
 
 namespace bfs = boost::filesystem;
 using boost::this_thread::sleep;
-using Concurrency::make_task;
-using Concurrency::task;
+using swganh::tre::ResourceExtractor;
 using swganh::tre::TreArchive;
 
-std::tuple<std::string, std::string> ProcessInput(int argc, char *argv[]);
+std::tuple<std::string, std::string, uint32_t> ProcessInput(int argc, char *argv[]);
 
 void ValidateSwgLiveConfig(const std::string& path_to_config);
 void ValidateTargetOutputDirectory(const std::string& target_output_directory);
 
-void SaveFile(std::string filename, const std::vector<unsigned char>& filedata);
-
 void UpdateProgressBar(double total, double completed);
 
 std::chrono::high_resolution_clock::time_point StartTimer();
@@ -44,33 +45,25 @@ int main(int argc, char *argv[])
     {
         std::string swg_live_file;
         std::string output_path;
+        uint32_t jobs;
 
-        std::tie(swg_live_file, output_path) = ProcessInput(argc, argv);
+        std::tie(swg_live_file, output_path, jobs) = ProcessInput(argc, argv);
 
         TreArchive archive(swg_live_file);
 
-        std::cout << "\nGetting the list of available resources\r" << std::endl;
-        auto resources = archive.GetAvailableResources();        
-        auto total = resources.size();
-        std::cout << "Found (" << total << ") resources\n" << std::endl;
-        
-        int i = 0;
-        for (auto& resource_name : resources)
-        {
-            auto target_filename = output_path + "/" + resource_name;
-            auto resource = archive.GetResource(resource_name);
-
-            SaveFile(target_filename, archive.GetResource(resource_name)); 
+        std::cout << "\nExtracting resources with " << jobs << " job(s)\n" << std::endl;
 
-            if (i % 100)
-            {
-                UpdateProgressBar(total, i);
-            }
+        auto statistics = ResourceExtractor(archive, output_path, jobs).Extract(
+            [] (uint64_t total, uint64_t completed) {
+                if (completed % 100 == 0 || completed == total)
+                {
+                    UpdateProgressBar(static_cast<double>(total), static_cast<double>(completed));
+                }
+            });
 
-            ++i;
-        }
+        std::cout << "\nExtracted (" << statistics.resources << ") resources, " << statistics.bytes << " bytes" << std::endl;
     }
-    catch (std::runtime_error& e)
+    catch (std::exception& e)
     {
         std::cout << "Error: " << e.what() << std::endl;
     }
@@ -82,16 +75,31 @@ int main(int argc, char *argv[])
 #endif
 
     std::cout << "Press any key to exit..." << std::endl;
-    while (anh::KeyboardHit() == 0) sleep(boost::posix_time::milliseconds(1));
+    while (swganh::KeyboardHit() == 0) sleep(boost::posix_time::milliseconds(1));
 
     return 0;
 }
 
 
-std::tuple<std::string, std::string> ProcessInput(int argc, char *argv[])
+std::tuple<std::string, std::string, uint32_t> ProcessInput(int argc, char *argv[])
 {
     std::string swg_live_file;
     std::string output_path;
+    uint32_t jobs = 1;
+
+    // --jobs N splits the extraction over N worker threads
+    if (argc >= 3 && std::string(argv[1]) == "--jobs")
+    {
+        jobs = std::stoul(argv[2]);
+        if (jobs == 0)
+        {
+            jobs = std::max(1u, boost::thread::hardware_concurrency());
+        }
+
+        argv[2] = argv[0];
+        argc -= 2;
+        argv += 2;
+    }
 
     if (argc == 1)
     {
@@ -115,10 +123,10 @@ std::tuple<std::string, std::string> ProcessInput(int argc, char *argv[])
     }
     else
     {        
-        throw std::runtime_error("Invalid number of parameters specified");
+        throw std::runtime_error("Invalid number of parameters specified, usage: tre_unpacker [--jobs N] <live.cfg> <output directory>");
     }
 
-    return std::make_tuple(swg_live_file, output_path);
+    return std::make_tuple(swg_live_file, output_path, jobs);
 }
 
 void ValidateSwgLiveConfig(const std::string& path_to_config)
@@ -152,30 +160,6 @@ void ValidateTargetOutputDirectory(const std::string& target_output_directory)
     }
 }
 
-void SaveFile(std::string filename, const std::vector<unsigned char>& filedata)
-{
-    auto path = bfs::path(filename);
-
-    if (bfs::is_regular_file(path))
-    {
-        bfs::remove(path);
-    }
-
-    if (!bfs::is_directory(path.parent_path()))
-    {
-        bfs::create_directories(path.parent_path());
-    }
-    
-    std::basic_ofstream<unsigned char> ofs(filename, std::ios::out | std::ios::binary);
-
-    if (filedata.size() > 0)
-    {
-        ofs.write(&filedata[0], filedata.size());
-    }
-
-    ofs.close();
-}
-
 void UpdateProgressBar(double total, double completed)
 {
     // how wide you want the progress meter to be
@@ -72,14 +72,42 @@ options_description AppConfig::BuildConfigDescription() {
         ("tre_config", boost::program_options::value<std::string>(&tre_config),
             "File containing the tre configuration (live.cfg)")
 
+        ("static_snapshot_directory", value<string>(&static_snapshot_directory)->default_value(""),
+            "Directory the static world snapshots are cached in, empty to always load from the database")
+
         ("galaxy_name", boost::program_options::value<std::string>(&galaxy_name),
             "Name of the galaxy (cluster) to this process should run")
             
-        ("resource_cache_size", boost::program_options::value<uint32_t>(&resource_cache_size),
-            "Available cache size for the resource manager (in Megabytes)")
+        ("resource_cache_size", boost::program_options::value<uint32_t>(&resource_cache_size)->default_value(500),
+            "Available cache size for the resource manager (in Megabytes), 0 for no limit")
+        ("visitor_cache_directory", value<string>(&visitor_cache_directory)->default_value(""),
+            "Directory parsed tre resources are cached in, empty to parse them on every start")
+        ("terrain_tile_size", value<float>(&terrain_tile_size)->default_value(64.0f),
+            "Edge length in meters of the tiles terrain heights are cached in")
+        ("terrain_tile_resolution", value<float>(&terrain_tile_resolution)->default_value(2.0f),
+            "Distance in meters between the cached terrain heights, heights in between are interpolated")
+        ("terrain_cache_size", value<uint32_t>(&terrain_cache_size)->default_value(64),
+            "Cache size for terrain height tiles per scene (in Megabytes), 0 for no limit")
             
         ("db_threads", value<uint32_t>(&db_threads)->default_value(2),
             "Total number of threads to allocate for database management")
+        ("db_max_connections", value<uint32_t>(&db_max_connections)->default_value(16),
+            "Maximum number of connections opened to each datastore")
+        ("db_connection_timeout", value<uint32_t>(&db_connection_timeout)->default_value(5000),
+            "Time in milliseconds to wait for a free datastore connection before giving up")
+        ("db_statement_cache_size", value<uint32_t>(&db_statement_cache_size)->default_value(64),
+            "Number of prepared statements cached per datastore connection")
+
+        ("object_journal_directory", value<string>(&object_journal_directory)->default_value(""),
+            "Directory of the local journal of object changes, empty to only persist on the persist timer")
+        ("object_journal_interval", value<uint32_t>(&object_journal_interval)->default_value(1000),
+            "Time in milliseconds between writing changed objects to the journal")
+        ("object_journal_compact_interval", value<uint32_t>(&object_journal_compact_interval)->default_value(60),
+            "Time in seconds between replaying the journal into the database")
+        ("persist_db_share", value<uint32_t>(&persist_db_share)->default_value(50),
+            "Percentage of db_max_connections that object persistence may write on at once")
+        ("persist_rows_per_second", value<double>(&persist_rows_per_second)->default_value(0),
+            "Object rows and writes persisted per second at most, 0 for no limit")
 
         ("db.galaxy_manager.host", boost::program_options::value<std::string>(&galaxy_manager_db.host),
             "Host address for the galaxy_manager datastore")
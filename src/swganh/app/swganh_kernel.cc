@@ -68,7 +68,9 @@ AppConfig& SwganhKernel::GetAppConfig() {
 
 DatabaseManager* SwganhKernel::GetDatabaseManager() {
     if (!database_manager_) {
-        database_manager_.reset(new DatabaseManager(sql::mysql::get_driver_instance(), GetAppConfig().db_threads));
+        auto& config = GetAppConfig();
+        database_manager_.reset(new DatabaseManager(sql::mysql::get_driver_instance(), config.db_threads,
+            config.db_max_connections, config.db_connection_timeout, config.db_statement_cache_size));
     }
 
     return database_manager_.get();
@@ -120,7 +122,10 @@ swganh::tre::ResourceManager* SwganhKernel::GetResourceManager()
 {
     if (!resource_manager_)
     {
-        resource_manager_.reset(new swganh::tre::ResourceManager(std::make_shared<swganh::tre::TreArchive>(GetAppConfig().tre_config)));
+        resource_manager_.reset(new swganh::tre::ResourceManager(
+            std::make_shared<swganh::tre::TreArchive>(GetAppConfig().tre_config),
+            static_cast<uint64_t>(GetAppConfig().resource_cache_size) * 1024 * 1024,
+            GetAppConfig().visitor_cache_directory));
     }
 
     return resource_manager_.get();
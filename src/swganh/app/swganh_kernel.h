@@ -32,8 +32,21 @@ struct AppConfig {
     std::string script_directory;
     std::string galaxy_name;
     std::string tre_config;
+    std::string static_snapshot_directory;
     uint32_t resource_cache_size;
+    std::string visitor_cache_directory;
+    float terrain_tile_size;
+    float terrain_tile_resolution;
+    uint32_t terrain_cache_size;
     uint32_t db_threads;
+    uint32_t db_max_connections;
+    uint32_t db_connection_timeout;
+    uint32_t db_statement_cache_size;
+    std::string object_journal_directory;
+    uint32_t object_journal_interval;
+    uint32_t object_journal_compact_interval;
+    uint32_t persist_db_share;
+    double persist_rows_per_second;
 
     /*!
     * @Brief Contains information about the database config"
@@ -6,27 +6,51 @@
 #include "swganh/database/database_manager.h"
 
 #include <algorithm>
+#include <cassert>
 #include <functional>
+#include <sstream>
 
 #include <cppconn/driver.h>
 
+#include "swganh/logger.h"
+
 using namespace swganh::database;
 
-DatabaseManager::DatabaseManager(sql::Driver* driver, uint32_t num_threads)   
+namespace {
+    // Pooled connections idle for longer than this are pinged before reuse, mysql
+    // drops connections that have been idle for wait_timeout.
+    const std::chrono::seconds kIdleCheckInterval(30);
+}
+
+DatabaseManager::DatabaseManager(sql::Driver* driver, uint32_t num_threads, uint32_t max_connections, uint32_t connection_timeout_ms, uint32_t statement_cache_size)
     : driver_(driver)
+    , max_connections_(max_connections > 0 ? max_connections : 1)
+    , connection_timeout_(connection_timeout_ms)
+    , statement_cache_size_(statement_cache_size)
+    , connections_created_(0)
+    , pool_waits_(0)
+    , pool_timeouts_(0)
+    , pool_wait_us_(0)
+    , health_check_failures_(0)
+    , statement_cache_hits_(0)
+    , statement_cache_misses_(0)
+    , statement_cache_evictions_(0)
     , thread_pool_(num_threads)
 {}
 
 DatabaseManager::~DatabaseManager() 
 {
     std::for_each(connections_.begin(), connections_.end(), [] (ConnectionPoolMap::value_type& conn) {
-        while (!conn.second.empty()) 
+        std::deque<IdleConnection> idle;
         {
-            // close each connection and pop it from the list
-            std::shared_ptr<sql::Connection> connection;
-            if (conn.second.try_pop(connection)) {
-                connection->close();
-            }
+            std::lock_guard<std::mutex> lock(conn.second->mutex);
+            idle.swap(conn.second->idle);
+        }
+
+        // close each connection, releasing it afterwards deletes it
+        for (auto& entry : idle)
+        {
+            entry.connection->close();
         }
     });
 }
@@ -42,18 +66,25 @@ bool DatabaseManager::registerStorageType(const StorageType& storage_type, const
         return false;
     }
 
+    auto pool = connections_.insert(std::make_pair(storage_type, std::make_shared<ConnectionPool>())).first->second;
+
     // create a valid connection to verify the integrity of the data passed in
     auto connection = std::shared_ptr<sql::Connection>(
         driver_->connect(host, username, password), 
-        std::bind(&DatabaseManager::recycleConnection_, this, storage_type, std::placeholders::_1));
+        ConnectionRecycler(this, storage_type, std::make_shared<PreparedStatementCache>(statement_cache_size_)));
 
     connection->setSchema(schema);
+    ++connections_created_;
 
     // insert the data
     connection_data_.insert(std::make_pair(storage_type, std::make_shared<ConnectionData>(schema, host, username, password)));
 
     // add the created connection to the connection pool
-    connections_[storage_type].push(connection);
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        ++pool->open_connections;
+        pool->idle.push_back(IdleConnection(connection, std::chrono::steady_clock::now()));
+    }
 
     return true;
 }
@@ -61,11 +92,12 @@ bool DatabaseManager::registerStorageType(const StorageType& storage_type, const
 bool DatabaseManager::hasConnection(const StorageType& storage_type) const 
 {
     // return whether or not the connection pool for this storage type is empty
-    auto find_iter = connections_.find(storage_type);
+    auto pool = FindPool_(storage_type);
 
-    if (find_iter != end(connections_))
+    if (pool)
     {
-        return !find_iter->second.empty();
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        return !pool->idle.empty();
     }
 
     return false;
@@ -73,52 +105,233 @@ bool DatabaseManager::hasConnection(const StorageType& storage_type) const
 
 std::shared_ptr<sql::Connection> DatabaseManager::getConnection(const StorageType& storage_type) 
 {
-    auto connection_pool_iter = connections_.find(storage_type);
+    auto connection_data_iter = connection_data_.find(storage_type);
+    auto pool = FindPool_(storage_type);
+    if (connection_data_iter == connection_data_.end() || !pool)
+    {
+        assert(false && "Requested a storage type that has not been registered");
+        return nullptr;
+    }
+
+    auto wait_start = std::chrono::steady_clock::now();
+    auto deadline = wait_start + connection_timeout_;
+    bool waited = false;
 
-    if (connection_pool_iter == connections_.end() || connection_pool_iter->second.empty())
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    while (true)
     {
-        auto connection_data_iter = connection_data_.find(storage_type);
-        if (connection_data_iter == connection_data_.end())
+        // most recently returned first, its statement cache is the warmest
+        while (!pool->idle.empty())
         {
-            assert(false && "Requested a storage type that has not been registered");
-            return nullptr;
+            IdleConnection idle = std::move(pool->idle.back());
+            pool->idle.pop_back();
+            lock.unlock();
+
+            if (IsHealthy_(idle))
+            {
+                if (waited)
+                {
+                    pool_wait_us_ += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - wait_start).count();
+                }
+                return idle.connection;
+            }
+
+            ++health_check_failures_;
+            LOG(warning) << "Discarding dead pooled connection for storage type " << storage_type.ident_string();
+
+            // the connection is closed by now, releasing it deletes it and frees its slot
+            idle.connection.reset();
+            lock.lock();
+        }
+
+        if (pool->open_connections < max_connections_)
+        {
+            ++pool->open_connections;
+            lock.unlock();
+
+            try
+            {
+                return CreateConnection(connection_data_iter->second, storage_type);
+            }
+            catch(...)
+            {
+                lock.lock();
+                --pool->open_connections;
+                lock.unlock();
+                pool->connection_available.notify_one();
+                throw;
+            }
+        }
+
+        if (!waited)
+        {
+            waited = true;
+            ++pool_waits_;
+        }
+
+        if (pool->connection_available.wait_until(lock, deadline) == std::cv_status::timeout &&
+            pool->idle.empty() && pool->open_connections >= max_connections_)
+        {
+            ++pool_timeouts_;
+            pool_wait_us_ += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - wait_start).count();
+            std::stringstream reason;
+            reason << "Timed out waiting for a connection to storage type " << storage_type.ident_string()
+                << " (" << pool->open_connections << " connections in use)";
+            LOG(error) << reason.str();
+            throw ConnectionTimeout(reason.str());
         }
-    
-        // create a valid connection to verify the integrity of the data passed in
-        return CreateConnection(connection_data_iter->second, storage_type);
     }
+}
 
-    std::shared_ptr<sql::Connection> connection;        
-    if (!connection_pool_iter->second.try_pop(connection))
+std::shared_ptr<sql::PreparedStatement> DatabaseManager::getPreparedStatement(const std::shared_ptr<sql::Connection>& connection, const std::string& sql)
+{
+    auto recycler = std::get_deleter<ConnectionRecycler>(connection);
+    if (!recycler)
     {
-        return nullptr;
+        // not a pooled connection, nowhere to keep the statement
+        ++statement_cache_misses_;
+        return std::shared_ptr<sql::PreparedStatement>(connection->prepareStatement(sql));
     }
-    
-    if (connection->isClosed())
+
+    auto statement = recycler->statements->Find(sql);
+    if (statement)
+    {
+        ++statement_cache_hits_;
+        statement->clearParameters();
+        return statement;
+    }
+
+    ++statement_cache_misses_;
+    statement.reset(connection->prepareStatement(sql));
+
+    if (recycler->statements->Insert(sql, statement))
+    {
+        ++statement_cache_evictions_;
+    }
+
+    return statement;
+}
+
+DatabaseStatistics DatabaseManager::GetStatistics() const
+{
+    DatabaseStatistics statistics;
+    statistics.connections_created = connections_created_;
+    statistics.connections_open = 0;
+    statistics.pool_waits = pool_waits_;
+    statistics.pool_timeouts = pool_timeouts_;
+    statistics.pool_wait_ms = pool_wait_us_ / 1000.0;
+    statistics.health_check_failures = health_check_failures_;
+    statistics.statement_cache_hits = statement_cache_hits_;
+    statistics.statement_cache_misses = statement_cache_misses_;
+    statistics.statement_cache_evictions = statement_cache_evictions_;
+
+    for (auto iter = connections_.begin(); iter != connections_.end(); ++iter)
+    {
+        std::lock_guard<std::mutex> lock(iter->second->mutex);
+        statistics.connections_open += iter->second->open_connections;
+    }
+
+    return statistics;
+}
+
+std::shared_ptr<DatabaseManager::ConnectionPool> DatabaseManager::FindPool_(const StorageType& storage_type) const
+{
+    auto find_iter = connections_.find(storage_type);
+    if (find_iter == connections_.end())
     {
         return nullptr;
     }
 
-    return connection;
+    return find_iter->second;
 }
 
 std::shared_ptr<sql::Connection> DatabaseManager::CreateConnection(const std::shared_ptr<ConnectionData>& connection_data, const StorageType& storage_type)
 {
     auto connection = std::shared_ptr<sql::Connection>(driver_->connect(connection_data->host, connection_data->username, connection_data->password), 
-            std::bind(&DatabaseManager::recycleConnection_, this, storage_type, std::placeholders::_1));
+            ConnectionRecycler(this, storage_type, std::make_shared<PreparedStatementCache>(statement_cache_size_)));
     connection->setSchema(connection_data->schema);
+    ++connections_created_;
 
     return connection;
 }
 
-void DatabaseManager::recycleConnection_(const StorageType& storage_type, sql::Connection* connection) {
+bool DatabaseManager::IsHealthy_(const IdleConnection& idle)
+{
+    if (idle.connection->isClosed())
+    {
+        return false;
+    }
+
+    if (std::chrono::steady_clock::now() - idle.idle_since < kIdleCheckInterval)
+    {
+        return true;
+    }
+
+    try
+    {
+        std::unique_ptr<sql::Statement> statement(idle.connection->createStatement());
+        statement->execute("SELECT 1");
+    }
+    catch(sql::SQLException &e)
+    {
+        LOG(warning) << "Pooled connection failed its health check: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
+
+        try
+        {
+            idle.connection->close();
+        }
+        catch(sql::SQLException&) {}
+
+        return false;
+    }
+
+    return true;
+}
+
+void DatabaseManager::recycleConnection_(const ConnectionRecycler& recycler, sql::Connection* connection) {
+    auto pool = FindPool_(recycler.storage_type);
+
     if (connection->isClosed()) 
     {
+        // statements have to go before the connection they were prepared on
+        recycler.statements->Clear();
         delete connection;
+
+        if (pool)
+        {
+            {
+                std::lock_guard<std::mutex> lock(pool->mutex);
+                --pool->open_connections;
+            }
+            pool->connection_available.notify_one();
+        }
         return;
     }
     
-    connections_[storage_type].push(std::shared_ptr<sql::Connection>(
-        connection, 
-        std::bind(&DatabaseManager::recycleConnection_, this, storage_type, std::placeholders::_1)));
-}
\ No newline at end of file
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->idle.push_back(IdleConnection(std::shared_ptr<sql::Connection>(connection, recycler), std::chrono::steady_clock::now()));
+    }
+    pool->connection_available.notify_one();
+}
+
+void DatabaseManager::LogAsyncError_(const std::exception_ptr& error) const
+{
+    try
+    {
+        std::rethrow_exception(error);
+    }
+    catch(sql::SQLException &e)
+    {
+        LOG(error) << "SQLException in asynchronous database task";
+        LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
+    }
+    catch(std::exception &e)
+    {
+        LOG(error) << "Asynchronous database task failed: " << e.what();
+    }
+    catch(...)
+    {
+        LOG(error) << "Asynchronous database task failed with an unknown exception";
+    }
+}
@@ -3,10 +3,19 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
+#include <boost/asio/strand.hpp>
 #include <boost/noncopyable.hpp>
 
 #include <cppconn/exception.h>
@@ -31,6 +40,7 @@ namespace Concurrency {
 
 #include "swganh/hash_string.h"
 #include "swganh/thread_pool.h"
+#include "swganh/database/prepared_statement_cache.h"
 
 namespace swganh {
 namespace database {
@@ -53,7 +63,33 @@ struct ConnectionData {
     std::string password;
 };
 
+struct DatabaseStatistics {
+    uint64_t connections_created;
+    uint64_t connections_open;       ///< checked out and idle, across all storage types
+    uint64_t pool_waits;             ///< requests that found the pool exhausted and had to wait
+    uint64_t pool_timeouts;          ///< waits that gave up without a connection
+    double pool_wait_ms;             ///< total time spent waiting for a connection
+    uint64_t health_check_failures;  ///< pooled connections found dead and replaced
+    uint64_t statement_cache_hits;
+    uint64_t statement_cache_misses;
+    uint64_t statement_cache_evictions;
+};
+
+/*! Thrown by getConnection when no pooled connection became available before
+* the connection timeout.
+*/
+class ConnectionTimeout : public sql::SQLException {
+public:
+    explicit ConnectionTimeout(const std::string& reason)
+        : sql::SQLException(reason, "HYT00", 0)
+    {}
+};
+
 /*! Exposes an API for managing mysql connector/c++ connections.
+*
+* Connections are pooled per storage type, up to max_connections each. Once a pool
+* is exhausted requests wait for a connection to be returned instead of opening new
+* ones. Every pooled connection carries its own cache of prepared statements.
 */
 class DatabaseManager : private boost::noncopyable {
 public:
@@ -63,8 +99,12 @@ public:
     * @param driver An instance of the sql driver used to provide concrete 
     *      functionality for the database layer.
     * @param num_threads The number of database worker threads to spin up.
+    * @param max_connections The most connections opened per storage type.
+    * @param connection_timeout_ms How long getConnection waits on an exhausted pool.
+    * @param statement_cache_size The number of prepared statements cached per connection.
     */
-    DatabaseManager(sql::Driver* driver, uint32_t num_threads = 1);
+    DatabaseManager(sql::Driver* driver, uint32_t num_threads = 1, uint32_t max_connections = 16,
+        uint32_t connection_timeout_ms = 5000, uint32_t statement_cache_size = 64);
 
     ~DatabaseManager();
 
@@ -91,23 +131,58 @@ public:
     
     /*! Processes a request for a connection to a specific storage type.
     *
+    * Idle pooled connections are health checked before being handed out. When none
+    * are idle and the pool is at its limit the call blocks until one is returned.
+    *
     * @param storage_type The storage type a connection is being requested for.
-    * @return Returns a connection or nullptr if one could not be created, or if
-    * the storage type has not been seen before.
+    * @return Returns a connection or nullptr if the storage type has not been seen before.
+    * @throws ConnectionTimeout if no connection became available before the timeout.
     */
     std::shared_ptr<sql::Connection> getConnection(const StorageType& storage_type);
 
+    /*! Returns a prepared statement for the given sql from the connection's statement
+    * cache, preparing it on the first use. Cached statements have their parameters
+    * cleared before being returned.
+    *
+    * The statement belongs to the connection and must not be used after the
+    * connection has been released.
+    *
+    * @param connection A connection obtained from getConnection.
+    * @param sql The statement text, also used as the cache key.
+    */
+    std::shared_ptr<sql::PreparedStatement> getPreparedStatement(const std::shared_ptr<sql::Connection>& connection, const std::string& sql);
+
+    DatabaseStatistics GetStatistics() const;
+
     /*! Execute an asyncronous database task on one of its dedicated worker threads.
     *
+    * The connection is requested on the worker thread, so the caller never blocks
+    * on an exhausted pool.
+    *
     * @param task The task to be executed, must accept a const std::shared_ptr<sql::Connection>& as
     *             its only parameter.
     * @param storage_type The storage type the task should be executed on.
     * @return A std::future for the return value of the task.
     */
     template<typename T>
-    std::future<typename std::result_of<T()>::type> ExecuteAsync(T&& task, const StorageType& storage_type)
+    std::future<typename std::result_of<T(std::shared_ptr<sql::Connection>)>::type> ExecuteAsync(T task, const StorageType& storage_type)
+    {
+        typedef typename std::result_of<T(std::shared_ptr<sql::Connection>)>::type ResultType;
+        return thread_pool_.Schedule([this, task, storage_type] () -> ResultType {
+            return task(getConnection(storage_type));
+        });
+    }
+
+    /*! Execute an asyncronous task that requests its own connections on one of the
+    * dedicated database worker threads.
+    *
+    * @param task The task to be executed, takes no parameters.
+    * @return A std::future for the return value of the task.
+    */
+    template<typename T>
+    std::future<typename std::result_of<T()>::type> ExecuteAsync(T task)
     {
-        return thread_pool_.Schedule(std::bind(task, getConnection(storage_type)));
+        return thread_pool_.Schedule(std::move(task));
     }
 
     /*! Execute an asyncronous database task on one of its dedicated worker threads.
@@ -124,24 +199,170 @@ public:
         return ExecuteAsync(std::bind(task, instance, std::placeholders::_1), storage_type);
     }
 
+    /*! Execute a task that requests its own connections on one of the worker
+    * threads and post its result to a strand, nothing ever waits on the task.
+    *
+    * Exceptions thrown by the task are logged on the worker and handed to the
+    * handler, which then receives a default constructed result.
+    *
+    * @param task The task to be executed, takes no parameters and must return a
+    *             default constructible value.
+    * @param strand The strand the handler is posted to, must outlive the task.
+    * @param handler Called as handler(std::exception_ptr error, Result result).
+    */
+    template<typename T, typename Handler>
+    void ExecuteAsync(T task, boost::asio::strand& strand, Handler handler)
+    {
+        typedef typename std::result_of<T()>::type ResultType;
+        thread_pool_.Schedule([this, task, &strand, handler] () {
+            auto result = std::make_shared<ResultType>();
+            std::exception_ptr error;
+
+            try {
+                *result = task();
+            } catch(...) {
+                error = std::current_exception();
+                LogAsyncError_(error);
+            }
+
+            strand.post([handler, error, result] () {
+                handler(error, std::move(*result));
+            });
+        });
+    }
+
+    /*! Execute a database task on one of the worker threads and post its result
+    * to a strand.
+    *
+    * @param task The task to be executed, must accept a const std::shared_ptr<sql::Connection>& as
+    *             its only parameter and return a default constructible value.
+    * @param storage_type The storage type the task should be executed on.
+    * @param strand The strand the handler is posted to, must outlive the task.
+    * @param handler Called as handler(std::exception_ptr error, Result result).
+    */
+    template<typename T, typename Handler>
+    void ExecuteAsync(T task, const StorageType& storage_type, boost::asio::strand& strand, Handler handler)
+    {
+        ExecuteAsync([this, task, storage_type] () {
+            auto connection = getConnection(storage_type);
+            if (!connection) {
+                throw std::runtime_error("No connection available for storage type " + storage_type.ident_string());
+            }
+
+            return task(connection);
+        }, strand, std::move(handler));
+    }
+
+    /*! Run a query on one of the worker threads and post the mapped rows to a strand.
+    *
+    * The statement comes from the connection's statement cache, any further result
+    * sets (as returned by stored procedures) are drained before the connection is
+    * released.
+    *
+    * @param storage_type The storage type the query should be executed on.
+    * @param statement_text The sql of the query.
+    * @param binder Sets the parameters, called as binder(sql::PreparedStatement&).
+    * @param mapper Turns the current row into a value, called as mapper(sql::ResultSet&).
+    * @param strand The strand the handler is posted to, must outlive the query.
+    * @param handler Called as handler(std::exception_ptr error, std::vector<Row> rows).
+    */
+    template<typename Binder, typename Mapper, typename Handler>
+    void QueryAsync(const StorageType& storage_type, std::string statement_text, Binder binder, Mapper mapper,
+        boost::asio::strand& strand, Handler handler)
+    {
+        typedef typename std::result_of<Mapper(sql::ResultSet&)>::type Row;
+        ExecuteAsync([this, statement_text, binder, mapper] (const std::shared_ptr<sql::Connection>& connection) -> std::vector<Row> {
+            auto statement = getPreparedStatement(connection, statement_text);
+            binder(*statement);
+
+            std::vector<Row> rows;
+            std::unique_ptr<sql::ResultSet> result_set(statement->executeQuery());
+            while (result_set->next()) {
+                rows.push_back(mapper(*result_set));
+            }
+
+            while (statement->getMoreResults());
+            return rows;
+        }, storage_type, strand, std::move(handler));
+    }
+
 private:
     // disable the default constructor to ensure that DatabaseManager is always
     // created with a driver instance
     DatabaseManager();
     
+    /*! Deleter for pooled connections, hands the connection back to its pool and
+    * carries the connection's statement cache between checkouts.
+    */
+    struct ConnectionRecycler {
+        ConnectionRecycler(DatabaseManager* manager_, const StorageType& storage_type_, std::shared_ptr<PreparedStatementCache> statements_)
+            : manager(manager_)
+            , storage_type(storage_type_)
+            , statements(std::move(statements_))
+        {}
+
+        void operator()(sql::Connection* connection) const
+        {
+            manager->recycleConnection_(*this, connection);
+        }
+
+        DatabaseManager* manager;
+        StorageType storage_type;
+        std::shared_ptr<PreparedStatementCache> statements;
+    };
+
+    struct IdleConnection {
+        IdleConnection(std::shared_ptr<sql::Connection> connection_, std::chrono::steady_clock::time_point idle_since_)
+            : connection(std::move(connection_))
+            , idle_since(idle_since_)
+        {}
+
+        std::shared_ptr<sql::Connection> connection;
+        std::chrono::steady_clock::time_point idle_since;
+    };
+
+    struct ConnectionPool {
+        ConnectionPool() : open_connections(0) {}
+
+        std::mutex mutex;
+        std::condition_variable connection_available;
+        std::deque<IdleConnection> idle;
+        uint32_t open_connections;  ///< idle plus checked out
+    };
+
+    std::shared_ptr<ConnectionPool> FindPool_(const StorageType& storage_type) const;
+
     std::shared_ptr<sql::Connection> CreateConnection(const std::shared_ptr<ConnectionData>& connection_data, const StorageType& storage_type);
-    
-    void recycleConnection_(const StorageType& storage_type, sql::Connection* connection);
+
+    /*! Checks that an idle connection is still usable, connections that sat idle
+    * for longer than the idle check interval are pinged.
+    */
+    bool IsHealthy_(const IdleConnection& idle);
+
+    void recycleConnection_(const ConnectionRecycler& recycler, sql::Connection* connection);
+
+    void LogAsyncError_(const std::exception_ptr& error) const;
 
     sql::Driver* driver_;
+    uint32_t max_connections_;
+    std::chrono::milliseconds connection_timeout_;
+    uint32_t statement_cache_size_;
     
     typedef Concurrency::concurrent_unordered_map<StorageType, std::shared_ptr<ConnectionData>> ConnectionDataMap;
     ConnectionDataMap connection_data_;
     
-    typedef Concurrency::concurrent_queue<std::shared_ptr<sql::Connection>> ConnectionPool;
-    typedef Concurrency::concurrent_unordered_map<StorageType, ConnectionPool> ConnectionPoolMap;
+    typedef Concurrency::concurrent_unordered_map<StorageType, std::shared_ptr<ConnectionPool>> ConnectionPoolMap;
     ConnectionPoolMap connections_;
 
+    std::atomic<uint64_t> connections_created_;
+    std::atomic<uint64_t> pool_waits_;
+    std::atomic<uint64_t> pool_timeouts_;
+    std::atomic<uint64_t> pool_wait_us_;
+    std::atomic<uint64_t> health_check_failures_;
+    std::atomic<uint64_t> statement_cache_hits_;
+    std::atomic<uint64_t> statement_cache_misses_;
+    std::atomic<uint64_t> statement_cache_evictions_;
+
     ThreadPool thread_pool_;
 };
 
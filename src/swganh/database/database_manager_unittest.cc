@@ -1,6 +1,11 @@
 // This file is part of SWGANH which is released under the MIT license.
 // See file LICENSE or go to http://swganh.com/LICENSE
 
+#include <chrono>
+#include <thread>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/strand.hpp>
 #include <boost/test/unit_test.hpp>
 #include <turtle/mock.hpp>
 
@@ -204,6 +209,219 @@ BOOST_AUTO_TEST_CASE(DeletingConnectionReturnsItToThePool) {
     BOOST_CHECK(manager.hasStorageType("my_storage_type"));
 }
 
+/// Preparing the same sql twice on a pooled connection only prepares it once.
+BOOST_AUTO_TEST_CASE(PreparedStatementsAreCachedPerConnection) {
+    MockDriver mock_driver;
+    MockConnection* mock_connection = new MockConnection();
+    MockPreparedStatement* mock_statement = new MockPreparedStatement();
+
+    MOCK_EXPECT(mock_connection->setSchema)
+        .with(sql::SQLString("galaxy"))
+        .once();
+
+    bool closed = false;
+    MOCK_EXPECT(mock_connection->isClosed)
+        .calls([&closed] () { return closed; });
+    MOCK_EXPECT(mock_connection->close)
+        .once()
+        .calls([&closed] () { closed = true; });
+
+    MOCK_EXPECT(mock_connection->tag1)
+        .once()
+        .with(sql::SQLString("CALL sp_GetType(?);"))
+        .returns(mock_statement);
+
+    // a cached statement is handed out with its parameters cleared
+    MOCK_EXPECT(mock_statement->clearParameters)
+        .once();
+
+    MOCK_EXPECT(mock_driver.connect3)
+        .once()
+        .returns(mock_connection);
+
+    DatabaseManager manager(&mock_driver);
+    manager.registerStorageType("my_storage_type", "galaxy", host_, username_, password_);
+
+    {
+        auto connection = manager.getConnection("my_storage_type");
+
+        auto first = manager.getPreparedStatement(connection, "CALL sp_GetType(?);");
+        auto second = manager.getPreparedStatement(connection, "CALL sp_GetType(?);");
+
+        BOOST_CHECK(first == second);
+    }
+
+    auto statistics = manager.GetStatistics();
+    BOOST_CHECK_EQUAL(1u, statistics.statement_cache_hits);
+    BOOST_CHECK_EQUAL(1u, statistics.statement_cache_misses);
+}
+
+/// Once every connection of a storage type is in use, requests wait for one to
+/// be returned rather than opening another, and throw once the timeout passes.
+BOOST_AUTO_TEST_CASE(ExhaustedPoolWaitsForAConnection) {
+    MockDriver mock_driver;
+    MockConnection* mock_connection = new MockConnection();
+
+    MOCK_EXPECT(mock_connection->setSchema)
+        .with(sql::SQLString("galaxy"))
+        .once();
+
+    bool closed = false;
+    MOCK_EXPECT(mock_connection->isClosed)
+        .calls([&closed] () { return closed; });
+    MOCK_EXPECT(mock_connection->close)
+        .once()
+        .calls([&closed] () { closed = true; });
+
+    // only the registration connection is ever opened
+    MOCK_EXPECT(mock_driver.connect3)
+        .once()
+        .returns(mock_connection);
+
+    DatabaseManager manager(&mock_driver, 1, 1, 50);
+    manager.registerStorageType("my_storage_type", "galaxy", host_, username_, password_);
+
+    {
+        auto connection = manager.getConnection("my_storage_type");
+        BOOST_CHECK(connection != nullptr);
+
+        // the only connection is checked out
+        BOOST_CHECK_THROW(manager.getConnection("my_storage_type"), ConnectionTimeout);
+
+        std::thread releaser([&connection] () {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            connection.reset();
+        });
+
+        // a waiting request is handed the returned connection
+        auto reused = manager.getConnection("my_storage_type");
+        releaser.join();
+        BOOST_CHECK(reused != nullptr);
+    }
+
+    auto statistics = manager.GetStatistics();
+    BOOST_CHECK(statistics.pool_waits >= 1);
+    BOOST_CHECK_EQUAL(1u, statistics.pool_timeouts);
+    BOOST_CHECK_EQUAL(1u, statistics.connections_created);
+}
+
+/// An asynchronous query maps its rows on a worker and hands them to the strand.
+BOOST_AUTO_TEST_CASE(AsyncQueryPostsMappedRowsToStrand) {
+    MockDriver mock_driver;
+    MockConnection* mock_connection = new MockConnection();
+    MockPreparedStatement* mock_statement = new MockPreparedStatement();
+    MockResultSet* mock_result_set = new MockResultSet();
+
+    MOCK_EXPECT(mock_connection->setSchema)
+        .with(sql::SQLString("galaxy"))
+        .once();
+
+    bool closed = false;
+    MOCK_EXPECT(mock_connection->isClosed)
+        .calls([&closed] () { return closed; });
+    MOCK_EXPECT(mock_connection->close)
+        .once()
+        .calls([&closed] () { closed = true; });
+
+    MOCK_EXPECT(mock_connection->tag1)
+        .once()
+        .with(sql::SQLString("CALL sp_MailFetchHeaders(?);"))
+        .returns(mock_statement);
+
+    MOCK_EXPECT(mock_statement->setUInt64)
+        .once()
+        .with(1, 42u);
+    MOCK_EXPECT(mock_statement->tag4)
+        .once()
+        .returns(mock_result_set);
+    MOCK_EXPECT(mock_statement->getMoreResults)
+        .returns(false);
+
+    int rows_left = 2;
+    MOCK_EXPECT(mock_result_set->next)
+        .calls([&rows_left] () { return rows_left-- > 0; });
+    MOCK_EXPECT(mock_result_set->tag11)
+        .with(sql::SQLString("id"))
+        .returns(7u);
+
+    MOCK_EXPECT(mock_driver.connect3)
+        .once()
+        .returns(mock_connection);
+
+    DatabaseManager manager(&mock_driver);
+    manager.registerStorageType("my_storage_type", "galaxy", host_, username_, password_);
+
+    boost::asio::io_service io_service;
+    boost::asio::io_service::work work(io_service);
+    boost::asio::strand strand(io_service);
+
+    bool failed = true;
+    std::vector<uint32_t> ids;
+    manager.QueryAsync("my_storage_type", "CALL sp_MailFetchHeaders(?);",
+        [] (sql::PreparedStatement& statement) { statement.setUInt64(1, 42); },
+        [] (sql::ResultSet& result_set) { return result_set.getUInt("id"); },
+        strand,
+        [&] (std::exception_ptr error, std::vector<uint32_t> rows) {
+            BOOST_CHECK(strand.running_in_this_thread());
+            failed = static_cast<bool>(error);
+            ids = std::move(rows);
+            io_service.stop();
+        });
+
+    io_service.run();
+
+    BOOST_CHECK(!failed);
+    BOOST_REQUIRE_EQUAL(2u, ids.size());
+    BOOST_CHECK_EQUAL(7u, ids[1]);
+}
+
+/// A task that throws still completes on the strand, with the error and an empty result.
+BOOST_AUTO_TEST_CASE(AsyncTaskFailureIsPostedToStrand) {
+    MockDriver mock_driver;
+    MockConnection* mock_connection = new MockConnection();
+
+    MOCK_EXPECT(mock_connection->setSchema)
+        .with(sql::SQLString("galaxy"))
+        .once();
+
+    bool closed = false;
+    MOCK_EXPECT(mock_connection->isClosed)
+        .calls([&closed] () { return closed; });
+    MOCK_EXPECT(mock_connection->close)
+        .once()
+        .calls([&closed] () { closed = true; });
+
+    MOCK_EXPECT(mock_driver.connect3)
+        .once()
+        .returns(mock_connection);
+
+    DatabaseManager manager(&mock_driver);
+    manager.registerStorageType("my_storage_type", "galaxy", host_, username_, password_);
+
+    boost::asio::io_service io_service;
+    boost::asio::io_service::work work(io_service);
+    boost::asio::strand strand(io_service);
+
+    std::exception_ptr failure;
+    uint32_t message_id = 1;
+    manager.ExecuteAsync(
+        [] (const std::shared_ptr<sql::Connection>&) -> uint32_t {
+            throw sql::SQLException("lost connection");
+        },
+        "my_storage_type",
+        strand,
+        [&] (std::exception_ptr error, uint32_t result) {
+            failure = error;
+            message_id = result;
+            io_service.stop();
+        });
+
+    io_service.run();
+
+    BOOST_CHECK(failure != nullptr);
+    BOOST_CHECK_EQUAL(0u, message_id);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 /*****************************************************************************/
 // Implementation for the test fixture //
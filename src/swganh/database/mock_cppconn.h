@@ -118,6 +118,7 @@ MOCK_BASE_CLASS(MockPreparedStatement, sql::PreparedStatement)
     MOCK_METHOD(setNull, 2);
     MOCK_METHOD(setString, 2);
     MOCK_METHOD(setResultSetType, 1);
+    MOCK_METHOD(getMoreResults, 0);
 };
 
 MOCK_BASE_CLASS(MockResultSet, sql::ResultSet)
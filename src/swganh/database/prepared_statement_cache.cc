@@ -0,0 +1,65 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "swganh/database/prepared_statement_cache.h"
+
+#include <cppconn/prepared_statement.h>
+
+using namespace swganh::database;
+
+PreparedStatementCache::PreparedStatementCache(size_t capacity)
+    : capacity_(capacity > 0 ? capacity : 1)
+{}
+
+std::shared_ptr<sql::PreparedStatement> PreparedStatementCache::Find(const std::string& sql)
+{
+    auto find_iter = lookup_.find(sql);
+    if (find_iter == lookup_.end())
+    {
+        return nullptr;
+    }
+
+    entries_.splice(entries_.begin(), entries_, find_iter->second);
+
+    return find_iter->second->second;
+}
+
+bool PreparedStatementCache::Insert(const std::string& sql, std::shared_ptr<sql::PreparedStatement> statement)
+{
+    auto find_iter = lookup_.find(sql);
+    if (find_iter != lookup_.end())
+    {
+        find_iter->second->second = std::move(statement);
+        entries_.splice(entries_.begin(), entries_, find_iter->second);
+        return false;
+    }
+
+    bool evicted = false;
+    if (entries_.size() >= capacity_)
+    {
+        lookup_.erase(entries_.back().first);
+        entries_.pop_back();
+        evicted = true;
+    }
+
+    entries_.push_front(Entry(sql, std::move(statement)));
+    lookup_[sql] = entries_.begin();
+
+    return evicted;
+}
+
+void PreparedStatementCache::Clear()
+{
+    lookup_.clear();
+    entries_.clear();
+}
+
+size_t PreparedStatementCache::Size() const
+{
+    return entries_.size();
+}
+
+size_t PreparedStatementCache::Capacity() const
+{
+    return capacity_;
+}
@@ -0,0 +1,62 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <boost/noncopyable.hpp>
+
+namespace sql {
+    class PreparedStatement;
+}
+
+namespace swganh {
+namespace database {
+
+/*! Least recently used cache of prepared statements keyed by their sql text.
+*
+* Each pooled connection owns one of these. A connection is only ever used by the
+* thread that checked it out, so the cache does no locking of its own.
+*/
+class PreparedStatementCache : private boost::noncopyable {
+public:
+    explicit PreparedStatementCache(size_t capacity = 64);
+
+    /*! Looks up a statement and marks it as the most recently used.
+    *
+    * @return The cached statement or nullptr if the sql has not been prepared yet.
+    */
+    std::shared_ptr<sql::PreparedStatement> Find(const std::string& sql);
+
+    /*! Adds a statement, dropping the least recently used one when the cache is full.
+    *
+    * @return True if a statement was evicted to make room.
+    */
+    bool Insert(const std::string& sql, std::shared_ptr<sql::PreparedStatement> statement);
+
+    /*! Releases every cached statement, must be called before the owning connection
+    * is deleted.
+    */
+    void Clear();
+
+    size_t Size() const;
+    size_t Capacity() const;
+
+private:
+    typedef std::pair<std::string, std::shared_ptr<sql::PreparedStatement>> Entry;
+    typedef std::list<Entry> EntryList;
+
+    // most recently used first
+    EntryList entries_;
+    std::unordered_map<std::string, EntryList::iterator> lookup_;
+    size_t capacity_;
+};
+
+}  // namespace database
+}  // namespace swganh
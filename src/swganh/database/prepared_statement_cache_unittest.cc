@@ -0,0 +1,50 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <boost/test/unit_test.hpp>
+#include <turtle/mock.hpp>
+
+#include "swganh/database/mock_cppconn.h"
+
+#include "swganh/database/prepared_statement_cache.h"
+
+using namespace swganh::database;
+
+BOOST_AUTO_TEST_SUITE(PreparedStatementCacheTest)
+
+/// This test shows that a cached statement is found by its sql text.
+BOOST_AUTO_TEST_CASE(CachedStatementIsFoundBySql) {
+    PreparedStatementCache cache(4);
+    auto statement = std::make_shared<MockPreparedStatement>();
+
+    BOOST_CHECK(cache.Find("CALL sp_GetType(?);") == nullptr);
+
+    cache.Insert("CALL sp_GetType(?);", statement);
+
+    BOOST_CHECK(cache.Find("CALL sp_GetType(?);") == statement);
+    BOOST_CHECK_EQUAL(1u, cache.Size());
+}
+
+/// This test shows that the least recently used statement is evicted once the
+/// cache is full.
+BOOST_AUTO_TEST_CASE(LeastRecentlyUsedStatementIsEvicted) {
+    PreparedStatementCache cache(2);
+
+    BOOST_CHECK(!cache.Insert("a", std::make_shared<MockPreparedStatement>()));
+    BOOST_CHECK(!cache.Insert("b", std::make_shared<MockPreparedStatement>()));
+
+    // touch a so that b becomes the least recently used
+    cache.Find("a");
+
+    BOOST_CHECK(cache.Insert("c", std::make_shared<MockPreparedStatement>()));
+
+    BOOST_CHECK(cache.Find("a") != nullptr);
+    BOOST_CHECK(cache.Find("b") == nullptr);
+    BOOST_CHECK(cache.Find("c") != nullptr);
+    BOOST_CHECK_EQUAL(2u, cache.Size());
+
+    cache.Clear();
+    BOOST_CHECK_EQUAL(0u, cache.Size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
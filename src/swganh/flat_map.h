@@ -0,0 +1,168 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace swganh {
+
+/*! \brief An associative container backed by a single sorted std::vector.
+ *
+ * Intended for the small per-object maps (attributes, flags) where a node based
+ * std::map costs one heap allocation per entry plus three pointers of overhead.
+ * Lookups are a binary search over contiguous memory. Iterators are invalidated
+ * by any insertion or removal.
+ */
+template<typename Key, typename Value, typename Compare = std::less<Key>>
+class FlatMap {
+public:
+    typedef Key key_type;
+    typedef Value mapped_type;
+    typedef std::pair<Key, Value> value_type;
+    typedef std::vector<value_type> container_type;
+    typedef typename container_type::iterator iterator;
+    typedef typename container_type::const_iterator const_iterator;
+    typedef typename container_type::size_type size_type;
+
+    iterator begin() { return data_.begin(); }
+    iterator end() { return data_.end(); }
+    const_iterator begin() const { return data_.begin(); }
+    const_iterator end() const { return data_.end(); }
+
+    bool empty() const { return data_.empty(); }
+    size_type size() const { return data_.size(); }
+    void clear() { data_.clear(); }
+
+    /// Trims the backing storage down to the number of stored entries.
+    void shrink_to_fit() { container_type(data_).swap(data_); }
+
+    /// Pre-allocates room for the given number of entries.
+    void reserve(size_type count) { data_.reserve(count); }
+
+    iterator find(const Key& key)
+    {
+        auto iter = lower_bound(key);
+        return (iter != data_.end() && !compare_(key, iter->first)) ? iter : data_.end();
+    }
+
+    const_iterator find(const Key& key) const
+    {
+        auto iter = lower_bound(key);
+        return (iter != data_.end() && !compare_(key, iter->first)) ? iter : data_.end();
+    }
+
+    size_type count(const Key& key) const { return find(key) != data_.end() ? 1 : 0; }
+
+    Value& operator[](const Key& key)
+    {
+        auto iter = lower_bound(key);
+        if (iter == data_.end() || compare_(key, iter->first))
+        {
+            iter = data_.insert(iter, value_type(key, Value()));
+        }
+        return iter->second;
+    }
+
+    std::pair<iterator, bool> insert(value_type value)
+    {
+        auto iter = lower_bound(value.first);
+        if (iter != data_.end() && !compare_(value.first, iter->first))
+        {
+            return std::make_pair(iter, false);
+        }
+        return std::make_pair(data_.insert(iter, std::move(value)), true);
+    }
+
+    size_type erase(const Key& key)
+    {
+        auto iter = find(key);
+        if (iter == data_.end())
+        {
+            return 0;
+        }
+        data_.erase(iter);
+        return 1;
+    }
+
+    iterator erase(iterator iter) { return data_.erase(iter); }
+
+    bool operator==(const FlatMap& other) const { return data_ == other.data_; }
+
+private:
+    iterator lower_bound(const Key& key)
+    {
+        return std::lower_bound(data_.begin(), data_.end(), key,
+            [this] (const value_type& entry, const Key& k) { return compare_(entry.first, k); });
+    }
+
+    const_iterator lower_bound(const Key& key) const
+    {
+        return std::lower_bound(data_.begin(), data_.end(), key,
+            [this] (const value_type& entry, const Key& k) { return compare_(entry.first, k); });
+    }
+
+    container_type data_;
+    Compare compare_;
+};
+
+/*! \brief A set counterpart to FlatMap, storing its keys in a sorted sequence.
+ *
+ * The backing sequence defaults to std::vector, swganh::SmallVector can be used
+ * to keep small sets free of heap allocations.
+ */
+template<typename Key, typename Compare = std::less<Key>, typename Container = std::vector<Key>>
+class FlatSet {
+public:
+    typedef Key key_type;
+    typedef Key value_type;
+    typedef Container container_type;
+    typedef typename container_type::const_iterator iterator;
+    typedef typename container_type::const_iterator const_iterator;
+    typedef typename container_type::size_type size_type;
+
+    const_iterator begin() const { return data_.begin(); }
+    const_iterator end() const { return data_.end(); }
+
+    bool empty() const { return data_.empty(); }
+    size_type size() const { return data_.size(); }
+    void clear() { data_.clear(); }
+
+    const_iterator find(const Key& key) const
+    {
+        auto iter = std::lower_bound(data_.begin(), data_.end(), key, compare_);
+        return (iter != data_.end() && !compare_(key, *iter)) ? iter : data_.end();
+    }
+
+    size_type count(const Key& key) const { return find(key) != data_.end() ? 1 : 0; }
+
+    std::pair<const_iterator, bool> insert(const Key& key)
+    {
+        auto iter = std::lower_bound(data_.begin(), data_.end(), key, compare_);
+        if (iter != data_.end() && !compare_(key, *iter))
+        {
+            return std::make_pair(const_iterator(iter), false);
+        }
+        return std::make_pair(const_iterator(data_.insert(iter, key)), true);
+    }
+
+    size_type erase(const Key& key)
+    {
+        auto iter = std::lower_bound(data_.begin(), data_.end(), key, compare_);
+        if (iter == data_.end() || compare_(key, *iter))
+        {
+            return 0;
+        }
+        data_.erase(iter);
+        return 1;
+    }
+
+private:
+    container_type data_;
+    Compare compare_;
+};
+
+}  // namespace swganh
@@ -0,0 +1,78 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include "swganh/flat_map.h"
+#include "swganh/string_interner.h"
+
+using namespace swganh;
+
+BOOST_AUTO_TEST_SUITE(FlatMapTest)
+
+/// This test shows that entries are kept sorted by key regardless of insertion order.
+BOOST_AUTO_TEST_CASE(EntriesAreSortedByKey) {
+    FlatMap<uint32_t, int> map;
+    map[30] = 3;
+    map[10] = 1;
+    map[20] = 2;
+
+    BOOST_REQUIRE_EQUAL(3u, map.size());
+
+    uint32_t last_key = 0;
+    for (auto& entry : map)
+    {
+        BOOST_CHECK_GT(entry.first, last_key);
+        last_key = entry.first;
+    }
+}
+
+/// This test shows that inserting an existing key keeps the original value.
+BOOST_AUTO_TEST_CASE(InsertDoesNotOverwriteExistingKey) {
+    FlatMap<uint32_t, int> map;
+    BOOST_CHECK(map.insert(std::make_pair(5u, 1)).second);
+    BOOST_CHECK(!map.insert(std::make_pair(5u, 2)).second);
+
+    BOOST_CHECK_EQUAL(1, map.find(5)->second);
+}
+
+/// This test shows that entries can be found and erased by key.
+BOOST_AUTO_TEST_CASE(CanFindAndEraseByKey) {
+    FlatMap<uint32_t, std::wstring> map;
+    map[1] = L"one";
+    map[2] = L"two";
+
+    BOOST_CHECK(map.find(3) == map.end());
+    BOOST_CHECK(map.find(2)->second == L"two");
+
+    BOOST_CHECK_EQUAL(1u, map.erase(2));
+    BOOST_CHECK_EQUAL(0u, map.erase(2));
+    BOOST_CHECK(map.find(2) == map.end());
+}
+
+/// This test shows that a FlatSet holds each key only once.
+BOOST_AUTO_TEST_CASE(FlatSetHoldsUniqueKeys) {
+    FlatSet<uint32_t> set;
+    set.insert(7);
+    set.insert(3);
+    set.insert(7);
+
+    BOOST_CHECK_EQUAL(2u, set.size());
+    BOOST_CHECK_EQUAL(1u, set.count(3));
+    BOOST_CHECK_EQUAL(1u, set.erase(3));
+    BOOST_CHECK_EQUAL(0u, set.count(3));
+}
+
+/// This test shows that interned strings can be recovered from their identifier.
+BOOST_AUTO_TEST_CASE(InternedStringsCanBeLookedUp) {
+    auto& interner = StringInterner::getInstance();
+    uint32_t ident = interner.Intern("flat_map_test_attribute");
+
+    BOOST_CHECK_EQUAL(StringInterner::Hash("flat_map_test_attribute"), ident);
+    BOOST_CHECK_EQUAL("flat_map_test_attribute", interner.Lookup(ident));
+    BOOST_CHECK(interner.Lookup(StringInterner::Hash("never_interned")).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
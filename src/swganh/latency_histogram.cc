@@ -0,0 +1,110 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "swganh/latency_histogram.h"
+
+#include <sstream>
+
+using namespace swganh;
+
+namespace {
+    // upper bounds in milliseconds, the last bucket catches everything slower
+    const uint32_t kBucketBounds[LatencyHistogram::kBucketCount - 1] = {
+        1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000
+    };
+}
+
+LatencyHistogram::LatencyHistogram()
+    : count_(0)
+    , total_us_(0)
+    , max_us_(0)
+{
+    for (auto& bucket : buckets_)
+    {
+        bucket = 0;
+    }
+}
+
+void LatencyHistogram::Record(std::chrono::steady_clock::duration latency)
+{
+    uint64_t us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+
+    size_t bucket = 0;
+    while (bucket < kBucketCount - 1 && us > kBucketBounds[bucket] * 1000ull)
+    {
+        ++bucket;
+    }
+
+    ++buckets_[bucket];
+    ++count_;
+    total_us_ += us;
+
+    uint64_t current_max = max_us_;
+    while (us > current_max && !max_us_.compare_exchange_weak(current_max, us)) {}
+}
+
+uint64_t LatencyHistogram::Count() const
+{
+    return count_;
+}
+
+double LatencyHistogram::MaxMilliseconds() const
+{
+    return max_us_ / 1000.0;
+}
+
+double LatencyHistogram::MeanMilliseconds() const
+{
+    uint64_t count = count_;
+    return (count > 0) ? (total_us_ / 1000.0) / count : 0;
+}
+
+double LatencyHistogram::PercentileMilliseconds(double percentile) const
+{
+    uint64_t count = count_;
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>((percentile / 100.0) * count + 0.5);
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < kBucketCount - 1; ++bucket)
+    {
+        seen += buckets_[bucket];
+        if (seen >= rank)
+        {
+            return kBucketBounds[bucket];
+        }
+    }
+
+    return MaxMilliseconds();
+}
+
+uint64_t LatencyHistogram::BucketCount(size_t bucket) const
+{
+    return (bucket < kBucketCount) ? buckets_[bucket].load() : 0;
+}
+
+uint32_t LatencyHistogram::BucketUpperBound(size_t bucket)
+{
+    return (bucket < kBucketCount - 1) ? kBucketBounds[bucket] : 0;
+}
+
+std::string LatencyHistogram::ToString() const
+{
+    std::stringstream ss;
+    ss << "count: " << Count()
+       << ", mean: " << MeanMilliseconds() << "ms"
+       << ", p50: " << PercentileMilliseconds(50) << "ms"
+       << ", p95: " << PercentileMilliseconds(95) << "ms"
+       << ", p99: " << PercentileMilliseconds(99) << "ms"
+       << ", max: " << MaxMilliseconds() << "ms";
+
+    return ss.str();
+}
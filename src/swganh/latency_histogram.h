@@ -0,0 +1,61 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <boost/noncopyable.hpp>
+
+namespace swganh {
+
+/*! \brief Lock free histogram of operation latencies.
+ *
+ * Samples are counted in fixed buckets with roughly logarithmic upper bounds
+ * (1ms, 2ms, 5ms, 10ms, ... 10s), anything slower lands in a final overflow
+ * bucket. Recording is safe from any thread.
+ */
+class LatencyHistogram : private boost::noncopyable
+{
+public:
+    static const size_t kBucketCount = 14;
+
+    LatencyHistogram();
+
+    void Record(std::chrono::steady_clock::duration latency);
+
+    /// Returns the number of samples recorded.
+    uint64_t Count() const;
+
+    /// Returns the largest sample recorded, in milliseconds.
+    double MaxMilliseconds() const;
+
+    /// Returns the mean of the samples recorded, in milliseconds.
+    double MeanMilliseconds() const;
+
+    /*! Returns the upper bound of the bucket holding the given percentile
+     * (0 - 100), in milliseconds. The overflow bucket reports the largest sample.
+     */
+    double PercentileMilliseconds(double percentile) const;
+
+    /// Returns the number of samples in a bucket.
+    uint64_t BucketCount(size_t bucket) const;
+
+    /// Returns the upper bound of a bucket in milliseconds, 0 for the overflow bucket.
+    static uint32_t BucketUpperBound(size_t bucket);
+
+    /// Returns a one line summary suitable for logging.
+    std::string ToString() const;
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_;
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> total_us_;
+    std::atomic<uint64_t> max_us_;
+};
+
+}  // namespace swganh
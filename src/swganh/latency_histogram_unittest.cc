@@ -0,0 +1,50 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <boost/test/unit_test.hpp>
+
+#include "swganh/latency_histogram.h"
+
+using namespace swganh;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+BOOST_AUTO_TEST_SUITE(LatencyHistogramTest)
+
+/// This test shows that samples land in the bucket whose upper bound covers them.
+BOOST_AUTO_TEST_CASE(SamplesAreBucketedByUpperBound) {
+    LatencyHistogram histogram;
+
+    histogram.Record(microseconds(500));
+    histogram.Record(milliseconds(1));
+    histogram.Record(milliseconds(3));
+    histogram.Record(milliseconds(60000));
+
+    BOOST_CHECK_EQUAL(2u, histogram.BucketCount(0));
+    BOOST_CHECK_EQUAL(1u, histogram.BucketCount(2));
+    BOOST_CHECK_EQUAL(1u, histogram.BucketCount(LatencyHistogram::kBucketCount - 1));
+    BOOST_CHECK_EQUAL(4u, histogram.Count());
+}
+
+/// This test shows that percentiles report the bound of the bucket holding them,
+/// and the overflow bucket reports the largest sample.
+BOOST_AUTO_TEST_CASE(PercentilesReportBucketBounds) {
+    LatencyHistogram histogram;
+
+    BOOST_CHECK_EQUAL(0, histogram.PercentileMilliseconds(50));
+
+    for (int i = 0; i < 98; ++i)
+    {
+        histogram.Record(milliseconds(4));
+    }
+    histogram.Record(milliseconds(150));
+    histogram.Record(milliseconds(20000));
+
+    BOOST_CHECK_EQUAL(5, histogram.PercentileMilliseconds(50));
+    BOOST_CHECK_EQUAL(5, histogram.PercentileMilliseconds(95));
+    BOOST_CHECK_EQUAL(200, histogram.PercentileMilliseconds(99));
+    BOOST_CHECK_EQUAL(20000, histogram.PercentileMilliseconds(100));
+    BOOST_CHECK_EQUAL(20000, histogram.MaxMilliseconds());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,229 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+
+namespace swganh {
+
+/*! Snapshot of the usage of one fixed size block pool.
+ */
+struct PoolStatistics
+{
+    size_t block_size;
+    uint64_t blocks_in_use;      ///< blocks currently handed out
+    uint64_t blocks_reserved;    ///< blocks owned by the pool, in use or free
+    uint64_t allocations;        ///< total blocks handed out since startup
+    uint64_t heap_allocations;   ///< chunk allocations made against the global heap
+};
+
+namespace detail {
+
+class BlockPoolBase
+{
+public:
+    virtual ~BlockPoolBase() {}
+    virtual PoolStatistics GetStatistics() const = 0;
+};
+
+/// Registry of every instantiated block pool, used for reporting only.
+class BlockPoolRegistry
+{
+public:
+    static BlockPoolRegistry& getInstance()
+    {
+        static BlockPoolRegistry instance;
+        return instance;
+    }
+
+    void Register(const BlockPoolBase* pool)
+    {
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        pools_.push_back(pool);
+    }
+
+    std::vector<PoolStatistics> GetStatistics() const
+    {
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        std::vector<PoolStatistics> statistics;
+        for (auto pool : pools_)
+        {
+            statistics.push_back(pool->GetStatistics());
+        }
+        return statistics;
+    }
+
+private:
+    mutable boost::mutex mutex_;
+    std::vector<const BlockPoolBase*> pools_;
+};
+
+/*! Process wide free list of BlockSize byte blocks. Memory is carved out of
+ * chunks of BlocksPerChunk blocks and is recycled but never returned to the heap.
+ */
+template<size_t BlockSize, size_t BlocksPerChunk = 64>
+class BlockPool : public BlockPoolBase
+{
+public:
+    static BlockPool& getInstance()
+    {
+        static BlockPool instance;
+        return instance;
+    }
+
+    void* Allocate()
+    {
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        if (!free_list_)
+        {
+            AllocateChunk_();
+        }
+
+        FreeBlock* block = free_list_;
+        free_list_ = block->next;
+
+        ++blocks_in_use_;
+        ++allocations_;
+
+        return block;
+    }
+
+    void Deallocate(void* ptr)
+    {
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        block->next = free_list_;
+        free_list_ = block;
+
+        --blocks_in_use_;
+    }
+
+    PoolStatistics GetStatistics() const
+    {
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        PoolStatistics statistics;
+        statistics.block_size = kAlignedBlockSize;
+        statistics.blocks_in_use = blocks_in_use_;
+        statistics.blocks_reserved = chunks_.size() * BlocksPerChunk;
+        statistics.allocations = allocations_;
+        statistics.heap_allocations = chunks_.size();
+        return statistics;
+    }
+
+private:
+    struct FreeBlock { FreeBlock* next; };
+
+    // round each block up so every block in a chunk stays maximally aligned
+    static const size_t kAlignment = sizeof(long double) > sizeof(void*) ? sizeof(long double) : sizeof(void*);
+    static const size_t kAlignedBlockSize = ((BlockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : BlockSize) + kAlignment - 1) / kAlignment * kAlignment;
+
+    BlockPool()
+        : free_list_(nullptr)
+        , blocks_in_use_(0)
+        , allocations_(0)
+    {
+        BlockPoolRegistry::getInstance().Register(this);
+    }
+
+    // Chunks are intentionally never released, pooled objects held by other
+    // statics may still be alive while this pool is being destroyed.
+    ~BlockPool() {}
+
+    void AllocateChunk_()
+    {
+        char* chunk = static_cast<char*>(::operator new(kAlignedBlockSize * BlocksPerChunk));
+        chunks_.push_back(chunk);
+
+        for (size_t i = BlocksPerChunk; i > 0; --i)
+        {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * kAlignedBlockSize);
+            block->next = free_list_;
+            free_list_ = block;
+        }
+    }
+
+    mutable boost::mutex mutex_;
+    FreeBlock* free_list_;
+    std::vector<char*> chunks_;
+    uint64_t blocks_in_use_;
+    uint64_t allocations_;
+};
+
+}  // namespace detail
+
+/*! \brief Standard allocator backed by a process wide free list per object size.
+ *
+ * Used with std::allocate_shared so both the object and its shared_ptr control
+ * block come out of (and go back to) a recycled block instead of the heap.
+ */
+template<typename T>
+class PoolAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template<typename U>
+    struct rebind { typedef PoolAllocator<U> other; };
+
+    PoolAllocator() {}
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    pointer allocate(size_type count)
+    {
+        if (count != 1)
+        {
+            return static_cast<pointer>(::operator new(count * sizeof(T)));
+        }
+        return static_cast<pointer>(detail::BlockPool<sizeof(T)>::getInstance().Allocate());
+    }
+
+    void deallocate(pointer ptr, size_type count)
+    {
+        if (count != 1)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+        detail::BlockPool<sizeof(T)>::getInstance().Deallocate(ptr);
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>&) const { return true; }
+
+    template<typename U>
+    bool operator!=(const PoolAllocator<U>&) const { return false; }
+};
+
+/*! Creates a default constructed T whose storage comes from a PoolAllocator.
+ */
+template<typename T>
+std::shared_ptr<T> MakePooled()
+{
+    return std::allocate_shared<T>(PoolAllocator<T>());
+}
+
+/*! @return Usage statistics for every block pool created so far.
+ */
+inline std::vector<PoolStatistics> GetPoolStatistics()
+{
+    return detail::BlockPoolRegistry::getInstance().GetStatistics();
+}
+
+}  // namespace swganh
@@ -0,0 +1,88 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include "swganh/pool_allocator.h"
+#include "swganh/small_vector.h"
+
+using namespace swganh;
+
+namespace {
+    struct PooledTestObject
+    {
+        PooledTestObject() : value(42) {}
+        uint64_t value;
+        std::string name;
+        char padding[200];
+    };
+
+    uint64_t BlocksInUse(size_t min_block_size)
+    {
+        uint64_t in_use = 0;
+        for (auto& statistics : GetPoolStatistics())
+        {
+            if (statistics.block_size >= min_block_size)
+                in_use += statistics.blocks_in_use;
+        }
+        return in_use;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(PoolAllocatorTest)
+
+/// This test shows that pooled objects are constructed and their blocks returned on release.
+BOOST_AUTO_TEST_CASE(PooledObjectsAreRecycled) {
+    auto baseline = BlocksInUse(sizeof(PooledTestObject));
+    void* first_address = nullptr;
+    {
+        auto object = MakePooled<PooledTestObject>();
+        BOOST_CHECK_EQUAL(42u, object->value);
+        BOOST_CHECK_EQUAL(baseline + 1, BlocksInUse(sizeof(PooledTestObject)));
+        first_address = object.get();
+    }
+    BOOST_CHECK_EQUAL(baseline, BlocksInUse(sizeof(PooledTestObject)));
+
+    // the most recently released block is handed out first
+    auto object = MakePooled<PooledTestObject>();
+    BOOST_CHECK_EQUAL(first_address, static_cast<void*>(object.get()));
+}
+
+/// This test shows that a small vector stays inline until it outgrows its buffer.
+BOOST_AUTO_TEST_CASE(SmallVectorSpillsToHeapWhenFull) {
+    SmallVector<std::string, 2> vector;
+    vector.push_back("a");
+    vector.push_back("b");
+    BOOST_CHECK(vector.is_inline());
+
+    vector.push_back("c");
+    BOOST_CHECK(!vector.is_inline());
+    BOOST_REQUIRE_EQUAL(3u, vector.size());
+    BOOST_CHECK_EQUAL("c", vector[2]);
+
+    auto copy = vector;
+    vector.erase(vector.begin());
+    BOOST_CHECK_EQUAL(2u, vector.size());
+    BOOST_CHECK_EQUAL("b", vector[0]);
+    BOOST_CHECK_EQUAL(3u, copy.size());
+}
+
+/// This test shows that insert keeps the existing elements in order.
+BOOST_AUTO_TEST_CASE(SmallVectorInsertShiftsTail) {
+    SmallVector<int, 4> vector;
+    vector.push_back(1);
+    vector.push_back(3);
+    vector.insert(vector.begin() + 1, 2);
+    vector.insert(vector.begin(), 0);
+    vector.insert(vector.end(), 4);
+
+    BOOST_REQUIRE_EQUAL(5u, vector.size());
+    for (int i = 0; i < 5; ++i)
+    {
+        BOOST_CHECK_EQUAL(i, vector[i]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,217 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace swganh {
+
+/*! \brief A vector that stores up to N elements inline and only touches the
+ * heap once it grows past that.
+ *
+ * Meant for small per-object collections (observers, aware objects) where the
+ * common case holds a handful of entries and a node based container would pay
+ * one allocation per entry. Iterators are plain pointers and are invalidated
+ * by any insertion or removal.
+ */
+template<typename T, size_t N>
+class SmallVector {
+public:
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+
+    SmallVector()
+        : data_(inline_data())
+        , size_(0)
+        , capacity_(N)
+    {}
+
+    SmallVector(const SmallVector& other)
+        : data_(inline_data())
+        , size_(0)
+        , capacity_(N)
+    {
+        reserve(other.size_);
+        std::uninitialized_copy(other.begin(), other.end(), data_);
+        size_ = other.size_;
+    }
+
+    SmallVector(SmallVector&& other)
+        : data_(inline_data())
+        , size_(0)
+        , capacity_(N)
+    {
+        move_from(std::move(other));
+    }
+
+    ~SmallVector()
+    {
+        clear();
+        release();
+    }
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other)
+        {
+            SmallVector tmp(other);
+            clear();
+            move_from(std::move(tmp));
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            move_from(std::move(other));
+        }
+        return *this;
+    }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+
+    bool empty() const { return size_ == 0; }
+    size_type size() const { return size_; }
+    size_type capacity() const { return capacity_; }
+
+    /// @return True while the elements still live in the inline buffer.
+    bool is_inline() const { return data_ == inline_data(); }
+
+    reference operator[](size_type index) { return data_[index]; }
+    const_reference operator[](size_type index) const { return data_[index]; }
+
+    void clear()
+    {
+        for (size_type i = 0; i < size_; ++i)
+        {
+            data_[i].~T();
+        }
+        size_ = 0;
+    }
+
+    void reserve(size_type count)
+    {
+        if (count <= capacity_)
+        {
+            return;
+        }
+
+        T* new_data = static_cast<T*>(::operator new(count * sizeof(T)));
+        for (size_type i = 0; i < size_; ++i)
+        {
+            new (new_data + i) T(std::move(data_[i]));
+            data_[i].~T();
+        }
+
+        release();
+        data_ = new_data;
+        capacity_ = count;
+    }
+
+    void push_back(T value)
+    {
+        grow_for_one();
+        new (data_ + size_) T(std::move(value));
+        ++size_;
+    }
+
+    iterator insert(iterator pos, T value)
+    {
+        size_type index = pos - data_;
+        grow_for_one();
+
+        if (index == size_)
+        {
+            new (data_ + size_) T(std::move(value));
+        }
+        else
+        {
+            // shift the tail up by one, then assign into the gap
+            new (data_ + size_) T(std::move(data_[size_ - 1]));
+            std::move_backward(data_ + index, data_ + size_ - 1, data_ + size_);
+            data_[index] = std::move(value);
+        }
+
+        ++size_;
+        return data_ + index;
+    }
+
+    iterator erase(iterator pos)
+    {
+        std::move(pos + 1, end(), pos);
+        --size_;
+        data_[size_].~T();
+        return pos;
+    }
+
+private:
+    T* inline_data() { return reinterpret_cast<T*>(&inline_storage_); }
+    const T* inline_data() const { return reinterpret_cast<const T*>(&inline_storage_); }
+
+    void grow_for_one()
+    {
+        if (size_ == capacity_)
+        {
+            reserve(capacity_ * 2);
+        }
+    }
+
+    void release()
+    {
+        if (!is_inline())
+        {
+            ::operator delete(data_);
+            data_ = inline_data();
+            capacity_ = N;
+        }
+    }
+
+    // expects this to be empty
+    void move_from(SmallVector&& other)
+    {
+        if (other.is_inline())
+        {
+            for (size_type i = 0; i < other.size_; ++i)
+            {
+                new (data_ + i) T(std::move(other.data_[i]));
+            }
+            size_ = other.size_;
+            other.clear();
+        }
+        else
+        {
+            release();
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+
+            other.data_ = other.inline_data();
+            other.size_ = 0;
+            other.capacity_ = N;
+        }
+    }
+
+    T* data_;
+    size_type size_;
+    size_type capacity_;
+    typename std::aligned_storage<sizeof(T) * N, std::alignment_of<T>::value>::type inline_storage_;
+};
+
+}  // namespace swganh
@@ -0,0 +1,56 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "string_interner.h"
+
+#include <boost/thread/locks.hpp>
+
+#include "crc.h"
+
+using namespace swganh;
+
+StringInterner& StringInterner::getInstance()
+{
+    static StringInterner instance;
+    return instance;
+}
+
+uint32_t StringInterner::Hash(const std::string& value)
+{
+    return memcrc(value);
+}
+
+uint32_t StringInterner::Intern(const std::string& value)
+{
+    uint32_t ident = Hash(value);
+
+    {
+        boost::shared_lock<boost::shared_mutex> lock(mutex_);
+        if (strings_.find(ident) != strings_.end())
+        {
+            return ident;
+        }
+    }
+
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    strings_.insert(std::make_pair(ident, value));
+
+    return ident;
+}
+
+const std::string& StringInterner::Lookup(uint32_t ident) const
+{
+    static const std::string empty_string;
+
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    auto find_iter = strings_.find(ident);
+
+    // unordered_map nodes are never relocated, so the reference stays valid
+    return (find_iter != strings_.end()) ? find_iter->second : empty_string;
+}
+
+size_t StringInterner::Size() const
+{
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    return strings_.size();
+}
@@ -0,0 +1,46 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include <boost/thread/shared_mutex.hpp>
+
+namespace swganh {
+
+/*! \brief Process wide table that maps strings to the same 32bit identifier
+ * HashString generates, and keeps a single shared copy of each string.
+ *
+ * Hot containers store only the identifier and can recover the original text
+ * with Lookup when it is needed (eg. for persistence or display).
+ */
+class StringInterner
+{
+public:
+    static StringInterner& getInstance();
+
+    /// Returns the identifier for a string without registering it.
+    static uint32_t Hash(const std::string& value);
+
+    /// Registers the string (if needed) and returns its identifier.
+    uint32_t Intern(const std::string& value);
+
+    /// Returns the string registered for an identifier, or an empty string if unknown.
+    const std::string& Lookup(uint32_t ident) const;
+
+    /// Returns the number of distinct strings registered.
+    size_t Size() const;
+
+private:
+    StringInterner() {}
+    StringInterner(const StringInterner&);
+    StringInterner& operator=(const StringInterner&);
+
+    mutable boost::shared_mutex mutex_;
+    std::unordered_map<uint32_t, std::string> strings_;
+};
+
+}  // namespace swganh
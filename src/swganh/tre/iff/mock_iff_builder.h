@@ -0,0 +1,71 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace swganh {
+namespace tre {
+
+    /**
+     * Builds iff files for tests. Values are appended to the current node until
+     * Node wraps them up, sizes are stored big endian.
+     */
+    class MockIffBuilder
+    {
+    public:
+        /// Appends a null terminated string.
+        MockIffBuilder& Text(const std::string& text)
+        {
+            data_.insert(data_.end(), text.begin(), text.end());
+            data_.push_back('\0');
+            return *this;
+        }
+
+        MockIffBuilder& Byte(char value)
+        {
+            data_.push_back(value);
+            return *this;
+        }
+
+        template<typename T>
+        MockIffBuilder& Value(T value)
+        {
+            const char* bytes = reinterpret_cast<const char*>(&value);
+            data_.insert(data_.end(), bytes, bytes + sizeof(value));
+            return *this;
+        }
+
+        /// Wraps everything appended since the last node into a node.
+        MockIffBuilder& Node(const std::string& name)
+        {
+            std::vector<char> node(name.begin(), name.end());
+            uint32_t size = static_cast<uint32_t>(data_.size());
+            for (int shift = 24; shift >= 0; shift -= 8)
+            {
+                node.push_back(static_cast<char>((size >> shift) & 0xff));
+            }
+            node.insert(node.end(), data_.begin(), data_.end());
+
+            nodes_.insert(nodes_.end(), node.begin(), node.end());
+            data_.clear();
+            return *this;
+        }
+
+        /// @return All nodes inside a FORM.
+        std::vector<char> Form()
+        {
+            data_ = std::move(nodes_);
+            nodes_.clear();
+            Node("FORM");
+            return std::move(nodes_);
+        }
+
+    private:
+        std::vector<char> data_;
+        std::vector<char> nodes_;
+    };
+
+}}  // namespace swganh::tre
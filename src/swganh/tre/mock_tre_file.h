@@ -0,0 +1,113 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <zlib.h>
+
+#include "swganh/tre/tre_data.h"
+
+namespace swganh {
+namespace tre {
+
+    /**
+     * Writes small .tre files for tests, removed again when it goes out of scope.
+     */
+    class MockTreFile
+    {
+    public:
+        MockTreFile()
+            : path_((boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%-%%%%.tre")).string())
+        {}
+
+        ~MockTreFile()
+        {
+            boost::system::error_code error;
+            boost::filesystem::remove(path_, error);
+        }
+
+        /// Adds a resource, compressed entries are stored zlib deflated.
+        void AddResource(std::string name, std::vector<char> data, bool compressed = false)
+        {
+            Entry entry;
+            entry.name = std::move(name);
+            entry.data = std::move(data);
+            entry.compressed = compressed;
+            entries_.push_back(std::move(entry));
+        }
+
+        /// Writes the file and returns its path.
+        const std::string& Write()
+        {
+            std::vector<char> data_block;
+            std::vector<char> name_block;
+            std::vector<TreResourceInfo> infos;
+
+            for (auto& entry : entries_)
+            {
+                TreResourceInfo info = TreResourceInfo();
+                info.data_size = static_cast<uint32_t>(entry.data.size());
+                info.data_offset = static_cast<uint32_t>(sizeof(TreHeader) + data_block.size());
+                info.name_offset = static_cast<uint32_t>(name_block.size());
+
+                std::vector<char> stored = entry.data;
+                if (entry.compressed)
+                {
+                    uLongf compressed_size = compressBound(static_cast<uLong>(entry.data.size()));
+                    stored.resize(compressed_size);
+                    compress(reinterpret_cast<Bytef*>(&stored[0]), &compressed_size,
+                        reinterpret_cast<const Bytef*>(entry.data.data()), static_cast<uLong>(entry.data.size()));
+                    stored.resize(compressed_size);
+                    info.data_compression = 2;
+                }
+                info.data_compressed_size = static_cast<uint32_t>(stored.size());
+
+                data_block.insert(data_block.end(), stored.begin(), stored.end());
+                name_block.insert(name_block.end(), entry.name.begin(), entry.name.end());
+                name_block.push_back('\0');
+                infos.push_back(info);
+            }
+
+            TreHeader header = TreHeader();
+            std::memcpy(header.file_type, "EERT", 4);
+            std::memcpy(header.file_version, "5000", 4);
+            header.resource_count = static_cast<uint32_t>(infos.size());
+            header.info_offset = static_cast<uint32_t>(sizeof(TreHeader) + data_block.size());
+            header.info_compressed_size = static_cast<uint32_t>(infos.size() * sizeof(TreResourceInfo));
+            header.name_compressed_size = static_cast<uint32_t>(name_block.size());
+            header.name_uncompressed_size = static_cast<uint32_t>(name_block.size());
+
+            std::ofstream file(path_.c_str(), std::ios_base::binary | std::ios_base::trunc);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(data_block.data(), data_block.size());
+            file.write(reinterpret_cast<const char*>(infos.data()), infos.size() * sizeof(TreResourceInfo));
+            file.write(name_block.data(), name_block.size());
+
+            return path_;
+        }
+
+        const std::string& GetPath() const
+        {
+            return path_;
+        }
+
+    private:
+        struct Entry
+        {
+            std::string name;
+            std::vector<char> data;
+            bool compressed;
+        };
+
+        std::string path_;
+        std::vector<Entry> entries_;
+    };
+
+}}  // namespace swganh::tre
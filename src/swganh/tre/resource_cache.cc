@@ -0,0 +1,238 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "resource_cache.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/locks.hpp>
+
+using namespace swganh::tre;
+
+ResourceCache::ResourceCache(uint64_t byte_budget, uint32_t shard_count)
+    : byte_budget_(byte_budget)
+    , use_clock_(0)
+    , cached_bytes_(0)
+{
+    shard_count = std::max<uint32_t>(shard_count, 1);
+
+    for (uint32_t i = 0; i < shard_count; ++i)
+    {
+        shards_.push_back(std::unique_ptr<Shard>(new Shard));
+    }
+}
+
+std::shared_ptr<VisitorInterface> ResourceCache::Get(const std::string& name, bool pinned, const Loader& loader)
+{
+    auto& shard = ShardFor_(name);
+
+    std::promise<std::shared_ptr<VisitorInterface>> load;
+    {
+        boost::unique_lock<boost::mutex> lock(shard.mutex);
+
+        auto visitor = Lookup_(shard, name);
+        if (visitor)
+        {
+            ++shard.hits;
+            return visitor;
+        }
+
+        auto loading = shard.loading.find(name);
+        if (loading != shard.loading.end())
+        {
+            ++shard.shared_loads;
+            PendingLoad pending = loading->second;
+            lock.unlock();
+
+            return pending.get();
+        }
+
+        ++shard.misses;
+        shard.loading.insert(std::make_pair(name, load.get_future().share()));
+    }
+
+    CachedResource resource;
+    try
+    {
+        resource = loader();
+    }
+    catch (...)
+    {
+        {
+            boost::lock_guard<boost::mutex> lock(shard.mutex);
+            shard.loading.erase(name);
+        }
+
+        load.set_exception(std::current_exception());
+        throw;
+    }
+
+    {
+        boost::lock_guard<boost::mutex> lock(shard.mutex);
+        shard.loading.erase(name);
+        Insert_(shard, name, resource, pinned);
+    }
+
+    EvictToBudget_();
+
+    load.set_value(resource.visitor);
+    return resource.visitor;
+}
+
+void ResourceCache::Insert(const std::string& name, CachedResource resource, bool pinned)
+{
+    auto& shard = ShardFor_(name);
+
+    {
+        boost::lock_guard<boost::mutex> lock(shard.mutex);
+        Insert_(shard, name, std::move(resource), pinned);
+    }
+
+    EvictToBudget_();
+}
+
+std::shared_ptr<VisitorInterface> ResourceCache::Find(const std::string& name)
+{
+    auto& shard = ShardFor_(name);
+
+    boost::lock_guard<boost::mutex> lock(shard.mutex);
+    auto visitor = Lookup_(shard, name);
+    if (visitor)
+    {
+        ++shard.hits;
+    }
+
+    return visitor;
+}
+
+ResourceCacheStatistics ResourceCache::GetStatistics() const
+{
+    ResourceCacheStatistics statistics = ResourceCacheStatistics();
+
+    for (auto& shard : shards_)
+    {
+        boost::lock_guard<boost::mutex> lock(shard->mutex);
+        statistics.hits += shard->hits;
+        statistics.misses += shard->misses;
+        statistics.shared_loads += shard->shared_loads;
+        statistics.evictions += shard->evictions;
+        statistics.entries += shard->entries.size() + shard->pinned.size();
+        statistics.cached_bytes += shard->bytes;
+        statistics.pinned_bytes += shard->pinned_bytes;
+    }
+
+    return statistics;
+}
+
+ResourceCache::Shard& ResourceCache::ShardFor_(const std::string& name)
+{
+    return *shards_[std::hash<std::string>()(name) % shards_.size()];
+}
+
+std::shared_ptr<VisitorInterface> ResourceCache::Lookup_(Shard& shard, const std::string& name)
+{
+    auto pinned = shard.pinned.find(name);
+    if (pinned != shard.pinned.end())
+    {
+        return pinned->second.visitor;
+    }
+
+    auto entry = shard.entries.find(name);
+    if (entry == shard.entries.end())
+    {
+        return nullptr;
+    }
+
+    shard.lru.splice(shard.lru.begin(), shard.lru, entry->second);
+    entry->second->last_used = ++use_clock_;
+    return entry->second->resource.visitor;
+}
+
+void ResourceCache::Insert_(Shard& shard, const std::string& name, CachedResource resource, bool pinned)
+{
+    Erase_(shard, name);
+
+    if (pinned)
+    {
+        shard.pinned_bytes += resource.size;
+        shard.pinned.insert(std::make_pair(name, std::move(resource)));
+        return;
+    }
+
+    // a resource larger than the whole budget is handed out but not kept
+    if (byte_budget_ && resource.size > byte_budget_)
+    {
+        ++shard.evictions;
+        return;
+    }
+
+    shard.bytes += resource.size;
+    cached_bytes_ += resource.size;
+    Entry entry = {name, std::move(resource), ++use_clock_};
+    shard.lru.push_front(std::move(entry));
+    shard.entries.insert(std::make_pair(name, shard.lru.begin()));
+}
+
+void ResourceCache::Erase_(Shard& shard, const std::string& name)
+{
+    auto pinned = shard.pinned.find(name);
+    if (pinned != shard.pinned.end())
+    {
+        shard.pinned_bytes -= pinned->second.size;
+        shard.pinned.erase(pinned);
+    }
+
+    auto entry = shard.entries.find(name);
+    if (entry != shard.entries.end())
+    {
+        shard.bytes -= entry->second->resource.size;
+        cached_bytes_ -= entry->second->resource.size;
+        shard.lru.erase(entry->second);
+        shard.entries.erase(entry);
+    }
+}
+
+void ResourceCache::EvictToBudget_()
+{
+    if (!byte_budget_ || cached_bytes_ <= byte_budget_)
+    {
+        return;
+    }
+
+    boost::lock_guard<boost::mutex> eviction_lock(eviction_mutex_);
+
+    while (cached_bytes_ > byte_budget_)
+    {
+        // the shard whose least recently used entry is the oldest of all
+        Shard* oldest_shard = nullptr;
+        uint64_t oldest_use = std::numeric_limits<uint64_t>::max();
+        for (auto& shard : shards_)
+        {
+            boost::lock_guard<boost::mutex> lock(shard->mutex);
+            if (!shard->lru.empty() && shard->lru.back().last_used < oldest_use)
+            {
+                oldest_shard = shard.get();
+                oldest_use = shard->lru.back().last_used;
+            }
+        }
+
+        if (!oldest_shard)
+        {
+            return;
+        }
+
+        // a lookup may have touched it since, then its next oldest entry goes
+        boost::lock_guard<boost::mutex> lock(oldest_shard->mutex);
+        if (!oldest_shard->lru.empty())
+        {
+            auto& oldest = oldest_shard->lru.back();
+            oldest_shard->bytes -= oldest.resource.size;
+            cached_bytes_ -= oldest.resource.size;
+            oldest_shard->entries.erase(oldest.name);
+            oldest_shard->lru.pop_back();
+            ++oldest_shard->evictions;
+        }
+    }
+}
@@ -0,0 +1,137 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "visitors/visitor_interface.h"
+
+namespace swganh {
+namespace tre {
+
+    struct ResourceCacheStatistics
+    {
+        uint64_t hits;
+        uint64_t misses;           ///< lookups that started a load
+        uint64_t shared_loads;     ///< lookups that waited on a load already in flight
+        uint64_t evictions;
+        uint64_t entries;          ///< including pinned entries
+        uint64_t cached_bytes;     ///< charged against the budget
+        uint64_t pinned_bytes;     ///< never evicted, not charged against the budget
+    };
+
+    /// A parsed resource and the bytes it is charged with.
+    struct CachedResource
+    {
+        std::shared_ptr<VisitorInterface> visitor;
+        uint64_t size;
+    };
+
+    /**
+     * Size bounded cache of parsed resources.
+     *
+     * Names are spread over shards that are locked independently. The budget
+     * holds for the cache as a whole: once it is exceeded the least recently
+     * used entry of all shards is evicted, so one large resource may take most
+     * of it. Pinned entries are kept until the cache is destroyed.
+     *
+     * A lookup that misses loads the resource without holding the shard lock.
+     * Concurrent lookups of a name that is being loaded wait for that load
+     * instead of starting their own.
+     */
+    class ResourceCache : private boost::noncopyable
+    {
+    public:
+        typedef std::function<CachedResource ()> Loader;
+
+        /**
+         * @param byte_budget Bytes of unpinned resources to keep, 0 for no limit.
+         * @param shard_count Number of independently locked shards.
+         */
+        explicit ResourceCache(uint64_t byte_budget, uint32_t shard_count = 16);
+
+        /**
+         * Returns the cached resource or loads it, exceptions thrown by the loader
+         * are passed on to every caller waiting for the load.
+         *
+         * @param name The name of the resource.
+         * @param pinned Keep the resource once loaded, regardless of the budget.
+         * @param loader Called to load the resource if it is not cached.
+         */
+        std::shared_ptr<VisitorInterface> Get(const std::string& name, bool pinned, const Loader& loader);
+
+        /**
+         * Adds a resource that was loaded elsewhere, replacing any cached version.
+         */
+        void Insert(const std::string& name, CachedResource resource, bool pinned);
+
+        /**
+         * @return The cached resource, or nullptr. Does not wait for loads in flight.
+         */
+        std::shared_ptr<VisitorInterface> Find(const std::string& name);
+
+        ResourceCacheStatistics GetStatistics() const;
+
+    private:
+        struct Entry
+        {
+            std::string name;
+            CachedResource resource;
+            uint64_t last_used;     // use_clock_ at the last lookup
+        };
+
+        typedef std::list<Entry> LruList;
+        typedef std::shared_future<std::shared_ptr<VisitorInterface>> PendingLoad;
+
+        struct Shard
+        {
+            Shard() : bytes(0), pinned_bytes(0), hits(0), misses(0), shared_loads(0), evictions(0) {}
+
+            mutable boost::mutex mutex;
+            LruList lru;    // most recently used first
+            std::unordered_map<std::string, LruList::iterator> entries;
+            std::unordered_map<std::string, CachedResource> pinned;
+            std::unordered_map<std::string, PendingLoad> loading;
+            uint64_t bytes;
+            uint64_t pinned_bytes;
+            uint64_t hits;
+            uint64_t misses;
+            uint64_t shared_loads;
+            uint64_t evictions;
+        };
+
+        Shard& ShardFor_(const std::string& name);
+
+        /// @return The cached visitor, the shard must be locked.
+        std::shared_ptr<VisitorInterface> Lookup_(Shard& shard, const std::string& name);
+
+        /// Stores the resource, the shard must be locked.
+        void Insert_(Shard& shard, const std::string& name, CachedResource resource, bool pinned);
+
+        void Erase_(Shard& shard, const std::string& name);
+
+        /// Evicts down to the budget, no shard may be locked by the caller.
+        void EvictToBudget_();
+
+        std::vector<std::unique_ptr<Shard>> shards_;
+        uint64_t byte_budget_;
+
+        std::atomic<uint64_t> use_clock_;
+        std::atomic<uint64_t> cached_bytes_;   // bytes of every shard
+
+        // one eviction at a time, taken before a shard lock
+        boost::mutex eviction_mutex_;
+    };
+
+}}  // namespace swganh::tre
@@ -0,0 +1,140 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include "swganh/tre/resource_cache.h"
+
+using namespace swganh::tre;
+
+namespace {
+
+    class NullVisitor : public VisitorInterface
+    {
+    public:
+        virtual void visit_data(uint32_t depth, std::string name, uint32_t size, swganh::ByteBuffer& data) {}
+        virtual void visit_folder(uint32_t depth, std::string name, uint32_t size) {}
+    };
+
+    /// Loader that hands out a new visitor of the given size and counts its calls.
+    struct CountingLoader
+    {
+        CountingLoader() : loads(0) {}
+
+        ResourceCache::Loader Get(uint64_t size)
+        {
+            return [this, size] () -> CachedResource {
+                ++loads;
+                CachedResource resource = {std::make_shared<NullVisitor>(), size};
+                return resource;
+            };
+        }
+
+        int loads;
+    };
+
+}
+
+BOOST_AUTO_TEST_SUITE(ResourceCacheTest)
+
+/// This test shows that the least recently used entries are evicted first once
+/// the budget is exceeded.
+BOOST_AUTO_TEST_CASE(LeastRecentlyUsedIsEvictedFirst) {
+    ResourceCache cache(300, 1);
+    CountingLoader loader;
+
+    auto first = cache.Get("first", false, loader.Get(100));
+    cache.Get("second", false, loader.Get(100));
+    cache.Get("third", false, loader.Get(100));
+
+    // touching first makes second the oldest entry
+    BOOST_CHECK(first == cache.Get("first", false, loader.Get(100)));
+    cache.Get("fourth", false, loader.Get(100));
+
+    BOOST_CHECK(cache.Find("second") == nullptr);
+
+    // third is now the oldest, lookups that miss do not change the order
+    cache.Get("fifth", false, loader.Get(100));
+    BOOST_CHECK(cache.Find("third") == nullptr);
+    BOOST_CHECK(cache.Find("first") == first);
+    BOOST_CHECK(cache.Find("fourth") != nullptr);
+    BOOST_CHECK(cache.Find("fifth") != nullptr);
+
+    auto statistics = cache.GetStatistics();
+    BOOST_CHECK_EQUAL(5u, loader.loads);
+    BOOST_CHECK_EQUAL(5u, statistics.misses);
+    BOOST_CHECK_EQUAL(2u, statistics.evictions);
+    BOOST_CHECK_EQUAL(3u, statistics.entries);
+    BOOST_CHECK_EQUAL(300u, statistics.cached_bytes);
+}
+
+/// This test shows that the budget holds for the cache as a whole: a resource
+/// larger than a shard's share of it is kept, and the least recently used
+/// entries of all shards are evicted first.
+BOOST_AUTO_TEST_CASE(BudgetIsSharedByAllShards) {
+    ResourceCache cache(1000, 16);
+    CountingLoader loader;
+
+    auto large = cache.Get("large", false, loader.Get(500));
+    BOOST_CHECK(cache.Find("large") == large);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        cache.Get("small" + std::to_string(i), false, loader.Get(100));
+    }
+
+    // large was used first, so it went first and made room for the rest
+    BOOST_CHECK(cache.Find("large") == nullptr);
+    for (int i = 0; i < 10; ++i)
+    {
+        BOOST_CHECK(cache.Find("small" + std::to_string(i)) != nullptr);
+    }
+
+    // a resource larger than the whole budget is handed out but not kept
+    BOOST_CHECK(cache.Get("huge", false, loader.Get(2000)) != nullptr);
+    BOOST_CHECK(cache.Find("huge") == nullptr);
+
+    auto statistics = cache.GetStatistics();
+    BOOST_CHECK_EQUAL(1000u, statistics.cached_bytes);
+    BOOST_CHECK_EQUAL(10u, statistics.entries);
+    BOOST_CHECK_EQUAL(2u, statistics.evictions);
+}
+
+/// This test shows that pinned entries are kept and not charged against the budget.
+BOOST_AUTO_TEST_CASE(PinnedEntriesAreNeverEvicted) {
+    ResourceCache cache(200, 1);
+    CountingLoader loader;
+
+    auto terrain = cache.Get("terrain/tatooine.trn", true, loader.Get(1000));
+    cache.Get("first", false, loader.Get(100));
+    cache.Get("second", false, loader.Get(100));
+    cache.Get("third", false, loader.Get(100));
+
+    BOOST_CHECK(cache.Get("terrain/tatooine.trn", true, loader.Get(1000)) == terrain);
+    BOOST_CHECK(cache.Find("first") == nullptr);
+
+    auto statistics = cache.GetStatistics();
+    BOOST_CHECK_EQUAL(4u, loader.loads);
+    BOOST_CHECK_EQUAL(1000u, statistics.pinned_bytes);
+    BOOST_CHECK_EQUAL(200u, statistics.cached_bytes);
+    BOOST_CHECK_EQUAL(1u, statistics.evictions);
+}
+
+/// This test shows that a failed load is reported and retried by the next lookup.
+BOOST_AUTO_TEST_CASE(FailedLoadsAreNotCached) {
+    ResourceCache cache(0);
+    CountingLoader loader;
+
+    BOOST_CHECK_THROW(cache.Get("missing", false, [] () -> CachedResource {
+        throw std::runtime_error("Requested unknown resource missing");
+    }), std::runtime_error);
+
+    BOOST_CHECK(cache.Get("missing", false, loader.Get(10)) != nullptr);
+    BOOST_CHECK_EQUAL(1u, loader.loads);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,222 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "resource_extractor.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "swganh/byte_buffer.h"
+
+#include "tre_archive.h"
+
+using namespace swganh::tre;
+
+namespace {
+
+    void WriteResource(const std::string& output_directory, const std::string& resource_name, const swganh::ByteBuffer& data)
+    {
+        auto path = boost::filesystem::path(output_directory) / resource_name;
+        boost::filesystem::create_directories(path.parent_path());
+
+        std::ofstream file(path.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (data.size() > 0)
+        {
+            file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        }
+
+        if (!file)
+        {
+            throw std::runtime_error("Unable to write " + path.string());
+        }
+    }
+
+    /**
+     * Resources read by the workers, waiting to be written in order. Workers
+     * only claim resources within queue_capacity of the next one to be written.
+     */
+    struct ExtractionQueue
+    {
+        ExtractionQueue(size_t total, size_t capacity)
+            : total(total), capacity(capacity), next_claim(0), next_write(0), stopped(false)
+        {}
+
+        /// @return False once there is nothing left to claim.
+        bool Claim(size_t& index)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] () {
+                return stopped || next_claim >= total || next_claim < next_write + capacity;
+            });
+
+            if (stopped || next_claim >= total)
+            {
+                return false;
+            }
+
+            index = next_claim++;
+            return true;
+        }
+
+        void Finish(size_t index, swganh::ByteBuffer data)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.insert(std::make_pair(index, std::move(data)));
+            }
+            condition.notify_all();
+        }
+
+        /// @return False if the extraction was stopped before the next resource was read.
+        bool TakeNext(swganh::ByteBuffer& data)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] () {
+                return stopped || finished.count(next_write) != 0;
+            });
+
+            if (stopped)
+            {
+                return false;
+            }
+
+            auto it = finished.find(next_write);
+            data = std::move(it->second);
+            finished.erase(it);
+            return true;
+        }
+
+        void Written()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++next_write;
+            }
+            condition.notify_all();
+        }
+
+        void Stop(std::exception_ptr failure)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                {
+                    error = failure;
+                }
+                stopped = true;
+            }
+            condition.notify_all();
+        }
+
+        const size_t total;
+        const size_t capacity;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::map<size_t, swganh::ByteBuffer> finished;
+        size_t next_claim;
+        size_t next_write;
+        bool stopped;
+        std::exception_ptr error;
+    };
+
+}
+
+ResourceExtractor::ResourceExtractor(TreArchive& archive, std::string output_directory, uint32_t jobs, uint32_t queue_capacity)
+    : archive_(archive)
+    , output_directory_(std::move(output_directory))
+    , jobs_(std::max<uint32_t>(jobs, 1))
+    , queue_capacity_(std::max<uint32_t>(queue_capacity, 1))
+{}
+
+ExtractionStatistics ResourceExtractor::Extract(const ProgressCallback& progress_callback)
+{
+    auto resources = archive_.GetAvailableResources();
+
+    ExtractionStatistics statistics = ExtractionStatistics();
+
+    auto written = [&] (const std::string& resource_name, const swganh::ByteBuffer& data) {
+        WriteResource(output_directory_, resource_name, data);
+
+        ++statistics.resources;
+        statistics.bytes += data.size();
+
+        if (progress_callback)
+        {
+            progress_callback(resources.size(), statistics.resources);
+        }
+    };
+
+    if (jobs_ == 1)
+    {
+        for (auto& resource_name : resources)
+        {
+            written(resource_name, archive_.GetResource(resource_name));
+        }
+
+        return statistics;
+    }
+
+    ExtractionQueue queue(resources.size(), queue_capacity_);
+
+    std::vector<std::thread> workers;
+    for (uint32_t i = 0; i < std::min<size_t>(jobs_, resources.size()); ++i)
+    {
+        workers.push_back(std::thread([this, &queue, &resources] () {
+            size_t index;
+            while (queue.Claim(index))
+            {
+                try
+                {
+                    swganh::ByteBuffer data;
+                    archive_.GetResource(resources[index], data);
+                    queue.Finish(index, std::move(data));
+                }
+                catch (...)
+                {
+                    queue.Stop(std::current_exception());
+                }
+            }
+        }));
+    }
+
+    try
+    {
+        swganh::ByteBuffer data;
+        for (auto& resource_name : resources)
+        {
+            if (!queue.TakeNext(data))
+            {
+                break;
+            }
+
+            written(resource_name, data);
+            queue.Written();
+        }
+    }
+    catch (...)
+    {
+        queue.Stop(std::current_exception());
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    if (queue.error)
+    {
+        std::rethrow_exception(queue.error);
+    }
+
+    return statistics;
+}
@@ -0,0 +1,59 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include <boost/noncopyable.hpp>
+
+namespace swganh {
+namespace tre {
+
+    class TreArchive;
+
+    struct ExtractionStatistics
+    {
+        uint64_t resources;
+        uint64_t bytes;     ///< uncompressed bytes written
+    };
+
+    /**
+     * Writes every resource of an archive to a directory tree, one file per
+     * resource named after the resource.
+     *
+     * With more than one job the resources are split over worker threads that
+     * read and inflate them into their own buffers, the files are written in
+     * order by the calling thread from a bounded queue. The output is identical
+     * for any number of jobs.
+     */
+    class ResourceExtractor : private boost::noncopyable
+    {
+    public:
+        typedef std::function<void (uint64_t total, uint64_t completed)> ProgressCallback;
+
+        /**
+         * @param archive The archive to extract, must outlive the extractor.
+         * @param output_directory Root of the tree, created if missing.
+         * @param jobs Number of worker threads, 0 or 1 reads on the calling thread.
+         * @param queue_capacity Resources read ahead of the writer at most.
+         */
+        ResourceExtractor(TreArchive& archive, std::string output_directory, uint32_t jobs = 1, uint32_t queue_capacity = 64);
+
+        /**
+         * Extracts every resource, the first error stops the extraction and is
+         * rethrown.
+         *
+         * @param progress_callback Called after every file that was written, may be empty.
+         */
+        ExtractionStatistics Extract(const ProgressCallback& progress_callback = ProgressCallback());
+
+    private:
+        TreArchive& archive_;
+        std::string output_directory_;
+        uint32_t jobs_;
+        uint32_t queue_capacity_;
+    };
+
+}}  // namespace swganh::tre
@@ -0,0 +1,145 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "swganh/crc.h"
+#include "swganh/tre/mock_tre_file.h"
+#include "swganh/tre/resource_extractor.h"
+#include "swganh/tre/tre_archive.h"
+
+using namespace swganh::tre;
+
+namespace {
+
+    /// Output directory that is removed again when the test ends.
+    struct OutputDirectory
+    {
+        OutputDirectory()
+            : path((boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string())
+        {}
+
+        ~OutputDirectory()
+        {
+            boost::system::error_code error;
+            boost::filesystem::remove_all(path, error);
+        }
+
+        std::string path;
+    };
+
+    std::vector<char> MakeData(uint32_t seed, uint32_t size)
+    {
+        std::vector<char> data(size);
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            // compressible, but different for every resource
+            data[i] = static_cast<char>((seed * 31 + i / 7) & 0xff);
+        }
+        return data;
+    }
+
+    uint32_t Checksum(const std::vector<char>& data)
+    {
+        return swganh::memcrc(reinterpret_cast<const unsigned char*>(data.data()), static_cast<uint32_t>(data.size()), 0);
+    }
+
+    /// @return The checksum of every file in the tree, by path relative to the root.
+    std::map<std::string, uint32_t> ChecksumTree(const std::string& root)
+    {
+        std::map<std::string, uint32_t> checksums;
+
+        for (boost::filesystem::recursive_directory_iterator it(root), end; it != end; ++it)
+        {
+            if (!boost::filesystem::is_regular_file(it->path()))
+            {
+                continue;
+            }
+
+            std::ifstream file(it->path().string(), std::ios::binary);
+            std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+            auto relative = it->path().string().substr(root.size());
+            checksums[relative] = Checksum(data);
+        }
+
+        return checksums;
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ResourceExtractorTest)
+
+/// This test shows that extracting with several jobs writes the same files
+/// with the same contents as extracting on one thread.
+BOOST_AUTO_TEST_CASE(ParallelExtractionMatchesSingleThreaded) {
+    MockTreFile tre_file;
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        auto name = "appearance/mesh/set" + std::to_string(i % 7) + "/mesh_" + std::to_string(i) + ".msh";
+        tre_file.AddResource(name, MakeData(i, 100 + (i * 97) % 5000), i % 3 != 0);
+    }
+    tre_file.AddResource("datatables/empty.iff", std::vector<char>());
+    tre_file.Write();
+
+    std::vector<std::string> files;
+    files.push_back(tre_file.GetPath());
+    TreArchive archive(std::move(files));
+
+    OutputDirectory single_output, parallel_output;
+
+    auto single = ResourceExtractor(archive, single_output.path, 1).Extract();
+
+    uint64_t last_completed = 0;
+    auto parallel = ResourceExtractor(archive, parallel_output.path, 4, 3).Extract(
+        [&last_completed] (uint64_t total, uint64_t completed) {
+            BOOST_CHECK_EQUAL(201u, total);
+            BOOST_CHECK_EQUAL(last_completed + 1, completed);
+            last_completed = completed;
+        });
+
+    BOOST_CHECK_EQUAL(201u, single.resources);
+    BOOST_CHECK_EQUAL(single.resources, parallel.resources);
+    BOOST_CHECK_EQUAL(single.bytes, parallel.bytes);
+    BOOST_CHECK_EQUAL(201u, last_completed);
+
+    auto single_tree = ChecksumTree(single_output.path);
+    auto parallel_tree = ChecksumTree(parallel_output.path);
+    BOOST_CHECK_EQUAL(201u, single_tree.size());
+    BOOST_CHECK(single_tree == parallel_tree);
+
+    auto data = MakeData(5, 100 + (5 * 97) % 5000);
+    BOOST_CHECK_EQUAL(Checksum(data), single_tree["/appearance/mesh/set5/mesh_5.msh"]);
+}
+
+/// This test shows that a resource that can not be written stops the extraction
+/// and is reported to the caller.
+BOOST_AUTO_TEST_CASE(WriteErrorsStopTheExtraction) {
+    MockTreFile tre_file;
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        tre_file.AddResource("shader/shader_" + std::to_string(i) + ".sht", MakeData(i, 64), true);
+    }
+    tre_file.Write();
+
+    std::vector<std::string> files;
+    files.push_back(tre_file.GetPath());
+    TreArchive archive(std::move(files));
+
+    // a file where the shader directory would go
+    OutputDirectory output;
+    boost::filesystem::create_directories(output.path);
+    std::ofstream((boost::filesystem::path(output.path) / "shader").string()) << "in the way";
+
+    BOOST_CHECK_THROW(ResourceExtractor(archive, output.path, 4, 2).Extract(), std::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
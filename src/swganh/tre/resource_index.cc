@@ -0,0 +1,140 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "resource_index.h"
+
+#include <cstring>
+
+using namespace swganh::tre;
+
+namespace {
+
+    // Slots are kept at most half full so probe runs stay short.
+    const size_t kMinimumCapacity = 16;
+
+    size_t CapacityFor(size_t size)
+    {
+        size_t capacity = kMinimumCapacity;
+        while (capacity < size * 2)
+        {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+}
+
+ResourceIndex::ResourceIndex(size_t expected_size)
+    : size_(0)
+{
+    Slot empty = Slot();
+    slots_.assign(CapacityFor(expected_size), empty);
+}
+
+uint64_t ResourceIndex::HashPath(const char* path, size_t length)
+{
+    // 64 bit FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= static_cast<unsigned char>(path[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t ResourceIndex::HashPath(const std::string& path)
+{
+    return HashPath(path.data(), path.length());
+}
+
+void ResourceIndex::Insert(const char* name, ResourceLocation location)
+{
+    if ((size_ + 1) * 2 > slots_.size())
+    {
+        Rehash_(slots_.size() * 2);
+    }
+
+    size_t length = std::strlen(name);
+    uint64_t hash = HashPath(name, length);
+    size_t mask = slots_.size() - 1;
+
+    for (size_t i = SlotFor_(hash); ; i = (i + 1) & mask)
+    {
+        Slot& slot = slots_[i];
+        if (!slot.name)
+        {
+            slot.hash = hash;
+            slot.name = name;
+            slot.location = location;
+            ++size_;
+            return;
+        }
+
+        if (slot.hash == hash && std::strcmp(slot.name, name) == 0)
+        {
+            slot.location = location;
+            return;
+        }
+    }
+}
+
+const ResourceLocation* ResourceIndex::Find(const std::string& name) const
+{
+    return Find(HashPath(name), name.c_str(), name.length());
+}
+
+const ResourceLocation* ResourceIndex::Find(uint64_t hash, const char* name, size_t length) const
+{
+    size_t mask = slots_.size() - 1;
+
+    for (size_t i = SlotFor_(hash); ; i = (i + 1) & mask)
+    {
+        const Slot& slot = slots_[i];
+        if (!slot.name)
+        {
+            return nullptr;
+        }
+
+        if (slot.hash == hash && std::strncmp(slot.name, name, length) == 0 && slot.name[length] == '\0')
+        {
+            return &slot.location;
+        }
+    }
+}
+
+size_t ResourceIndex::Size() const
+{
+    return size_;
+}
+
+size_t ResourceIndex::SlotFor_(uint64_t hash) const
+{
+    // fold the high bits in, FNV's low bits alone cluster on similar paths
+    return static_cast<size_t>(hash ^ (hash >> 32)) & (slots_.size() - 1);
+}
+
+void ResourceIndex::Rehash_(size_t capacity)
+{
+    std::vector<Slot> old_slots;
+    old_slots.swap(slots_);
+
+    Slot empty = Slot();
+    slots_.assign(capacity, empty);
+
+    size_t mask = capacity - 1;
+    for (auto& old_slot : old_slots)
+    {
+        if (!old_slot.name)
+        {
+            continue;
+        }
+
+        size_t i = SlotFor_(old_slot.hash);
+        while (slots_[i].name)
+        {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = old_slot;
+    }
+}
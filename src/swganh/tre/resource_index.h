@@ -0,0 +1,73 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace swganh {
+namespace tre {
+
+    /**
+     * Where a resource lives, the reader within an archive and the entry within
+     * that reader's resource table.
+     */
+    struct ResourceLocation
+    {
+        uint32_t reader;
+        uint32_t entry;
+    };
+
+    /**
+     * Open addressing hash index from resource paths to their location.
+     *
+     * Slots are keyed by a 64 bit hash of the path computed once when the resource
+     * is inserted, a lookup hashes the requested path once, probes linearly and
+     * only compares names on a hash match. The index does not copy names, they
+     * must outlive it (they point into the readers' name blocks).
+     */
+    class ResourceIndex
+    {
+    public:
+        explicit ResourceIndex(size_t expected_size = 0);
+
+        /**
+         * @return The 64 bit hash the index is keyed by.
+         */
+        static uint64_t HashPath(const char* path, size_t length);
+        static uint64_t HashPath(const std::string& path);
+
+        /**
+         * Inserts a resource, replacing the location of an earlier resource with
+         * the same name. This is how later archives override earlier ones.
+         */
+        void Insert(const char* name, ResourceLocation location);
+
+        /**
+         * @return The location of the resource, or nullptr if it is not indexed.
+         */
+        const ResourceLocation* Find(const std::string& name) const;
+        const ResourceLocation* Find(uint64_t hash, const char* name, size_t length) const;
+
+        /**
+         * @return The number of distinct resources indexed.
+         */
+        size_t Size() const;
+
+    private:
+        struct Slot
+        {
+            uint64_t hash;
+            const char* name;  ///< nullptr marks an empty slot
+            ResourceLocation location;
+        };
+
+        size_t SlotFor_(uint64_t hash) const;
+        void Rehash_(size_t capacity);
+
+        std::vector<Slot> slots_;
+        size_t size_;
+    };
+
+}}  // namespace swganh::tre
@@ -6,21 +6,57 @@
 
 #include "iff/iff.h"
 
-#include "swganh/logger.h"
-
 using namespace swganh::tre;
 
-ResourceManager::ResourceManager(std::shared_ptr<TreArchive> archive) 
-	: archive_(archive)
+ResourceManager::ResourceManager(std::shared_ptr<TreArchive> archive, uint64_t cache_size, std::string visitor_cache_directory) 
+	: cache_(cache_size)
+	, archive_(archive)
 {
+	if(!visitor_cache_directory.empty())
+	{
+		visitor_cache_.reset(new VisitorCache(std::move(visitor_cache_directory)));
+	}
 }
 
 void ResourceManager::LoadResourceByName(const std::string& name, std::shared_ptr<VisitorInterface> type, bool is_cached) 
 {
-	iff_file::loadIFF(archive_->GetResource(name), type);
+	auto resource = Load_(name, type);
 	if(is_cached)
 	{
-		boost::lock_guard<boost::mutex> lock(resource_mutex_);
-		loadedResources_.insert(ResourceCache::value_type(name, type));
+		cache_.Insert(name, std::move(resource), false);
+	}
+}
+
+bool ResourceManager::IsPinned(VisitorType type)
+{
+	return type == TRN_VISITOR || type == SLOT_DEFINITION_VISITOR;
+}
+
+CachedResource ResourceManager::Load_(const std::string& name, std::shared_ptr<VisitorInterface> visitor)
+{
+	bool use_visitor_cache = visitor_cache_ && visitor->CacheVersion() != 0;
+	uint64_t version = use_visitor_cache ? archive_->GetResourceVersion(name) : 0;
+
+	uint64_t raw_size;
+	if(use_visitor_cache && visitor_cache_->Load(name, version, *visitor))
+	{
+		raw_size = archive_->GetResourceSize(name);
 	}
-}
\ No newline at end of file
+	else
+	{
+		auto data = archive_->GetResource(name);
+		raw_size = data.size();
+
+		iff_file::loadIFF(data, visitor);
+
+		if(use_visitor_cache)
+		{
+			visitor_cache_->Store(name, version, *visitor);
+		}
+	}
+
+	// visitors without an estimate are charged what they were parsed from
+	uint64_t size = visitor->Size();
+	CachedResource resource = {visitor, size ? size : raw_size};
+	return resource;
+}
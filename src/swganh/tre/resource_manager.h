@@ -2,51 +2,79 @@
 // See file LICENSE or go to http://swganh.com/LICENSE
 #pragma once
 
-#include <map>
+#include <cstdint>
+#include <memory>
+#include <string>
 
+#include "swganh/tre/resource_cache.h"
 #include "swganh/tre/tre_archive.h"
+#include "swganh/tre/visitor_cache.h"
 #include "visitors/visitor_interface.h"
 
 namespace swganh {
 namespace tre {
-	
-	typedef std::map<std::string, std::shared_ptr<swganh::tre::VisitorInterface>> ResourceCache;
 
+	/**
+	 * Loads resources from the archive and keeps the parsed visitors in a size
+	 * bounded cache. Terrain and slot definitions are pinned once loaded.
+	 *
+	 * With a visitor cache directory, visitors that support it are restored from
+	 * their cached state instead of being parsed, as long as the resource has not
+	 * changed since it was stored.
+	 */
 	class ResourceManager
 	{
 	public:
-		ResourceManager(std::shared_ptr<swganh::tre::TreArchive> archive);
+		/**
+		 * @param archive The archive resources are loaded from.
+		 * @param cache_size Bytes of parsed resources to keep, 0 for no limit.
+		 * @param visitor_cache_directory Where parsed visitors are stored, empty to always parse.
+		 */
+		ResourceManager(std::shared_ptr<swganh::tre::TreArchive> archive, uint64_t cache_size = 0,
+			std::string visitor_cache_directory = "");
 
 		void LoadResourceByName(const std::string& name, std::shared_ptr<VisitorInterface> visitor, bool is_cached=true);
 
 		template<class ValueType>
 		std::shared_ptr<ValueType> GetResourceByName(const std::string& name, bool is_cached=true)
 		{
+			if(name.size() == 0)
 			{
-				boost::lock_guard<boost::mutex> lock(resource_mutex_);
-				auto itr = loadedResources_.find(name);
-				if(itr != loadedResources_.end())
-				{
-					return std::static_pointer_cast<ValueType>(itr->second);
-				}
+				return nullptr;
 			}
 
-			if(name.size() != 0)
+			if(!is_cached)
 			{
 				std::shared_ptr<ValueType> visitor = std::make_shared<ValueType>();
-				LoadResourceByName(name, visitor, is_cached);
+				LoadResourceByName(name, visitor, false);
 				return visitor;
 			}
-			else
-			{
-				return nullptr;
-			}
+
+			return std::static_pointer_cast<ValueType>(cache_.Get(name, IsPinned(ValueType::Type), [this, &name] () {
+				return Load_(name, std::make_shared<ValueType>());
+			}));
 		}
 
+		std::shared_ptr<swganh::tre::TreArchive> GetArchive() const { return archive_; }
+
+		ResourceCacheStatistics GetCacheStatistics() const { return cache_.GetStatistics(); }
+
+		/**
+		 * @return The visitor cache, or nullptr if it is disabled.
+		 */
+		VisitorCache* GetVisitorCache() const { return visitor_cache_.get(); }
+
+		/**
+		 * @return True if resources parsed by this type of visitor are never evicted.
+		 */
+		static bool IsPinned(VisitorType type);
+
 	private:
-		boost::mutex resource_mutex_;
-		ResourceCache loadedResources_;
+		CachedResource Load_(const std::string& name, std::shared_ptr<VisitorInterface> visitor);
+
+		ResourceCache cache_;
 		std::shared_ptr<swganh::tre::TreArchive> archive_;
+		std::unique_ptr<VisitorCache> visitor_cache_;
 	};
 
 }
@@ -0,0 +1,112 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "swganh/byte_buffer.h"
+#include "swganh/tre/mock_tre_file.h"
+#include "swganh/tre/resource_manager.h"
+
+using namespace swganh::tre;
+
+namespace {
+
+    std::atomic<int> parse_count(0);
+
+    /// Counts how often a resource is parsed, and parses slowly.
+    class CountingVisitor : public VisitorInterface
+    {
+    public:
+        static const VisitorType Type = IFF_VISITOR;
+
+        virtual void visit_data(uint32_t depth, std::string name, uint32_t size, swganh::ByteBuffer& data) {}
+
+        virtual void visit_folder(uint32_t depth, std::string name, uint32_t size)
+        {
+            ++parse_count;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+
+        virtual uint64_t Size() const { return 100; }
+    };
+
+    /// A FORM holding a single data node.
+    std::vector<char> MakeIff()
+    {
+        const char data[] = {
+            'F', 'O', 'R', 'M', 0, 0, 0, 16,
+            'T', 'E', 'S', 'T', 'D', 'A', 'T', 'A', 0, 0, 0, 4,
+            1, 2, 3, 4
+        };
+        return std::vector<char>(data, data + sizeof(data));
+    }
+
+    std::shared_ptr<TreArchive> MakeArchive(MockTreFile& tre_file)
+    {
+        tre_file.AddResource("datatables/shared.iff", MakeIff());
+        tre_file.AddResource("datatables/other.iff", MakeIff());
+        tre_file.Write();
+
+        std::vector<std::string> files;
+        files.push_back(tre_file.GetPath());
+        return std::make_shared<TreArchive>(std::move(files));
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ResourceManagerTest)
+
+/// This test shows that concurrent requests for the same resource parse it only once.
+BOOST_AUTO_TEST_CASE(ConcurrentRequestsParseOnce) {
+    MockTreFile tre_file;
+    ResourceManager manager(MakeArchive(tre_file));
+    parse_count = 0;
+
+    std::vector<std::shared_ptr<CountingVisitor>> results(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        threads.push_back(std::thread([&manager, &results, i] () {
+            results[i] = manager.GetResourceByName<CountingVisitor>("datatables/shared.iff");
+        }));
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    BOOST_CHECK_EQUAL(1, parse_count);
+    for (auto& result : results)
+    {
+        BOOST_CHECK(result == results[0]);
+    }
+
+    auto statistics = manager.GetCacheStatistics();
+    BOOST_CHECK_EQUAL(1u, statistics.misses);
+    BOOST_CHECK_EQUAL(7u, statistics.hits + statistics.shared_loads);
+    BOOST_CHECK_EQUAL(100u, statistics.cached_bytes);
+}
+
+/// This test shows that uncached requests always parse a private copy.
+BOOST_AUTO_TEST_CASE(UncachedRequestsBypassTheCache) {
+    MockTreFile tre_file;
+    ResourceManager manager(MakeArchive(tre_file));
+    parse_count = 0;
+
+    auto first = manager.GetResourceByName<CountingVisitor>("datatables/other.iff", false);
+    auto second = manager.GetResourceByName<CountingVisitor>("datatables/other.iff", false);
+
+    BOOST_CHECK(first != second);
+    BOOST_CHECK_EQUAL(2, parse_count);
+    BOOST_CHECK_EQUAL(0u, manager.GetCacheStatistics().entries);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
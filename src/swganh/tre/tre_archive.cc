@@ -3,6 +3,8 @@
 
 #include "tre_archive.h"
 
+#include <boost/filesystem.hpp>
+
 #include "config_reader.h"
 #include "swganh/byte_buffer.h"
     
@@ -16,11 +18,14 @@ using std::vector;
 
 TreArchive::TreArchive(vector<std::unique_ptr<TreReader>>&& readers)
     : readers_(move(readers))
-{}
+{
+    BuildIndex();
+}
 
 TreArchive::TreArchive(vector<string>&& resource_files)
 {
     CreateReaders(resource_files);
+    BuildIndex();
 }
 
 TreArchive::~TreArchive()
@@ -33,6 +38,7 @@ TreArchive::TreArchive(string config_file)
     ConfigReader config_reader(config_file);
 
     CreateReaders(config_reader.GetTreFilenames());
+    BuildIndex();
 }
 
 bool TreArchive::Open()
@@ -42,37 +48,37 @@ bool TreArchive::Open()
 
 uint32_t TreArchive::GetResourceSize(const string& resource_name) const
 {
-    for (auto& reader : readers_)
-    {
-        if (reader->ContainsResource(resource_name))
-        {
-            return reader->GetResourceSize(resource_name);
-        }
-    }
-
-    throw runtime_error("Requested unknown resource " + resource_name);
+    auto& location = FindResource(resource_name);
+    return readers_[location.reader]->GetResourceInfo(location.entry).data_size;
 }
 
 swganh::ByteBuffer TreArchive::GetResource(const string& resource_name)
 {
-	auto find_itr = lookup_.find(resource_name.c_str());
-	if(find_itr != lookup_.end())
-	{
-		return readers_[find_itr->second]->GetResource(resource_name);
-	}
-
-    throw runtime_error("Requested unknown resource " + resource_name);
+    swganh::ByteBuffer buffer;
+    GetResource(resource_name, buffer);
+    return buffer;
 }
 
 void TreArchive::GetResource(const std::string& resource_name, swganh::ByteBuffer& buffer)
 {
-	auto find_itr = lookup_.find(resource_name.c_str());
-	if(find_itr != lookup_.end())
-	{
-		return readers_[find_itr->second]->GetResource(resource_name, buffer);
-	}
+    auto& location = FindResource(resource_name);
+    readers_[location.reader]->GetResource(location.entry, buffer);
+}
 
-    throw runtime_error("Requested unknown resource " + resource_name);
+uint64_t TreArchive::GetResourceVersion(const string& resource_name) const
+{
+    auto& location = FindResource(resource_name);
+    auto& info = readers_[location.reader]->GetResourceInfo(location.entry);
+
+    uint64_t entry[] = {
+        reader_versions_[location.reader],
+        location.entry,
+        info.checksum,
+        info.data_offset,
+        info.data_size,
+        info.data_compressed_size
+    };
+    return ResourceIndex::HashPath(reinterpret_cast<const char*>(entry), sizeof(entry));
 }
 
 vector<string> TreArchive::GetTreFilenames() const
@@ -104,7 +110,10 @@ std::vector<std::string> TreArchive::GetAvailableResources(std::function<void (i
         resource_list.insert(begin(resource_list), begin(resources), end(resources));
 
         ++completed;
-        progress_callback(total, completed);
+        if (progress_callback)
+        {
+            progress_callback(total, completed);
+        }
     }
 
     // sort and remove duplicates
@@ -116,10 +125,56 @@ std::vector<std::string> TreArchive::GetAvailableResources(std::function<void (i
 }
 
 
- void TreArchive::CreateReaders(const vector<string>& resource_files)
- { 
-	uint32_t index = 0;
-	std::for_each(resource_files.rbegin(), resource_files.rend(), [&, this] (std::string name) {
-        readers_.push_back(std::unique_ptr<TreReader>(new TreReader(name, lookup_, index++)));
-	});
- }
+void TreArchive::CreateReaders(const vector<string>& resource_files)
+{ 
+    // the first file listed has the highest priority, it goes last
+    std::for_each(resource_files.rbegin(), resource_files.rend(), [this] (const std::string& name) {
+        readers_.push_back(std::unique_ptr<TreReader>(new TreReader(name)));
+    });
+}
+
+void TreArchive::BuildIndex()
+{
+    size_t resource_count = 0;
+    for (auto& reader : readers_)
+    {
+        resource_count += reader->GetResourceCount();
+    }
+
+    index_ = ResourceIndex(resource_count);
+
+    // files are identified by name, size and modification time
+    reader_versions_.clear();
+    for (auto& reader : readers_)
+    {
+        boost::system::error_code error;
+        auto filename = reader->GetFilename();
+        uint64_t file[] = {
+            ResourceIndex::HashPath(filename),
+            static_cast<uint64_t>(boost::filesystem::file_size(filename, error)),
+            static_cast<uint64_t>(boost::filesystem::last_write_time(filename, error))
+        };
+        reader_versions_.push_back(ResourceIndex::HashPath(reinterpret_cast<const char*>(file), sizeof(file)));
+    }
+
+    for (uint32_t reader = 0; reader < readers_.size(); ++reader)
+    {
+        uint32_t entry_count = readers_[reader]->GetResourceCount();
+        for (uint32_t entry = 0; entry < entry_count; ++entry)
+        {
+            ResourceLocation location = {reader, entry};
+            index_.Insert(readers_[reader]->GetResourceName(entry), location);
+        }
+    }
+}
+
+const ResourceLocation& TreArchive::FindResource(const std::string& resource_name) const
+{
+    auto location = index_.Find(resource_name);
+    if (!location)
+    {
+        throw runtime_error("Requested unknown resource " + resource_name);
+    }
+
+    return *location;
+}
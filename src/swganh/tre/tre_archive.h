@@ -9,6 +9,7 @@
 #include <vector>
 #include <unordered_map>
 
+#include "resource_index.h"
 #include "tre_reader.h"
 
 namespace swganh {
@@ -17,6 +18,11 @@ namespace tre {
     /**
      * TreArchive is a simple utility for accessing resource files from
      * a collection of .tre files.
+     *
+     * When a resource is in more than one file the version from the highest
+     * priority file is used. All files are indexed once when the archive is
+     * created, so looking up a resource hashes its name once and does not depend
+     * on the number of files.
      */
     class TreArchive
     {
@@ -24,14 +30,15 @@ namespace tre {
         /**
          * Explicit constructor that accepts a collection of tre files.
          *
-         * \param tre_files Collection of tre files.
+         * \param tre_files Collection of tre files, later files override earlier ones.
          */
         explicit TreArchive(std::vector<std::unique_ptr<TreReader>>&& tre_files);
 
         /**
          * Explicit constructor that accepts a list of tre files to load.
          *
-         * \param tre_filenames A collection of filenames to load.
+         * \param tre_filenames A collection of filenames to load, earlier files
+         *      override later ones (the order of a live.cfg).
          */
         explicit TreArchive(std::vector<std::string>&& tre_filenames);
 
@@ -78,6 +85,16 @@ namespace tre {
          * \param buffer The buffer to store the resource.
          */
         void GetResource(const std::string& resource_name, swganh::ByteBuffer& buffer);
+
+        /**
+         * Returns a value that changes whenever the data of the resource may have
+         * changed, eg. because the tre file holding it was replaced or a patch
+         * file now overrides it.
+         *
+         * \param resource_name The name of the resource.
+         * \return The version of the resource.
+         */
+        uint64_t GetResourceVersion(const std::string& resource_name) const;
         
         /**
          * Returns a list of the available tre files.
@@ -107,9 +124,15 @@ namespace tre {
 
         void CreateReaders(const std::vector<std::string>& resource_files);
 
+        /// Indexes every reader, readers later in readers_ override earlier ones.
+        void BuildIndex();
+
+        /// @return The location of the resource, throws if it is unknown.
+        const ResourceLocation& FindResource(const std::string& resource_name) const;
 		
         typedef std::vector<std::unique_ptr<TreReader>> ReaderList;
         ReaderList readers_;
-		ResourceLookup lookup_;
+        std::vector<uint64_t> reader_versions_;
+        ResourceIndex index_;
     };
 }}  // namespace swganh::tre
@@ -0,0 +1,121 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "swganh/byte_buffer.h"
+#include "swganh/tre/mock_tre_file.h"
+#include "swganh/tre/tre_archive.h"
+
+using namespace swganh::tre;
+
+namespace {
+
+    std::vector<char> MakeData(const std::string& text)
+    {
+        return std::vector<char>(text.begin(), text.end());
+    }
+
+    std::string ToString(const swganh::ByteBuffer& buffer)
+    {
+        return std::string(buffer.data(), buffer.data() + buffer.size());
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(TreArchiveTest)
+
+/// This test shows that a resource in several files is read from the file listed
+/// first, as in a live.cfg, and that resources only in lower priority files are
+/// still found.
+BOOST_AUTO_TEST_CASE(FirstListedFileOverridesLaterFiles) {
+    MockTreFile patch;
+    patch.AddResource("datatables/shared.iff", MakeData("patched"));
+    patch.AddResource("terrain/tatooine.trn", MakeData("new terrain"), true);
+    patch.Write();
+
+    MockTreFile base;
+    base.AddResource("datatables/shared.iff", MakeData("original"));
+    base.AddResource("terrain/tatooine.trn", MakeData("old terrain"));
+    base.AddResource("object/only_in_base.iff", MakeData("base"));
+    base.Write();
+
+    std::vector<std::string> files;
+    files.push_back(patch.GetPath());
+    files.push_back(base.GetPath());
+    TreArchive archive(std::move(files));
+
+    BOOST_CHECK_EQUAL("patched", ToString(archive.GetResource("datatables/shared.iff")));
+    BOOST_CHECK_EQUAL("new terrain", ToString(archive.GetResource("terrain/tatooine.trn")));
+    BOOST_CHECK_EQUAL("base", ToString(archive.GetResource("object/only_in_base.iff")));
+
+    // sizes come from the same file as the data
+    BOOST_CHECK_EQUAL(7u, archive.GetResourceSize("datatables/shared.iff"));
+    BOOST_CHECK_EQUAL(4u, archive.GetResourceSize("object/only_in_base.iff"));
+
+    BOOST_CHECK_EQUAL(3u, archive.GetAvailableResources().size());
+}
+
+/// This test shows that readers handed over directly are overridden by the ones after them.
+BOOST_AUTO_TEST_CASE(LaterReadersOverrideEarlierReaders) {
+    MockTreFile base;
+    base.AddResource("datatables/shared.iff", MakeData("original"));
+    base.Write();
+
+    MockTreFile patch;
+    patch.AddResource("datatables/shared.iff", MakeData("patched"));
+    patch.Write();
+
+    std::vector<std::unique_ptr<TreReader>> readers;
+    readers.push_back(std::unique_ptr<TreReader>(new TreReader(base.GetPath())));
+    readers.push_back(std::unique_ptr<TreReader>(new TreReader(patch.GetPath())));
+    TreArchive archive(std::move(readers));
+
+    BOOST_CHECK_EQUAL("patched", ToString(archive.GetResource("datatables/shared.iff")));
+}
+
+/// This test shows that unknown resources, including prefixes of known ones, are rejected.
+BOOST_AUTO_TEST_CASE(UnknownResourcesThrow) {
+    MockTreFile base;
+    base.AddResource("datatables/shared.iff", MakeData("original"));
+    base.Write();
+
+    std::vector<std::string> files;
+    files.push_back(base.GetPath());
+    TreArchive archive(std::move(files));
+
+    BOOST_CHECK_THROW(archive.GetResource("datatables/shared"), std::runtime_error);
+    BOOST_CHECK_THROW(archive.GetResourceSize("datatables/missing.iff"), std::runtime_error);
+}
+
+/// This test shows that the index keeps every entry reachable as it grows.
+BOOST_AUTO_TEST_CASE(IndexFindsEveryEntryAfterGrowing) {
+    std::vector<std::string> names;
+    for (int i = 0; i < 5000; ++i)
+    {
+        names.push_back("object/tangible/shared_" + std::to_string(i) + ".iff");
+    }
+
+    ResourceIndex index;
+    for (uint32_t i = 0; i < names.size(); ++i)
+    {
+        ResourceLocation location = {0, i};
+        index.Insert(names[i].c_str(), location);
+    }
+
+    BOOST_CHECK_EQUAL(names.size(), index.Size());
+    for (uint32_t i = 0; i < names.size(); ++i)
+    {
+        auto location = index.Find(names[i]);
+        BOOST_REQUIRE(location != nullptr);
+        BOOST_CHECK_EQUAL(i, location->entry);
+    }
+    BOOST_CHECK(index.Find("object/tangible/shared_5000.iff") == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -11,6 +11,9 @@
 #include <sstream>
 #include <stdexcept>
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/thread/lock_guard.hpp>
 #include <boost/thread/mutex.hpp>
 
 #include <zlib.h>
@@ -28,24 +31,85 @@ using std::string;
 using std::stringstream;
 using std::vector;
 
-TreReader::TreReader(const string& filename, ResourceLookup& lookup_, uint32_t index)
+namespace {
+
+    void Inflate(const char* compressed_data, uint32_t compressed_size, char* buffer, uint32_t uncompressed_size)
+    {
+        int result;
+        z_stream stream;
+        stream.zalloc = Z_NULL;
+        stream.zfree = Z_NULL;
+        stream.opaque = Z_NULL;
+        stream.avail_in = Z_NULL;
+        stream.next_in = Z_NULL;
+        result = inflateInit(&stream);
+
+        if (result != Z_OK)
+        {
+            throw std::runtime_error("Zlib error: " + std::to_string(result));
+        }
+
+        // zlib does not write through next_in, the cast only drops the const
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed_data));
+        stream.avail_in = compressed_size;
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = uncompressed_size;
+
+        inflate(&stream, Z_FINISH);
+        inflateEnd(&stream);
+    }
+
+}
+
+TreReader::TreReader(const string& filename, Backend backend)
 : filename_(filename)
+, backend_(backend)
+, mapped_data_(nullptr)
+, mapped_size_(0)
 {
-    input_stream_.exceptions(ifstream::failbit | ifstream::badbit);
-    input_stream_.open(filename_.c_str(), ios_base::binary);
+    if (backend_ == MEMORY_MAPPED)
+    {
+        try
+        {
+            boost::interprocess::file_mapping file(filename_.c_str(), boost::interprocess::read_only);
+            region_.reset(new boost::interprocess::mapped_region(file, boost::interprocess::read_only));
+            mapped_data_ = static_cast<const char*>(region_->get_address());
+            mapped_size_ = region_->get_size();
+        }
+        catch (boost::interprocess::interprocess_exception&)
+        {
+            // empty files and file systems without mapping support
+            region_.reset();
+            backend_ = STREAM;
+        }
+    }
+
+    if (backend_ == STREAM)
+    {
+        input_stream_.exceptions(ifstream::failbit | ifstream::badbit);
+        input_stream_.open(filename_.c_str(), ios_base::binary);
+    }
 
     ReadHeader();
-    ReadIndex(lookup_, index);
+    ReadIndex();
 }
 
 TreReader::~TreReader()
 {
     {
         boost::lock_guard<boost::mutex> lg(mutex_);
-        input_stream_.close();
+        if (input_stream_.is_open())
+        {
+            input_stream_.close();
+        }
     }
 }
 
+TreReader::Backend TreReader::GetBackend() const
+{
+    return backend_;
+}
+
 uint32_t TreReader::GetResourceCount() const
 {
     return header_.resource_count;
@@ -59,14 +123,15 @@ const string& TreReader::GetFilename() const
 vector<string> TreReader::GetResourceNames() const
 {
     vector<string> resource_names;
+    resource_names.reserve(resources_.size());
 
-    for_each(
-        begin(resource_lookup_),
-        end(resource_lookup_),
-		[this, &resource_names] (const std::pair<const char*, TreResourceInfo>& info)
+    for (auto& info : resources_)
     {
-        resource_names.push_back(info.first);
-    });
+        resource_names.push_back(&name_block_[info.name_offset]);
+    }
+
+    // callers have always been handed the names in order
+    std::sort(resource_names.begin(), resource_names.end());
 
     return resource_names;
 }
@@ -82,7 +147,18 @@ swganh::ByteBuffer TreReader::GetResource(const std::string& resource_name)
 
 void TreReader::GetResource(const std::string& resource_name, swganh::ByteBuffer& buffer)
 {    
-    auto file_info = GetResourceInfo(resource_name);
+    auto location = index_.Find(resource_name);
+    if (!location)
+    {
+        throw std::runtime_error("Requested invalid file: " + resource_name);
+    }
+
+    GetResource(location->entry, buffer);
+}
+
+void TreReader::GetResource(uint32_t entry, swganh::ByteBuffer& buffer)
+{
+    const auto& file_info = GetResourceInfo(entry);
 
     if (file_info.data_size > buffer.size())
     {
@@ -98,71 +174,131 @@ void TreReader::GetResource(const std::string& resource_name, swganh::ByteBuffer
             file_info.data_size,
             (char*)(&buffer.raw()[0]));
     }
+}
+
+TreResourceView TreReader::GetResourceView(const std::string& resource_name, std::vector<char>& scratch)
+{
+    auto location = index_.Find(resource_name);
+    if (!location)
+    {
+        throw std::runtime_error("Requested invalid file: " + resource_name);
+    }
+
+    return GetResourceView(location->entry, scratch);
+}
+
+TreResourceView TreReader::GetResourceView(uint32_t entry, std::vector<char>& scratch)
+{
+    const auto& file_info = GetResourceInfo(entry);
+
+    TreResourceView view;
+    view.size = file_info.data_size;
+    view.data = nullptr;
+
+    if (file_info.data_size == 0)
+    {
+        return view;
+    }
 
+    if (backend_ == MEMORY_MAPPED && file_info.data_compression == 0)
+    {
+        view.data = MappedData(file_info.data_offset, file_info.data_size);
+        return view;
+    }
+
+    if (scratch.size() < file_info.data_size)
+    {
+        scratch.resize(file_info.data_size);
+    }
+
+    ReadDataBlock(
+        file_info.data_offset,
+        file_info.data_compression,
+        file_info.data_compressed_size,
+        file_info.data_size,
+        &scratch[0]);
+
+    view.data = &scratch[0];
+    return view;
+}
+
+const char* TreReader::GetResourceName(uint32_t entry) const
+{
+    return &name_block_[GetResourceInfo(entry).name_offset];
+}
+
+const TreResourceInfo& TreReader::GetResourceInfo(uint32_t entry) const
+{
+    if (entry >= resources_.size())
+    {
+        throw std::runtime_error("Requested invalid entry in " + filename_);
+    }
+
+    return resources_[entry];
 }
 
 bool TreReader::ContainsResource(const string& resource_name) const
 {
-	auto find_iter = resource_lookup_.find(resource_name.c_str());
-    return find_iter != end(resource_lookup_);
+    return index_.Find(resource_name) != nullptr;
 }
 
 uint32_t TreReader::GetResourceSize(const string& resource_name) const
 {
-    auto find_iter = resource_lookup_.find(resource_name.c_str());
-
-    if (find_iter == resource_lookup_.end())
+    auto location = index_.Find(resource_name);
+    if (!location)
     {
         throw std::runtime_error("File name invalid");
     }
          
-    return find_iter->second.data_size;
+    return resources_[location->entry].data_size;
 }
 
 const TreResourceInfo& TreReader::GetResourceInfo(const string& resource_name) const
 {
-    auto find_iter = resource_lookup_.find(resource_name.c_str());
-    if (find_iter == end(resource_lookup_))
+    auto location = index_.Find(resource_name);
+    if (!location)
     {
         throw std::runtime_error("Requested info for invalid file: " + resource_name);
     }
 
-    return find_iter->second;
+    return resources_[location->entry];
 }
 
 void TreReader::ReadHeader()
 {
+    if (backend_ == MEMORY_MAPPED)
     {
-        boost::lock_guard<boost::mutex> lg(mutex_);
-        input_stream_.read(reinterpret_cast<char*>(&header_), sizeof(header_));
+        std::memcpy(&header_, MappedData(0, sizeof(header_)), sizeof(header_));
+    }
+    else
+    {
+        ReadStream(0, sizeof(header_), reinterpret_cast<char*>(&header_));
     }
 
     ValidateFileType(string(header_.file_type, 4));
     ValidateFileVersion(string(header_.file_version, 4));        
 }
 
-void TreReader::ReadIndex(ResourceLookup& lookup_, uint32_t index)
+void TreReader::ReadIndex()
 {
-	std::vector<TreResourceInfo> resource_block_ = ReadResourceBlock();
+    resources_ = ReadResourceBlock();
     name_block_ = ReadNameBlock();
 
-	for(auto& info : resource_block_)
-	{
-		//Insert into the global index pointing to this reader
-		char* name = &name_block_[info.name_offset];
-		auto lb = lookup_.lower_bound(name);
-		if(lb != lookup_.end() && !(lookup_.key_comp()(name, lb->first)))
-		{
-			lb->second = index;
-		}
-		else
-		{
-			lookup_.insert(lb, std::make_pair(name, index));
-		}
-
-		//Insert into the local index pointing to the info.
-		resource_lookup_.insert(std::make_pair(name, info));
-	}
+    // the name block is only sized from the header, do not trust it to be terminated
+    name_block_.push_back('\0');
+
+    index_ = ResourceIndex(resources_.size());
+
+    for (uint32_t entry = 0; entry < resources_.size(); ++entry)
+    {
+        if (resources_[entry].name_offset >= name_block_.size())
+        {
+            throw runtime_error("Invalid resource name offset in " + filename_);
+        }
+
+        ResourceLocation location = {0, entry};
+        index_.Insert(&name_block_[resources_[entry].name_offset], location);
+    }
 }
 
 vector<TreResourceInfo> TreReader::ReadResourceBlock()
@@ -221,46 +357,27 @@ void TreReader::ReadDataBlock(
 {    
     if (compression == 0)
     {
+        if (backend_ == MEMORY_MAPPED)
+        {
+            std::memcpy(buffer, MappedData(offset, uncompressed_size), uncompressed_size);
+        }
+        else
         {
-            boost::lock_guard<boost::mutex> lg(mutex_);
-            input_stream_.seekg(offset, ios_base::beg);
-            input_stream_.read(buffer, uncompressed_size);
+            ReadStream(offset, uncompressed_size, buffer);
         }
     }
     else if (compression == 2)
     {
-        vector<char> compressed_data(compressed_size);
-        
+        if (backend_ == MEMORY_MAPPED)
         {
-            boost::lock_guard<boost::mutex> lg(mutex_);
-            input_stream_.seekg(offset, ios_base::beg);
-            input_stream_.read(&compressed_data[0], compressed_size);
+            Inflate(MappedData(offset, compressed_size), compressed_size, buffer, uncompressed_size);
         }
-
-        int result;
-        z_stream stream;
-        stream.zalloc = Z_NULL;
-        stream.zfree = Z_NULL;
-        stream.opaque = Z_NULL;
-        stream.avail_in = Z_NULL;
-        stream.next_in = Z_NULL;
-        result = inflateInit(&stream);
-
-        if (result != Z_OK)
+        else
         {
-            throw std::runtime_error("Zlib error: " + std::to_string(result));
-        }
-
-        stream.next_in = reinterpret_cast<Bytef*>(&compressed_data[0]);
-        stream.avail_in = compressed_size;
-        stream.next_out = reinterpret_cast<Bytef*>(buffer);
-        stream.avail_out = uncompressed_size;
-
-        inflate(&stream, Z_FINISH);
+            vector<char> compressed_data(compressed_size);
+            ReadStream(offset, compressed_size, &compressed_data[0]);
 
-        if(stream.total_out > 0)
-        {
-            inflateEnd(&stream);
+            Inflate(&compressed_data[0], compressed_size, buffer, uncompressed_size);
         }
     }
     else
@@ -268,3 +385,20 @@ void TreReader::ReadDataBlock(
         throw std::runtime_error("Unknown format");
     }
 }
+
+const char* TreReader::MappedData(uint32_t offset, uint32_t size) const
+{
+    if (static_cast<uint64_t>(offset) + size > mapped_size_)
+    {
+        throw std::runtime_error("Resource lies outside of " + filename_);
+    }
+
+    return mapped_data_ + offset;
+}
+
+void TreReader::ReadStream(uint32_t offset, uint32_t size, char* buffer)
+{
+    boost::lock_guard<boost::mutex> lg(mutex_);
+    input_stream_.seekg(offset, ios_base::beg);
+    input_stream_.read(buffer, size);
+}
@@ -4,16 +4,22 @@
 
 #include <cstdint>
 #include <array>
+#include <cstring>
 #include <fstream>
 #include <memory>
 #include <string>
 #include <vector>
-#include <map>
 
 #include <boost/thread/mutex.hpp>
 
+#include "resource_index.h"
 #include "tre_data.h"
 
+namespace boost {
+namespace interprocess {
+	class mapped_region;
+}}  // namespace boost::interprocess
+
 namespace swganh {
 	class ByteBuffer;
 }
@@ -21,31 +27,48 @@ namespace swganh {
 namespace swganh {
 namespace tre {
 
-	struct name_comp
+	/**
+	 * A read only view of a resource's bytes, see TreReader::GetResourceView.
+	 */
+	struct TreResourceView
 	{
-		bool operator()(const char* a, const char* b) const
-		{
-			return std::strcmp(a, b) < 0;
-		}
+		const char* data;
+		uint32_t size;
 	};
-	typedef std::map<const char*, size_t, name_comp> ResourceLookup;
 
     /**
      * TreReader is a utility class used for reading data from a single 
      * .tre file in pre-publish 15 format.
+     *
+     * By default the file is memory mapped once and resources are read straight
+     * from the mapping, so any number of threads can read at the same time
+     * without locking. The stream backend reads through a single file stream
+     * under a mutex instead, it is used when the file can not be mapped.
      */
     class TreReader
     {
     public:
+        enum Backend
+        {
+            MEMORY_MAPPED,
+            STREAM
+        };
+
         /**
          * Explicit constructor taking the filename of the archive. This can
          * be an explicit path or relative to the current working directory.
          *
          * \param filename The filename of the archive file to be loaded.
+         * \param backend How resources are read from the file.
          */
-        explicit TreReader(const std::string& filename, ResourceLookup& lookup_, uint32_t index);
+        explicit TreReader(const std::string& filename, Backend backend = MEMORY_MAPPED);
         ~TreReader();
 
+        /**
+         * \return The backend in use, the stream backend if mapping the file failed.
+         */
+        Backend GetBackend() const;
+
         /**
          * Checks whether a specified resource is contained within the archive.
          *
@@ -94,12 +117,34 @@ namespace tre {
         swganh::ByteBuffer GetResource(const std::string& resource_name);
 
         void GetResource(const std::string& resource_name, swganh::ByteBuffer& buffer);
+
+        /**
+         * Returns a view of the requested resource without copying it where possible.
+         *
+         * Stored resources point straight into the mapped file and stay valid for the
+         * lifetime of the reader. Compressed resources, and every resource with the
+         * stream backend, are read into scratch, which must outlive the view.
+         *
+         * \param resource_name The name of the resource.
+         * \param scratch Caller owned buffer used when the bytes have to be produced.
+         */
+        TreResourceView GetResourceView(const std::string& resource_name, std::vector<char>& scratch);
+
+        /**
+         * Entry based access, entries are numbered 0 to GetResourceCount() - 1 in
+         * the order of the archive's resource table. Used by TreArchive, which
+         * resolves names through its own index.
+         */
+        const char* GetResourceName(uint32_t entry) const;
+        const TreResourceInfo& GetResourceInfo(uint32_t entry) const;
+        void GetResource(uint32_t entry, swganh::ByteBuffer& buffer);
+        TreResourceView GetResourceView(uint32_t entry, std::vector<char>& scratch);
     
     private:
         TreReader();
 
         void ReadHeader();
-        void ReadIndex(ResourceLookup& lookup_, uint32_t index);
+        void ReadIndex();
                 
         std::vector<TreResourceInfo> ReadResourceBlock();
         std::vector<char> ReadNameBlock();
@@ -114,6 +159,11 @@ namespace tre {
 	    	uint32_t uncompressed_size, 
 	    	char* buffer);
 
+        /// Returns the bytes at offset in the mapped file, bounds checked.
+        const char* MappedData(uint32_t offset, uint32_t size) const;
+
+        void ReadStream(uint32_t offset, uint32_t size, char* buffer);
+
         bool initialized_;
 
         typedef std::ifstream BinaryStream;
@@ -121,10 +171,17 @@ namespace tre {
         std::string filename_;
         TreHeader header_;
 
+        // Only used by the stream backend, the mapping is read without locking.
         boost::mutex mutex_;
 
-        std::map<const char*, TreResourceInfo, name_comp> resource_lookup_;
+        Backend backend_;
+        std::unique_ptr<boost::interprocess::mapped_region> region_;
+        const char* mapped_data_;
+        size_t mapped_size_;
+
+        std::vector<TreResourceInfo> resources_;
         std::vector<char> name_block_;
+        ResourceIndex index_;
     };
 
 }}  // namespace swganh::tre
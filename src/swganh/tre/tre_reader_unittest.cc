@@ -0,0 +1,112 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "swganh/byte_buffer.h"
+#include "swganh/tre/mock_tre_file.h"
+#include "swganh/tre/tre_reader.h"
+
+using namespace swganh::tre;
+
+namespace {
+
+    std::vector<char> MakeData(size_t size, char seed)
+    {
+        std::vector<char> data(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            data[i] = static_cast<char>(seed + i * 31 + (i >> 7));
+        }
+        return data;
+    }
+
+    std::vector<char> ToVector(const swganh::ByteBuffer& buffer)
+    {
+        return std::vector<char>(buffer.data(), buffer.data() + buffer.size());
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(TreReaderTest)
+
+/// This test shows that 16 threads reading the same resources from the mapped file
+/// at once all get the bytes the stream backend reads.
+BOOST_AUTO_TEST_CASE(ConcurrentMappedReadsMatchStreamReads) {
+    MockTreFile tre_file;
+    tre_file.AddResource("object/tangible/shared_stored.iff", MakeData(70000, 1));
+    tre_file.AddResource("object/tangible/shared_compressed.iff", MakeData(150000, 7), true);
+    tre_file.AddResource("object/tangible/shared_empty.iff", std::vector<char>());
+    tre_file.Write();
+
+    TreReader stream_reader(tre_file.GetPath(), TreReader::STREAM);
+    TreReader mapped_reader(tre_file.GetPath());
+    BOOST_REQUIRE_EQUAL(TreReader::MEMORY_MAPPED, mapped_reader.GetBackend());
+
+    auto stored = ToVector(stream_reader.GetResource("object/tangible/shared_stored.iff"));
+    auto compressed = ToVector(stream_reader.GetResource("object/tangible/shared_compressed.iff"));
+    BOOST_REQUIRE(stored == MakeData(70000, 1));
+    BOOST_REQUIRE(compressed == MakeData(150000, 7));
+
+    std::atomic<uint32_t> mismatches(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 16; ++i)
+    {
+        threads.push_back(std::thread([&mapped_reader, &stored, &compressed, &mismatches] () {
+            std::vector<char> scratch;
+            for (int j = 0; j < 50; ++j)
+            {
+                auto view = mapped_reader.GetResourceView("object/tangible/shared_stored.iff", scratch);
+                if (std::vector<char>(view.data, view.data + view.size) != stored)
+                {
+                    ++mismatches;
+                }
+
+                view = mapped_reader.GetResourceView("object/tangible/shared_compressed.iff", scratch);
+                if (std::vector<char>(view.data, view.data + view.size) != compressed)
+                {
+                    ++mismatches;
+                }
+
+                if (ToVector(mapped_reader.GetResource("object/tangible/shared_compressed.iff")) != compressed)
+                {
+                    ++mismatches;
+                }
+            }
+        }));
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    BOOST_CHECK_EQUAL(0u, mismatches.load());
+    BOOST_CHECK_EQUAL(0u, mapped_reader.GetResource("object/tangible/shared_empty.iff").size());
+}
+
+/// This test shows that stored resources are viewed in place and only compressed
+/// ones are inflated into the caller's buffer.
+BOOST_AUTO_TEST_CASE(StoredResourcesAreNotCopied) {
+    MockTreFile tre_file;
+    tre_file.AddResource("stored.iff", MakeData(128, 3));
+    tre_file.AddResource("compressed.iff", MakeData(4096, 5), true);
+    tre_file.Write();
+
+    TreReader reader(tre_file.GetPath());
+
+    std::vector<char> scratch;
+    auto view = reader.GetResourceView("stored.iff", scratch);
+    BOOST_CHECK(scratch.empty());
+    BOOST_CHECK_EQUAL(128u, view.size);
+
+    view = reader.GetResourceView("compressed.iff", scratch);
+    BOOST_CHECK(view.data == scratch.data());
+    BOOST_CHECK(std::vector<char>(view.data, view.data + view.size) == MakeData(4096, 5));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,166 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "visitor_cache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <typeinfo>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "swganh/byte_buffer.h"
+#include "swganh/crc.h"
+#include "swganh/logger.h"
+
+#include "resource_index.h"
+
+using namespace swganh::tre;
+
+namespace {
+
+    const uint32_t ENTRY_MAGIC = 0x48435656;    // "VVCH"
+    const uint32_t ENTRY_FORMAT = 1;
+
+    uint64_t VisitorTypeHash(const VisitorInterface& visitor)
+    {
+        return ResourceIndex::HashPath(typeid(visitor).name());
+    }
+
+}
+
+VisitorCache::VisitorCache(std::string directory)
+    : directory_(std::move(directory))
+    , hits_(0)
+    , misses_(0)
+    , stores_(0)
+{
+    boost::system::error_code error;
+    boost::filesystem::create_directories(directory_, error);
+}
+
+bool VisitorCache::Load(const std::string& name, uint64_t version, VisitorInterface& visitor)
+{
+    if (visitor.CacheVersion() == 0)
+    {
+        return false;
+    }
+
+    auto path = GetEntryPath(name);
+
+    boost::system::error_code error;
+    if (!boost::filesystem::exists(path, error) || boost::filesystem::file_size(path, error) == 0)
+    {
+        ++misses_;
+        return false;
+    }
+
+    try
+    {
+        boost::interprocess::file_mapping file(path.c_str(), boost::interprocess::read_only);
+        boost::interprocess::mapped_region region(file, boost::interprocess::read_only);
+
+        swganh::ByteBuffer entry(static_cast<const unsigned char*>(region.get_address()), region.get_size());
+
+        if (entry.read<uint32_t>() != ENTRY_MAGIC ||
+            entry.read<uint32_t>() != ENTRY_FORMAT ||
+            entry.read<uint64_t>() != VisitorTypeHash(visitor) ||
+            entry.read<uint32_t>() != visitor.CacheVersion() ||
+            entry.read<uint64_t>() != version ||
+            entry.read<std::string>() != name)
+        {
+            ++misses_;
+            return false;
+        }
+
+        uint32_t payload_size = entry.read<uint32_t>();
+        uint32_t payload_crc = entry.read<uint32_t>();
+        if (entry.size() - entry.read_position() != payload_size ||
+            swganh::memcrc(entry.data() + entry.read_position(), payload_size, 0) != payload_crc)
+        {
+            LOG(warning) << "Ignoring damaged visitor cache entry " << path << " for " << name;
+            ++misses_;
+            return false;
+        }
+
+        visitor.Deserialize(entry);
+    }
+    catch (const std::exception& e)
+    {
+        LOG(warning) << "Unable to read visitor cache entry " << path << " for " << name << ": " << e.what();
+        ++misses_;
+        return false;
+    }
+
+    ++hits_;
+    return true;
+}
+
+void VisitorCache::Store(const std::string& name, uint64_t version, const VisitorInterface& visitor)
+{
+    if (visitor.CacheVersion() == 0)
+    {
+        return;
+    }
+
+    swganh::ByteBuffer payload;
+    visitor.Serialize(payload);
+
+    swganh::ByteBuffer entry;
+    entry.write(ENTRY_MAGIC);
+    entry.write(ENTRY_FORMAT);
+    entry.write(VisitorTypeHash(visitor));
+    entry.write(visitor.CacheVersion());
+    entry.write(version);
+    entry.write(name);
+    entry.write(static_cast<uint32_t>(payload.size()));
+    entry.write(swganh::memcrc(payload.data(), payload.size(), 0));
+    entry.append(std::move(payload));
+
+    auto path = GetEntryPath(name);
+    auto temp_path = path + "." + boost::filesystem::unique_path().string();
+
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(entry.data()), entry.size());
+        if (!file)
+        {
+            LOG(warning) << "Unable to write visitor cache entry " << temp_path << " for " << name;
+            file.close();
+            std::remove(temp_path.c_str());
+            return;
+        }
+    }
+
+    boost::system::error_code error;
+    boost::filesystem::rename(temp_path, path, error);
+    if (error)
+    {
+        LOG(warning) << "Unable to replace visitor cache entry " << path << ": " << error.message();
+        boost::filesystem::remove(temp_path, error);
+        return;
+    }
+
+    ++stores_;
+}
+
+VisitorCacheStatistics VisitorCache::GetStatistics() const
+{
+    VisitorCacheStatistics statistics;
+    statistics.hits = hits_;
+    statistics.misses = misses_;
+    statistics.stores = stores_;
+    return statistics;
+}
+
+std::string VisitorCache::GetEntryPath(const std::string& name) const
+{
+    std::ostringstream filename;
+    filename << std::hex << std::setw(16) << std::setfill('0') << ResourceIndex::HashPath(name) << ".vc";
+
+    return (boost::filesystem::path(directory_) / filename.str()).string();
+}
@@ -0,0 +1,72 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include <boost/noncopyable.hpp>
+
+#include "visitors/visitor_interface.h"
+
+namespace swganh {
+namespace tre {
+
+    struct VisitorCacheStatistics
+    {
+        uint64_t hits;
+        uint64_t misses;    ///< no entry, or one written for other data or another format
+        uint64_t stores;
+    };
+
+    /**
+     * On disk cache of parsed visitors, so resources do not have to be parsed
+     * again on every start.
+     *
+     * Every resource is stored in its own file, named after the hash of the
+     * resource name, holding the state written by VisitorInterface::Serialize.
+     * An entry is only used if the resource version it was written for, the
+     * visitor type and its CacheVersion all still match and the payload checksum
+     * is intact. Entries are mapped read only when they are loaded and written to
+     * a temporary file that is renamed into place, so readers never see a partly
+     * written entry.
+     */
+    class VisitorCache : private boost::noncopyable
+    {
+    public:
+        /**
+         * @param directory Where the entries are kept, created if missing.
+         */
+        explicit VisitorCache(std::string directory);
+
+        /**
+         * Restores a visitor from its entry.
+         *
+         * @param name The name of the resource.
+         * @param version The current version of the resource, see TreArchive::GetResourceVersion.
+         * @param visitor Receives the cached state, left unchanged on failure.
+         * @return True if the visitor was restored.
+         */
+        bool Load(const std::string& name, uint64_t version, VisitorInterface& visitor);
+
+        /**
+         * Writes the state of a freshly parsed visitor. Failures are logged and
+         * otherwise ignored, the resource is simply parsed again next time.
+         */
+        void Store(const std::string& name, uint64_t version, const VisitorInterface& visitor);
+
+        VisitorCacheStatistics GetStatistics() const;
+
+        /// @return The path of the entry for a resource.
+        std::string GetEntryPath(const std::string& name) const;
+
+    private:
+        std::string directory_;
+
+        std::atomic<uint64_t> hits_;
+        std::atomic<uint64_t> misses_;
+        std::atomic<uint64_t> stores_;
+    };
+
+}}  // namespace swganh::tre
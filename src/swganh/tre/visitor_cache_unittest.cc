@@ -0,0 +1,199 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "swganh/byte_buffer.h"
+#include "swganh/tre/iff/iff.h"
+#include "swganh/tre/iff/mock_iff_builder.h"
+#include "swganh/tre/mock_tre_file.h"
+#include "swganh/tre/resource_manager.h"
+#include "swganh/tre/visitor_cache.h"
+#include "swganh/tre/visitors/datatables/datatable_visitor.h"
+#include "swganh/tre/visitors/objects/object_visitor.h"
+#include "swganh/tre/visitors/slots/slot_definition_visitor.h"
+
+using namespace swganh::tre;
+
+namespace {
+
+    /// Cache directory that is removed again when the test ends.
+    struct CacheDirectory
+    {
+        CacheDirectory()
+            : path((boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string())
+        {}
+
+        ~CacheDirectory()
+        {
+            boost::system::error_code error;
+            boost::filesystem::remove_all(path, error);
+        }
+
+        std::string path;
+    };
+
+    std::vector<char> MakeObjectTemplate(const std::string& parent, const std::string& appearance)
+    {
+        return MockIffBuilder()
+            .Text(parent).Node("DERVXXXX")
+            .Text("appearanceFilename").Byte(1).Text(appearance).Node("XXXX")
+            .Text("collisionActionFlags").Byte(1).Byte(0).Value<uint32_t>(255).Node("XXXX")
+            .Text("clearFloraRadius").Byte(1).Byte(0).Value<float>(2.5f).Node("XXXX")
+            .Text("hasWings").Byte(1).Byte(1).Node("XXXX")
+            .Text("objectName").Byte(1).Byte(1).Text("item_n").Byte(1).Text("stimpack").Node("XXXX")
+            .Form();
+    }
+
+    std::vector<char> MakeDatatable()
+    {
+        return MockIffBuilder()
+            .Value<uint32_t>(3).Text("commandName").Text("defaultTime").Text("cooldown").Node("0001COLS")
+            .Text("s").Text("f").Text("i").Node("TYPE")
+            .Value<uint32_t>(2)
+                .Text("burstrun").Value<float>(1.5f).Value<uint32_t>(300)
+                .Text("kneel").Value<float>(0.25f).Value<uint32_t>(0)
+                .Node("ROWS")
+            .Form();
+    }
+
+    std::vector<char> MakeSlotDefinitions()
+    {
+        return MockIffBuilder()
+            .Text("hat").Byte(1).Byte(0).Byte(1).Text("hp_hat").Value<uint32_t>(7)
+            .Text("inventory").Byte(0).Byte(1).Byte(0).Text("").Value<uint32_t>(0)
+            .Node("0006DATA")
+            .Form();
+    }
+
+    const char* OBJECT_TEMPLATE = "object/tangible/medicine/shared_stimpack.iff";
+    const char* DATATABLE = "datatables/command/command_table.iff";
+    const char* SLOT_DEFINITIONS = "abstract/slot/slot_definition/slot_definitions.iff";
+
+    void AddSampleResources(MockTreFile& tre_file, const std::string& appearance)
+    {
+        tre_file.AddResource(OBJECT_TEMPLATE, MakeObjectTemplate("object/tangible/shared_base.iff", appearance), true);
+        tre_file.AddResource(DATATABLE, MakeDatatable());
+        tre_file.AddResource(SLOT_DEFINITIONS, MakeSlotDefinitions());
+        tre_file.Write();
+    }
+
+    std::shared_ptr<TreArchive> OpenArchive(MockTreFile& tre_file)
+    {
+        std::vector<std::string> files;
+        files.push_back(tre_file.GetPath());
+        return std::make_shared<TreArchive>(std::move(files));
+    }
+
+    swganh::ByteBuffer StateOf(const VisitorInterface& visitor)
+    {
+        swganh::ByteBuffer state;
+        visitor.Serialize(state);
+        return state;
+    }
+
+    template<typename T>
+    void CheckRoundTrip(const std::string& name, ResourceManager& fresh, ResourceManager& cached)
+    {
+        auto parsed = fresh.GetResourceByName<T>(name, false);
+        auto restored = cached.GetResourceByName<T>(name, false);
+
+        BOOST_CHECK_MESSAGE(StateOf(*parsed).size() > 4, name);
+        BOOST_CHECK_MESSAGE(StateOf(*parsed) == StateOf(*restored), name);
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(VisitorCacheTest)
+
+/// This test shows that visitors restored from the cache hold the same state as
+/// freshly parsed ones.
+BOOST_AUTO_TEST_CASE(CachedVisitorsMatchParsedVisitors) {
+    CacheDirectory directory;
+    MockTreFile tre_file;
+    AddSampleResources(tre_file, "appearance/stimpack.apt");
+    auto archive = OpenArchive(tre_file);
+
+    ResourceManager fresh(archive);
+    {
+        // fills the cache
+        ResourceManager first_boot(archive, 0, directory.path);
+        first_boot.GetResourceByName<ObjectVisitor>(OBJECT_TEMPLATE, false);
+        first_boot.GetResourceByName<DatatableVisitor>(DATATABLE, false);
+        first_boot.GetResourceByName<SlotDefinitionVisitor>(SLOT_DEFINITIONS, false);
+        BOOST_CHECK_EQUAL(3u, first_boot.GetVisitorCache()->GetStatistics().stores);
+    }
+
+    ResourceManager cached(archive, 0, directory.path);
+    CheckRoundTrip<ObjectVisitor>(OBJECT_TEMPLATE, fresh, cached);
+    CheckRoundTrip<DatatableVisitor>(DATATABLE, fresh, cached);
+    CheckRoundTrip<SlotDefinitionVisitor>(SLOT_DEFINITIONS, fresh, cached);
+
+    auto statistics = cached.GetVisitorCache()->GetStatistics();
+    BOOST_CHECK_EQUAL(3u, statistics.hits);
+    BOOST_CHECK_EQUAL(0u, statistics.stores);
+
+    auto object = cached.GetResourceByName<ObjectVisitor>(OBJECT_TEMPLATE);
+    BOOST_CHECK_EQUAL("appearance/stimpack.apt", object->attribute<std::string>("appearanceFilename"));
+    BOOST_CHECK_EQUAL(255u, object->attribute<uint32_t>("collisionActionFlags"));
+    BOOST_CHECK_EQUAL("stimpack", object->attribute<std::shared_ptr<ObjectVisitor::ClientString>>("objectName")->entry);
+
+    auto slots = cached.GetResourceByName<SlotDefinitionVisitor>(SLOT_DEFINITIONS);
+    BOOST_REQUIRE_EQUAL(2u, slots->count());
+    BOOST_CHECK_EQUAL("hp_hat", slots->entry(0).hardpoint_name);
+}
+
+/// This test shows that entries written for other data are not used and are replaced.
+BOOST_AUTO_TEST_CASE(ChangedResourcesAreParsedAgain) {
+    CacheDirectory directory;
+    {
+        MockTreFile tre_file;
+        AddSampleResources(tre_file, "appearance/stimpack.apt");
+        ResourceManager manager(OpenArchive(tre_file), 0, directory.path);
+        manager.GetResourceByName<ObjectVisitor>(OBJECT_TEMPLATE);
+    }
+
+    MockTreFile patched;
+    AddSampleResources(patched, "appearance/stimpack_new.apt");
+    ResourceManager manager(OpenArchive(patched), 0, directory.path);
+
+    auto object = manager.GetResourceByName<ObjectVisitor>(OBJECT_TEMPLATE);
+    BOOST_CHECK_EQUAL("appearance/stimpack_new.apt", object->attribute<std::string>("appearanceFilename"));
+
+    auto statistics = manager.GetVisitorCache()->GetStatistics();
+    BOOST_CHECK_EQUAL(0u, statistics.hits);
+    BOOST_CHECK_EQUAL(1u, statistics.misses);
+    BOOST_CHECK_EQUAL(1u, statistics.stores);
+}
+
+/// This test shows that a damaged entry is ignored and the visitor left untouched.
+BOOST_AUTO_TEST_CASE(DamagedEntriesAreIgnored) {
+    CacheDirectory directory;
+    VisitorCache cache(directory.path);
+
+    auto iff = MakeSlotDefinitions();
+    swganh::ByteBuffer data(reinterpret_cast<const unsigned char*>(iff.data()), iff.size());
+    auto visitor = std::make_shared<SlotDefinitionVisitor>();
+    iff_file::loadIFF(data, visitor);
+    cache.Store(SLOT_DEFINITIONS, 1, *visitor);
+
+    auto path = cache.GetEntryPath(SLOT_DEFINITIONS);
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-1, std::ios::end);
+        file.put('\x7f');
+    }
+
+    SlotDefinitionVisitor restored;
+    BOOST_CHECK(!cache.Load(SLOT_DEFINITIONS, 1, restored));
+    BOOST_CHECK_EQUAL(0u, restored.count());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,7 @@
 #include "../../iff/iff.h"
 
 #include <regex>
+#include <stdexcept>
 
 using namespace std;
 using namespace swganh::tre;
@@ -35,6 +36,7 @@ void DatatableVisitor::_handle0001COLS(swganh::ByteBuffer& buf)
 	for(unsigned int i=0; i < count; ++i)
 	{
 		column_names_.push_back(buf.read<std::string>(false, true));
+		column_lookup_.insert(std::make_pair(column_names_.back(), column_names_.size() - 1));
 	}
 }
 
@@ -77,28 +79,231 @@ void DatatableVisitor::_handleTYPE(swganh::ByteBuffer& buf)
 void DatatableVisitor::_handleROWS(swganh::ByteBuffer& buf)
 {
 	std::uint32_t count = buf.read<std::uint32_t>();
+	reset_columns_(count);
+
 	for(std::uint32_t i=0; i < count; ++i)
 	{
-		DATA_ROW row;
-		for(std::uint32_t j=0; j < column_types_.size(); ++j)
+		for(auto& column : columns_)
+		{
+			if(column.type == 'i')
+			{
+				column.ints.push_back(buf.read<std::uint32_t>());
+			}
+			else if(column.type == 'f')
+			{
+				column.floats.push_back(buf.read<float>());
+			}
+			else
+			{
+				column.strings.push_back(buf.read<std::string>(false, true));
+			}
+		}
+	}
+	row_count_ = count;
+}
+
+void DatatableVisitor::reset_columns_(size_t rows)
+{
+	columns_.clear();
+	columns_.resize(column_types_.size());
+	indexes_.clear();
+
+	for(size_t i = 0; i < columns_.size(); ++i)
+	{
+		auto& column = columns_[i];
+		column.type = column_types_[i];
+		if(column.type == 'i')
+		{
+			column.ints.reserve(rows);
+		}
+		else if(column.type == 'f')
+		{
+			column.floats.reserve(rows);
+		}
+		else
+		{
+			column.strings.reserve(rows);
+		}
+
+		indexes_.push_back(std::unique_ptr<KeyIndex>(new KeyIndex));
+	}
+	row_count_ = 0;
+}
+
+int DatatableVisitor::column_index(const std::string& name) const
+{
+	auto it = column_lookup_.find(name);
+	return (it != column_lookup_.end()) ? static_cast<int>(it->second) : -1;
+}
+
+boost::any DatatableVisitor::cell(size_t row, size_t column) const
+{
+	switch(columns_.at(column).type)
+	{
+	case 'i':
+		return value<uint32_t>(row, column);
+	case 'f':
+		return value<float>(row, column);
+	default:
+		return value<std::string>(row, column);
+	}
+}
+
+const DatatableVisitor::Column& DatatableVisitor::column_of_(char type, size_t column) const
+{
+	auto& found = columns_.at(column);
+	if(found.type != type)
+	{
+		throw std::runtime_error("Invalid type requested for datatable column");
+	}
+	return found;
+}
+
+const DatatableVisitor::KeyIndex& DatatableVisitor::index_of_(size_t column) const
+{
+	auto& index = *indexes_.at(column);
+	std::call_once(index.built, [this, &index, column] () {
+		auto& found = columns_[column];
+
+		// the first row with a key wins
+		for(size_t row = row_count_; row-- > 0;)
+		{
+			if(found.type == 'i')
+			{
+				index.ints[found.ints[row]] = row;
+			}
+			else if(found.type == 's')
+			{
+				index.strings[found.strings[row]] = row;
+			}
+		}
+	});
+	return index;
+}
+
+int DatatableVisitor::find_row(size_t column, const std::string& key) const
+{
+	column_of_('s', column);
+
+	auto& index = index_of_(column);
+	auto it = index.strings.find(key);
+	return (it != index.strings.end()) ? static_cast<int>(it->second) : -1;
+}
+
+int DatatableVisitor::find_row(size_t column, uint32_t key) const
+{
+	column_of_('i', column);
+
+	auto& index = index_of_(column);
+	auto it = index.ints.find(key);
+	return (it != index.ints.end()) ? static_cast<int>(it->second) : -1;
+}
+
+uint64_t DatatableVisitor::Size() const
+{
+	uint64_t size = sizeof(*this) + column_types_.capacity() + columns_.capacity() * sizeof(Column);
+	for(auto& column_name : column_names_)
+	{
+		// the name is held by column_names_ and column_lookup_
+		size += 2 * (sizeof(column_name) + column_name.capacity()) + 2 * sizeof(void*);
+	}
+
+	for(auto& column : columns_)
+	{
+		size += column.ints.capacity() * sizeof(uint32_t) + column.floats.capacity() * sizeof(float)
+			+ column.strings.capacity() * sizeof(std::string);
+		for(auto& value : column.strings)
+		{
+			size += value.capacity();
+		}
+	}
+	return size;
+}
+
+void DatatableVisitor::Serialize(swganh::ByteBuffer& buffer) const
+{
+	buffer.write<uint32_t>(column_names_.size());
+	for(auto& column_name : column_names_)
+	{
+		buffer.write(column_name);
+	}
+
+	buffer.write<uint32_t>(column_types_.size());
+	for(char column_type : column_types_)
+	{
+		buffer.write(column_type);
+	}
+
+	buffer.write<uint32_t>(row_count_);
+	for(size_t row = 0; row < row_count_; ++row)
+	{
+		for(auto& column : columns_)
 		{
-			if(column_types_[j] == 'i')
+			switch(column.type)
 			{
-				row.columns.push_back(buf.read<std::uint32_t>());
+			case 'i':
+				buffer.write(column.ints[row]);
+				break;
+			case 'f':
+				buffer.write(column.floats[row]);
+				break;
+			default:
+				buffer.write(column.strings[row]);
+				break;
 			}
-			else if(column_types_[j] == 'f')
+		}
+	}
+}
+
+void DatatableVisitor::Deserialize(swganh::ByteBuffer& buffer)
+{
+	//Read into a scratch table first, so a damaged buffer leaves this one unchanged
+	DatatableVisitor restored;
+
+	uint32_t count = buffer.read<uint32_t>();
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		restored.column_names_.push_back(buffer.read<std::string>());
+		restored.column_lookup_.insert(std::make_pair(restored.column_names_.back(), i));
+	}
+
+	count = buffer.read<uint32_t>();
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		char column_type = buffer.read<char>();
+		if(column_type != 'i' && column_type != 'f' && column_type != 's')
+		{
+			throw std::runtime_error("Invalid column type in cached datatable");
+		}
+		restored.column_types_.push_back(column_type);
+	}
+
+	uint32_t rows = buffer.read<uint32_t>();
+	restored.reset_columns_(rows);
+	for(uint32_t row = 0; row < rows; ++row)
+	{
+		for(auto& column : restored.columns_)
+		{
+			if(column.type == 'i')
 			{
-				row.columns.push_back(buf.read<float>());
+				column.ints.push_back(buffer.read<std::uint32_t>());
 			}
-			else if(column_types_[j] == 's')
+			else if(column.type == 'f')
 			{
-				row.columns.push_back(buf.read<std::string>(false, true));
+				column.floats.push_back(buffer.read<float>());
 			}
-			else if(column_types_[j] == 'b')
+			else
 			{
-				row.columns.push_back((buf.read<char>()) ? true : false);
+				column.strings.push_back(buffer.read<std::string>());
 			}
 		}
-		rows_.push_back(std::move(row));
 	}
-}
\ No newline at end of file
+	restored.row_count_ = rows;
+
+	column_names_ = std::move(restored.column_names_);
+	column_types_ = std::move(restored.column_types_);
+	column_lookup_ = std::move(restored.column_lookup_);
+	columns_ = std::move(restored.columns_);
+	indexes_ = std::move(restored.indexes_);
+	row_count_ = rows;
+}
@@ -4,22 +4,33 @@
 
 #include "../visitor_interface.h"
 
-#include <map>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <list>
+#include <unordered_map>
 #include <vector>
-#include <cstdint>
+
 #include <boost/any.hpp>
 
 namespace swganh
 {
 namespace tre
 {
+	/**
+		@brief An IFFVisitor for datatable iff files.
+
+		Cells are stored by column, each column is one contiguous vector of its type
+		('i' uint32_t, 'f' float or 's' std::string), so rows are accessed randomly
+		and a table costs a few allocations per column rather than one per cell.
+	*/
 	class DatatableVisitor : public VisitorInterface
 	{
 	public:
 		static const VisitorType Type = DATATABLE_VISITOR;
 
+		DatatableVisitor() : row_count_(0) {}
+
 		/**
 			@brief interprets a IFF::FileNode associated with this visitor.
 			This should only be called by the IFFFile code.
@@ -32,32 +43,123 @@ namespace tre
 		*/
 		virtual void visit_folder(uint32_t depth, std::string name, uint32_t size);
 
+		/**
+			@brief returns an estimate of the memory held by the columns.
+		*/
+		virtual uint64_t Size() const;
+
+		virtual uint32_t CacheVersion() const { return 1; }
+		virtual void Serialize(swganh::ByteBuffer& buffer) const;
+		virtual void Deserialize(swganh::ByteBuffer& buffer);
+
+		/**
+			@brief A view of one row of the table.
+		*/
 		class DATA_ROW
 		{
 		public:
+			DATA_ROW(const DatatableVisitor* table, size_t row) : table_(table), row_(row) {}
 
 			template <typename T>
-			T GetValue(int column_id) {
-				return boost::any_cast<T>(columns.at(column_id));
+			T GetValue(int column_id) const {
+				return table_->value<T>(row_, column_id);
 			}
 
-			std::vector<boost::any> columns;
+			boost::any GetAny(int column_id) const {
+				return table_->cell(row_, column_id);
+			}
+
+		private:
+			const DatatableVisitor* table_;
+			size_t row_;
 		};
 
-		const std::vector<std::string>& column_names() { return column_names_; }
-		const std::vector<char>& column_types() { return column_types_; }
-					
-		std::list<DATA_ROW>::iterator begin_itr() { return rows_.begin(); }
-		std::list<DATA_ROW>::iterator end_itr() { return rows_.end(); }
+		const std::vector<std::string>& column_names() const { return column_names_; }
+		const std::vector<char>& column_types() const { return column_types_; }
+
+		size_t row_count() const { return row_count_; }
+		DATA_ROW row(size_t row) const { return DATA_ROW(this, row); }
+
+		/**
+			@return the index of the named column, or -1 if there is none
+		*/
+		int column_index(const std::string& name) const;
+
+		/**
+			@return the cell at row and column, throws if the column holds another type
+		*/
+		template <typename T> const T& value(size_t row, size_t column) const;
+
+		/**
+			@return the cell at row and column wrapped in a boost::any
+		*/
+		boost::any cell(size_t row, size_t column) const;
+
+		/**
+			@return all cells of a column, throws if it holds another type
+		*/
+		const std::vector<uint32_t>& int_column(size_t column) const { return column_of_('i', column).ints; }
+		const std::vector<float>& float_column(size_t column) const { return column_of_('f', column).floats; }
+		const std::vector<std::string>& string_column(size_t column) const { return column_of_('s', column).strings; }
+
+		/**
+			@brief finds a row by the value of a key column. The column is hashed on
+			first use, later lookups are constant time.
+
+			@return the first row holding key, or -1 if there is none
+		*/
+		int find_row(size_t column, const std::string& key) const;
+		int find_row(size_t column, uint32_t key) const;
 
 	private:
+		struct Column
+		{
+			char type;
+			std::vector<uint32_t> ints;
+			std::vector<float> floats;
+			std::vector<std::string> strings;
+		};
+
+		struct KeyIndex
+		{
+			std::once_flag built;
+			std::unordered_map<std::string, size_t> strings;
+			std::unordered_map<uint32_t, size_t> ints;
+		};
+
 		void _handle0001COLS(swganh::ByteBuffer& buf);
 		void _handleTYPE(swganh::ByteBuffer& buf);
 		void _handleROWS(swganh::ByteBuffer& buf);
 
+		const Column& column_of_(char type, size_t column) const;
+		const KeyIndex& index_of_(size_t column) const;
+
+		// Sets up empty columns of the given types and reserves room for rows.
+		void reset_columns_(size_t rows);
+
 		std::vector<char> column_types_;
 		std::vector<std::string> column_names_;
-		std::list<DATA_ROW> rows_;
+		std::unordered_map<std::string, size_t> column_lookup_;
+
+		std::vector<Column> columns_;
+		size_t row_count_;
+
+		mutable std::vector<std::unique_ptr<KeyIndex>> indexes_;
 	};
+
+	template <> inline const uint32_t& DatatableVisitor::value<uint32_t>(size_t row, size_t column) const
+	{
+		return int_column(column).at(row);
+	}
+
+	template <> inline const float& DatatableVisitor::value<float>(size_t row, size_t column) const
+	{
+		return float_column(column).at(row);
+	}
+
+	template <> inline const std::string& DatatableVisitor::value<std::string>(size_t row, size_t column) const
+	{
+		return string_column(column).at(row);
+	}
 }
 }
@@ -0,0 +1,122 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/any.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "swganh/byte_buffer.h"
+#include "swganh/tre/iff/iff.h"
+#include "swganh/tre/iff/mock_iff_builder.h"
+#include "swganh/tre/visitors/datatables/datatable_visitor.h"
+
+using namespace swganh::tre;
+
+namespace {
+
+    struct CommandRow
+    {
+        const char* command_name;
+        float default_time;
+        uint32_t cooldown;
+        uint32_t god_level;
+    };
+
+    // the rows of the fixture, the expected values of every test
+    const CommandRow ROWS[] = {
+        {"burstrun", 1.5f, 300, 0},
+        {"kneel", 0.25f, 0, 1},
+        {"burstrun", 3.0f, 600, 1}
+    };
+
+    const size_t ROW_COUNT = sizeof(ROWS) / sizeof(ROWS[0]);
+
+    std::shared_ptr<DatatableVisitor> MakeDatatable()
+    {
+        MockIffBuilder builder;
+        builder
+            .Value<uint32_t>(4).Text("commandName").Text("defaultTime").Text("cooldown").Text("godLevel").Node("0001COLS")
+            .Text("s").Text("f").Text("i").Text("b").Node("TYPE")
+            .Value<uint32_t>(ROW_COUNT);
+
+        for (auto& row : ROWS)
+        {
+            builder.Text(row.command_name).Value<float>(row.default_time).Value<uint32_t>(row.cooldown).Value<uint32_t>(row.god_level);
+        }
+
+        auto iff = builder.Node("ROWS").Form();
+
+        swganh::ByteBuffer data(reinterpret_cast<const unsigned char*>(iff.data()), iff.size());
+        auto datatable = std::make_shared<DatatableVisitor>();
+        iff_file::loadIFF(data, datatable);
+        return datatable;
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(DatatableVisitorTest)
+
+/// This test shows that the typed columns and the boost::any interface both
+/// hand out the values the fixture was written with.
+BOOST_AUTO_TEST_CASE(TypedAndAnyValuesMatchTheFixture) {
+    auto datatable = MakeDatatable();
+
+    BOOST_REQUIRE_EQUAL(ROW_COUNT, datatable->row_count());
+    BOOST_REQUIRE_EQUAL(4u, datatable->column_names().size());
+    BOOST_CHECK_EQUAL("godLevel", datatable->column_names()[3]);
+    BOOST_CHECK_EQUAL('i', datatable->column_types()[3]);
+
+    for (size_t i = 0; i < ROW_COUNT; ++i)
+    {
+        auto& expected = ROWS[i];
+        auto row = datatable->row(i);
+
+        BOOST_CHECK_EQUAL(expected.command_name, row.GetValue<std::string>(0));
+        BOOST_CHECK_EQUAL(expected.command_name, boost::any_cast<std::string>(row.GetAny(0)));
+        BOOST_CHECK_EQUAL(expected.command_name, datatable->value<std::string>(i, 0));
+
+        BOOST_CHECK_EQUAL(expected.default_time, row.GetValue<float>(1));
+        BOOST_CHECK_EQUAL(expected.default_time, boost::any_cast<float>(row.GetAny(1)));
+        BOOST_CHECK_EQUAL(expected.default_time, datatable->value<float>(i, 1));
+
+        BOOST_CHECK_EQUAL(expected.cooldown, row.GetValue<uint32_t>(2));
+        BOOST_CHECK_EQUAL(expected.cooldown, boost::any_cast<uint32_t>(row.GetAny(2)));
+        BOOST_CHECK_EQUAL(expected.cooldown, datatable->int_column(2)[i]);
+
+        BOOST_CHECK_EQUAL(expected.god_level, row.GetValue<uint32_t>(3));
+        BOOST_CHECK_EQUAL(expected.god_level, boost::any_cast<uint32_t>(datatable->cell(i, 3)));
+    }
+}
+
+/// This test shows that rows are found by key and by column name.
+BOOST_AUTO_TEST_CASE(RowsAreFoundByKey) {
+    auto datatable = MakeDatatable();
+
+    BOOST_CHECK_EQUAL(2, datatable->column_index("cooldown"));
+    BOOST_CHECK_EQUAL(-1, datatable->column_index("missing"));
+
+    // the first row holding a key wins
+    BOOST_CHECK_EQUAL(0, datatable->find_row(0, std::string("burstrun")));
+    BOOST_CHECK_EQUAL(1, datatable->find_row(0, std::string("kneel")));
+    BOOST_CHECK_EQUAL(-1, datatable->find_row(0, std::string("prone")));
+
+    BOOST_CHECK_EQUAL(2, datatable->find_row(2, 600u));
+    BOOST_CHECK_EQUAL(-1, datatable->find_row(2, 5u));
+}
+
+/// This test shows that asking a column for another type than it holds throws.
+BOOST_AUTO_TEST_CASE(WrongTypesAreRejected) {
+    auto datatable = MakeDatatable();
+
+    BOOST_CHECK_THROW(datatable->row(0).GetValue<uint32_t>(0), std::runtime_error);
+    BOOST_CHECK_THROW(datatable->value<float>(0, 2), std::runtime_error);
+    BOOST_CHECK_THROW(datatable->find_row(1, std::string("burstrun")), std::runtime_error);
+    BOOST_CHECK_THROW(datatable->value<uint32_t>(3, 2), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -6,14 +6,50 @@ namespace swganh
 {
 namespace tre
 {
-	template <class T> T ObjectVisitor::attribute(const std::string& key)
+	namespace detail
 	{
-		std::map<std::string, std::shared_ptr<boost::any>>::const_iterator it = attributes_.find(key);
-		if(it != attributes_.cend())
+		inline const ObjectVisitor::AttributeValue& CheckAttribute(
+			const ObjectVisitor::AttributeValue* value, ObjectVisitor::AttributeValue::ValueType type)
 		{
-			return boost::any_cast<T>(*it->second);
+			if(value == nullptr || value->type != type)
+			{
+				throw std::runtime_error("Invalid type requested for attribute");
+			}
+			return *value;
 		}
-		throw std::runtime_error("Invalid type requested for attribute");
+	}
+
+	template <> inline std::string ObjectVisitor::attribute<std::string>(uint32_t key) const
+	{
+		auto found = FindAttribute_(key);
+		return found.first->String_(detail::CheckAttribute(found.second, AttributeValue::STRING).string_index);
+	}
+
+	template <> inline uint32_t ObjectVisitor::attribute<uint32_t>(uint32_t key) const
+	{
+		return detail::CheckAttribute(FindAttribute_(key).second, AttributeValue::UINT32).uint32_value;
+	}
+
+	template <> inline float ObjectVisitor::attribute<float>(uint32_t key) const
+	{
+		return detail::CheckAttribute(FindAttribute_(key).second, AttributeValue::FLOAT).float_value;
+	}
+
+	template <> inline bool ObjectVisitor::attribute<bool>(uint32_t key) const
+	{
+		return detail::CheckAttribute(FindAttribute_(key).second, AttributeValue::BOOL).bool_value;
+	}
+
+	template <> inline std::shared_ptr<ObjectVisitor::ClientString>
+		ObjectVisitor::attribute<std::shared_ptr<ObjectVisitor::ClientString>>(uint32_t key) const
+	{
+		auto found = FindAttribute_(key);
+		auto& value = detail::CheckAttribute(found.second, AttributeValue::CLIENT_STRING);
+
+		auto client_string = std::make_shared<ClientString>();
+		client_string->file = found.first->String_(value.string_index);
+		client_string->entry = found.first->String_(value.entry_index);
+		return client_string;
 	}
 }
 }
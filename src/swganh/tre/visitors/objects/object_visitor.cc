@@ -7,6 +7,10 @@
 
 #include <swganh/tre/resource_manager.h>
 
+#include <algorithm>
+
+#include <boost/thread/lock_guard.hpp>
+
 using namespace swganh::tre;
 using namespace std;
 using namespace std::placeholders;
@@ -156,16 +160,21 @@ void ObjectVisitor::_handleClientString(ObjectVisitor* dst, string& name, swganh
 {
 	if(buf.read<char>())
 	{
-		shared_ptr<ClientString> cs = make_shared<ClientString>();
+		std::string file, entry;
 		if(buf.read<char>())
 		{
-			cs->file = buf.read<std::string>(false,true);
+			file = buf.read<std::string>(false,true);
 			if(buf.read<char>())
 			{
-				cs->entry = buf.read<std::string>(false,true);
+				entry = buf.read<std::string>(false,true);
 			}
 		}
-		dst->attributes_.insert(AttributeMap::value_type(move(name), std::make_shared<boost::any>(cs)));
+
+		AttributeValue value;
+		value.type = AttributeValue::CLIENT_STRING;
+		value.string_index = dst->AddString_(move(file));
+		value.entry_index = dst->AddString_(move(entry));
+		dst->AddAttribute_(name, value);
 	}
 }
 
@@ -173,7 +182,10 @@ void ObjectVisitor::_handleString(ObjectVisitor* dst, string& name, swganh::Byte
 {
 	if(buf.read<char>())
 	{
-		dst->attributes_.insert(AttributeMap::value_type(move(name), std::make_shared<boost::any>(buf.read<std::string>(false,true))));
+		AttributeValue value;
+		value.type = AttributeValue::STRING;
+		value.string_index = dst->AddString_(buf.read<std::string>(false,true));
+		dst->AddAttribute_(name, value);
 	}
 }
 
@@ -182,8 +194,10 @@ void ObjectVisitor::_handleInt(ObjectVisitor* dst, string& name, swganh::ByteBuf
 	if(buf.read<char>())
 	{
 		buf.read<char>();
-		uint32_t buffer = buf.read<uint32_t>();
-		dst->attributes_.insert(AttributeMap::value_type(move(name), std::make_shared<boost::any>(buffer)));
+		AttributeValue value;
+		value.type = AttributeValue::UINT32;
+		value.uint32_value = buf.read<uint32_t>();
+		dst->AddAttribute_(name, value);
 	}
 }
 
@@ -192,8 +206,10 @@ void ObjectVisitor::_handleFloat(ObjectVisitor* dst, string& name, swganh::ByteB
 	if(buf.read<char>())
 	{
 		buf.read<char>();
-		float buffer = buf.read<float>();
-		dst->attributes_.insert(AttributeMap::value_type(move(name), std::make_shared<boost::any>(buffer)));
+		AttributeValue value;
+		value.type = AttributeValue::FLOAT;
+		value.float_value = buf.read<float>();
+		dst->AddAttribute_(name, value);
 	}
 }
 
@@ -201,7 +217,10 @@ void ObjectVisitor::_handleBool(ObjectVisitor* dst, string& name, swganh::ByteBu
 {
 	if(buf.read<char>())
 	{
-		dst->attributes_.insert(AttributeMap::value_type(move(name), std::make_shared<boost::any>((buf.read<char>()) ? true : false)));
+		AttributeValue value;
+		value.type = AttributeValue::BOOL;
+		value.bool_value = (buf.read<char>()) ? true : false;
+		dst->AddAttribute_(name, value);
 	}
 }
 
@@ -212,49 +231,185 @@ void ObjectVisitor::_handleUnhandled(ObjectVisitor* dst, std::string& name, swga
 
 void ObjectVisitor::load_aggregate_data(swganh::tre::ResourceManager* f)
 {
+	boost::lock_guard<boost::mutex> lock(aggregate_mutex_);
 	if(!has_aggregate_)
 	{
-		AttributeMap aggregateAttributeMap;
+		//Parents are only linked, lookups fall through to them.
+		std::vector<std::shared_ptr<ObjectVisitor>> parents;
+		for(auto& parentFile : parentFiles)
+		{
+			auto parent = f->GetResourceByName<ObjectVisitor>(parentFile);
+			parent->load_aggregate_data(f);
+			parents.push_back(move(parent));
+		}
+
+		parents_ = move(parents);
+		has_aggregate_ = true;
+	}
+}
+
+std::pair<const ObjectVisitor*, const ObjectVisitor::AttributeValue*> ObjectVisitor::FindAttribute_(uint32_t key) const
+{
+	auto it = attributes_.find(key);
+	if(it != attributes_.end())
+	{
+		return std::make_pair(this, &it->second);
+	}
 
-		std::for_each(parentFiles.begin(), parentFiles.end(), [&] (std::string parentFile)
+	for(auto parent = parents_.rbegin(); parent != parents_.rend(); ++parent)
+	{
+		auto found = (*parent)->FindAttribute_(key);
+		if(found.second != nullptr)
 		{
-			auto subI = f->GetResourceByName<ObjectVisitor>(parentFile);
-
-			subI->load_aggregate_data(f);
-
-			//Now we continue to build up our map.
-			std::for_each(subI->attributes_.begin(), subI->attributes_.end(), [&] (AttributeMap::value_type pair) {
-				AttributeMap::iterator lb = aggregateAttributeMap.lower_bound(pair.first);
-				if(lb != aggregateAttributeMap.end() && !(aggregateAttributeMap.key_comp()(pair.first, lb->first)))
-				{
-					lb->second = pair.second;
-				}
-				else
-				{
-					aggregateAttributeMap.insert(lb, AttributeMap::value_type(pair.first, pair.second));
-				}
-			});
-		});
-
-		std::for_each(attributes_.begin(), attributes_.end(), [&] (AttributeMap::value_type pair) {
-			AttributeMap::iterator lb = aggregateAttributeMap.lower_bound(pair.first);
-			if(lb != aggregateAttributeMap.end() && !(aggregateAttributeMap.key_comp()(pair.first, lb->first)))
-			{
-				lb->second = pair.second;
-			}
-			else
-			{
-				aggregateAttributeMap.insert(lb, AttributeMap::value_type(pair.first, pair.second));    // Use lb as a hint to insert,
-																// so it can avoid another lookup
-			}
-		});
+			return found;
+		}
+	}
+
+	return std::pair<const ObjectVisitor*, const AttributeValue*>(nullptr, nullptr);
+}
+
+std::vector<uint32_t> ObjectVisitor::attribute_ids() const
+{
+	std::vector<uint32_t> ids;
+	for(auto& parent : parents_)
+	{
+		auto parent_ids = parent->attribute_ids();
+		ids.insert(ids.end(), parent_ids.begin(), parent_ids.end());
+	}
+
+	for(auto& attribute : attributes_)
+	{
+		ids.push_back(attribute.first);
+	}
+
+	std::sort(ids.begin(), ids.end());
+	ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+	return ids;
+}
+
+void ObjectVisitor::AddAttribute_(const std::string& name, AttributeValue value)
+{
+	attributes_.insert(AttributeMap::value_type(swganh::StringInterner::getInstance().Intern(name), value));
+}
+
+uint32_t ObjectVisitor::AddString_(std::string value)
+{
+	strings_.push_back(move(value));
+	return static_cast<uint32_t>(strings_.size() - 1);
+}
 
-		attributes_ = std::move(aggregateAttributeMap);
-		has_aggregate_ = true;		
+const std::string& ObjectVisitor::String_(uint32_t index) const
+{
+	return strings_.at(index);
+}
+
+uint64_t ObjectVisitor::Size() const
+{
+	uint64_t size = sizeof(*this) + attributes_.size() * sizeof(AttributeMap::value_type)
+		+ strings_.capacity() * sizeof(std::string)
+		+ parents_.capacity() * sizeof(std::shared_ptr<ObjectVisitor>);
+	for(auto& value : strings_)
+	{
+		size += value.capacity();
+	}
+
+	for(auto& parent : parentFiles)
+	{
+		size += sizeof(parent) + 4 * sizeof(void*) + parent.capacity();
 	}
+	return size;
 }
 
-bool ObjectVisitor::has_attribute(const std::string& key)
+void ObjectVisitor::Serialize(swganh::ByteBuffer& buffer) const
 {
-	return attributes_.find(key) != attributes_.end();
-}
\ No newline at end of file
+	auto& interner = swganh::StringInterner::getInstance();
+
+	buffer.write<uint32_t>(attributes_.size());
+	for(auto& attribute : attributes_)
+	{
+		auto& value = attribute.second;
+
+		buffer.write(interner.Lookup(attribute.first));
+		buffer.write<uint8_t>(value.type);
+		switch(value.type)
+		{
+		case AttributeValue::CLIENT_STRING:
+			buffer.write(String_(value.string_index));
+			buffer.write(String_(value.entry_index));
+			break;
+		case AttributeValue::STRING:
+			buffer.write(String_(value.string_index));
+			break;
+		case AttributeValue::UINT32:
+			buffer.write(value.uint32_value);
+			break;
+		case AttributeValue::FLOAT:
+			buffer.write(value.float_value);
+			break;
+		case AttributeValue::BOOL:
+			buffer.write<uint8_t>(value.bool_value);
+			break;
+		}
+	}
+
+	buffer.write<uint32_t>(parentFiles.size());
+	for(auto& parent : parentFiles)
+	{
+		buffer.write(parent);
+	}
+
+	buffer.write<uint8_t>(loaded_reference_);
+}
+
+void ObjectVisitor::Deserialize(swganh::ByteBuffer& buffer)
+{
+	//Parsed into a scratch visitor first, so a damaged buffer leaves this one unchanged
+	ObjectVisitor restored;
+
+	uint32_t count = buffer.read<uint32_t>();
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		std::string name = buffer.read<std::string>();
+
+		AttributeValue value;
+		value.type = static_cast<AttributeValue::ValueType>(buffer.read<uint8_t>());
+		switch(value.type)
+		{
+		case AttributeValue::CLIENT_STRING:
+			value.string_index = restored.AddString_(buffer.read<std::string>());
+			value.entry_index = restored.AddString_(buffer.read<std::string>());
+			break;
+		case AttributeValue::STRING:
+			value.string_index = restored.AddString_(buffer.read<std::string>());
+			break;
+		case AttributeValue::UINT32:
+			value.uint32_value = buffer.read<uint32_t>();
+			break;
+		case AttributeValue::FLOAT:
+			value.float_value = buffer.read<float>();
+			break;
+		case AttributeValue::BOOL:
+			value.bool_value = buffer.read<uint8_t>() != 0;
+			break;
+		default:
+			throw std::runtime_error("Invalid attribute type in cached object template");
+		}
+
+		restored.AddAttribute_(name, value);
+	}
+
+	count = buffer.read<uint32_t>();
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		restored.parentFiles.insert(buffer.read<std::string>());
+	}
+
+	bool loaded_reference = buffer.read<uint8_t>() != 0;
+
+	attributes_ = std::move(restored.attributes_);
+	strings_ = std::move(restored.strings_);
+	parentFiles = std::move(restored.parentFiles);
+	parents_.clear();
+	has_aggregate_ = false;
+	loaded_reference_ = loaded_reference;
+}
@@ -10,7 +10,13 @@
 #include <functional>
 #include <cstdint>
 #include <memory>
-#include <boost/any.hpp>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include "swganh/flat_map.h"
+#include "swganh/string_interner.h"
 
 namespace swganh
 {
@@ -32,11 +38,14 @@ namespace tre
 	typedef std::function<void(ObjectVisitor*, std::string&, swganh::ByteBuffer&)> AttributeFunctor;
 	typedef std::map<std::string, AttributeFunctor> AttributeHandlerIndex;
 	typedef std::map<std::string, AttributeFunctor>::const_iterator AttributeHandlerIndexIterator;
-	typedef std::map<std::string, std::shared_ptr<boost::any>> AttributeMap;
 	//End Typedefs
 
 	/**
 		@brief An IFFVisitor for object iff files.
+
+		Attributes are kept in a sorted flat array keyed by the interned attribute name.
+		A derived template only stores the attributes it sets itself and falls back to
+		its parents for the rest, so nothing is copied when the templates are linked.
 	*/
 	class ObjectVisitor : public VisitorInterface
 	{
@@ -60,6 +69,15 @@ namespace tre
 		*/
 		virtual void visit_folder(uint32_t depth, std::string name, uint32_t size);
 
+		/**
+			@brief returns an estimate of the memory held by the attributes.
+		*/
+		virtual uint64_t Size() const;
+
+		virtual uint32_t CacheVersion() const { return 2; }
+		virtual void Serialize(swganh::ByteBuffer& buffer) const;
+		virtual void Deserialize(swganh::ByteBuffer& buffer);
+
 		/**
 			@brief An internal ClientString structure. This could later be moved outside this class.
 			It is merely here now for completeness.
@@ -72,15 +90,50 @@ namespace tre
 		};
 
 		/**
-			@brief returns an attribute loaded from the object iff associated with this interpreter.
+			@brief A tagged attribute value, strings are indexes into the string table
+			of the template that set the attribute.
+		*/
+		struct AttributeValue
+		{
+			enum ValueType : uint8_t { CLIENT_STRING, STRING, UINT32, FLOAT, BOOL };
+
+			ValueType type;
+			union
+			{
+				uint32_t string_index;	// STRING, the file of a CLIENT_STRING
+				uint32_t uint32_value;
+				float float_value;
+				bool bool_value;
+			};
+			uint32_t entry_index;		// the entry of a CLIENT_STRING
+		};
+
+		typedef swganh::FlatMap<uint32_t, AttributeValue> AttributeMap;
 
-			@param key the key to lookup
+		/**
+			@brief returns an attribute loaded from the object iff associated with this
+			interpreter or one of its parents. Supported types are std::string, uint32_t,
+			float, bool and std::shared_ptr<ClientString>.
 
-			@return a boost::any casted shared_ptr<T> that was requested
+			@param key the key to lookup, or its id from AttributeId
+
+			@return the requested value, throws if it is missing or of another type
 		*/
-		template <class T> T attribute(const std::string& key);
+		template <class T> T attribute(const std::string& key) const { return attribute<T>(AttributeId(key)); }
+		template <class T> T attribute(uint32_t key) const;
 		
-		bool has_attribute(const std::string& key);
+		bool has_attribute(const std::string& key) const { return has_attribute(AttributeId(key)); }
+		bool has_attribute(uint32_t key) const { return FindAttribute_(key).second != nullptr; }
+
+		/**
+			@return the ids of every attribute this template resolves, set by itself or inherited
+		*/
+		std::vector<uint32_t> attribute_ids() const;
+
+		/**
+			@return the id attributes named key are stored under
+		*/
+		static uint32_t AttributeId(const std::string& key) { return swganh::StringInterner::Hash(key); }
 
 		std::uint32_t attribute_uint32(std::string& key);
 		float attribute_float(std::string& key);
@@ -111,13 +164,27 @@ namespace tre
 		void _handleXXXX(swganh::ByteBuffer& buf);
 		void _handleDERVXXXX(swganh::ByteBuffer& buf);
 
-		//Attributes this object iff might have
+		//Returns the template that set the attribute and its value, or nullptrs
+		std::pair<const ObjectVisitor*, const AttributeValue*> FindAttribute_(uint32_t key) const;
+
+		//Adds an attribute, the first value of an attribute wins
+		void AddAttribute_(const std::string& name, AttributeValue value);
+		uint32_t AddString_(std::string value);
+
+		const std::string& String_(uint32_t index) const;
+
+		//Attributes set by this object iff, sorted by id
 		AttributeMap attributes_;
+		std::vector<std::string> strings_;
 
 		//Parent files this object iff might have
 		std::set<std::string> parentFiles;
 
+		//Linked by load_aggregate_data, later parents override earlier ones
+		std::vector<std::shared_ptr<ObjectVisitor>> parents_;
+
 		//Stored for determing if we've already loaded our aggregate information.
+		boost::mutex aggregate_mutex_;
 		bool has_aggregate_;
 		bool loaded_reference_;
 	};
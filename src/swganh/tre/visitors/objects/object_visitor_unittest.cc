@@ -0,0 +1,96 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "swganh/tre/iff/mock_iff_builder.h"
+#include "swganh/tre/mock_tre_file.h"
+#include "swganh/tre/resource_manager.h"
+#include "swganh/tre/visitors/objects/object_visitor.h"
+
+using namespace swganh::tre;
+
+namespace {
+
+    const char* BASE_TEMPLATE = "object/tangible/shared_base_tangible.iff";
+    const char* MEDICINE_TEMPLATE = "object/tangible/medicine/shared_base_medicine.iff";
+    const char* STIMPACK_TEMPLATE = "object/tangible/medicine/shared_stimpack.iff";
+
+    std::shared_ptr<TreArchive> MakeArchive(MockTreFile& tre_file)
+    {
+        tre_file.AddResource(BASE_TEMPLATE, MockIffBuilder()
+            .Text("appearanceFilename").Byte(1).Text("appearance/defaultappearance.apt").Node("XXXX")
+            .Text("collisionActionFlags").Byte(1).Byte(0).Value<uint32_t>(1).Node("XXXX")
+            .Text("collisionHeight").Byte(1).Byte(0).Value<float>(1.0f).Node("XXXX")
+            .Text("hasWings").Byte(1).Byte(0).Node("XXXX")
+            .Form());
+
+        tre_file.AddResource(MEDICINE_TEMPLATE, MockIffBuilder()
+            .Text(BASE_TEMPLATE).Node("DERVXXXX")
+            .Text("collisionHeight").Byte(1).Byte(0).Value<float>(0.5f).Node("XXXX")
+            .Text("objectName").Byte(1).Byte(1).Text("item_n").Byte(1).Text("medicine").Node("XXXX")
+            .Form());
+
+        tre_file.AddResource(STIMPACK_TEMPLATE, MockIffBuilder()
+            .Text(MEDICINE_TEMPLATE).Node("DERVXXXX")
+            .Text("appearanceFilename").Byte(1).Text("appearance/stimpack.apt").Node("XXXX")
+            .Text("objectName").Byte(1).Byte(1).Text("item_n").Byte(1).Text("stimpack").Node("XXXX")
+            .Form());
+
+        tre_file.Write();
+
+        std::vector<std::string> files;
+        files.push_back(tre_file.GetPath());
+        return std::make_shared<TreArchive>(std::move(files));
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ObjectVisitorTest)
+
+/// This test shows that a derived template sees its own attributes first and
+/// those of its parents, nearest parent first, for the rest.
+BOOST_AUTO_TEST_CASE(DerivedTemplatesOverrideTheirParents) {
+    MockTreFile tre_file;
+    ResourceManager manager(MakeArchive(tre_file));
+
+    auto stimpack = manager.GetResourceByName<ObjectVisitor>(STIMPACK_TEMPLATE);
+    BOOST_CHECK(!stimpack->has_attribute("collisionHeight"));
+
+    stimpack->load_aggregate_data(&manager);
+
+    BOOST_CHECK_EQUAL("appearance/stimpack.apt", stimpack->attribute<std::string>("appearanceFilename"));
+    BOOST_CHECK_EQUAL("stimpack", stimpack->attribute<std::shared_ptr<ObjectVisitor::ClientString>>("objectName")->entry);
+    BOOST_CHECK_EQUAL(0.5f, stimpack->attribute<float>("collisionHeight"));
+    BOOST_CHECK_EQUAL(1u, stimpack->attribute<uint32_t>("collisionActionFlags"));
+    BOOST_CHECK_EQUAL(false, stimpack->attribute<bool>("hasWings"));
+    BOOST_CHECK(!stimpack->has_attribute("collisionLength"));
+
+    // parents are shared, not changed by their children
+    auto medicine = manager.GetResourceByName<ObjectVisitor>(MEDICINE_TEMPLATE);
+    BOOST_CHECK_EQUAL("medicine", medicine->attribute<std::shared_ptr<ObjectVisitor::ClientString>>("objectName")->entry);
+    BOOST_CHECK_EQUAL("appearance/defaultappearance.apt", medicine->attribute<std::string>("appearanceFilename"));
+
+    // lookups by id find the same values
+    BOOST_CHECK_EQUAL(0.5f, stimpack->attribute<float>(ObjectVisitor::AttributeId("collisionHeight")));
+}
+
+/// This test shows that missing attributes and mismatched types are rejected.
+BOOST_AUTO_TEST_CASE(InvalidRequestsThrow) {
+    MockTreFile tre_file;
+    ResourceManager manager(MakeArchive(tre_file));
+
+    auto stimpack = manager.GetResourceByName<ObjectVisitor>(STIMPACK_TEMPLATE);
+    stimpack->load_aggregate_data(&manager);
+
+    BOOST_CHECK_THROW(stimpack->attribute<float>("appearanceFilename"), std::runtime_error);
+    BOOST_CHECK_THROW(stimpack->attribute<std::string>("collisionLength"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -147,4 +147,26 @@ void PobVisitor::debug()
 			printf("%d\n", static_cast<int>(p.vertices.size()));
 		}
 	});*/
-}
\ No newline at end of file
+}
+
+uint64_t PobVisitor::Size() const
+{
+	uint64_t size = sizeof(*this) + portals_.capacity() * sizeof(Portal) + cells_.capacity() * sizeof(Cell);
+	for(auto& portal : portals_)
+	{
+		size += portal.vertices.capacity() * sizeof(glm::vec3);
+	}
+
+	for(auto& cell : cells_)
+	{
+		size += cell.name.capacity() + cell.mesh.capacity() + cell.collision.capacity()
+			+ cell.vertices.capacity() * sizeof(glm::vec3)
+			+ cell.triangles.capacity() * sizeof(triangle)
+			+ cell.links.capacity() * sizeof(Link);
+		for(auto& link : cell.links)
+		{
+			size += link.doorname.capacity();
+		}
+	}
+	return size;
+}
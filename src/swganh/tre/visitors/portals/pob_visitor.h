@@ -46,6 +46,11 @@ namespace tre
 		*/
 		virtual void visit_folder(uint32_t depth, std::string name, uint32_t size);
 
+		/**
+			@brief returns an estimate of the memory held by the portals and cells.
+		*/
+		virtual uint64_t Size() const;
+
 		/**
 			@brief A portal object used inside the POB files.
 		*/
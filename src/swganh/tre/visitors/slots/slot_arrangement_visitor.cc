@@ -24,4 +24,47 @@ void SlotArrangementVisitor::visit_data(uint32_t depth, std::string name, uint32
 		}
 		combinations_.push_back(std::move(combination));
 	}
-}
\ No newline at end of file
+}
+
+uint64_t SlotArrangementVisitor::Size() const
+{
+	uint64_t size = sizeof(*this);
+	for(auto& combination : combinations_)
+	{
+		size += sizeof(combination) + 2 * sizeof(void*) + combination.capacity() * sizeof(std::string);
+		for(auto& slot : combination)
+		{
+			size += slot.capacity();
+		}
+	}
+	return size;
+}
+
+void SlotArrangementVisitor::Serialize(swganh::ByteBuffer& buffer) const
+{
+	buffer.write<uint32_t>(combinations_.size());
+	for(auto& combination : combinations_)
+	{
+		buffer.write<uint32_t>(combination.size());
+		for(auto& slot : combination)
+		{
+			buffer.write(slot);
+		}
+	}
+}
+
+void SlotArrangementVisitor::Deserialize(swganh::ByteBuffer& buffer)
+{
+	std::list<std::vector<std::string>> combinations;
+	uint32_t count = buffer.read<uint32_t>();
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		std::vector<std::string> combination(buffer.read<uint32_t>());
+		for(auto& slot : combination)
+		{
+			slot = buffer.read<std::string>();
+		}
+		combinations.push_back(std::move(combination));
+	}
+	combinations_ = std::move(combinations);
+}
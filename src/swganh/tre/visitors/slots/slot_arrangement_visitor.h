@@ -33,6 +33,15 @@ namespace tre
 		*/
 		virtual void visit_folder(uint32_t depth, std::string name, uint32_t size);
 
+		/**
+			@brief returns an estimate of the memory held by the combinations.
+		*/
+		virtual uint64_t Size() const;
+
+		virtual uint32_t CacheVersion() const { return 1; }
+		virtual void Serialize(swganh::ByteBuffer& buffer) const;
+		virtual void Deserialize(swganh::ByteBuffer& buffer);
+
 		//const std::vector<std::string>& slots_occupied(size_t id) { return combinations_[id]; };
 
 		std::list<std::vector<std::string>>::const_iterator begin() {return combinations_.cbegin();}
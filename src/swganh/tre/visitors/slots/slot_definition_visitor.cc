@@ -43,4 +43,43 @@ size_t SlotDefinitionVisitor::findSlotByName(const std::string& name)
 			return i;
 	}
 	return -1;
-}
\ No newline at end of file
+}
+
+uint64_t SlotDefinitionVisitor::Size() const
+{
+	uint64_t size = sizeof(*this) + slots_.capacity() * sizeof(slot_entry);
+	for(auto& slot : slots_)
+	{
+		size += slot.name.capacity() + slot.hardpoint_name.capacity();
+	}
+	return size;
+}
+
+void SlotDefinitionVisitor::Serialize(swganh::ByteBuffer& buffer) const
+{
+	buffer.write<uint32_t>(slots_.size());
+	for(auto& slot : slots_)
+	{
+		buffer.write(slot.name);
+		buffer.write<uint8_t>(slot.global);
+		buffer.write<uint8_t>(slot.canMod);
+		buffer.write<uint8_t>(slot.exclusive);
+		buffer.write(slot.hardpoint_name);
+		buffer.write(slot.unkValue);
+	}
+}
+
+void SlotDefinitionVisitor::Deserialize(swganh::ByteBuffer& buffer)
+{
+	std::vector<slot_entry> slots(buffer.read<uint32_t>());
+	for(auto& slot : slots)
+	{
+		slot.name = buffer.read<std::string>();
+		slot.global = buffer.read<uint8_t>() != 0;
+		slot.canMod = buffer.read<uint8_t>() != 0;
+		slot.exclusive = buffer.read<uint8_t>() != 0;
+		slot.hardpoint_name = buffer.read<std::string>();
+		slot.unkValue = buffer.read<std::uint32_t>();
+	}
+	slots_ = std::move(slots);
+}
@@ -28,6 +28,15 @@ namespace tre
 		*/
 		virtual void visit_folder(uint32_t depth, std::string name, uint32_t size);
 
+		/**
+			@brief returns an estimate of the memory held by the slot entries.
+		*/
+		virtual uint64_t Size() const;
+
+		virtual uint32_t CacheVersion() const { return 1; }
+		virtual void Serialize(swganh::ByteBuffer& buffer) const;
+		virtual void Deserialize(swganh::ByteBuffer& buffer);
+
 		struct slot_entry
 		{
 			std::string name;
@@ -22,4 +22,33 @@ void SlotDescriptorVisitor::visit_data(uint32_t depth, std::string name, uint32_
 			slots_available.push_back(data.read<std::string>(false, true));
 		}
 	}
-}
\ No newline at end of file
+}
+
+uint64_t SlotDescriptorVisitor::Size() const
+{
+	uint64_t size = sizeof(*this) + slots_available.capacity() * sizeof(std::string);
+	for(auto& slot : slots_available)
+	{
+		size += slot.capacity();
+	}
+	return size;
+}
+
+void SlotDescriptorVisitor::Serialize(swganh::ByteBuffer& buffer) const
+{
+	buffer.write<uint32_t>(slots_available.size());
+	for(auto& slot : slots_available)
+	{
+		buffer.write(slot);
+	}
+}
+
+void SlotDescriptorVisitor::Deserialize(swganh::ByteBuffer& buffer)
+{
+	std::vector<std::string> slots(buffer.read<uint32_t>());
+	for(auto& slot : slots)
+	{
+		slot = buffer.read<std::string>();
+	}
+	slots_available = std::move(slots);
+}
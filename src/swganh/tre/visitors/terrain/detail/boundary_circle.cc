@@ -49,4 +49,21 @@ float BoundaryCircle::Process(float px, float pz)
 	//std::cout << "BCIR(" << this << ")::PROCESS("<< px << "," << pz << "=" << result <<")" << std::endl;
 
 	return result;
-}
\ No newline at end of file
+}
+
+void BoundaryCircle::ProcessBatch(const float* px, const float* pz, size_t count, float* results)
+{
+	float r2 = pow(rad,2);
+	float fCircle = (float) pow((1.0 - feather_amount) * rad,2);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		float dist = pow(px[i]-x,2) + pow(pz[i]-z,2);
+
+		float result = 0.0f;
+		if (dist <= r2)
+			result = (dist > fCircle) ? 1.0f - (dist - fCircle) / (r2 - fCircle) : 1.0f;
+
+		results[i] = result;
+	}
+}
@@ -21,6 +21,7 @@ namespace tre
 		virtual void Deserialize(swganh::ByteBuffer& buffer);
 		virtual bool IsContained(float px, float pz);
 		virtual float Process(float px, float pz);
+		virtual void ProcessBatch(const float* px, const float* pz, size_t count, float* results);
 		
 	protected:
 		float x,z;
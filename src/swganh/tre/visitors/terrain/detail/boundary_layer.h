@@ -18,6 +18,17 @@ namespace tre
 
 		virtual bool IsContained(float px, float pz) = 0;
 		virtual float Process(float px, float pz) = 0;
+
+		/**
+			Process for count points at once, the points are given as separate x and z arrays.
+		*/
+		virtual void ProcessBatch(const float* px, const float* pz, size_t count, float* results)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				results[i] = Process(px[i], pz[i]);
+			}
+		}
 		
 		uint32_t feather_type;
 		float feather_amount;
@@ -25,6 +25,8 @@ namespace tre
 		virtual void Deserialize(swganh::ByteBuffer& buffer);
 		virtual bool IsContained(float px, float pz);
 		virtual float Process(float px, float pz);
+
+		const std::vector<glm::vec2>& GetVertices() const { return verts; }
 		
 		uint32_t use_water_height;
 		float water_height;
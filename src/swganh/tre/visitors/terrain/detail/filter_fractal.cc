@@ -20,13 +20,29 @@ void FractalFilter::Deserialize(swganh::ByteBuffer& buffer)
 	step = buffer.read<float>();
 }
 
-float FractalFilter::Process(float x, float z, float transform_value, float& base_value, std::map<uint32_t,Fractal*>& fractals)
+float FractalFilter::Process(float x, float z, float transform_value, float& base_value, const std::map<uint32_t,Fractal*>& fractals)
 {
 	//std::cout << "FFRA::PROCESS("<< x << "," << z <<")" << std::endl;
 	
 	Fractal* fractal = fractals.find(fractal_id)->second;
 
-	float noise_result = fractal->getNoise(x, z) * step;
+	return Filter(fractal->getNoise(x, z) * step);
+}
+
+void FractalFilter::ProcessBatch(const float* x, const float* z, const float* transform_values, const float* base_values, size_t count, float* results, const std::map<uint32_t,Fractal*>& fractals)
+{
+	Fractal* fractal = fractals.find(fractal_id)->second;
+
+	fractal->getNoise(x, z, count, results);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		results[i] = Filter(results[i] * step);
+	}
+}
+
+float FractalFilter::Filter(float noise_result)
+{
 	float result = 0;
 
 	if (noise_result > min && noise_result < max) {
@@ -43,4 +59,4 @@ float FractalFilter::Process(float x, float z, float transform_value, float& bas
 		result = 0;
 
 	return result;
-}
\ No newline at end of file
+}
@@ -19,9 +19,13 @@ namespace tre
 		
 		virtual void Deserialize(swganh::ByteBuffer& buffer);
 
-		virtual float Process(float x, float z, float transform_value, float& base_value, std::map<uint32_t,Fractal*>& fractals);
+		virtual float Process(float x, float z, float transform_value, float& base_value, const std::map<uint32_t,Fractal*>& fractals);
+
+		virtual void ProcessBatch(const float* x, const float* z, const float* transform_values, const float* base_values, size_t count, float* results, const std::map<uint32_t,Fractal*>& fractals);
 
 	private:
+		float Filter(float noise_result);
+
 		uint32_t fractal_id;
 		float min, max, step;
 	};
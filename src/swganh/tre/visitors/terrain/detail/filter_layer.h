@@ -18,7 +18,19 @@ namespace tre
 
 		virtual LayerType GetType() { return LAYER_TYPE_FILTER; }
 
-		virtual float Process(float x, float z, float transform_value, float& base_value, std::map<uint32_t,Fractal*>& fractals) = 0;
+		virtual float Process(float x, float z, float transform_value, float& base_value, const std::map<uint32_t,Fractal*>& fractals) = 0;
+
+		/**
+			Process for count points at once, every argument is an array of count values.
+		*/
+		virtual void ProcessBatch(const float* x, const float* z, const float* transform_values, const float* base_values, size_t count, float* results, const std::map<uint32_t,Fractal*>& fractals)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				float base_value = base_values[i];
+				results[i] = Process(x[i], z[i], transform_values[i], base_value, fractals);
+			}
+		}
 		
 		int   feather_type;
         float feather_amount;
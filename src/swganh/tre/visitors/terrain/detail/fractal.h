@@ -4,6 +4,7 @@
 
 #include <string>
 #include <iostream>
+#include <vector>
 
 #include "swganh/byte_buffer.h"
 #include "random.h"
@@ -131,6 +132,90 @@ namespace tre
 				break;
 			}
 
+			return shapeNoise(result);
+		}
+
+		// Generate noise for count points given as separate x and z arrays, the
+		// results are the same as those of getNoise for each point.
+		void getNoise(const float* x, const float* z, size_t count, float* results)
+		{
+			if (count == 0)
+				return;
+
+			std::vector<float> x_offsets(count), z_offsets(count), noise_values(count), noise_gen(count, 0.0f);
+			std::vector<double> x_coords(count), z_coords(count);
+
+			for (size_t k = 0; k < count; ++k)
+			{
+				float xFrequency = x[k] * freq_x;
+				float zFrequency = z[k] * freq_z;
+
+				x_offsets[k] = xFrequency + offset_x;
+
+				// combination 1 takes z as a double and adds the offset in double precision
+				if (combination_type <= 1)
+					z_offsets[k] = (float)( (double)zFrequency + offset_z);
+				else
+					z_offsets[k] = zFrequency + offset_z;
+			}
+
+			float curr_offset = 1.0, curr_ampl = 1.0;
+
+			for (unsigned int i = 0; i < octaves && combination_type <= 5; ++i)
+			{
+				for (size_t k = 0; k < count; ++k)
+				{
+					x_coords[k] = x_offsets[k] * curr_offset;
+					z_coords[k] = z_offsets[k] * curr_offset;
+				}
+
+				noise.noise2(&x_coords[0], &z_coords[0], count, &noise_values[0]);
+
+				switch (combination_type)
+				{
+				case 0:
+				case 1:
+					for (size_t k = 0; k < count; ++k)
+						noise_gen[k] = noise_values[k] * curr_ampl + noise_gen[k];
+					break;
+				case 2:
+					for (size_t k = 0; k < count; ++k)
+						noise_gen[k] = (float)( (1.0 - fabs(noise_values[k])) * curr_ampl + noise_gen[k]);
+					break;
+				case 3:
+					for (size_t k = 0; k < count; ++k)
+						noise_gen[k] = fabs(noise_values[k]) * curr_ampl + noise_gen[k];
+					break;
+				case 4:
+					for (size_t k = 0; k < count; ++k)
+						noise_gen[k] = (float)( (1.0 - clampGain(noise_values[k])) * curr_ampl + noise_gen[k]);
+					break;
+				case 5:
+					for (size_t k = 0; k < count; ++k)
+						noise_gen[k] = clampGain(noise_values[k]) * curr_ampl + noise_gen[k];
+					break;
+				}
+
+				curr_offset = curr_offset * octaves_arg;
+				curr_ampl = curr_ampl * amplitude;
+			}
+
+			for (size_t k = 0; k < count; ++k)
+			{
+				double result = 0;
+
+				if (combination_type <= 1)
+					result = (noise_gen[k] * offset + 1.0) * 0.5;
+				else if (combination_type <= 5)
+					result = noise_gen[k] * offset;
+
+				results[k] = shapeNoise(result);
+			}
+		}
+
+		// Applies bias and gain to a combined noise value
+		float shapeNoise(double result)
+		{
 			if (use_bias) 
 			{
 				result = pow(result, log(bias) / log(0.5));
@@ -167,6 +252,23 @@ namespace tre
 			return (float)result;
 		}
 
+		// Combinations 4 and 5 only keep negative noise and values above one
+		static float clampGain(float noise_gain)
+		{
+			if ( noise_gain >= 0.0 ) 
+			{
+				if ( noise_gain > 1.0 )
+				{
+					noise_gain = 1.0;
+				}
+				else 
+				{
+					noise_gain = 0.0;
+				}
+			}
+			return noise_gain;
+		}
+
 		double calculateCombination1(float x, double z)
 		{
 			//std::cout << "MFAM::CALCCOMBO1("<< x << "," << z <<")" << std::endl;
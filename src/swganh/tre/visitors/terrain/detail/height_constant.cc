@@ -10,7 +10,7 @@ void HeightConstant::Deserialize(swganh::ByteBuffer& buffer)
 	this->height_val = buffer.read<float>();
 }
 		
-void HeightConstant::GetBaseHeight(float x, float z, float transform_value, float& base_value, std::map<uint32_t,Fractal*>& fractals)
+void HeightConstant::GetBaseHeight(float x, float z, float transform_value, float& base_value, const std::map<uint32_t,Fractal*>& fractals)
 {
 	//std::cout << "AHCN::PROCESS("<< x << "," << z <<")" << std::endl;
 	
@@ -3,6 +3,8 @@
 #include "height_fractal.h"
 #include "fractal.h"
 
+#include <vector>
+
 using namespace swganh::tre;
 
 void HeightFractal::Deserialize(swganh::ByteBuffer& buffer)
@@ -12,7 +14,7 @@ void HeightFractal::Deserialize(swganh::ByteBuffer& buffer)
 	this->height_val = buffer.read<float>();
 }
 		
-void HeightFractal::GetBaseHeight(float x, float z, float transform_value, float& base_value, std::map<uint32_t,Fractal*>& fractals)
+void HeightFractal::GetBaseHeight(float x, float z, float transform_value, float& base_value, const std::map<uint32_t,Fractal*>& fractals)
 {
 	//std::cout << "AHFR::PROCESS("<< x << "," << z <<")" << std::endl;
 	
@@ -20,6 +22,24 @@ void HeightFractal::GetBaseHeight(float x, float z, float transform_value, float
 	
 	float noise_result = fractal->getNoise(x, z) * height_val;
 
+	base_value = Transform(noise_result, transform_value, base_value);
+}
+
+void HeightFractal::GetBaseHeights(const float* x, const float* z, const float* transform_values, float* base_values, size_t count, const std::map<uint32_t,Fractal*>& fractals)
+{
+	Fractal* fractal = fractals.find(fractal_id)->second;
+
+	std::vector<float> noise(count);
+	fractal->getNoise(x, z, count, noise.data());
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		base_values[i] = Transform(noise[i] * height_val, transform_values[i], base_values[i]);
+	}
+}
+
+float HeightFractal::Transform(float noise_result, float transform_value, float base_value)
+{
 	float result;
 
 	switch (transform_type)
@@ -41,5 +61,5 @@ void HeightFractal::GetBaseHeight(float x, float z, float transform_value, float
 		break;
 	}
 
-	base_value = result;
-}
\ No newline at end of file
+	return result;
+}
@@ -18,9 +18,13 @@ namespace tre
 
 		virtual void Deserialize(swganh::ByteBuffer& buffer);
 		
-		virtual void GetBaseHeight(float x, float z, float transform_value, float& base_value, std::map<uint32_t,Fractal*>& fractals);
+		virtual void GetBaseHeight(float x, float z, float transform_value, float& base_value, const std::map<uint32_t,Fractal*>& fractals);
+
+		virtual void GetBaseHeights(const float* x, const float* z, const float* transform_values, float* base_values, size_t count, const std::map<uint32_t,Fractal*>& fractals);
 
 	private:
+		float Transform(float noise_result, float transform_value, float base_value);
+
 		int   fractal_id;
 		int   transform_type;
 		float height_val;
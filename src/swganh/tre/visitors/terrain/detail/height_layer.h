@@ -18,7 +18,18 @@ namespace tre
 
 		virtual LayerType GetType() { return LAYER_TYPE_HEIGHT; }
 		
-		virtual void GetBaseHeight(float x, float z, float transform_value, float& base_value, std::map<uint32_t, Fractal*>& fractals) = 0;
+		virtual void GetBaseHeight(float x, float z, float transform_value, float& base_value, const std::map<uint32_t,Fractal*>& fractals) = 0;
+
+		/**
+			GetBaseHeight for count points at once, every argument is an array of count values.
+		*/
+		virtual void GetBaseHeights(const float* x, const float* z, const float* transform_values, float* base_values, size_t count, const std::map<uint32_t,Fractal*>& fractals)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				GetBaseHeight(x[i], z[i], transform_values[i], base_values[i], fractals);
+			}
+		}
 	};
 	
 }
@@ -2,6 +2,7 @@
 // See file LICENSE or go to http://swganh.com/LICENSE
 #pragma once
 
+#include <cstdint> //For uint64_t
 #include <memory> //For shared ptr
 #include <string> //For String
 #include "visitor_types.h" //For visitor types
@@ -31,6 +32,30 @@ namespace tre
 			This should only be called by the IFFFile code.
 		*/
 		virtual void visit_folder(uint32_t depth, std::string name, uint32_t size) = 0;
+
+		/**
+			@brief returns an estimate of the memory held by this visitor in bytes.
+			Used by the ResourceManager to charge cached visitors against its budget,
+			0 charges the size of the raw resource instead.
+		*/
+		virtual uint64_t Size() const { return 0; }
+
+		/**
+			@brief returns the version of the format written by Serialize, 0 if this
+			visitor can not be stored in the VisitorCache.
+		*/
+		virtual uint32_t CacheVersion() const { return 0; }
+
+		/**
+			@brief writes the parsed state of this visitor.
+		*/
+		virtual void Serialize(swganh::ByteBuffer& buffer) const {}
+
+		/**
+			@brief restores the state written by Serialize. Throws if the data is
+			damaged, in which case the visitor is left unchanged.
+		*/
+		virtual void Deserialize(swganh::ByteBuffer& buffer) {}
 	};
 }
 }
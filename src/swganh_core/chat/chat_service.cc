@@ -69,9 +69,55 @@ using boost::wsmatch;
 using boost::regex_match;
 #endif
 
+namespace {
+
+    struct PersistentMessageRow
+    {
+        std::string sender;
+        std::string sender_game;
+        std::string sender_galaxy;
+        std::wstring subject;
+        std::wstring message;
+        std::vector<char> attachments;
+        uint32_t id;
+        uint8_t status;
+        uint32_t sent_time;
+    };
+
+    PersistentMessageRow ReadMessageHeader(sql::ResultSet& result_set)
+    {
+        PersistentMessageRow row;
+        row.sender = result_set.getString("sender");
+        row.sender_game = result_set.getString("sender_game");
+        row.sender_galaxy = result_set.getString("sender_galaxy");
+
+        std::string tmp = result_set.getString("subject");
+        row.subject = std::wstring(std::begin(tmp), std::end(tmp));
+
+        row.id = result_set.getUInt("id");
+        row.status = static_cast<uint8_t>(result_set.getUInt("status"));
+        row.sent_time = result_set.getUInt("sent_time");
+        return row;
+    }
+
+    PersistentMessageRow ReadMessage(sql::ResultSet& result_set)
+    {
+        auto row = ReadMessageHeader(result_set);
+
+        std::string tmp = result_set.getString("message");
+        row.message = std::wstring(std::begin(tmp), std::end(tmp));
+
+        tmp = result_set.getString("attachments");
+        row.attachments = std::vector<char>(std::begin(tmp), std::end(tmp));
+        return row;
+    }
+
+}
+
 ChatService::ChatService(SwganhKernel* kernel)
     : kernel_(kernel)
     , db_manager_(kernel->GetDatabaseManager())
+    , strand_(kernel->GetIoService())
 {}
 
 ServiceDescription ChatService::GetServiceDescription()
@@ -97,24 +143,7 @@ bool ChatService::SendPersistentMessage(
     const std::wstring& message, 
     const std::vector<char>& attachments)
 {
-    uint64_t recipient_id = GetObjectIdByCustomName(recipient);
-    
-    if (!recipient_id)
-    {
-        DLOG(warning) << "Unable to find recipient for persistent message: " << recipient;
-        return false;
-    }
-
-    uint8_t status = 'N'; // N for new
-    uint32_t timestamp = static_cast<uint32_t>(time(NULL));
-    uint32_t message_id = StorePersistentMessage(
-        recipient_id, sender, sender_game, sender_galaxy, subject, message, attachments, status, timestamp);
-
-    if (auto online_object = simulation_service_->GetObjectById(recipient_id))
-    {
-        SendChatPersistentMessageToClient(online_object->GetController(), sender, sender_game, sender_galaxy, subject, message_id, status, timestamp);
-    }
-
+    SendPersistentMessage_(recipient, sender, sender_game, sender_galaxy, subject, message, attachments, nullptr);
     return true;
 }
     
@@ -127,6 +156,99 @@ bool ChatService::SendPersistentMessage(
     return SendPersistentMessage(recipient, sender, "SWG", kernel_->GetServiceDirectory()->galaxy().name(), subject, message, std::vector<char>());
 }
 
+void ChatService::SendPersistentMessage(
+    const std::string& recipient,
+    const std::string& sender,
+    const std::string& sender_game,
+    const std::string& sender_galaxy,
+    const std::wstring& subject,
+    const std::wstring& message,
+    const std::vector<char>& attachments,
+    std::function<void (bool)> callback)
+{
+    SendPersistentMessage_(recipient, sender, sender_game, sender_galaxy, subject, message, attachments, std::move(callback));
+}
+
+void ChatService::SendPersistentMessage(
+    const std::string& recipient,
+    const std::string& sender,
+    const std::wstring& subject,
+    const std::wstring& message,
+    std::function<void (bool)> callback)
+{
+    SendPersistentMessage_(recipient, sender, "SWG", kernel_->GetServiceDirectory()->galaxy().name(), subject, message,
+        std::vector<char>(), std::move(callback));
+}
+
+void ChatService::SendPersistentMessage_(
+    const std::string& recipient,
+    const std::string& sender, 
+    const std::string& sender_game, 
+    const std::string& sender_galaxy, 
+    const std::wstring& subject, 
+    const std::wstring& message, 
+    const std::vector<char>& attachments,
+    std::function<void (bool)> callback)
+{
+    uint8_t status = 'N'; // N for new
+    uint32_t timestamp = static_cast<uint32_t>(time(NULL));
+
+    // Resolve the recipient and store the message on a database worker, only
+    // the notifications happen back on the strand.
+    db_manager_->ExecuteAsync(
+        [this, recipient, sender, sender_game, sender_galaxy, subject, message, attachments, status, timestamp] (
+            const std::shared_ptr<sql::Connection>& connection) -> std::pair<uint64_t, uint32_t>
+    {
+        uint64_t recipient_id = GetObjectIdByCustomName(connection, recipient);
+        if (!recipient_id)
+        {
+            return std::make_pair(recipient_id, 0u);
+        }
+
+        return std::make_pair(recipient_id, StorePersistentMessage(
+            connection, recipient_id, sender, sender_game, sender_galaxy, subject, message, attachments, status, timestamp));
+    },
+    "galaxy",
+    strand_,
+    [this, recipient, sender, sender_game, sender_galaxy, subject, status, timestamp, callback] (
+        std::exception_ptr error, std::pair<uint64_t, uint32_t> stored)
+    {
+        if (!error && !stored.first)
+        {
+            DLOG(warning) << "Unable to find recipient for persistent message: " << recipient;
+        }
+
+        if (!error && stored.first)
+        {
+            NotifyRecipient_(stored.first, sender, sender_game, sender_galaxy, subject, stored.second, status, timestamp);
+        }
+
+        if (callback)
+        {
+            callback(!error && stored.first != 0);
+        }
+    });
+}
+
+void ChatService::NotifyRecipient_(
+    uint64_t recipient_id,
+    const std::string& sender,
+    const std::string& sender_game,
+    const std::string& sender_galaxy,
+    const std::wstring& subject,
+    uint32_t message_id,
+    uint8_t status,
+    uint32_t timestamp)
+{
+    if (auto online_object = simulation_service_->GetObjectById(recipient_id))
+    {
+        if (auto controller = online_object->GetController())
+        {
+            SendChatPersistentMessageToClient(controller, sender, sender_game, sender_galaxy, subject, message_id, status, timestamp);
+        }
+    }
+}
+
 void ChatService::SendSpatialChat(
 	const std::shared_ptr<swganh::object::Object>& actor,
 	const std::shared_ptr<swganh::object::Object>& target,
@@ -182,26 +304,18 @@ void ChatService::Startup()
 	});
 }
    
-uint64_t ChatService::GetObjectIdByCustomName(const std::string& custom_name)
+uint64_t ChatService::GetObjectIdByCustomName(const std::shared_ptr<sql::Connection>& connection, const std::string& custom_name)
 {
     uint64_t object_id = 0;
 
-    try {
-        auto conn = db_manager_->getConnection("galaxy");
-        auto statement = std::unique_ptr<sql::PreparedStatement>(
-            conn->prepareStatement("SELECT sf_GetObjectIdByCustomName(?);"));
+    auto statement = db_manager_->getPreparedStatement(connection, "SELECT sf_GetObjectIdByCustomName(?);");
 
-        statement->setString(1, custom_name);
+    statement->setString(1, custom_name);
 
-        auto result_set = unique_ptr<sql::ResultSet>(statement->executeQuery());
+    auto result_set = unique_ptr<sql::ResultSet>(statement->executeQuery());
 
-        while (result_set->next()) {
-            object_id = result_set->getUInt64(1);
-        }
-
-    } catch(sql::SQLException &e) {
-        LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
-        LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
+    while (result_set->next()) {
+        object_id = result_set->getUInt64(1);
     }
 
     return object_id;
@@ -343,90 +457,112 @@ void ChatService::HandleChatPersistentMessageToServer(
         return;
     }
 
-    uint32_t receiver_status = ChatOnSendInstantMessage::FAILED;
     auto clean_message = FilterMessage(message->message);    
     auto firstname = sender->GetFirstName();
-
-    if (SendPersistentMessage(
-            message->recipient, 
-            std::string(firstname.begin(), firstname.end()), 
-            "SWG", 
-            kernel_->GetServiceDirectory()->galaxy().name(), 
-            message->subject, 
-            clean_message, 
-            message->attachment_data))
+    auto sender_controller = sender->GetController();
+    uint32_t mail_id = message->mail_id;
+
+    SendPersistentMessage_(
+        message->recipient, 
+        std::string(firstname.begin(), firstname.end()), 
+        "SWG", 
+        kernel_->GetServiceDirectory()->galaxy().name(), 
+        message->subject, 
+        clean_message, 
+        message->attachment_data,
+        [this, sender_controller, mail_id] (bool sent)
     {
-        receiver_status = ChatOnSendInstantMessage::OK;
-    }
-
-    SendChatOnSendPersistentMessage(sender->GetController(), message->mail_id, receiver_status);
+        uint32_t receiver_status = sent ? ChatOnSendInstantMessage::OK : ChatOnSendInstantMessage::FAILED;
+        SendChatOnSendPersistentMessage(sender_controller, mail_id, receiver_status);
+    });
 }
 
 void ChatService::HandleChatRequestPersistentMessage(
     const std::shared_ptr<swganh::connection::ConnectionClientInterface>& client,
     swganh::messages::ChatRequestPersistentMessage* message)
 {    
-    try {
-        auto conn = db_manager_->getConnection("galaxy");
-        auto statement = std::unique_ptr<sql::PreparedStatement>(
-            conn->prepareStatement("CALL sp_MailGetMessage(?, ?);"));
-
-        statement->setUInt(1, message->mail_message_id);
-        statement->setUInt64(2, client->GetController()->GetId());
-
-        auto result_set = std::unique_ptr<sql::ResultSet>(statement->executeQuery());
-
-        while (result_set->next()) {
-            
-            std::string tmp = result_set->getString("subject");
-            std::wstring subject(std::begin(tmp), std::end(tmp));
-
-            tmp = result_set->getString("message");
-            std::wstring message(std::begin(tmp), std::end(tmp));
-
-            tmp = result_set->getString("attachments");
-            std::vector<char> attachments(std::begin(tmp), std::end(tmp));
-
-            SendChatPersistentMessageToClient(client->GetController(), 
-                result_set->getString("sender"),
-                result_set->getString("sender_game"),
-                result_set->getString("sender_galaxy"),
-                subject,
-                message,
-                result_set->getUInt("id"),
-                result_set->getUInt("status"),
-                attachments,
-                result_set->getUInt("sent_time"),
+    auto controller = client->GetController();
+    if (!controller)
+    {
+        return;
+    }
+
+    uint32_t mail_message_id = message->mail_message_id;
+    uint64_t owner_id = controller->GetId();
+
+    db_manager_->QueryAsync("galaxy", "CALL sp_MailGetMessage(?, ?);",
+        [mail_message_id, owner_id] (sql::PreparedStatement& statement)
+    {
+        statement.setUInt(1, mail_message_id);
+        statement.setUInt64(2, owner_id);
+    },
+    &ReadMessage,
+    strand_,
+    [this, client, mail_message_id, owner_id] (std::exception_ptr error, std::vector<PersistentMessageRow> rows)
+    {
+        // the query error itself was logged by the database worker
+        if (error)
+        {
+            LOG(warning) << "Could not load persistent message " << mail_message_id << " for " << owner_id;
+            return;
+        }
+
+        // the player may have logged out while the message was loading
+        auto controller = client->GetController();
+        if (!controller)
+        {
+            return;
+        }
+
+        for (auto& row : rows)
+        {
+            SendChatPersistentMessageToClient(controller, 
+                row.sender,
+                row.sender_game,
+                row.sender_galaxy,
+                row.subject,
+                row.message,
+                row.id,
+                row.status,
+                row.attachments,
+                row.sent_time,
                 false);
         }
-        
-		while(statement->getMoreResults());
-    } catch(sql::SQLException &e) {
-        LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
-        LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
-    }
+    });
 }
 
 void ChatService::HandleChatDeletePersistentMessage(
     const std::shared_ptr<swganh::connection::ConnectionClientInterface>& client,
     swganh::messages::ChatDeletePersistentMessage* message)
 {
-    try {
-        auto conn = db_manager_->getConnection("galaxy");
-        auto statement = std::unique_ptr<sql::PreparedStatement>(
-            conn->prepareStatement("CALL sp_MailDeleteMessage(?, ?);"));
+    auto controller = client->GetController();
+    if (!controller)
+    {
+        return;
+    }
+
+    uint32_t mail_message_id = message->mail_message_id;
+    uint64_t owner_id = controller->GetId();
+
+    db_manager_->ExecuteAsync(
+        [this, mail_message_id, owner_id] (const std::shared_ptr<sql::Connection>& connection) -> bool
+    {
+        auto statement = db_manager_->getPreparedStatement(connection, "CALL sp_MailDeleteMessage(?, ?);");
 
-        statement->setUInt(1, message->mail_message_id);
-        statement->setUInt64(2, client->GetController()->GetId());
+        statement->setUInt(1, mail_message_id);
+        statement->setUInt64(2, owner_id);
 
         statement->execute();
-    } catch(sql::SQLException &e) {
-        LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
-        LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
-    }
+		while(statement->getMoreResults());
+        return true;
+    },
+    "galaxy",
+    strand_,
+    [] (std::exception_ptr, bool) {});
 }
 
 uint32_t ChatService::StorePersistentMessage(
+    const std::shared_ptr<sql::Connection>& connection,
     uint64_t recipient_id,
     const std::string& sender_name, 
     const std::string& sender_game, 
@@ -439,31 +575,23 @@ uint32_t ChatService::StorePersistentMessage(
 {   
     uint32_t message_id = 0;
 
-    try {
-        auto conn = db_manager_->getConnection("galaxy");
-        auto statement = std::unique_ptr<sql::PreparedStatement>(
-            conn->prepareStatement("SELECT sf_MailCreate(?, ?, ?, ?, ?, ?, ?, ?, ?);"));
+    auto statement = db_manager_->getPreparedStatement(connection, "SELECT sf_MailCreate(?, ?, ?, ?, ?, ?, ?, ?, ?);");
 
-        statement->setString(1, sender_name);
-        statement->setString(2, sender_game);
-        statement->setString(3, sender_galaxy);
-        statement->setUInt64(4, recipient_id);
-        statement->setString(5, std::string(std::begin(subject), std::end(subject)));
-        statement->setString(6, std::string(std::begin(message), std::end(message)));
-        statement->setString(7, std::string(std::begin(attachments), std::end(attachments)));
-        statement->setUInt(8, status);
-        statement->setUInt(9, timestamp);
+    statement->setString(1, sender_name);
+    statement->setString(2, sender_game);
+    statement->setString(3, sender_galaxy);
+    statement->setUInt64(4, recipient_id);
+    statement->setString(5, std::string(std::begin(subject), std::end(subject)));
+    statement->setString(6, std::string(std::begin(message), std::end(message)));
+    statement->setString(7, std::string(std::begin(attachments), std::end(attachments)));
+    statement->setUInt(8, status);
+    statement->setUInt(9, timestamp);
 
-        auto result_set = std::unique_ptr<sql::ResultSet>(statement->executeQuery());
-
-        while(result_set->next()) 
-        {
-            message_id = result_set->getUInt(1);
-        }
+    auto result_set = std::unique_ptr<sql::ResultSet>(statement->executeQuery());
 
-    } catch(sql::SQLException &e) {
-        LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
-        LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
+    while(result_set->next()) 
+    {
+        message_id = result_set->getUInt(1);
     }
 
     return message_id;
@@ -471,35 +599,36 @@ uint32_t ChatService::StorePersistentMessage(
     
 void ChatService::LoadMessageHeaders(const std::shared_ptr<swganh::object::Object>& receiver)
 {
-    try {
-        auto conn = db_manager_->getConnection("galaxy");
-        auto statement = std::unique_ptr<sql::PreparedStatement>(
-            conn->prepareStatement("CALL sp_MailFetchHeaders(?);"));
-
-        statement->setUInt64(1, receiver->GetObjectId());
-
-        auto result_set = std::unique_ptr<sql::ResultSet>(statement->executeQuery());
-
-        while(result_set->next())
-        {           
-            std::string tmp = result_set->getString("subject");
-            std::wstring subject(std::begin(tmp), std::end(tmp));
-            
-            SendChatPersistentMessageToClient(receiver->GetController(), 
-                result_set->getString("sender"),
-                result_set->getString("sender_game"),
-                result_set->getString("sender_galaxy"),
-                subject,
-                result_set->getUInt("id"),
-                result_set->getUInt("status"),
-                result_set->getUInt("sent_time"));
+    uint64_t receiver_id = receiver->GetObjectId();
+
+    db_manager_->QueryAsync("galaxy", "CALL sp_MailFetchHeaders(?);",
+        [receiver_id] (sql::PreparedStatement& statement)
+    {
+        statement.setUInt64(1, receiver_id);
+    },
+    &ReadMessageHeader,
+    strand_,
+    [this, receiver] (std::exception_ptr error, std::vector<PersistentMessageRow> rows)
+    {
+        // the player may have logged out while the headers were loading
+        auto controller = receiver->GetController();
+        if (!controller)
+        {
+            return;
         }
 
-		while(statement->getMoreResults());
-    } catch(sql::SQLException &e) {
-        LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
-        LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
-    }
+        for (auto& row : rows)
+        {
+            SendChatPersistentMessageToClient(controller, 
+                row.sender,
+                row.sender_game,
+                row.sender_galaxy,
+                row.subject,
+                row.id,
+                row.status,
+                row.sent_time);
+        }
+    });
 }
 
 std::wstring ChatService::FilterMessage(const std::wstring& message)
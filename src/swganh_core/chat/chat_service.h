@@ -3,9 +3,12 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 
+#include <boost/asio/strand.hpp>
+
 #include "swganh_core/chat/chat_service_interface.h"
 #include "swganh_core/command/command_service_interface.h"
 #include "swganh_core/simulation/simulation_service_interface.h"
@@ -13,6 +16,10 @@
 #include "swganh/app/swganh_kernel.h"
 #include "swganh_core/messages/controllers/command_queue_enqueue.h"
 
+namespace sql {
+    class Connection;
+}  // namespace sql
+
 namespace swganh {
 namespace connection {
     class ConnectionClientInterface;
@@ -62,6 +69,23 @@ public:
         const std::wstring& subject, 
         const std::wstring& message);
 
+    void SendPersistentMessage(
+        const std::string& recipient,
+        const std::string& sender,
+        const std::string& sender_game,
+        const std::string& sender_galaxy,
+        const std::wstring& subject,
+        const std::wstring& message,
+        const std::vector<char>& attachments,
+        std::function<void (bool)> callback);
+
+    void SendPersistentMessage(
+        const std::string& recipient,
+        const std::string& sender,
+        const std::wstring& subject,
+        const std::wstring& message,
+        std::function<void (bool)> callback);
+
 	/**
 	* Sends a spatial chat message
 	* @param actor the speaker
@@ -82,13 +106,48 @@ public:
 	*/
     void Startup();
 
-    uint64_t GetObjectIdByCustomName(const std::string& custom_name);
+    /**
+    * Looks up a character by name, runs on the caller's database connection.
+    */
+    uint64_t GetObjectIdByCustomName(const std::shared_ptr<sql::Connection>& connection, const std::string& custom_name);
 
 private:
     swganh::database::DatabaseManager* db_manager_;
 	swganh::command::CommandServiceInterface* command_service_;
     swganh::simulation::SimulationServiceInterface* simulation_service_;
     swganh::app::SwganhKernel* kernel_;
+
+    // Database completions are posted here, the queries themselves run on the database workers.
+    boost::asio::strand strand_;
+
+    /**
+    * Resolves the recipient and stores the message off the calling thread, then
+    * notifies the recipient if online.
+    *
+    * @param callback Called on the strand with whether the message was stored, may be empty.
+    */
+    void SendPersistentMessage_(
+        const std::string& recipient,
+        const std::string& sender, 
+        const std::string& sender_game, 
+        const std::string& sender_galaxy, 
+        const std::wstring& subject, 
+        const std::wstring& message, 
+        const std::vector<char>& attachments,
+        std::function<void (bool)> callback);
+
+    /**
+    * Sends the header of a stored message to its recipient if online, runs on the strand.
+    */
+    void NotifyRecipient_(
+        uint64_t recipient_id,
+        const std::string& sender,
+        const std::string& sender_game,
+        const std::string& sender_galaxy,
+        const std::wstring& subject,
+        uint32_t message_id,
+        uint8_t status,
+        uint32_t timestamp);
     
     void SendChatPersistentMessageToClient(
         const std::shared_ptr<swganh::observer::ObserverInterface>& receiver, 
@@ -159,6 +218,7 @@ private:
         swganh::messages::ChatDeletePersistentMessage* message);
 
     uint32_t StorePersistentMessage(
+        const std::shared_ptr<sql::Connection>& connection,
         uint64_t recipient_id,
         const std::string& sender_name, 
         const std::string& sender_game, 
@@ -8,6 +8,7 @@
 #endif
 
 #include "swganh/scripting/python_shared_ptr.h"
+#include "swganh/scripting/utilities.h"
 #include <boost/python/suite/indexing/vector_indexing_suite.hpp>
 #include "chat_service_interface.h"
 #include <boost/python.hpp>
@@ -17,6 +18,41 @@ using namespace swganh::chat;
 using namespace boost::python;
 using namespace std;
 
+// The python callable is only touched with the gil held, also when the last copy
+// of the handler goes away on a database worker.
+std::function<void (bool)> MakeStoredCallback(object callback)
+{
+    std::shared_ptr<object> shared_callback(new object(callback), [] (object* callable) {
+        swganh::scripting::ScopedGilLock lock;
+        delete callable;
+    });
+
+    return [shared_callback] (bool stored) {
+        swganh::scripting::ScopedGilLock lock;
+        try
+        {
+            (*shared_callback)(stored);
+        }
+        catch(error_already_set& /*e*/)
+        {
+            PyErr_Print();
+        }
+    };
+}
+
+void SendPersistentMessageWithCallback(ChatServiceInterface* self, const std::string& recipient, const std::string& sender,
+    const std::string& sender_game, const std::string& sender_galaxy, const std::wstring& subject, const std::wstring& message,
+    const std::vector<char>& attachments, object callback)
+{
+    self->SendPersistentMessage(recipient, sender, sender_game, sender_galaxy, subject, message, attachments, MakeStoredCallback(callback));
+}
+
+void SendShortPersistentMessageWithCallback(ChatServiceInterface* self, const std::string& recipient, const std::string& sender,
+    const std::wstring& subject, const std::wstring& message, object callback)
+{
+    self->SendPersistentMessage(recipient, sender, subject, message, MakeStoredCallback(callback));
+}
+
 void exportChatService()
 {
     class_<ChatServiceInterface, shared_ptr<ChatServiceInterface>, boost::noncopyable>("ChatService", "The chat service processes in-game chat features.", no_init)
@@ -35,5 +71,9 @@ void exportChatService()
             const std::wstring& subject, 
             const std::wstring& message)>(&ChatServiceInterface::SendPersistentMessage),
             "Send a persistent message without attachments")
+        .def("sendPersistentMessage", &SendPersistentMessageWithCallback,
+            "Send a persistent message including attachments, callback(stored) is called once it was stored or dropped")
+        .def("sendPersistentMessage", &SendShortPersistentMessageWithCallback,
+            "Send a persistent message without attachments, callback(stored) is called once it was stored or dropped")
         ;
 }
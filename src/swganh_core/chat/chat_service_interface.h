@@ -3,8 +3,10 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "swganh/service/service_interface.h"
 
@@ -22,6 +24,12 @@ namespace chat {
     class ChatServiceInterface: public swganh::service::ServiceInterface
     {
     public:
+        /**
+        * Queues a persistent message, the recipient is resolved and the message
+        * stored on a database worker. Unknown recipients are logged and dropped.
+        *
+        * @return True once the message has been queued.
+        */
         virtual bool SendPersistentMessage(
             const std::string& recipient,
             const std::string& sender,
@@ -38,6 +46,30 @@ namespace chat {
             const std::wstring& subject, 
             const std::wstring& message) = 0;
 
+        /**
+        * Queues a persistent message like the overloads above and reports the
+        * outcome.
+        *
+        * @param callback Called on the chat strand with true if the recipient was
+        *      found and the message stored.
+        */
+        virtual void SendPersistentMessage(
+            const std::string& recipient,
+            const std::string& sender,
+            const std::string& sender_game,
+            const std::string& sender_galaxy,
+            const std::wstring& subject,
+            const std::wstring& message,
+            const std::vector<char>& attachments,
+            std::function<void (bool)> callback) = 0;
+
+        virtual void SendPersistentMessage(
+            const std::string& recipient,
+            const std::string& sender,
+            const std::wstring& subject,
+            const std::wstring& message,
+            std::function<void (bool)> callback) = 0;
+
         virtual void SendSpatialChat(
 		    const std::shared_ptr<swganh::object::Object>& actor, // creature object
 		    const std::shared_ptr<swganh::object::Object>& target,	// target object
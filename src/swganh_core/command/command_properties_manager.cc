@@ -54,10 +54,12 @@ CommandPropertiesMap CommandPropertiesManager::LoadCommandPropertiesMap()
     {
 		auto datatable = resource_manager_->GetResourceByName<DatatableVisitor>("datatables/command/command_table.iff");
         
-		vector<int> bits;
-        std::for_each(datatable->begin_itr(), datatable->end_itr(), [&] (DatatableVisitor::DATA_ROW& row) {
+        for (size_t row_index = 0; row_index < datatable->row_count(); ++row_index)
+        {
+            auto row = datatable->row(row_index);
 
             CommandProperties properties;
+            vector<int> bits;
 
             auto tmp_command_name = row.GetValue<string>(0);            
             std::transform(tmp_command_name.begin(), tmp_command_name.end(), tmp_command_name.begin(), ::tolower);
@@ -89,7 +91,7 @@ CommandPropertiesMap CommandPropertiesManager::LoadCommandPropertiesMap()
             properties.add_to_combat_queue = row.GetValue<uint32_t>(74);
 
             properties_map.insert(make_pair(properties.command_name, properties));
-        });
+        }
     }
     catch(exception& e)
     {
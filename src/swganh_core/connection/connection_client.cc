@@ -16,6 +16,9 @@ using namespace swganh::observer;
 
 ConnectionClient::ConnectionClient(ServerInterface* server, boost::asio::io_service& io_service, boost::asio::ip::udp::endpoint remote_endpoint)
     : ConnectionClientInterface(server, io_service, remote_endpoint)
+    , state_(NEW)
+    , account_id_(0)
+    , player_id_(0)
 {}
 
 ConnectionClient::State ConnectionClient::GetState() const
@@ -33,12 +36,26 @@ uint64_t ConnectionClient::GetPlayerId() const
     return player_id_;
 }
 
+bool ConnectionClient::BeginConnect()
+{
+    State expected = NEW;
+    return state_.compare_exchange_strong(expected, CONNECTING);
+}
+
+void ConnectionClient::CancelConnect()
+{
+    State expected = CONNECTING;
+    state_.compare_exchange_strong(expected, NEW);
+}
+
 void ConnectionClient::Connect(uint32_t account_id, uint64_t player_id)
 {
     account_id_ = account_id;
     player_id_ = player_id;
 
-    state_ = CONNECTED;
+    // a client closed meanwhile stays closed
+    State expected = CONNECTING;
+    state_.compare_exchange_strong(expected, CONNECTED);
 }
 
 void ConnectionClient::OnClose()
@@ -2,6 +2,7 @@
 // See file LICENSE or go to http://swganh.com/LICENSE
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 
 #include "swganh_core/connection/connection_client_interface.h"
@@ -41,6 +42,10 @@ public:
 	* @param account_id the account to set
 	* @param player_id the player id to set
 	*/
+    bool BeginConnect();
+
+    void CancelConnect();
+
     void Connect(uint32_t account_id, uint64_t player_id);
     
 	/**
@@ -57,7 +62,8 @@ private:
 
     void OnClose();
 
-   State state_;
+    // changed from the io threads and the connection service strand
+    std::atomic<State> state_;
     uint32_t account_id_;
     uint64_t player_id_;
     std::shared_ptr<swganh::observer::ObserverInterface> controller_;
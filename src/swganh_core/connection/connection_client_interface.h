@@ -20,7 +20,8 @@ class ConnectionClientInterface : public swganh::network::soe::Session
 public:
     enum State
     {
-        CONNECTING = 0,
+        NEW = 0,        // no ClientIdMsg handled yet
+        CONNECTING,     // the ClientIdMsg is being checked
         CONNECTED,
         PLAYING,
         DISCONNECTING
@@ -38,6 +39,18 @@ public:
 
     virtual uint64_t GetPlayerId() const = 0;
 
+    /**
+    * Marks the client as connecting while its ClientIdMsg is checked.
+    *
+    * @return False if the client is already connecting, connected or closing.
+    */
+    virtual bool BeginConnect() = 0;
+
+    /**
+    * Returns a connecting client whose ClientIdMsg was rejected to NEW.
+    */
+    virtual void CancelConnect() = 0;
+
     virtual void Connect(uint32_t account_id, uint64_t player_id) = 0;
     
     virtual const std::shared_ptr<swganh::observer::ObserverInterface>& GetController() const = 0;
@@ -9,6 +9,7 @@
 #include "swganh/logger.h"
 
 #include "swganh/crc.h"
+#include "swganh/database/database_manager.h"
 #include "swganh/event_dispatcher.h"
 #include "swganh/network/soe/server.h"
 #include "swganh/plugin/plugin_manager.h"
@@ -45,6 +46,20 @@ using swganh::ValueEvent;
 using boost::asio::ip::udp;
 using swganh::app::SwganhKernel;
 
+namespace {
+
+    /// The accounts a client id resolves to, zero ids mean it was not authorized.
+    struct ClientIdLookup
+    {
+        ClientIdLookup() : account_id(0), player_id(0), max_characters(0) {}
+
+        uint32_t account_id;
+        uint64_t player_id;
+        uint32_t max_characters;
+    };
+
+}
+
 ConnectionService::ConnectionService(
         string listen_address,
         uint16_t listen_port,
@@ -57,6 +72,7 @@ ConnectionService::ConnectionService(
     , listen_address_(listen_address)
     , listen_port_(listen_port)
     , ping_port_(ping_port)
+    , strand_(kernel->GetIoService())
 {
 
     session_provider_ = kernel_->GetPluginManager()->CreateObject<swganh::connection::providers::SessionProviderInterface>("Login::SessionProvider");
@@ -221,42 +237,87 @@ void ConnectionService::HandleClientIdMsg_(
 {
     DLOG(info) << "Handling ClientIdMsg";
 
-    // get session key from login service
-    uint32_t account_id = login_service_->GetAccountBySessionKey(message->session_hash);
-
-    // authorized
-    if (! account_id) {
-        LOG(warning) << "Account_id not found from session key, unauthorized access.";
+    // A resent ClientIdMsg must not start a second lookup and game session
+    if (!client->BeginConnect())
+    {
+        DLOG(info) << "Ignoring ClientIdMsg, the client is already connecting";
         return;
     }
 
-    // gets player from account
-    uint64_t player_id = session_provider_->GetPlayerId(account_id);
+    string session_hash = message->session_hash;
+    auto db_manager = kernel_->GetDatabaseManager();
 
-    // authorized
-    if (! player_id) {
-        LOG(warning) << "No player found for the requested account, unauthorized access.";
-        return;
-    }
+    // The login providers block on mysql, the lookups run on a database worker.
+    db_manager->ExecuteAsync([this, session_hash] () -> ClientIdLookup
+    {
+        ClientIdLookup lookup;
 
-    auto existing_session_connection = FindConnectionByPlayerId(player_id);
-    if (existing_session_connection)
+        // get session key from login service
+        lookup.account_id = login_service_->GetAccountBySessionKey(session_hash);
+        if (lookup.account_id)
+        {
+            // gets player from account
+            lookup.player_id = session_provider_->GetPlayerId(lookup.account_id);
+            lookup.max_characters = character_provider_->GetMaxCharacters(lookup.account_id);
+        }
+
+        return lookup;
+    },
+    strand_,
+    [this, client, db_manager] (std::exception_ptr error, ClientIdLookup lookup)
     {
-        existing_session_connection->Close();
-    }
+        // authorized
+        if (! lookup.account_id) {
+            LOG(warning) << "Account_id not found from session key, unauthorized access.";
+            client->CancelConnect();
+            return;
+        }
 
-    // creates a new session and stores it for later use
-    if (!session_provider_->CreateGameSession(player_id, client->connection_id())) {
-        DLOG(warning) << "Player Not Inserted into Session Map because No Game Session Created!";
-    }
+        // authorized
+        if (! lookup.player_id) {
+            LOG(warning) << "No player found for the requested account, unauthorized access.";
+            client->CancelConnect();
+            return;
+        }
+
+        // the client went away while its session key was checked
+        if (client->GetState() != ConnectionClientInterface::CONNECTING)
+        {
+            return;
+        }
 
-    client->Connect(account_id, player_id);
+        // Closing the old connection ends its game session, the new one is only
+        // created after that.
+        auto existing_session_connection = FindConnectionByPlayerId(lookup.player_id);
+        if (existing_session_connection)
+        {
+            existing_session_connection->Close();
+        }
 
-    ClientPermissionsMessage client_permissions;
-    client_permissions.galaxy_available = kernel_->GetServiceDirectory()->galaxy().status();
-    client_permissions.available_character_slots = static_cast<uint8_t>(character_provider_->GetMaxCharacters(account_id));
-    /// @TODO: Replace with configurable value
-    client_permissions.unlimited_characters = 0;
+        uint64_t player_id = lookup.player_id;
+        uint32_t connection_id = client->connection_id();
 
-    client->SendTo(client_permissions);
+        // creates a new session and stores it for later use
+        db_manager->ExecuteAsync([this, player_id, connection_id] () -> bool
+        {
+            return session_provider_->CreateGameSession(player_id, connection_id);
+        },
+        strand_,
+        [this, client, lookup] (std::exception_ptr error, bool created)
+        {
+            if (!created) {
+                DLOG(warning) << "Player Not Inserted into Session Map because No Game Session Created!";
+            }
+
+            client->Connect(lookup.account_id, lookup.player_id);
+
+            ClientPermissionsMessage client_permissions;
+            client_permissions.galaxy_available = kernel_->GetServiceDirectory()->galaxy().status();
+            client_permissions.available_character_slots = static_cast<uint8_t>(lookup.max_characters);
+            /// @TODO: Replace with configurable value
+            client_permissions.unlimited_characters = 0;
+
+            client->SendTo(client_permissions);
+        });
+    });
 }
@@ -113,6 +113,9 @@ private:
     uint16_t listen_port_;
     uint16_t ping_port_;
     std::shared_ptr<boost::asio::deadline_timer> session_timer_;
+
+    // Client id replies are sent from here once the session lookups have finished.
+    boost::asio::strand strand_;
 };
     
 }}  // namespace swganh::connection
@@ -48,6 +48,18 @@ using namespace std;
 using boost::asio::ip::udp;
 using swganh::app::SwganhKernel;
 
+namespace {
+
+    /// What the database side of a login produced, an empty account means it failed.
+    struct LoginResult
+    {
+        shared_ptr<Account> account;
+        string account_session;
+        vector<CharacterData> characters;
+    };
+
+}
+
 LoginService::LoginService(string listen_address, uint16_t listen_port, SwganhKernel* kernel)
     : swganh::login::LoginServiceInterface(kernel->GetIoService())
     , kernel_(kernel)
@@ -55,6 +67,7 @@ LoginService::LoginService(string listen_address, uint16_t listen_port, SwganhKe
     , listen_address_(listen_address)
     , listen_port_(listen_port)
     , active_(kernel->GetIoService())
+    , strand_(kernel->GetIoService())
 {
     account_provider_ = kernel->GetPluginManager()->CreateObject<swganh::login::providers::AccountProviderInterface>("Login::AccountProvider");
     
@@ -254,59 +267,82 @@ void LoginService::HandleLoginClientId_(const std::shared_ptr<LoginClientInterfa
     login_client->SetPassword(message->password);
     login_client->SetVersion(message->client_version);
 
-    auto account = account_provider_->FindByUsername(message->username);
+    string username = message->username;
+    string password = message->password;
+    bool auto_registration = login_auto_registration_;
 
-    if (!account && login_auto_registration_ == true)
+    // The account providers block on mysql, so the whole lookup runs on a
+    // database worker and only the replies are sent from the strand.
+    kernel_->GetDatabaseManager()->ExecuteAsync(
+        [this, login_client, username, password, auto_registration] () -> LoginResult
     {
-        if(account_provider_->AutoRegisterAccount(message->username, message->password))
+        LoginResult result;
+
+        auto account = account_provider_->FindByUsername(username);
+
+        if (!account && auto_registration == true)
         {
-            account = account_provider_->FindByUsername(message->username);
+            if(account_provider_->AutoRegisterAccount(username, password))
+            {
+                account = account_provider_->FindByUsername(username);
+            }
         }
-    }
 
-    if (!account || !authentication_manager_->Authenticate(login_client, account)) {
-        LOG(warning) << "Login request for invalid user: " << login_client->GetUsername();
+        if (!account || !authentication_manager_->Authenticate(login_client, account)) {
+            return result;
+        }
 
-        ErrorMessage error;
-        error.type = "@cpt_login_fail";
-        error.message = "@msg_login_fail";
-        error.force_fatal = false;
+        // create account session
+        result.account_session = boost::posix_time::to_simple_string(boost::posix_time::microsec_clock::local_time())
+            + boost::lexical_cast<string>(login_client->remote_endpoint().address());
 
-        login_client->SendTo(error);
+        account_provider_->CreateAccountSession(account->account_id(), result.account_session);
 
-        auto timer = std::make_shared<boost::asio::deadline_timer>(kernel_->GetIoService(), boost::posix_time::seconds(login_error_timeout_secs_));
-        timer->async_wait([login_client] (const boost::system::error_code& e)
-        {
-			if (login_client)
-			{
-                login_client->Close();
+        result.characters = character_provider_->GetCharactersForAccount(account->account_id());
+        result.account = account;
+        return result;
+    },
+    strand_,
+    [this, login_client] (std::exception_ptr error, LoginResult result)
+    {
+        if (!result.account) {
+            LOG(warning) << "Login request for invalid user: " << login_client->GetUsername();
 
-				DLOG(info) << "Closing connection";
-			}
-        });
+            ErrorMessage error_message;
+            error_message.type = "@cpt_login_fail";
+            error_message.message = "@msg_login_fail";
+            error_message.force_fatal = false;
 
-        return;
-    }
+            login_client->SendTo(error_message);
 
-    login_client->SetAccount(account);
-    // create account session
-    string account_session = boost::posix_time::to_simple_string(boost::posix_time::microsec_clock::local_time())
-        + boost::lexical_cast<string>(login_client->remote_endpoint().address());
+            auto timer = std::make_shared<boost::asio::deadline_timer>(kernel_->GetIoService(), boost::posix_time::seconds(login_error_timeout_secs_));
+            timer->async_wait([login_client] (const boost::system::error_code& e)
+            {
+			    if (login_client)
+			    {
+                    login_client->Close();
 
-    account_provider_->CreateAccountSession(account->account_id(), account_session);
-    login_client->SendTo(
-        BuildLoginClientToken(login_client, account_session));
+				    DLOG(info) << "Closing connection";
+			    }
+            });
 
-    login_client->SendTo(
-        BuildLoginEnumCluster(login_client, galaxy_status_));
+            return;
+        }
+
+        login_client->SetAccount(result.account);
 
-    login_client->SendTo(
-        BuildLoginClusterStatus(galaxy_status_));
+        login_client->SendTo(
+            BuildLoginClientToken(login_client, result.account_session));
 
-    auto characters = character_provider_->GetCharactersForAccount(login_client->GetAccount()->account_id());
+        login_client->SendTo(
+            BuildLoginEnumCluster(login_client, galaxy_status_));
 
-    login_client->SendTo(
-        BuildEnumerateCharacterId(characters));
+        login_client->SendTo(
+            BuildLoginClusterStatus(galaxy_status_));
+
+        login_client->SendTo(
+            BuildEnumerateCharacterId(result.characters));
+    });
 }
 
 uint32_t LoginService::GetAccountBySessionKey(const string& session_key) {
@@ -132,6 +132,9 @@ private:
     std::string listen_address_;
     uint16_t listen_port_;
     swganh::ActiveObject active_;
+
+    // Login replies are sent from here once the account lookup has finished.
+    boost::asio::strand strand_;
 };
 
 }} // namespace swganh::login
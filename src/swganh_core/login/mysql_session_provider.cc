@@ -24,7 +24,7 @@ uint64_t MysqlSessionProvider::GetPlayerId(uint32_t account_id) {
     try {
         string sql = "CALL sp_GetPlayerFromAccount(?);";
         auto conn = db_manager_->getConnection("galaxy");
-        auto statement = shared_ptr<sql::PreparedStatement>(conn->prepareStatement(sql));
+        auto statement = db_manager_->getPreparedStatement(conn, sql);
         statement->setUInt(1, account_id);
         auto result_set = unique_ptr<sql::ResultSet>(statement->executeQuery());
         
@@ -52,7 +52,7 @@ bool MysqlSessionProvider::CreateGameSession(uint64_t player_id, uint32_t sessio
     try {
         string sql = "CALL sp_CreateGameSession(?,?);";
         auto conn = db_manager_->getConnection("galaxy");
-        auto statement = shared_ptr<sql::PreparedStatement>(conn->prepareStatement(sql));
+        auto statement = db_manager_->getPreparedStatement(conn, sql);
         statement->setUInt64(1, player_id);
         statement->setString(2, game_session);
         auto rows_updated = statement->executeUpdate();
@@ -75,7 +75,7 @@ void MysqlSessionProvider::EndGameSession(uint64_t player_id)
 	try {
         string sql = "CALL sp_EndGameSession(?);";
         auto conn = db_manager_->getConnection("galaxy");
-        auto statement = shared_ptr<sql::PreparedStatement>(conn->prepareStatement(sql));
+        auto statement = db_manager_->getPreparedStatement(conn, sql);
         statement->setUInt64(1, player_id);
         auto rows_updated = statement->executeUpdate();
         
@@ -94,7 +94,7 @@ uint32_t MysqlSessionProvider::GetAccountId(uint64_t player_id) {
     try {
         string sql = "CALL sp_GetAccountId(?);";
         auto conn = db_manager_->getConnection("galaxy");
-        auto statement = shared_ptr<sql::PreparedStatement>(conn->prepareStatement(sql));
+        auto statement = db_manager_->getPreparedStatement(conn, sql);
         statement->setUInt64(1, player_id);
         auto result_set = unique_ptr<sql::ResultSet>(statement->executeQuery());
         
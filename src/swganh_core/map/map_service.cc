@@ -10,6 +10,8 @@
 #include <swganh/database/database_manager.h>
 #include <swganh/logger.h>
 
+#include <boost/thread/lock_guard.hpp>
+
 #include <swganh_core/simulation/simulation_service.h>
 #include <swganh_core/connection/connection_service_interface.h>
 #include <swganh_core/connection/connection_client_interface.h>
@@ -36,6 +38,7 @@ using swganh::messages::GetMapLocationsResponseMessage;
 
 MapService::MapService(swganh::app::SwganhKernel* kernel)
 	: kernel_(kernel)
+	, strand_(kernel->GetIoService())
 {
 }
 
@@ -142,6 +145,7 @@ bool MapService::LocationExists(uint32_t scene_id, std::wstring name)
 
 void MapService::SyncAddLocation(uint32_t scene_id, MapLocation& location)
 {
+	boost::lock_guard<boost::mutex> lock(changed_locations_mutex_);
 	changed_locations_.push(
 		std::tuple<uint32_t, uint32_t, MapLocation>(scene_id, 1, location)
 		);
@@ -149,6 +153,7 @@ void MapService::SyncAddLocation(uint32_t scene_id, MapLocation& location)
 
 void MapService::SyncRemoveLocation(uint32_t scene_id, MapLocation& location)
 {
+	boost::lock_guard<boost::mutex> lock(changed_locations_mutex_);
 	changed_locations_.push(
 		std::tuple<uint32_t, uint32_t, MapLocation>(scene_id, 2, location)
 		);
@@ -242,18 +247,32 @@ void MapService::LoadHighestLocationId()
 
 void MapService::PersistLocations()
 {
-	try
+	typedef std::tuple<uint32_t, uint32_t, MapLocation> ChangedLocation;
+
+	auto batch = std::make_shared<std::queue<ChangedLocation>>();
 	{
-		while(changed_locations_.size())
+		boost::lock_guard<boost::mutex> lock(changed_locations_mutex_);
+		if (changed_locations_.empty())
+		{
+			return;
+		}
+		std::swap(*batch, changed_locations_);
+	}
+
+	// The batch is written on a database worker, whatever is left of it after a
+	// failure goes back in front of the queue for the next timer.
+	auto db_manager = kernel_->GetDatabaseManager();
+	db_manager->ExecuteAsync([db_manager, batch] (const std::shared_ptr<sql::Connection>& conn) -> bool
+	{
+		while(batch->size())
 		{
-			std::tuple<uint32_t, uint32_t, MapLocation> location = changed_locations_.front();
+			const ChangedLocation& location = batch->front();
 
 			switch((uint32_t)std::get<1>(location))
 			{
 			case 1: // Add
 				{
-					auto conn = kernel_->GetDatabaseManager()->getConnection("galaxy");
-					auto statement = conn->prepareStatement("CALL sp_UpdateLocation(?, ?, ?, ?, ?, ?, ?);");
+					auto statement = db_manager->getPreparedStatement(conn, "CALL sp_UpdateLocation(?, ?, ?, ?, ?, ?, ?);");
 					statement->setUInt(1, (uint32_t)std::get<2>(location).id);
 					statement->setString(2, std::string(std::get<2>(location).name.begin(), std::get<2>(location).name.end()));
 					statement->setUInt(3, std::get<0>(location) - 1);
@@ -262,28 +281,44 @@ void MapService::PersistLocations()
 					statement->setDouble(6, std::get<2>(location).x);
 					statement->setDouble(7, std::get<2>(location).y);
 					auto result = std::unique_ptr<sql::ResultSet>(statement->executeQuery());
+					while(statement->getMoreResults());
 					break;
 				}
 
 			case 2: // Remove
 				{
-					auto conn = kernel_->GetDatabaseManager()->getConnection("galaxy");
-					auto statement = conn->prepareStatement("CALL sp_RemoveLocation(?, ?, ?);");
+					auto statement = db_manager->getPreparedStatement(conn, "CALL sp_RemoveLocation(?, ?, ?);");
 					statement->setUInt(1, (uint32_t)std::get<2>(location).id);
 					statement->setUInt(2, std::get<0>(location) - 1);
 					statement->setString(3, std::string(std::get<2>(location).name.begin(), std::get<2>(location).name.end()));
 					auto result = std::unique_ptr<sql::ResultSet>(statement->executeQuery());
+					while(statement->getMoreResults());
 					break;
 				}
 			}
 
+			batch->pop();
+		}
+
+		return true;
+	},
+	"galaxy",
+	strand_,
+	[this, batch] (std::exception_ptr error, bool)
+	{
+		if (!error)
+		{
+			return;
+		}
+
+		boost::lock_guard<boost::mutex> lock(changed_locations_mutex_);
+		while(changed_locations_.size())
+		{
+			batch->push(changed_locations_.front());
 			changed_locations_.pop();
 		}
-	}
-	catch(sql::SQLException &e) {
-		LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
-		LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
-	}
+		std::swap(*batch, changed_locations_);
+	});
 }
 
 void MapService::HandleRequestMapLocationsMessage(
@@ -5,6 +5,9 @@
 #include <queue>
 #include <tuple>
 
+#include <boost/asio/strand.hpp>
+#include <boost/thread/mutex.hpp>
+
 #include <swganh_core/map/map_service_interface.h>
 
 #include <swganh_core/messages/get_map_locations_response_message.h>
@@ -65,10 +68,15 @@ namespace map {
 		swganh::simulation::SimulationService* simulation_;
 		std::map<uint32_t, std::list<swganh::messages::MapLocation>> locations_;
 
+		// Changes are queued by the game and written by a database worker.
+		boost::mutex changed_locations_mutex_;
 		std::queue<
 			std::tuple<uint32_t /* scene_id */, uint32_t /* add, remove, update */, swganh::messages::MapLocation>
 			> changed_locations_;
 
+		// Database completions are posted here.
+		boost::asio::strand strand_;
+
 		uint32_t next_location_id_;
 	};
 
@@ -0,0 +1,203 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "bulk_object_loader.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <sstream>
+
+#include <cppconn/connection.h>
+#include <cppconn/resultset.h>
+#include <cppconn/statement.h>
+
+using namespace std;
+using namespace swganh::object;
+
+namespace {
+
+	void AppendIdList(stringstream& sql, const vector<uint64_t>& ids)
+	{
+		sql << "(";
+		for (size_t i = 0; i < ids.size(); ++i)
+		{
+			if (i != 0)
+			{
+				sql << ",";
+			}
+			sql << ids[i];
+		}
+		sql << ")";
+	}
+
+	template<typename Handler>
+	void ForEachChunk(const vector<uint64_t>& ids, size_t chunk_size, Handler handler)
+	{
+		for (size_t begin = 0; begin < ids.size(); begin += chunk_size)
+		{
+			size_t end = min(ids.size(), begin + chunk_size);
+			handler(vector<uint64_t>(ids.begin() + begin, ids.begin() + end));
+		}
+	}
+
+	// What ObjectFactory::CreateBaseObjectFromRow reads, by the names it reads them by.
+	const char* const kObjectColumns[] = {
+		"object.id AS object_id", "object.scene_id", "object.parent_id",
+		"object.x_position", "object.y_position", "object.z_position",
+		"object.x_orientation", "object.y_orientation", "object.z_orientation", "object.w_orientation",
+		"object.complexity", "object.stf_name_file", "object.stf_name_string", "object.custom_name",
+		"object.volume", "object.arrangement_id", "object.permission_type",
+		"swganh_static.iff_templates.iff_template", "swganh_static.iff_templates.attribute_template_id"
+	};
+
+	struct ChildRow
+	{
+		uint64_t object_id;
+		uint64_t parent_id;
+	};
+
+}
+
+BulkObjectLoader::BulkObjectLoader(uint32_t max_depth, size_t max_ids_per_query)
+	: max_depth_(max_depth)
+	, max_ids_per_query_(max_ids_per_query > 0 ? max_ids_per_query : 1)
+{
+}
+
+BulkLoadStatistics BulkObjectLoader::Load(sql::Connection& connection, uint64_t root_id, BulkLoadTarget& target)
+{
+	BulkLoadStatistics statistics = BulkLoadStatistics();
+	unique_ptr<sql::Statement> statement(connection.createStatement());
+
+	vector<uint64_t> frontier(1, root_id);
+	for (uint32_t depth = 0; depth < max_depth_ && !frontier.empty(); ++depth)
+	{
+		// Find the next level, grouped by type so each type is one query.
+		map<uint32_t, vector<ChildRow>> children_by_type;
+		vector<uint64_t> next_frontier;
+
+		ForEachChunk(frontier, max_ids_per_query_, [&] (const vector<uint64_t>& parent_ids) {
+			unique_ptr<sql::ResultSet> result(statement->executeQuery(BuildChildrenQuery(parent_ids)));
+			++statistics.queries;
+
+			while (result->next())
+			{
+				ChildRow child;
+				child.object_id = result->getUInt64("id");
+				child.parent_id = result->getUInt64("parent_id");
+				if (target.IsLoaded(child.object_id))
+				{
+					continue;
+				}
+
+				children_by_type[result->getUInt("type_id")].push_back(child);
+				next_frontier.push_back(child.object_id);
+			}
+		});
+
+		if (next_frontier.empty())
+		{
+			break;
+		}
+		++statistics.levels;
+
+		for (auto& type_children : children_by_type)
+		{
+			uint32_t object_type = type_children.first;
+			string type_table = target.GetTypeTable(object_type);
+			vector<string> type_columns = type_table.empty() ? vector<string>() : target.GetTypeColumns(object_type);
+
+			if (type_table.empty())
+			{
+				for (auto& child : type_children.second)
+				{
+					target.LoadSingle(child.object_id, object_type, child.parent_id);
+					++statistics.single_loads;
+				}
+				continue;
+			}
+
+			vector<uint64_t> object_ids;
+			object_ids.reserve(type_children.second.size());
+			for (auto& child : type_children.second)
+			{
+				object_ids.push_back(child.object_id);
+			}
+
+			ForEachChunk(object_ids, max_ids_per_query_, [&] (const vector<uint64_t>& ids) {
+				unique_ptr<sql::ResultSet> result(statement->executeQuery(BuildObjectQuery(type_table, type_columns, ids)));
+				++statistics.queries;
+
+				while (result->next())
+				{
+					target.LoadFromRow(object_type, *result);
+					++statistics.rows_loaded;
+				}
+			});
+		}
+
+		ForEachChunk(next_frontier, max_ids_per_query_, [&] (const vector<uint64_t>& ids) {
+			unique_ptr<sql::ResultSet> result(statement->executeQuery(BuildAttributeQuery(ids)));
+			++statistics.queries;
+
+			while (result->next())
+			{
+				target.LoadAttribute(result->getUInt64("object_id"), result->getString("name"), result->getString("attribute_value"));
+				++statistics.attributes;
+			}
+		});
+
+		frontier.swap(next_frontier);
+	}
+
+	return statistics;
+}
+
+string BulkObjectLoader::BuildChildrenQuery(const vector<uint64_t>& parent_ids)
+{
+	stringstream sql;
+	sql << "SELECT object.id, object.type_id, object.parent_id FROM object WHERE object.parent_id IN ";
+	AppendIdList(sql, parent_ids);
+	sql << " ORDER BY object.parent_id, object.id;";
+
+	return sql.str();
+}
+
+string BulkObjectLoader::BuildObjectQuery(const string& type_table, const vector<string>& type_columns,
+	const vector<uint64_t>& object_ids)
+{
+	// Only the columns the factories read, every joined table has an id column
+	// so the object id is selected as object_id.
+	stringstream sql;
+	sql << "SELECT ";
+	for (size_t i = 0; i < sizeof(kObjectColumns) / sizeof(kObjectColumns[0]); ++i)
+	{
+		sql << (i != 0 ? ", " : "") << kObjectColumns[i];
+	}
+	for (auto& column : type_columns)
+	{
+		sql << ", " << type_table << "." << column;
+	}
+	sql << " FROM object "
+		"LEFT JOIN swganh_static.iff_templates ON (object.iff_template_id = swganh_static.iff_templates.id) "
+		"LEFT JOIN " << type_table << " ON (" << type_table << ".id = object.id) "
+		"WHERE object.id IN ";
+	AppendIdList(sql, object_ids);
+	sql << " ORDER BY object.id;";
+
+	return sql.str();
+}
+
+string BulkObjectLoader::BuildAttributeQuery(const vector<uint64_t>& object_ids)
+{
+	stringstream sql;
+	sql << "SELECT object_attributes.object_id, swganh_static.attributes.name, object_attributes.attribute_value "
+		"FROM object_attributes "
+		"LEFT JOIN swganh_static.attributes ON (swganh_static.attributes.id = object_attributes.attribute_id) "
+		"WHERE object_attributes.object_id IN ";
+	AppendIdList(sql, object_ids);
+	sql << ";";
+
+	return sql.str();
+}
@@ -0,0 +1,118 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#ifndef SWGANH_OBJECT_BULK_OBJECT_LOADER_H_
+#define SWGANH_OBJECT_BULK_OBJECT_LOADER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+namespace sql {
+	class Connection;
+	class ResultSet;
+}
+
+namespace swganh {
+namespace object {
+
+	/**
+	 * Receives the objects found by a BulkObjectLoader. The ObjectManager turns
+	 * them into objects through the factories.
+	 */
+	class BulkLoadTarget
+	{
+	public:
+		virtual ~BulkLoadTarget() {}
+
+		/**
+		 * @return The table holding the type specific columns of a type, joined onto
+		 *      the object table to load every object of the type in one query. Empty
+		 *      if objects of the type have to be loaded one at a time.
+		 */
+		virtual std::string GetTypeTable(uint32_t object_type) = 0;
+
+		/**
+		 * @return The columns of the type table that LoadFromRow reads.
+		 */
+		virtual std::vector<std::string> GetTypeColumns(uint32_t object_type) = 0;
+
+		/**
+		 * @return True if the object is already loaded and should not be loaded again.
+		 */
+		virtual bool IsLoaded(uint64_t object_id) = 0;
+
+		/**
+		 * Creates an object from the current row of a type query. The row holds the
+		 * object columns read by ObjectFactory::CreateBaseObjectFromRow followed by
+		 * the GetTypeColumns of the type table, the id of the object is in the
+		 * object_id column.
+		 */
+		virtual void LoadFromRow(uint32_t object_type, sql::ResultSet& row) = 0;
+
+		/**
+		 * Loads an object whose type has no type table.
+		 */
+		virtual void LoadSingle(uint64_t object_id, uint32_t object_type, uint64_t parent_id) = 0;
+
+		/**
+		 * Applies a stored attribute to an object loaded earlier in the same level.
+		 */
+		virtual void LoadAttribute(uint64_t object_id, const std::string& name, const std::string& value) = 0;
+	};
+
+	struct BulkLoadStatistics
+	{
+		uint32_t levels;          ///< depth levels that had objects in them
+		uint32_t queries;         ///< round trips made
+		uint32_t rows_loaded;     ///< objects created from type query rows
+		uint32_t single_loads;    ///< objects handed to LoadSingle
+		uint32_t attributes;
+	};
+
+	/**
+	 * Loads every descendant of a stored object, breadth first.
+	 *
+	 * Each depth level costs one query to find the children of the previous level,
+	 * one query per object type present in the level and one query for the
+	 * attributes of the level, no matter how many objects the level holds. Long id
+	 * lists are split into chunks of max_ids_per_query.
+	 */
+	class BulkObjectLoader : private boost::noncopyable
+	{
+	public:
+		explicit BulkObjectLoader(uint32_t max_depth = 16, size_t max_ids_per_query = 1000);
+
+		/**
+		 * Loads the descendants of root_id into the target, parents are always
+		 * loaded before their children.
+		 */
+		BulkLoadStatistics Load(sql::Connection& connection, uint64_t root_id, BulkLoadTarget& target);
+
+		/**
+		 * @return A query for the id, type_id and parent_id of the children of the given objects.
+		 */
+		static std::string BuildChildrenQuery(const std::vector<uint64_t>& parent_ids);
+
+		/**
+		 * @return A query for the object columns and the given type table columns of
+		 *      the given objects.
+		 */
+		static std::string BuildObjectQuery(const std::string& type_table, const std::vector<std::string>& type_columns,
+			const std::vector<uint64_t>& object_ids);
+
+		/**
+		 * @return A query for the (object_id, name, attribute_value) attribute rows of the given objects.
+		 */
+		static std::string BuildAttributeQuery(const std::vector<uint64_t>& object_ids);
+
+	private:
+		uint32_t max_depth_;
+		size_t max_ids_per_query_;
+	};
+
+}}  // namespace swganh::object
+
+#endif  // SWGANH_OBJECT_BULK_OBJECT_LOADER_H_
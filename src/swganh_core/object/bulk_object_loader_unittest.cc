@@ -0,0 +1,197 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <turtle/mock.hpp>
+
+#include "swganh/database/mock_cppconn.h"
+
+#include "swganh_core/object/bulk_object_loader.h"
+
+using namespace swganh::object;
+
+namespace {
+
+	const uint32_t kTableType = 1;
+	const uint32_t kSingleType = 2;
+
+	typedef std::map<std::string, uint64_t> Row;
+
+	/**
+	 * Returns a result set that walks over the given rows, every column is read
+	 * through getUInt64/getUInt/getString by its label.
+	 */
+	sql::ResultSet* MakeResultSet(const std::vector<Row>& rows)
+	{
+		auto result = new MockResultSet();
+		auto data = std::make_shared<std::vector<Row>>(rows);
+		auto cursor = std::make_shared<int>(-1);
+
+		MOCK_EXPECT(result->next).calls([data, cursor] () {
+			return ++*cursor < static_cast<int>(data->size());
+		});
+		MOCK_EXPECT(result->tag15).calls([data, cursor] (const sql::SQLString& label) {
+			return data->at(*cursor).at(label.asStdString());
+		});
+		MOCK_EXPECT(result->tag11).calls([data, cursor] (const sql::SQLString& label) {
+			return static_cast<uint32_t>(data->at(*cursor).at(label.asStdString()));
+		});
+		MOCK_EXPECT(result->tag22).calls([data, cursor] (const sql::SQLString& label) {
+			return sql::SQLString(std::to_string(data->at(*cursor).at(label.asStdString())));
+		});
+
+		return result;
+	}
+
+	Row ChildRow(uint64_t id, uint32_t type_id, uint64_t parent_id)
+	{
+		Row row;
+		row["id"] = id;
+		row["type_id"] = type_id;
+		row["parent_id"] = parent_id;
+		return row;
+	}
+
+	Row ObjectRow(uint64_t id)
+	{
+		Row row;
+		row["object_id"] = id;
+		return row;
+	}
+
+	class FakeTarget : public BulkLoadTarget
+	{
+	public:
+		std::string GetTypeTable(uint32_t object_type)
+		{
+			return object_type == kTableType ? "tangible" : "";
+		}
+
+		std::vector<std::string> GetTypeColumns(uint32_t object_type)
+		{
+			return std::vector<std::string>(1, "options_bitmask");
+		}
+
+		bool IsLoaded(uint64_t object_id)
+		{
+			return std::find(loaded.begin(), loaded.end(), object_id) != loaded.end();
+		}
+
+		void LoadFromRow(uint32_t object_type, sql::ResultSet& row)
+		{
+			loaded.push_back(row.getUInt64("object_id"));
+		}
+
+		void LoadSingle(uint64_t object_id, uint32_t object_type, uint64_t parent_id)
+		{
+			loaded.push_back(object_id);
+		}
+
+		void LoadAttribute(uint64_t object_id, const std::string& name, const std::string& value)
+		{
+			++attributes;
+		}
+
+		std::vector<uint64_t> loaded;
+		int attributes;
+	};
+
+}
+
+BOOST_AUTO_TEST_SUITE(BulkObjectLoaderTest)
+
+/// This test shows that a tree is loaded with one children query, one query per
+/// type with a table and one attribute query per depth level, parents first.
+BOOST_AUTO_TEST_CASE(LoadsEachLevelWithOneQueryPerType) {
+	MockConnection connection;
+	auto statement = new MockStatement();
+	MOCK_EXPECT(connection.createStatement).once().returns(statement);
+
+	mock::sequence queries;
+	// level 1: 2 (table type) and 3 (single) inside of the root
+	MOCK_EXPECT(statement->executeQuery).once().in(queries).returns(
+		MakeResultSet({ChildRow(2, kTableType, 1), ChildRow(3, kSingleType, 1)}));
+	MOCK_EXPECT(statement->executeQuery).once().in(queries).returns(MakeResultSet({ObjectRow(2)}));
+	MOCK_EXPECT(statement->executeQuery).once().in(queries).returns(MakeResultSet(std::vector<Row>()));
+	// level 2: 4 and 5 inside of 2
+	MOCK_EXPECT(statement->executeQuery).once().in(queries).returns(
+		MakeResultSet({ChildRow(4, kTableType, 2), ChildRow(5, kTableType, 2)}));
+	MOCK_EXPECT(statement->executeQuery).once().in(queries).returns(MakeResultSet({ObjectRow(4), ObjectRow(5)}));
+	MOCK_EXPECT(statement->executeQuery).once().in(queries).returns(MakeResultSet(std::vector<Row>()));
+	// level 3: nothing left
+	MOCK_EXPECT(statement->executeQuery).once().in(queries).returns(MakeResultSet(std::vector<Row>()));
+
+	FakeTarget target;
+	target.attributes = 0;
+	auto statistics = BulkObjectLoader().Load(connection, 1, target);
+
+	BOOST_CHECK_EQUAL(2u, statistics.levels);
+	BOOST_CHECK_EQUAL(7u, statistics.queries);
+	BOOST_CHECK_EQUAL(3u, statistics.rows_loaded);
+	BOOST_CHECK_EQUAL(1u, statistics.single_loads);
+
+	std::vector<uint64_t> expected_order;
+	expected_order.push_back(2);
+	expected_order.push_back(3);
+	expected_order.push_back(4);
+	expected_order.push_back(5);
+	BOOST_CHECK_EQUAL_COLLECTIONS(expected_order.begin(), expected_order.end(), target.loaded.begin(), target.loaded.end());
+}
+
+/// This test shows that long id lists are split over several IN clauses.
+BOOST_AUTO_TEST_CASE(LongIdListsAreChunked) {
+	MockConnection connection;
+	auto statement = new MockStatement();
+	MOCK_EXPECT(connection.createStatement).once().returns(statement);
+
+	// three children of the root, two ids per query
+	MOCK_EXPECT(statement->executeQuery).once().returns(
+		MakeResultSet({ChildRow(2, kSingleType, 1), ChildRow(3, kSingleType, 1), ChildRow(4, kSingleType, 1)}));
+	MOCK_EXPECT(statement->executeQuery).exactly(2).with(mock::call([] (const sql::SQLString& sql) {
+		return sql.asStdString().find("object_attributes") != std::string::npos;
+	})).calls([] (const sql::SQLString&) { return MakeResultSet(std::vector<Row>()); });
+	MOCK_EXPECT(statement->executeQuery).exactly(2).with(mock::call([] (const sql::SQLString& sql) {
+		return sql.asStdString().find("WHERE object.parent_id IN") != std::string::npos;
+	})).calls([] (const sql::SQLString&) { return MakeResultSet(std::vector<Row>()); });
+
+	FakeTarget target;
+	target.attributes = 0;
+	auto statistics = BulkObjectLoader(16, 2).Load(connection, 1, target);
+
+	BOOST_CHECK_EQUAL(5u, statistics.queries);
+	BOOST_CHECK_EQUAL(3u, statistics.single_loads);
+}
+
+/// This test shows that the generated queries select by an IN list of the ids.
+BOOST_AUTO_TEST_CASE(QueriesSelectByIdList) {
+	std::vector<uint64_t> ids;
+	ids.push_back(10);
+	ids.push_back(11);
+
+	BOOST_CHECK_EQUAL(
+		"SELECT object.id, object.type_id, object.parent_id FROM object WHERE object.parent_id IN (10,11) ORDER BY object.parent_id, object.id;",
+		BulkObjectLoader::BuildChildrenQuery(ids));
+
+	std::vector<std::string> columns;
+	columns.push_back("customization");
+	columns.push_back("is_static");
+
+	auto object_sql = BulkObjectLoader::BuildObjectQuery("tangible", columns, ids);
+	BOOST_CHECK(object_sql.find("SELECT object.id AS object_id, ") == 0);
+	BOOST_CHECK(object_sql.find("*") == std::string::npos);
+	BOOST_CHECK(object_sql.find("swganh_static.iff_templates.iff_template, ") != std::string::npos);
+	BOOST_CHECK(object_sql.find(", tangible.customization, tangible.is_static FROM object ") != std::string::npos);
+	BOOST_CHECK(object_sql.find("LEFT JOIN tangible ON (tangible.id = object.id)") != std::string::npos);
+	BOOST_CHECK(object_sql.find("WHERE object.id IN (10,11)") != std::string::npos);
+
+	auto attribute_sql = BulkObjectLoader::BuildAttributeQuery(ids);
+	BOOST_CHECK(attribute_sql.find("WHERE object_attributes.object_id IN (10,11)") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -13,6 +13,7 @@
 #include "swganh/logger.h"
 
 #include "swganh/database/database_manager.h"
+#include "swganh_core/object/object_manager.h"
 
 using namespace std;
 using namespace swganh::object;
@@ -30,16 +31,15 @@ void CellFactory::RegisterEventHandlers()
 
 void CellFactory::PersistChangedObjects()
 {
-	std::set<shared_ptr<Object>> persisted;
-	{
-		boost::lock_guard<boost::mutex> lg(persisted_objects_mutex_);
-		persisted = move(persisted_objects_);
-	}
-	for (auto& object : persisted)
-	{
-		if(object->IsDatabasePersisted())
-			PersistObject(object);
-	}
+	PersistChangedTypeColumns();
+}
+
+void CellFactory::SnapshotTypeCalls(const shared_ptr<Object>& object, vector<ProcedureCall>& calls)
+{
+	auto cell = static_pointer_cast<Cell>(object);
+	ProcedureCall call(cell->GetObjectId(), "CALL sp_PersistCell(?);", MERGE_LATEST);
+	call.AddInt(cell->GetCell());
+	calls.push_back(move(call));
 }
 
 uint32_t CellFactory::PersistObject(const shared_ptr<Object>& object, bool persist_inherited)
@@ -50,13 +50,13 @@ uint32_t CellFactory::PersistObject(const shared_ptr<Object>& object, bool persi
 		IntangibleFactory::PersistObject(object, persist_inherited);
 	try 
     {
-		auto conn = GetDatabaseManager()->getConnection("galaxy");
-		auto statement = shared_ptr<sql::PreparedStatement>
-			(conn->prepareStatement("CALL sp_PersistCell(?);"));
-		
-		auto cell = static_pointer_cast<Cell>(object);
-		statement->setInt(counter++, cell->GetCell());
-		statement->executeUpdate();
+		vector<ProcedureCall> calls;
+		CellFactory::SnapshotTypeCalls(object, calls);
+		for (auto& call : calls)
+		{
+			WriteProcedureCall(GetDatabaseManager(), call);
+			counter += call.parameters.size();
+		}
 	}
 	catch(sql::SQLException &e)
 	{
@@ -3,6 +3,8 @@
 
 #include "creature.h"
 
+#include "swganh/pool_allocator.h"
+
 #include "swganh/crc.h"
 
 #include "swganh_core/object/object_events.h"
@@ -1299,7 +1301,7 @@ void Creature::CleanUpBuffs()
 std::shared_ptr<Object> Creature::Clone()
 {
 	boost::lock_guard<boost::mutex> lock(object_mutex_);
-	auto other = make_shared<Creature>();
+	auto other = swganh::MakePooled<Creature>();
 	Clone(other);
 	return other;
 }
@@ -3,6 +3,8 @@
 
 #include "creature_factory.h"
 
+#include "swganh/pool_allocator.h"
+
 #include <sstream>
 
 #include <cppconn/exception.h>
@@ -14,6 +16,7 @@
 #include "swganh/logger.h"
 
 #include "swganh/database/database_manager.h"
+#include "swganh_core/object/object_manager.h"
 #include "swganh_core/object/creature/creature.h"
 #include "swganh_core/object/exception.h"
 #include "swganh_core/simulation/simulation_service_interface.h"
@@ -73,16 +76,83 @@ void CreatureFactory::RegisterEventHandlers()
 }
 void CreatureFactory::PersistChangedObjects()
 {
-	std::set<shared_ptr<Object>> persisted;
-	{
-		boost::lock_guard<boost::mutex> lg(persisted_objects_mutex_);
-		persisted = move(persisted_objects_);
-	}
-	for (auto& object : persisted)
-	{
-		if(object->IsDatabasePersisted())
-			PersistObject(object);
-	}
+	PersistChangedTypeColumns();
+}
+void CreatureFactory::SnapshotTypeCalls(const shared_ptr<Object>& object, vector<ProcedureCall>& calls)
+{
+	auto creature = static_pointer_cast<Creature>(object);
+	// 65 of these
+	ProcedureCall call(creature->GetObjectId(), "CALL sp_PersistCreature(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,"
+		"?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);", MERGE_LATEST);
+	call.AddUInt64(creature->GetObjectId());
+	call.AddUInt64(creature->GetOwnerId());
+	call.AddUInt64(creature->GetListenToId());
+	call.AddUInt64(creature->GetBankCredits());
+	call.AddUInt64(creature->GetCashCredits());
+	call.AddUInt64(creature->GetPosture());
+	call.AddUInt(creature->GetFactionRank());
+	call.AddDouble(creature->GetScale());
+	call.AddUInt64(creature->GetBattleFatigue());
+	call.AddUInt64(creature->GetStateBitmask());
+	call.AddDouble(creature->GetAccelerationMultiplierBase());
+	call.AddDouble(creature->GetAccelerationMultiplierModifier());
+	call.AddDouble(creature->GetSpeedMultiplierBase());
+	call.AddDouble(creature->GetSpeedMultiplierModifier());
+	call.AddDouble(creature->GetRunSpeed());
+	call.AddDouble(creature->GetSlopeModifierAngle());
+	call.AddDouble(creature->GetSlopeModifierPercent());
+	call.AddDouble(creature->GetTurnRadius());
+	call.AddDouble(creature->GetWalkingSpeed());
+	call.AddDouble(creature->GetWaterModifierPercent());
+	call.AddInt(creature->GetCombatLevel());
+	call.AddString(creature->GetAnimation());
+	call.AddUInt64(creature->GetGroupId());
+	call.AddUInt(creature->GetGuildId());
+	call.AddUInt64(creature->GetWeaponId());
+	call.AddUInt(creature->GetMoodId());
+	call.AddUInt(creature->GetPerformanceId());
+	call.AddString(creature->GetDisguise());
+	// WOUNDS
+	call.AddInt(creature->GetStatWound(HEALTH));
+	call.AddInt(creature->GetStatWound(STRENGTH));
+	call.AddInt(creature->GetStatWound(CONSTITUTION));
+	call.AddInt(creature->GetStatWound(ACTION));
+	call.AddInt(creature->GetStatWound(QUICKNESS));
+	call.AddInt(creature->GetStatWound(STAMINA));
+	call.AddInt(creature->GetStatWound(MIND));
+	call.AddInt(creature->GetStatWound(FOCUS));
+	call.AddInt(creature->GetStatWound(WILLPOWER));
+	// ENCUMBERANCE
+	call.AddInt(creature->GetStatEncumberance(HEALTH));
+	call.AddInt(creature->GetStatEncumberance(STRENGTH));
+	call.AddInt(creature->GetStatEncumberance(CONSTITUTION));
+	call.AddInt(creature->GetStatEncumberance(ACTION));
+	call.AddInt(creature->GetStatEncumberance(QUICKNESS));
+	call.AddInt(creature->GetStatEncumberance(STAMINA));
+	call.AddInt(creature->GetStatEncumberance(MIND));
+	call.AddInt(creature->GetStatEncumberance(FOCUS));
+	call.AddInt(creature->GetStatEncumberance(WILLPOWER));
+	// CURRENT
+	call.AddInt(creature->GetStatCurrent(HEALTH));
+	call.AddInt(creature->GetStatCurrent(STRENGTH));
+	call.AddInt(creature->GetStatCurrent(CONSTITUTION));
+	call.AddInt(creature->GetStatCurrent(ACTION));
+	call.AddInt(creature->GetStatCurrent(QUICKNESS));
+	call.AddInt(creature->GetStatCurrent(STAMINA));
+	call.AddInt(creature->GetStatCurrent(MIND));
+	call.AddInt(creature->GetStatCurrent(FOCUS));
+	call.AddInt(creature->GetStatCurrent(WILLPOWER));
+	// MAX
+	call.AddInt(creature->GetStatMax(HEALTH));
+	call.AddInt(creature->GetStatMax(STRENGTH));
+	call.AddInt(creature->GetStatMax(CONSTITUTION));
+	call.AddInt(creature->GetStatMax(ACTION));
+	call.AddInt(creature->GetStatMax(QUICKNESS));
+	call.AddInt(creature->GetStatMax(STAMINA));
+	call.AddInt(creature->GetStatMax(MIND));
+	call.AddInt(creature->GetStatMax(FOCUS));
+	call.AddInt(creature->GetStatMax(WILLPOWER));
+	calls.push_back(move(call));
 }
 uint32_t CreatureFactory::PersistObject(const shared_ptr<Object>& object, bool persist_inherited)
 {
@@ -91,85 +161,14 @@ uint32_t CreatureFactory::PersistObject(const shared_ptr<Object>& object, bool p
 		TangibleFactory::PersistObject(object, persist_inherited);
 	// Now for the biggy
     try
-    {	
-        auto conn = GetDatabaseManager()->getConnection("galaxy");
-        // 65 of these
-        string sql = "CALL sp_PersistCreature(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,"
-            "?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);";
-        auto statement = unique_ptr<sql::PreparedStatement>(conn->prepareStatement(sql));
-        auto creature = static_pointer_cast<Creature>(object);
-        statement->setUInt64(counter++, creature->GetObjectId());
-        statement->setUInt64(counter++, creature->GetOwnerId());
-        statement->setUInt64(counter++, creature->GetListenToId());
-        statement->setUInt64(counter++, creature->GetBankCredits());
-        statement->setUInt64(counter++, creature->GetCashCredits());
-        statement->setUInt64(counter++, creature->GetPosture());
-        statement->setUInt(counter++, creature->GetFactionRank());
-        statement->setDouble(counter++, creature->GetScale());
-        statement->setUInt64(counter++, creature->GetBattleFatigue());
-        statement->setUInt64(counter++, creature->GetStateBitmask());
-        statement->setDouble(counter++, creature->GetAccelerationMultiplierBase());
-        statement->setDouble(counter++, creature->GetAccelerationMultiplierModifier());
-        statement->setDouble(counter++, creature->GetSpeedMultiplierBase());
-        statement->setDouble(counter++, creature->GetSpeedMultiplierModifier());
-        statement->setDouble(counter++, creature->GetRunSpeed());
-        statement->setDouble(counter++, creature->GetSlopeModifierAngle());
-        statement->setDouble(counter++, creature->GetSlopeModifierPercent());
-        statement->setDouble(counter++, creature->GetTurnRadius());
-        statement->setDouble(counter++, creature->GetWalkingSpeed());
-        statement->setDouble(counter++, creature->GetWaterModifierPercent());
-        statement->setInt(counter++, creature->GetCombatLevel());
-        statement->setString(counter++, creature->GetAnimation());
-        statement->setUInt64(counter++, creature->GetGroupId());
-        statement->setUInt(counter++, creature->GetGuildId());
-        statement->setUInt64(counter++, creature->GetWeaponId());
-        statement->setUInt(counter++, creature->GetMoodId());
-        statement->setUInt(counter++, creature->GetPerformanceId());
-        statement->setString(counter++, creature->GetDisguise());
-        // WOUNDS
-        statement->setInt(counter++, creature->GetStatWound(HEALTH));
-        statement->setInt(counter++, creature->GetStatWound(STRENGTH));
-        statement->setInt(counter++, creature->GetStatWound(CONSTITUTION));
-        statement->setInt(counter++, creature->GetStatWound(ACTION));
-        statement->setInt(counter++, creature->GetStatWound(QUICKNESS));
-        statement->setInt(counter++, creature->GetStatWound(STAMINA));
-        statement->setInt(counter++, creature->GetStatWound(MIND));
-        statement->setInt(counter++, creature->GetStatWound(FOCUS));
-        statement->setInt(counter++, creature->GetStatWound(WILLPOWER));
-        // ENCUMBERANCE
-        statement->setInt(counter++, creature->GetStatEncumberance(HEALTH));
-        statement->setInt(counter++, creature->GetStatEncumberance(STRENGTH));
-        statement->setInt(counter++, creature->GetStatEncumberance(CONSTITUTION));
-        statement->setInt(counter++, creature->GetStatEncumberance(ACTION));
-        statement->setInt(counter++, creature->GetStatEncumberance(QUICKNESS));
-        statement->setInt(counter++, creature->GetStatEncumberance(STAMINA));
-        statement->setInt(counter++, creature->GetStatEncumberance(MIND));
-        statement->setInt(counter++, creature->GetStatEncumberance(FOCUS));
-        statement->setInt(counter++, creature->GetStatEncumberance(WILLPOWER));
-        // CURRENT
-        statement->setInt(counter++, creature->GetStatCurrent(HEALTH));
-        statement->setInt(counter++, creature->GetStatCurrent(STRENGTH));
-        statement->setInt(counter++, creature->GetStatCurrent(CONSTITUTION));
-        statement->setInt(counter++, creature->GetStatCurrent(ACTION));
-        statement->setInt(counter++, creature->GetStatCurrent(QUICKNESS));
-        statement->setInt(counter++, creature->GetStatCurrent(STAMINA));
-        statement->setInt(counter++, creature->GetStatCurrent(MIND));
-        statement->setInt(counter++, creature->GetStatCurrent(FOCUS));
-        statement->setInt(counter++, creature->GetStatCurrent(WILLPOWER));
-        // MAX
-        statement->setInt(counter++, creature->GetStatMax(HEALTH));
-        statement->setInt(counter++, creature->GetStatMax(STRENGTH));
-        statement->setInt(counter++, creature->GetStatMax(CONSTITUTION));
-        statement->setInt(counter++, creature->GetStatMax(ACTION));
-        statement->setInt(counter++, creature->GetStatMax(QUICKNESS));
-        statement->setInt(counter++, creature->GetStatMax(STAMINA));
-        statement->setInt(counter++, creature->GetStatMax(MIND));
-        statement->setInt(counter++, creature->GetStatMax(FOCUS));
-        statement->setInt(counter++, creature->GetStatMax(WILLPOWER));
-
-        int updated = statement->executeUpdate();
-				
-        LOG(warning) << "Updated " << updated << " rows in sp_PersistCreature with object id = " << object->GetObjectId();
+    {
+		vector<ProcedureCall> calls;
+		CreatureFactory::SnapshotTypeCalls(object, calls);
+		for (auto& call : calls)
+		{
+			WriteProcedureCall(GetDatabaseManager(), call);
+			counter += call.parameters.size();
+		}
     }
     catch(sql::SQLException &e)
     {
@@ -186,7 +185,7 @@ void CreatureFactory::DeleteObjectFromStorage(const shared_ptr<Object>& object)
 
 shared_ptr<Object> CreatureFactory::CreateObjectFromStorage(uint64_t object_id)
 {
-    auto creature = make_shared<Creature>();
+    auto creature = swganh::MakePooled<Creature>();
     creature->SetObjectId(object_id);
     try {
         auto conn = GetDatabaseManager()->getConnection("galaxy");
@@ -303,7 +302,7 @@ shared_ptr<Object> CreatureFactory::CreateObjectFromStorage(uint64_t object_id)
 
 shared_ptr<Object> CreatureFactory::CreateObject()
 {
-	return make_shared<Creature>();
+	return swganh::MakePooled<Creature>();
 }
 
 void CreatureFactory::LoadBuffs_(
@@ -30,10 +30,14 @@ namespace object {
 
         void DeleteObjectFromStorage(const std::shared_ptr<swganh::object::Object>& object);
 		virtual void PersistChangedObjects();
+		virtual void SnapshotTypeCalls(const std::shared_ptr<swganh::object::Object>& object, std::vector<ProcedureCall>& calls);
 		virtual void RegisterEventHandlers();
         std::shared_ptr<swganh::object::Object> CreateObjectFromStorage(uint64_t object_id);
 
         std::shared_ptr<swganh::object::Object> CreateObject();
+
+        // Rows from the tangible table alone do not hold this type, load these one at a time.
+        virtual std::string GetBulkLoadTable() const { return ""; }
         
     private:
 		void LoadBuffs_(const std::shared_ptr<swganh::object::Creature>& creature,
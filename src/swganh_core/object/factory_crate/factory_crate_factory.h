@@ -26,6 +26,9 @@ namespace object {
 
 		std::shared_ptr<swganh::object::Object> CreateObject();
 
+		// Rows from the tangible table alone do not hold this type, load these one at a time.
+		virtual std::string GetBulkLoadTable() const { return ""; }
+
     };
 
 
@@ -14,6 +14,7 @@
 #include "swganh/logger.h"
 
 #include "swganh/database/database_manager.h"
+#include "swganh_core/object/object_manager.h"
 
 using namespace std;
 using namespace swganh::object;
@@ -41,16 +42,23 @@ void InstallationFactory::RegisterEventHandlers()
 }
 void InstallationFactory::PersistChangedObjects()
 {
-	std::set<shared_ptr<Object>> persisted;
-	{
-		boost::lock_guard<boost::mutex> lg(persisted_objects_mutex_);
-		persisted = move(persisted_objects_);
-	}
-	for (auto& object : persisted)
-	{
-		if(object->IsDatabasePersisted())
-			PersistObject(object);
-	}
+	PersistChangedTypeColumns();
+}
+void InstallationFactory::SnapshotTypeCalls(const shared_ptr<Object>& object, vector<ProcedureCall>& calls)
+{
+	auto installation = static_pointer_cast<Installation>(object);
+	ProcedureCall call(installation->GetObjectId(), "CALL sp_PersistInstallation(?,?,?,?,?,?,?,?,?,?);", MERGE_LATEST);
+	call.AddUInt64(installation->GetObjectId());
+	call.AddUInt64(installation->GetSelectedResourceId());
+	call.AddInt(installation->IsActive() == true ? 1 : 0);
+	call.AddDouble(installation->GetPowerReserve());
+	call.AddDouble(installation->GetPowerCost());
+	call.AddDouble(installation->GetMaxExtractionRate());
+	call.AddDouble(installation->GetCurrentExtractionRate());
+	call.AddDouble(installation->GetCurrentHopperSize());
+	call.AddInt(installation->IsUpdating() == true ? 1 : 0);
+	call.AddDouble(installation->GetConditionPercentage());
+	calls.push_back(move(call));
 }
 uint32_t InstallationFactory::PersistObject(const shared_ptr<Object>& object, bool persist_inherited)
 {
@@ -59,30 +67,19 @@ uint32_t InstallationFactory::PersistObject(const shared_ptr<Object>& object, bo
 		TangibleFactory::PersistObject(object, persist_inherited);
 	try 
     {
-        auto conn = GetDatabaseManager()->getConnection("galaxy");
-        auto statement = shared_ptr<sql::PreparedStatement>
-			(conn->prepareStatement("CALL sp_PersistInstallation(?,?,?,?,?,?,?,?,?,?);"));        
-
-		auto installation = static_pointer_cast<Installation>(object);
-		statement->setUInt64(counter++, installation->GetObjectId());
-		statement->setUInt64(counter++, installation->GetSelectedResourceId());
-		statement->setInt(counter++, installation->IsActive() == true ? 1 : 0);
-		statement->setDouble(counter++, installation->GetPowerReserve());
-		statement->setDouble(counter++, installation->GetPowerCost());
-		statement->setDouble(counter++, installation->GetMaxExtractionRate());
-		statement->setDouble(counter++, installation->GetCurrentExtractionRate());
-		statement->setDouble(counter++, installation->GetCurrentHopperSize());
-		statement->setInt(counter++, installation->IsUpdating() == true ? 1 : 0);
-		statement->setDouble(counter++, installation->GetConditionPercentage());
-
-		statement->executeUpdate();
+		vector<ProcedureCall> calls;
+		InstallationFactory::SnapshotTypeCalls(object, calls);
+		for (auto& call : calls)
+		{
+			WriteProcedureCall(GetDatabaseManager(), call);
+			counter += call.parameters.size();
+		}
 	}
 	catch(sql::SQLException &e)
-    {
-        LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
+	{
+		LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
         LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
-    }
-
+	}
 	return counter;
 }
 
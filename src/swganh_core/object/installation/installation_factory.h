@@ -18,11 +18,15 @@ namespace object {
 
         virtual uint32_t PersistObject(const std::shared_ptr<swganh::object::Object>& object, bool persist_inherited = false);
 		virtual void PersistChangedObjects();
+		virtual void SnapshotTypeCalls(const std::shared_ptr<swganh::object::Object>& object, std::vector<ProcedureCall>& calls);
         void DeleteObjectFromStorage(const std::shared_ptr<swganh::object::Object>& object);
 		std::shared_ptr<swganh::object::Object> CreateObjectFromStorage(uint64_t object_id);
 
         std::shared_ptr<swganh::object::Object> CreateObject();
 
+        // Rows from the tangible table alone do not hold this type, load these one at a time.
+        virtual std::string GetBulkLoadTable() const { return ""; }
+
 		virtual void RegisterEventHandlers();
     };
 
@@ -9,7 +9,6 @@
 #include "object_events.h"
 
 #include "swganh/logger.h"
-#include "swganh/crc.h"
 #include "swganh/observer/observer_interface.h"
 
 
@@ -31,7 +30,7 @@ using namespace swganh::messages;
 Object::Object()
     : object_id_(0)
 	, instance_id_(0)
-    , template_string_("")
+    , template_info_(TemplateRegistry::getInstance().Intern(""))
     , position_(glm::vec3(0,0,0))
     , orientation_(glm::quat())
     , complexity_(0)
@@ -48,6 +47,8 @@ Object::Object()
 	, attributes_template_id(-1)
 	, event_dispatcher_(nullptr)
 	, controller_(nullptr)
+	, changed_fields_(PERSIST_ALL_FIELDS)
+	, aware_objects_snapshot_(EmptyAwareObjects_())
 {
 }
 
@@ -101,8 +102,10 @@ void Object::AddObject(std::shared_ptr<Object> requester, std::shared_ptr<Object
 			arrangement_id = __InternalInsert(obj, arrangement_id);
 		}
 
-		//Update our observers with the new object
-		std::for_each(aware_objects_.begin(), aware_objects_.end(), [&] (std::shared_ptr<Object> object) {
+		//Update our observers with the new object, an object may be aware of
+		//itself, the snapshot stays the same while the set changes
+		auto aware_objects = GetAwareObjects_();
+		std::for_each(aware_objects->begin(), aware_objects->end(), [&] (const std::shared_ptr<Object>& object) {
 			obj->__InternalAddAwareObject(object);		
 			object->__InternalAddAwareObject(obj);
 		});
@@ -116,7 +119,8 @@ void Object::RemoveObject(std::shared_ptr<Object> requester, std::shared_ptr<Obj
 		boost::upgrade_lock<boost::shared_mutex> lock(global_container_lock_);
 
 		//Update our observers about the dead object
-		std::for_each(aware_objects_.begin(), aware_objects_.end(), [&] (std::shared_ptr<Object> object) {
+		auto aware_objects = GetAwareObjects_();
+		std::for_each(aware_objects->begin(), aware_objects->end(), [&] (const std::shared_ptr<Object>& object) {
 			oldObject->__InternalRemoveAwareObject(object);	
 			object->__InternalRemoveAwareObject(oldObject);
 		});
@@ -240,7 +244,14 @@ int32_t Object::__InternalInsert(std::shared_ptr<Object> object, int32_t arrange
 	}
 	else
 	{
-		auto& arrangement = object->slot_arrangements_[arrangement_id-4];
+		auto& arrangements = object->GetTemplateInfo()->GetSlotArrangements();
+		if (static_cast<size_t>(arrangement_id - 4) >= arrangements.size())
+		{
+			LOG(warning) << "Object " << object->GetObjectId() << " has no slot arrangement " << arrangement_id;
+			return arrangement_id;
+		}
+
+		auto& arrangement = arrangements[arrangement_id-4];
 		for (auto& i : arrangement)
 		{
 			slot_descriptor_[i]->insert_object(object);			
@@ -334,13 +345,38 @@ void Object::__InternalTransfer(std::shared_ptr<Object> requester, std::shared_p
 }
 
 
+const Object::AwareObjectSnapshot& Object::EmptyAwareObjects_()
+{
+	static const AwareObjectSnapshot empty = std::make_shared<const AwareObjectContainer>();
+	return empty;
+}
+
+Object::AwareObjectSnapshot Object::GetAwareObjects_() const
+{
+	boost::lock_guard<boost::mutex> lock(aware_objects_mutex_);
+	if(!aware_objects_snapshot_)
+	{
+		aware_objects_snapshot_ = aware_objects_.empty() ? EmptyAwareObjects_()
+			: std::make_shared<const AwareObjectContainer>(aware_objects_);
+	}
+	return aware_objects_snapshot_;
+}
+
 void Object::__InternalAddAwareObject(std::shared_ptr<swganh::object::Object> object)
 {	
-	auto find_itr = aware_objects_.find(object);
-	if(find_itr == aware_objects_.end())
+	bool inserted;
+	{
+		boost::lock_guard<boost::mutex> lock(aware_objects_mutex_);
+		inserted = aware_objects_.insert(object).second;
+		if(inserted)
+		{
+			aware_objects_snapshot_.reset();
+		}
+	}
+
+	if(inserted)
 	{
 		auto observer = object->GetController();
-		aware_objects_.insert(object);
 
 		if(observer)
 		{
@@ -367,16 +403,25 @@ void Object::__InternalAddAwareObject(std::shared_ptr<swganh::object::Object> ob
 
 void Object::__InternalViewAwareObjects(std::function<void(std::shared_ptr<swganh::object::Object>)> func, std::shared_ptr<swganh::object::Object> hint)
 {
-	std::for_each(aware_objects_.begin(), aware_objects_.end(), func);
+	auto aware_objects = GetAwareObjects_();
+	std::for_each(aware_objects->begin(), aware_objects->end(), func);
 }
 
 void Object::__InternalRemoveAwareObject(std::shared_ptr<swganh::object::Object> object)
 {
-	auto find_itr = aware_objects_.find(object);
-	if(find_itr != aware_objects_.end())
+	bool erased;
+	{
+		boost::lock_guard<boost::mutex> lock(aware_objects_mutex_);
+		erased = aware_objects_.erase(object) != 0;
+		if(erased)
+		{
+			aware_objects_snapshot_.reset();
+		}
+	}
+
+	if(erased)
 	{
 		auto observer = object->GetController();
-		aware_objects_.erase(object);
 
 		if(observer)
 		{
@@ -399,6 +444,7 @@ void Object::__InternalRemoveAwareObject(std::shared_ptr<swganh::object::Object>
 
 bool Object::__HasAwareObject(std::shared_ptr<Object> object)
 {
+	boost::lock_guard<boost::mutex> lock(aware_objects_mutex_);
 	return aware_objects_.find(object) != aware_objects_.end();
 }
 
@@ -412,15 +458,16 @@ glm::vec3 Object::__InternalGetAbsolutePosition()
 
 string Object::GetTemplate()
 {
-    boost::lock_guard<boost::mutex> lock(object_mutex_);
-	return template_string_;
+	return GetTemplateInfo()->GetName();
 }
 void Object::SetTemplate(const string& template_string)
 {
-    {
-        boost::lock_guard<boost::mutex> lock(object_mutex_);
-	    template_string_ = template_string;
-    }
+	auto& registry = TemplateRegistry::getInstance();
+	auto info = registry.Intern(template_string);
+	registry.SetObjectType(info, GetType());
+
+	template_info_ = info;
+	changed_fields_ |= PERSIST_TEMPLATE;
 	DISPATCH(Object, Template);
 }
 void Object::SetObjectId(uint64_t object_id)
@@ -444,6 +491,7 @@ void Object::SetCustomName(wstring custom_name)
         boost::lock_guard<boost::mutex> lock(object_mutex_);
         custom_name_ = custom_name;
     }
+    changed_fields_ |= PERSIST_CUSTOM_NAME;
     DISPATCH(Object, CustomName);
 }
 
@@ -481,12 +529,7 @@ void Object::Subscribe(const shared_ptr<ObserverInterface>& observer)
 void Object::Unsubscribe(const shared_ptr<ObserverInterface>& observer)
 {
 	boost::lock_guard<boost::mutex> lock(object_mutex_);
-    auto find_iter = observers_.find(observer);
-
-    if (find_iter != observers_.end())
-    {
-        observers_.erase(find_iter);
-    }
+    observers_.erase(observer);
 }
 
 void Object::NotifyObservers(swganh::messages::BaseSwgMessage* message)
@@ -507,6 +550,34 @@ bool Object::IsDirty()
 	boost::lock_guard<boost::mutex> lock(object_mutex_);
     return !deltas_.empty();
 }
+uint32_t Object::TakeChangedFields()
+{
+	return changed_fields_.exchange(0);
+}
+std::vector<uint32_t> Object::TakeChangedAttributes()
+{
+	boost::lock_guard<boost::mutex> lock(object_mutex_);
+	std::vector<uint32_t> changed(changed_attributes_.begin(), changed_attributes_.end());
+	changed_attributes_.clear();
+	return changed;
+}
+void Object::RestoreChangedFields(uint32_t fields, const std::vector<uint32_t>& attribute_ids)
+{
+	changed_fields_ |= fields;
+
+	boost::lock_guard<boost::mutex> lock(object_mutex_);
+	for (auto attribute_id : attribute_ids)
+	{
+		changed_attributes_.insert(attribute_id);
+	}
+}
+void Object::ClearChangedFields()
+{
+	changed_fields_ = 0;
+
+	boost::lock_guard<boost::mutex> lock(object_mutex_);
+	changed_attributes_.clear();
+}
 void Object::ClearBaselines()
 {
     boost::lock_guard<boost::mutex> lock(object_mutex_);
@@ -551,6 +622,7 @@ void Object::SetPosition(glm::vec3 position)
 		UpdateWorldCollisionBox();
 		UpdateAABB();
     }
+    changed_fields_ |= PERSIST_POSITION;
 	DISPATCH(Object, Position);
 }
 void Object::UpdatePosition(const glm::vec3& new_position, const glm::quat& quaternion, std::shared_ptr<Object> parent)
@@ -583,6 +655,7 @@ void Object::SetOrientation(glm::quat orientation)
 	    boost::lock_guard<boost::mutex> lock(object_mutex_);
         orientation_ = orientation;
     }
+    changed_fields_ |= PERSIST_ORIENTATION;
 	DISPATCH(Object, Orientation);
 }
 glm::quat Object::GetOrientation()
@@ -614,6 +687,7 @@ void Object::FacePosition(const glm::vec3& position)
         orientation_.y = -orientation_.y;
         orientation_.w = -orientation_.w; 
     }
+    changed_fields_ |= PERSIST_ORIENTATION;
 	DISPATCH(Object, Orientation);
 }
 
@@ -653,6 +727,7 @@ void Object::SetContainer(const std::shared_ptr<ContainerInterface>& container)
 	    boost::lock_guard<boost::mutex> lock(object_mutex_);
         container_ = container;		
     }
+    changed_fields_ |= PERSIST_CONTAINER;
 	DISPATCH(Object, Container);
 }
 
@@ -668,6 +743,7 @@ void Object::SetComplexity(float complexity)
         boost::lock_guard<boost::mutex> lock(object_mutex_);
         complexity_ = complexity;
     }
+    changed_fields_ |= PERSIST_COMPLEXITY;
 	DISPATCH(Object, Complexity);
 }
 
@@ -684,6 +760,7 @@ void Object::SetStfName(const string& stf_file_name, const string& stf_string)
         stf_name_file_ = stf_file_name;
         stf_name_string_ = stf_string;
     }
+    changed_fields_ |= PERSIST_STF_NAME;
 	DISPATCH(Object, StfName);
 }
 
@@ -702,6 +779,7 @@ string Object::GetStfNameString()
 void Object::SetVolume(uint32_t volume)
 {
     volume_ = volume;
+    changed_fields_ |= PERSIST_VOLUME;
 	DISPATCH(Object, Volume);
 }
 
@@ -713,6 +791,7 @@ uint32_t Object::GetVolume()
 void Object::SetSceneId(uint32_t scene_id)
 {
     scene_id_ = scene_id;
+    changed_fields_ |= PERSIST_SCENE;
 	DISPATCH(Object, SceneId);
 }
 
@@ -740,6 +819,7 @@ int32_t Object::GetArrangementId()
 void Object::SetArrangementId(int32_t arrangement_id)
 {
 	arrangement_id_ = arrangement_id;
+	changed_fields_ |= PERSIST_ARRANGEMENT;
 }
 
 swganh::EventDispatcher* Object::GetEventDispatcher()
@@ -767,7 +847,7 @@ void Object::SendCreateByCrc(std::shared_ptr<swganh::observer::ObserverInterface
 
 	swganh::messages::SceneCreateObjectByCrc scene_object;
     scene_object.object_id = GetObjectId();
-    scene_object.object_crc = swganh::memcrc(GetTemplate());
+    scene_object.object_crc = GetTemplateCrc();
     scene_object.position = GetPosition();
 	scene_object.orientation = GetOrientation();
     scene_object.byte_flag = 0;
@@ -805,30 +885,40 @@ void Object::SendDestroy(std::shared_ptr<swganh::observer::ObserverInterface> ob
 
 void Object::SetFlag(std::string flag)
 {
+    uint32_t flag_id = swganh::StringInterner::getInstance().Intern(flag);
+
     boost::lock_guard<boost::mutex> lg(object_mutex_);
-    flags_.insert(flag);
+    flags_.insert(flag_id);
 }
 
 void Object::RemoveFlag(std::string flag)
 {
     boost::lock_guard<boost::mutex> lg(object_mutex_);
-    flags_.erase(flag);
+    flags_.erase(swganh::StringInterner::Hash(flag));
 }
 
 bool Object::HasFlag(std::string flag)
+{
+    return HasFlag(swganh::StringInterner::Hash(flag));
+}
+
+bool Object::HasFlag(uint32_t flag_id)
 {
     boost::lock_guard<boost::mutex> lg(object_mutex_);
 
-    return flags_.find(flag) != flags_.end();
+    return flags_.find(flag_id) != flags_.end();
 }
 
 /// Slots
 
 void Object::SetSlotInformation(ObjectSlots slots, ObjectArrangements arrangements)
 {
+	// Arrangements are the same for every object of a template, they are kept
+	// once on the shared template record.
+	TemplateRegistry::getInstance().SetSlotArrangements(GetTemplateInfo(), arrangements);
+
 	boost::lock_guard<boost::mutex> lg(object_mutex_);
 	slot_descriptor_ = slots;
-	slot_arrangements_ = arrangements;
 }
 
 int32_t Object::GetAppropriateArrangementId(std::shared_ptr<Object> other)
@@ -840,7 +930,7 @@ int32_t Object::GetAppropriateArrangementId(std::shared_ptr<Object> other)
 	int32_t arrangement_id = 4;
 	int32_t filled_arrangement_id = 0;
 	// In each arrangment
-	for ( auto& arrangement : other->slot_arrangements_)
+	for ( auto& arrangement : other->GetTemplateInfo()->GetSlotArrangements())
 	{
 		bool passes_completely = true;
 		bool is_valid = true;
@@ -878,8 +968,7 @@ ObjectSlots Object::GetSlotDescriptor()
 }
 ObjectArrangements Object::GetSlotArrangements()
 {
-	boost::lock_guard<boost::mutex> lg(object_mutex_);
-	return slot_arrangements_;
+	return GetTemplateInfo()->GetSlotArrangements();
 }
 bool Object::ClearSlot(int32_t slot_id)
 {
@@ -944,12 +1033,14 @@ AttributesMap Object::GetAttributeMap()
 }
 
 AttributeVariant Object::GetAttribute(const std::string& name)
+{
+	return GetAttribute(swganh::StringInterner::Hash(name));
+}
+
+AttributeVariant Object::GetAttribute(uint32_t attribute_id)
 {
 	boost::lock_guard<boost::mutex> lock(object_mutex_);
-	auto find_iter = find_if(attributes_map_.begin(), attributes_map_.end(), [&](AttributesMap::value_type key_value)
-	{
-		return key_value.first == name;
-	});
+	auto find_iter = attributes_map_.find(attribute_id);
 	if (find_iter != attributes_map_.end())
 	{
 		return find_iter->second;
@@ -1038,7 +1129,12 @@ void Object::UpdateWorldCollisionBox(void)
 
 AttributeVariant Object::GetAttributeRecursive(const std::string& name)
 {
-	auto val = GetAttribute(name);
+	return GetAttributeRecursive(swganh::StringInterner::Hash(name));
+}
+
+AttributeVariant Object::GetAttributeRecursive(uint32_t attribute_id)
+{
+	auto val = GetAttribute(attribute_id);
 	{
 		boost::lock_guard<boost::mutex> lock(object_mutex_);
 		float float_val;
@@ -1049,13 +1145,13 @@ AttributeVariant Object::GetAttributeRecursive(const std::string& name)
 			// float
 			case 0:
 				float_val = boost::get<float>(val);
-				return AddAttributeRecursive<float>(float_val, name);			
+				return AddAttributeRecursive<float>(float_val, attribute_id);
 			case 1:
 				int_val = boost::get<int32_t>(val);
-				return AddAttributeRecursive<int32_t>(int_val, name);			
+				return AddAttributeRecursive<int32_t>(int_val, attribute_id);
 			case 2:
 				attr_val = boost::get<wstring>(val);
-				return AddAttributeRecursive<wstring>(attr_val, name);			
+				return AddAttributeRecursive<wstring>(attr_val, attribute_id);
 			case 3:
 				return boost::blank();				
 		}	
@@ -1065,9 +1161,21 @@ AttributeVariant Object::GetAttributeRecursive(const std::string& name)
 	return boost::blank();
 }
 
+void Object::LogAttributeTypeMismatch_(uint64_t object_id, uint32_t attribute_id)
+{
+	LOG(warning) << "Attribute " << swganh::StringInterner::getInstance().Lookup(attribute_id)
+		<< " of object " << object_id << " is not of the type being summed, it is skipped";
+}
+
 bool Object::HasAttribute(const std::string& name)
 {
-	return attributes_map_.find(name) != attributes_map_.end();
+	return HasAttribute(swganh::StringInterner::Hash(name));
+}
+
+bool Object::HasAttribute(uint32_t attribute_id)
+{
+	boost::lock_guard<boost::mutex> lock(object_mutex_);
+	return attributes_map_.find(attribute_id) != attributes_map_.end();
 }
 
 std::shared_ptr<Object> Object::Clone()
@@ -1083,7 +1191,7 @@ void Object::Clone(std::shared_ptr<Object> other)
 	other->object_id_.store(object_id_);
 	other->scene_id_.store(scene_id_);
     other->instance_id_.store(instance_id_);
-	other->template_string_ = template_string_;
+	other->template_info_.store(template_info_);
     other->position_ = position_;
     other->orientation_ = orientation_;
     other->complexity_ = complexity_;
@@ -1097,7 +1205,15 @@ void Object::Clone(std::shared_ptr<Object> other)
 	other->database_persisted_ = database_persisted_;
 	other->in_snapshot_ = in_snapshot_;
     other->flags_ = flags_;
-	other->slot_arrangements_ = slot_arrangements_;
+	other->collision_length_ = collision_length_;
+	other->collision_height_ = collision_height_;
+	other->collidable_ = collidable_;
+
+	// Same slot layout, but without the contents. Contents are cloned below.
+	for(auto& slot : slot_descriptor_)
+	{
+		other->slot_descriptor_.insert(ObjectSlots::value_type(slot.first, slot.second->clone_empty()));
+	}
 
 	__InternalViewObjects(nullptr, 0, true, [&] (std::shared_ptr<Object> object) {
 		other->AddObject(nullptr, object->Clone());
@@ -25,6 +25,9 @@
 #include <glm/gtx/quaternion.hpp>
 
 #include "swganh/event_dispatcher.h"
+#include "swganh/flat_map.h"
+#include "swganh/small_vector.h"
+#include "swganh/string_interner.h"
 #include "swganh/observer/observable_interface.h"
 #include "swganh_core/object/object_controller.h"
 
@@ -36,7 +39,9 @@
 #include "swganh/observer/observer_interface.h"
 #include "swganh_core/object/container_interface.h"
 
+#include "swganh_core/object/persist_fields.h"
 #include "swganh_core/object/slot_interface.h"
+#include "swganh_core/object/template_registry.h"
 
 #define DISPATCH(BIG, LITTLE) if(event_dispatcher_) \
 {GetEventDispatcher()->Dispatch(make_shared<BIG ## Event>(#BIG "::" #LITTLE, static_pointer_cast<BIG>(shared_from_this())));}
@@ -52,8 +57,12 @@ typedef std::vector<
     swganh::messages::DeltasMessage
 > DeltasCacheContainer;
 
-typedef std::map<
-	swganh::HashString,
+/**
+ * Attributes are keyed by the interned id of their name (see swganh::StringInterner),
+ * use StringInterner::Lookup to recover the name.
+ */
+typedef swganh::FlatMap<
+	uint32_t,
 	boost::variant<float, int32_t, std::wstring>
 > AttributesMap;
 
@@ -64,8 +73,6 @@ typedef std::map<
 
 typedef boost::variant<float, int32_t, std::wstring, boost::blank> AttributeVariant;
 
-typedef std::vector<std::vector<int32_t>> ObjectArrangements;
-
 typedef swganh::ValueEvent<std::shared_ptr<Object>> ObjectEvent;
 
 typedef boost::geometry::model::d2::point_xy<double> Point;
@@ -225,6 +232,28 @@ public:
      */
     bool IsDirty();
 
+    /**
+     * Returns the PersistField bits changed since the last call and clears them.
+     * New objects start with every field set.
+     */
+    uint32_t TakeChangedFields();
+
+    /**
+     * Returns the ids of the attributes changed since the last call and clears them.
+     */
+    std::vector<uint32_t> TakeChangedAttributes();
+
+    /**
+     * Marks fields and attributes taken for a write that failed as changed again,
+     * so that the next flush writes them.
+     */
+    void RestoreChangedFields(uint32_t fields, const std::vector<uint32_t>& attribute_ids);
+
+    /**
+     * Marks the object as in sync with storage, eg. after it was loaded.
+     */
+    void ClearChangedFields();
+
     /**
      * Returns the most recently generated baselines.
      *
@@ -255,6 +284,16 @@ public:
      */
     void SetTemplate(const std::string& template_string);
 
+    /**
+     * @return The shared record of the template this object was created from.
+     */
+    const TemplateInfo* GetTemplateInfo() const { return template_info_.load(); }
+
+    /**
+     * @return The crc of the iff template file name, as sent to the client.
+     */
+    uint32_t GetTemplateCrc() const { return template_info_.load()->GetCrc(); }
+
     /**
      * @return The object position as a vector.
      */
@@ -469,6 +508,7 @@ public:
 	void SetFlag(std::string flag);
     void RemoveFlag(std::string flag);
     bool HasFlag(std::string flag);
+	bool HasFlag(uint32_t flag_id);
 
 	/**
 	 * @brief Creates and fires off the Baseline event to send the Baselines for the given object
@@ -529,6 +569,7 @@ public:
 	AttributesMap GetAttributeMap();
 
 	bool HasAttribute(const std::string& name);
+	bool HasAttribute(uint32_t attribute_id);
 
 	/**
 	 * @brief Sets an attribute of the specified type
@@ -536,8 +577,11 @@ public:
 	template<typename T>
 	void SetAttribute(const std::string& name, T attribute)
 	{
+		uint32_t attribute_id = swganh::StringInterner::getInstance().Intern(name);
+
 		boost::lock_guard<boost::mutex> lock(object_mutex_);
-		attributes_map_[name] = attribute;
+		attributes_map_[attribute_id] = attribute;
+		changed_attributes_.insert(attribute_id);
 
 		if (event_dispatcher_)
 			event_dispatcher_->Dispatch(std::make_shared<ObjectEvent>("Object::UpdateAttribute", shared_from_this()));
@@ -560,9 +604,14 @@ public:
 	 */
 	std::wstring GetAttributeAsString(const std::string& name);
 	AttributeVariant GetAttribute(const std::string& name);
+	/**
+	 * @brief Gets an attribute by the interned id of its name, see swganh::StringInterner
+	 */
+	AttributeVariant GetAttribute(uint32_t attribute_id);
 
 	std::wstring GetAttributeRecursiveAsString(const std::string& name);
 	AttributeVariant GetAttributeRecursive(const std::string& name);
+	AttributeVariant GetAttributeRecursive(uint32_t attribute_id);
 	template<typename T>
 	T GetAttributeRecursive(const std::string& name)
 	{
@@ -574,13 +623,24 @@ public:
 	}
 	template<typename T>
 	T AddAttributeRecursive(T val, const std::string& name)
+	{
+		return AddAttributeRecursive<T>(val, swganh::StringInterner::Hash(name));
+	}
+	template<typename T>
+	T AddAttributeRecursive(T val, uint32_t attribute_id)
 	{
 		ViewObjects(nullptr, 1, false, [&](std::shared_ptr<Object> recurse)
 		{
-			if (recurse->HasAttribute(name))
+			auto recurse_val = recurse->GetAttribute(attribute_id);
+			if (auto recurse_typed = boost::get<T>(&recurse_val))
 			{
 				// Add Values
-				val += recurse->GetAttribute<T>(name);
+				val += *recurse_typed;
+			}
+			else if (recurse_val.which() != 3)
+			{
+				// a child holding another type is skipped rather than throwing boost::bad_get
+				LogAttributeTypeMismatch_(recurse->GetObjectId(), attribute_id);
 			}
 		});
 
@@ -663,7 +723,7 @@ protected:
 	std::atomic<uint64_t> object_id_;                // create
 	std::atomic<uint32_t> scene_id_;				 // create
     std::atomic<uint32_t> instance_id_;
-	std::string template_string_;                    // create
+	std::atomic<const TemplateInfo*> template_info_; // create
     glm::vec3 position_;                             // create
     glm::quat orientation_;                          // create
     float complexity_;                               // update 3
@@ -710,17 +770,44 @@ protected:
 	swganh::EventDispatcher* event_dispatcher_;
 
 private:
+
+    static void LogAttributeTypeMismatch_(uint64_t object_id, uint32_t attribute_id);
     
-    typedef std::set<std::shared_ptr<swganh::observer::ObserverInterface>> ObserverContainer;
-	typedef std::set<std::shared_ptr<swganh::object::Object>> AwareObjectContainer;
+    // Most objects have only a few observers/aware objects, keep those inline.
+    typedef swganh::FlatSet<
+        std::shared_ptr<swganh::observer::ObserverInterface>,
+        std::less<std::shared_ptr<swganh::observer::ObserverInterface>>,
+        swganh::SmallVector<std::shared_ptr<swganh::observer::ObserverInterface>, 4>
+    > ObserverContainer;
+	typedef swganh::FlatSet<
+        std::shared_ptr<swganh::object::Object>,
+        std::less<std::shared_ptr<swganh::object::Object>>,
+        swganh::SmallVector<std::shared_ptr<swganh::object::Object>, 8>
+    > AwareObjectContainer;
+
+    // The aware set is changed in place under aware_objects_mutex_. Readers
+    // iterate a shared copy without holding the lock, so the callbacks they run
+    // may change the set. The copy is taken by the first read after a change,
+    // a burst of changes costs one copy and unchanged sets none.
+    typedef std::shared_ptr<const AwareObjectContainer> AwareObjectSnapshot;
+
+    AwareObjectSnapshot GetAwareObjects_() const;
+
+    /// Shared by every object that is not aware of anything.
+    static const AwareObjectSnapshot& EmptyAwareObjects_();
 
 	AttributesMap attributes_map_;
 
+	// What changed since the object was last persisted
+	std::atomic<uint32_t> changed_fields_;
+	swganh::FlatSet<uint32_t> changed_attributes_;
+
     ObjectSlots slot_descriptor_;
-	ObjectArrangements slot_arrangements_;
 
     ObserverContainer observers_;
+	mutable boost::mutex aware_objects_mutex_;
 	AwareObjectContainer aware_objects_;
+	mutable AwareObjectSnapshot aware_objects_snapshot_;   ///< null after a change
 
     BaselinesCacheContainer baselines_;
     DeltasCacheContainer deltas_;
@@ -732,7 +819,7 @@ private:
 	bool database_persisted_;
 	bool in_snapshot_;
 
-    std::set<std::string> flags_;
+    swganh::FlatSet<uint32_t> flags_;
 };
 
 }}  // namespace
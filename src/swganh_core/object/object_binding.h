@@ -174,6 +174,8 @@ void exportObject()
     .value("MIX", controllers::MIX)
     ;
 	void (ContainerInterface::*RemoveObject)(shared_ptr<Object>, shared_ptr<Object>) = &ContainerInterface::RemoveObject;
+	bool (Object::*HasFlag)(std::string) = &Object::HasFlag;
+	bool (Object::*HasAttribute)(const std::string&) = &Object::HasAttribute;
 
 	class_<ContainerInterface, std::shared_ptr<ContainerInterface>, boost::noncopyable>("ContainerInterface", "Container interface", no_init)
 		.def("add", &ContainerInterface::AddObject, addObjectOverload(args("requester", "newObject", "arrangement_id"), "Adds an object to the current object"))
@@ -222,10 +224,10 @@ void exportObject()
 		.def("stfName", &Object::SetStfName, "sets the full stf name, takes stf_name_file and stf_name_string as parameters")
 		.add_property("custom_name", &Object::GetCustomName, &Object::SetCustomName, "Property to get and set the custom name")
         .def("controller", &Object::GetController, "Get the :class:`.ObjectController` of the object")
-        .def("hasFlag", &Object::HasFlag, "Checks if the object has a specific flag set on it")
+        .def("hasFlag", HasFlag, "Checks if the object has a specific flag set on it")
         .def("setFlag", &Object::SetFlag, "Sets a flag on the object")
         .def("removeFlag", &Object::RemoveFlag, "Removes a flag from the object")
-		.def("hasAttribute", &Object::HasAttribute, "Returns true if the object has the given attribute.")
+		.def("hasAttribute", HasAttribute, "Returns true if the object has the given attribute.")
 		.def("getFloatAttribute", &Object::GetAttribute<float>, "Gets the float attribute value")
 		.def("setFloatAttribute", &Object::SetAttribute<float>, "Sets the float attribute value")
 		.def("getIntAttribute", &Object::GetAttribute<int32_t>, "Gets the int attribute value")
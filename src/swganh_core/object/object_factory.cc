@@ -3,6 +3,7 @@
 
 #include "object_factory.h"
 
+#include <algorithm>
 
 #include <cppconn/exception.h>
 #include <cppconn/connection.h>
@@ -14,6 +15,7 @@
 
 #include "swganh/database/database_manager.h"
 #include "swganh_core/object/object.h"
+#include "swganh_core/object/object_journal.h"
 #include "swganh_core/object/object_manager.h"
 #include "swganh_core/object/exception.h"
 #include "swganh_core/simulation/simulation_service_interface.h"
@@ -30,6 +32,31 @@ using namespace swganh::object;
 using namespace swganh::simulation;
 using namespace swganh::tre;
 
+namespace {
+
+	/// Binds procedure parameters to consecutive placeholders.
+	class ParameterBinder : public boost::static_visitor<>
+	{
+	public:
+		explicit ParameterBinder(sql::PreparedStatement& statement)
+			: statement_(statement)
+			, index_(1)
+		{}
+
+		void operator()(int32_t value) { statement_.setInt(index_++, value); }
+		void operator()(uint32_t value) { statement_.setUInt(index_++, value); }
+		void operator()(uint64_t value) { statement_.setUInt64(index_++, value); }
+		void operator()(double value) { statement_.setDouble(index_++, value); }
+		void operator()(bool value) { statement_.setBoolean(index_++, value); }
+		void operator()(const std::string& value) { statement_.setString(index_++, value); }
+
+	private:
+		sql::PreparedStatement& statement_;
+		uint32_t index_;
+	};
+
+}
+
 ObjectFactory::ObjectFactory(SwganhKernel* kernel)
 	: kernel_(kernel)
 {
@@ -47,9 +74,38 @@ void ObjectFactory::RegisterEventHandlers()
 	GetEventDispatcher()->Subscribe("Object::Container", std::bind(&ObjectFactory::PersistHandler, this, std::placeholders::_1));
 	GetEventDispatcher()->Subscribe("Object::StfName", std::bind(&ObjectFactory::PersistHandler, this, std::placeholders::_1));
 	GetEventDispatcher()->Subscribe("Object::SceneId", std::bind(&ObjectFactory::PersistHandler, this, std::placeholders::_1));	
+	GetEventDispatcher()->Subscribe("Object::UpdateAttribute", std::bind(&ObjectFactory::PersistHandler, this, std::placeholders::_1));
 }
 
 void ObjectFactory::PersistChangedObjects()
+{
+	// Only the snapshot is taken here, the rows are written by the pipeline workers
+	// or, with the journal enabled, replayed from the journal.
+	auto pipeline = object_manager_->GetPersistencePipeline();
+	auto journal = object_manager_->GetObjectJournal();
+	if (journal)
+	{
+		JournalChangedObjects(*journal);
+		return;
+	}
+
+	// Queued containers first, the pipeline writes a level once nothing below it is left
+	vector<shared_ptr<Object>> changed;
+	TakeChangedObjects(changed);
+	vector<pair<uint32_t, shared_ptr<Object>>> by_depth;
+	for (auto& object : changed)
+	{
+		by_depth.push_back(make_pair(GetContainmentDepth(object), object));
+	}
+	stable_sort(by_depth.begin(), by_depth.end(), [] (const pair<uint32_t, shared_ptr<Object>>& a, const pair<uint32_t, shared_ptr<Object>>& b) {
+		return a.first < b.first;
+	});
+	for (auto& entry : by_depth)
+	{
+		PersistChangedObject(*pipeline, entry.second);
+	}
+}
+void ObjectFactory::TakeChangedObjects(vector<shared_ptr<Object>>& changed)
 {
 	std::set<shared_ptr<Object>> persisted;
 	{
@@ -59,8 +115,167 @@ void ObjectFactory::PersistChangedObjects()
 	for (auto& object : persisted)
 	{
 		if(object->IsDatabasePersisted())
-			PersistObject(object);
+			changed.push_back(object);
+	}
+}
+void ObjectFactory::PersistChangedObject(PersistencePipeline& pipeline, const shared_ptr<Object>& object)
+{
+	// The columns are read here, the workers only bind them
+	auto database_manager = GetDatabaseManager();
+	EnqueueChangedObject(pipeline, object, [database_manager] (const ProcedureCall& call) { WriteProcedureCall(database_manager, call); });
+}
+void ObjectFactory::EnqueueChangedObject(PersistencePipeline& pipeline, const shared_ptr<Object>& object, const CallWriter& call_writer)
+{
+	uint32_t depth = GetContainmentDepth(object);
+
+	auto row = SnapshotObject(object);
+	if (row.changed_fields != 0 || !row.attributes.empty())
+		pipeline.Enqueue(move(row), depth);
+
+	// The tasks of a level run after its rows, the type calls find the object row
+	// written. Keyed on the object they run in the order they were made.
+	vector<ProcedureCall> calls;
+	SnapshotTypeCalls(object, calls);
+	for (auto& call : calls)
+	{
+		pipeline.EnqueueTask([call_writer, call] () { call_writer(call); }, depth, call.object_id);
+	}
+}
+uint32_t ObjectFactory::GetContainmentDepth(const shared_ptr<Object>& object)
+{
+	// The scene a world object sits in is a container but no object, it is not counted.
+	uint32_t depth = 0;
+	for (auto container = object->GetContainer(); container != nullptr; container = container->GetContainer())
+	{
+		if (dynamic_pointer_cast<Object>(container) != nullptr)
+			++depth;
+	}
+	return depth;
+}
+void ObjectFactory::JournalChangedObjects(ObjectJournal& journal)
+{
+	std::set<shared_ptr<Object>> changed;
+	{
+		boost::lock_guard<boost::mutex> lg(persisted_objects_mutex_);
+		changed = move(persisted_objects_);
 	}
+	// The row goes first, the type calls may need the object to exist
+	vector<ProcedureCall> calls;
+	for (auto& object : changed)
+	{
+		if(!object->IsDatabasePersisted())
+			continue;
+
+		auto row = SnapshotObject(object);
+		if (row.changed_fields != 0 || !row.attributes.empty())
+			journal.Append(row);
+
+		calls.clear();
+		SnapshotTypeCalls(object, calls);
+		for (auto& call : calls)
+		{
+			journal.Append(call);
+		}
+	}
+}
+void ObjectFactory::PersistChangedTypeColumns()
+{
+	ObjectFactory::PersistChangedObjects();
+}
+void ObjectFactory::WriteProcedureCall(DatabaseManager* database_manager, const ProcedureCall& call)
+{
+	auto conn = database_manager->getConnection("galaxy");
+	auto statement = database_manager->getPreparedStatement(conn, call.statement);
+
+	ParameterBinder binder(*statement);
+	for (auto& parameter : call.parameters)
+	{
+		boost::apply_visitor(binder, parameter);
+	}
+
+	// Drain whatever the procedure returns, the statement stays cached on the connection
+	if (statement->execute())
+	{
+		unique_ptr<sql::ResultSet> result(statement->getResultSet());
+	}
+	while (statement->getMoreResults())
+	{
+		unique_ptr<sql::ResultSet> result(statement->getResultSet());
+	}
+}
+ObjectSnapshot ObjectFactory::SnapshotObject(const shared_ptr<Object>& object)
+{
+	ObjectSnapshot row = ObjectSnapshot();
+	row.changed_fields = object->TakeChangedFields();
+	row.object_id = object->GetObjectId();
+
+	uint32_t fields = row.changed_fields;
+	if (fields & PERSIST_SCENE)
+	{
+		row.scene_id = object->GetSceneId();
+	}
+	if (fields & PERSIST_CONTAINER)
+	{
+		auto container = object->GetContainer();
+		row.parent_id = (container != nullptr) ? container->GetObjectId() : 0;
+	}
+	if (fields & PERSIST_TEMPLATE)
+	{
+		row.iff_template = object->GetTemplate();
+	}
+	if (fields & PERSIST_POSITION)
+	{
+		auto position = object->GetPosition();
+		row.x_position = position.x;
+		row.y_position = position.y;
+		row.z_position = position.z;
+	}
+	if (fields & PERSIST_ORIENTATION)
+	{
+		auto orientation = object->GetOrientation();
+		row.x_orientation = orientation.x;
+		row.y_orientation = orientation.y;
+		row.z_orientation = orientation.z;
+		row.w_orientation = orientation.w;
+	}
+	if (fields & PERSIST_COMPLEXITY)
+	{
+		row.complexity = object->GetComplexity();
+	}
+	if (fields & PERSIST_STF_NAME)
+	{
+		row.stf_name_file = object->GetStfNameFile();
+		row.stf_name_string = object->GetStfNameString();
+	}
+	if (fields & PERSIST_CUSTOM_NAME)
+	{
+		auto custom_name = object->GetCustomName();
+		row.custom_name = string(begin(custom_name), end(custom_name));
+	}
+	if (fields & PERSIST_VOLUME)
+	{
+		row.volume = object->GetVolume();
+	}
+	if (fields & PERSIST_ARRANGEMENT)
+	{
+		row.arrangement_id = object->GetArrangementId();
+	}
+	if (fields == PERSIST_ALL_FIELDS)
+	{
+		row.permission_type = object->GetPermissions()->GetType();
+		row.type_id = object->GetType();
+	}
+
+	// Only the attributes that changed are written
+	auto& interner = swganh::StringInterner::getInstance();
+	for (auto attribute_id : object->TakeChangedAttributes())
+	{
+		const std::string& name = interner.Lookup(attribute_id);
+		std::wstring value = object->GetAttributeRecursiveAsString(name);
+		row.attributes.push_back(make_pair(name, std::string(value.begin(), value.end())));
+	}
+
+	return row;
 }
 void ObjectFactory::PersistHandler(const shared_ptr<swganh::EventInterface>& incoming_event)
 {
@@ -71,13 +286,21 @@ void ObjectFactory::PersistHandler(const shared_ptr<swganh::EventInterface>& inc
 		persisted_objects_.insert(object);
 	}
 }
+void ObjectFactory::RequeueChangedObject(const shared_ptr<Object>& object)
+{
+	if (object->IsDatabasePersisted())
+	{
+		boost::lock_guard<boost::mutex> lg(persisted_objects_mutex_);
+		persisted_objects_.insert(object);
+	}
+}
 uint32_t ObjectFactory::PersistObject(const shared_ptr<Object>& object, bool persist_inherited)
 {
 	uint32_t counter = 1;
     try {
         auto conn = GetDatabaseManager()->getConnection("galaxy");
-        auto prepared_statement = shared_ptr<sql::PreparedStatement>
-            (conn->prepareStatement("CALL sp_PersistObject(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);"));
+        auto prepared_statement = GetDatabaseManager()->getPreparedStatement(conn,
+            "CALL sp_PersistObject(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);");
         prepared_statement->setUInt64(counter++, object->GetObjectId());
 		if (object->GetContainer() != nullptr)
 		{
@@ -126,51 +349,18 @@ void ObjectFactory::CreateBaseObjectFromStorage(const shared_ptr<Object>& object
 {
     try {
         result->next();
-        // Set Event Dispatcher
-        object->SetEventDispatcher(GetEventDispatcher());
-        object->SetSceneId(result->getUInt("scene_id"));
-        object->SetPosition(glm::vec3(result->getDouble("x_position"),result->getDouble("y_position"), result->getDouble("z_position")));
-        object->SetOrientation(glm::quat(
-            static_cast<float>(result->getDouble("w_orientation")),
-			static_cast<float>(result->getDouble("x_orientation")),
-            static_cast<float>(result->getDouble("y_orientation")),
-            static_cast<float>(result->getDouble("z_orientation"))));
-
-        object->SetComplexity(static_cast<float>(result->getDouble("complexity")));
-        object->SetStfName(result->getString("stf_name_file"),
-                           result->getString("stf_name_string"));
-        string custom_string = result->getString("custom_name");
-        object->SetCustomName(wstring(begin(custom_string), end(custom_string)));
-        object->SetVolume(result->getUInt("volume"));
-        object->SetTemplate(result->getString("iff_template"));
-		object->SetArrangementId(result->getInt("arrangement_id"));
-
-		auto permissions_objects_ = object_manager_->GetPermissionsMap();
-		auto permissions_itr = permissions_objects_.find(result->getInt("permission_type"));
-		if(permissions_itr != permissions_objects_.end())
-		{
-			object->SetPermissions(permissions_itr->second);
-		}
-		else
-		{
-			DLOG(error) << "FAILED TO FIND PERMISSION TYPE " << result->getInt("perission_type");
-			object->SetPermissions(permissions_objects_.find(DEFAULT_PERMISSION)->second);
-		}
-		object_manager_->LoadSlotsForObject(object);
-		object_manager_->LoadCollisionInfoForObject(object);
+        CreateBaseObjectFromRow(object, *result);
 
 		auto parent = object_manager_->GetObjectById(result->getUInt64("parent_id"));
 		if(parent != nullptr)
 		{
 			parent->AddObject(nullptr, object);
 		}
-		// Attribute Template ID
-		int attribute_template_id = result->getInt("attribute_template_id");
-		object->SetAttributeTemplateId(attribute_template_id);
 
 		LoadAttributes(object);
 
-		GetClientData(object);
+		// Everything set so far came from storage
+		object->ClearChangedFields();
 
 		//Clear us from the db persist update queue.
 		boost::lock_guard<boost::mutex> lock(persisted_objects_mutex_);
@@ -186,37 +376,59 @@ void ObjectFactory::CreateBaseObjectFromStorage(const shared_ptr<Object>& object
     }
 }
 
+void ObjectFactory::CreateBaseObjectFromRow(const shared_ptr<Object>& object, sql::ResultSet& result)
+{
+    // Set Event Dispatcher
+    object->SetEventDispatcher(GetEventDispatcher());
+    object->SetSceneId(result.getUInt("scene_id"));
+    object->SetPosition(glm::vec3(result.getDouble("x_position"),result.getDouble("y_position"), result.getDouble("z_position")));
+    object->SetOrientation(glm::quat(
+        static_cast<float>(result.getDouble("w_orientation")),
+		static_cast<float>(result.getDouble("x_orientation")),
+        static_cast<float>(result.getDouble("y_orientation")),
+        static_cast<float>(result.getDouble("z_orientation"))));
+
+    object->SetComplexity(static_cast<float>(result.getDouble("complexity")));
+    object->SetStfName(result.getString("stf_name_file"),
+                       result.getString("stf_name_string"));
+    string custom_string = result.getString("custom_name");
+    object->SetCustomName(wstring(begin(custom_string), end(custom_string)));
+    object->SetVolume(result.getUInt("volume"));
+    object->SetTemplate(result.getString("iff_template"));
+	object->SetArrangementId(result.getInt("arrangement_id"));
+
+	auto permissions_objects_ = object_manager_->GetPermissionsMap();
+	auto permissions_itr = permissions_objects_.find(result.getInt("permission_type"));
+	if(permissions_itr != permissions_objects_.end())
+	{
+		object->SetPermissions(permissions_itr->second);
+	}
+	else
+	{
+		DLOG(error) << "FAILED TO FIND PERMISSION TYPE " << result.getInt("permission_type");
+		object->SetPermissions(permissions_objects_.find(DEFAULT_PERMISSION)->second);
+	}
+	object_manager_->LoadSlotsForObject(object);
+	object_manager_->LoadCollisionInfoForObject(object);
+
+	// Attribute Template ID
+	int attribute_template_id = result.getInt("attribute_template_id");
+	object->SetAttributeTemplateId(attribute_template_id);
+
+	GetClientData(object);
+}
+
 void ObjectFactory::LoadAttributes(std::shared_ptr<Object> object)
 {
 	 try {
         auto conn = GetDatabaseManager()->getConnection("galaxy");
-        auto statement = conn->prepareStatement("CALL sp_GetAttributes(?,?);");
+        auto statement = GetDatabaseManager()->getPreparedStatement(conn, "CALL sp_GetAttributes(?,?);");
 		statement->setString(1, object->GetTemplate());
         statement->setUInt64(2, object->GetObjectId());
         auto result = unique_ptr<sql::ResultSet>(statement->executeQuery());        
         while (result->next())
         {
-			string attr_name = result->getString("name");
-			string unparsed_value = result->getString("attribute_value");
-			try {				
-				if (std::string::npos != unparsed_value.find("."))
-				{
-					object->SetAttribute(attr_name, boost::lexical_cast<float>(unparsed_value));
-				}
-				else if (unparsed_value.find_first_of("0123456789") == 0)
-				{
-					object->SetAttribute(attr_name, boost::lexical_cast<int>(unparsed_value));
-				}
-				else
-				{
-					object->SetAttribute(attr_name, std::wstring(unparsed_value.begin(), unparsed_value.end()));
-				}
-			}
-			catch (std::exception& e)
-			{
-				LOG(error) << "Error parsing attribute " << attr_name <<" for object_id:" << object->GetObjectId() << " error message:" << e.what();
-				object->SetAttribute(attr_name, std::wstring(unparsed_value.begin(), unparsed_value.end()));
-			}
+			ApplyStoredAttribute(object, result->getString("name"), result->getString("attribute_value"));
         }          
     }
     catch(sql::SQLException &e)
@@ -225,6 +437,28 @@ void ObjectFactory::LoadAttributes(std::shared_ptr<Object> object)
         LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();        
     }
 }
+void ObjectFactory::ApplyStoredAttribute(const std::shared_ptr<Object>& object, const std::string& attr_name, const std::string& unparsed_value)
+{
+	try {				
+		if (std::string::npos != unparsed_value.find("."))
+		{
+			object->SetAttribute(attr_name, boost::lexical_cast<float>(unparsed_value));
+		}
+		else if (unparsed_value.find_first_of("0123456789") == 0)
+		{
+			object->SetAttribute(attr_name, boost::lexical_cast<int>(unparsed_value));
+		}
+		else
+		{
+			object->SetAttribute(attr_name, std::wstring(unparsed_value.begin(), unparsed_value.end()));
+		}
+	}
+	catch (std::exception& e)
+	{
+		LOG(error) << "Error parsing attribute " << attr_name <<" for object_id:" << object->GetObjectId() << " error message:" << e.what();
+		object->SetAttribute(attr_name, std::wstring(unparsed_value.begin(), unparsed_value.end()));
+	}
+}
 void ObjectFactory::PersistAttributes(std::shared_ptr<Object> object)
 {
 	try 
@@ -232,9 +466,9 @@ void ObjectFactory::PersistAttributes(std::shared_ptr<Object> object)
 		auto conn = GetDatabaseManager()->getConnection("galaxy");
 		for (auto& attribute : object->GetAttributeMap())
 		{
-			auto statement = conn->prepareStatement("CALL sp_PersistAttribute(?,?,?);");
+			auto statement = GetDatabaseManager()->getPreparedStatement(conn, "CALL sp_PersistAttribute(?,?,?);");
 			statement->setUInt64(1, object->GetObjectId());
-			std::string name = attribute.first.ident_string();
+			const std::string& name = swganh::StringInterner::getInstance().Lookup(attribute.first);
 			statement->setString(2, name);
 			std::wstring attr = object->GetAttributeRecursiveAsString(name);
 			statement->setString(3, std::string(attr.begin(), attr.end()));
@@ -257,7 +491,7 @@ uint32_t ObjectFactory::LookupType(uint64_t object_id)
     uint32_t type = 0;
     try {
 		auto conn = GetDatabaseManager()->getConnection("galaxy");
-        auto statement = conn->prepareStatement("CALL sp_GetType(?);");
+        auto statement = GetDatabaseManager()->getPreparedStatement(conn, "CALL sp_GetType(?);");
         statement->setUInt64(1, object_id);
         auto result = unique_ptr<sql::ResultSet>(statement->executeQuery());        
         while (result->next())
@@ -278,40 +512,37 @@ void ObjectFactory::LoadContainedObjects(
     const shared_ptr<Object>& object,
     const shared_ptr<Statement>& statement)
 {
-    // Check for contained objects        
+    // The contained objects are loaded in bulk by ObjectManager::LoadContainedObjects,
+    // the procedure's contained object list only needs to be drained here.
     if (statement->getMoreResults())
     {
         unique_ptr<ResultSet> result(statement->getResultSet());
-
-        uint64_t contained_id;
-        uint32_t contained_type;
-
-        while (result->next())
-        {
-            contained_id = result->getUInt64("id");
-            contained_type = result->getUInt("type_id");
-
-            auto contained_object = object_manager_->CreateObjectFromStorage(contained_id, contained_type);
-
-			if(contained_object->GetArrangementId() == -2)
-			{
-				//This object has never been loaded before and needs to be put into the default slot.
-				object->AddObject(nullptr, contained_object);
-			}
-			else 
-			{
-				//Put it back where it was persisted
-				object->AddObject(nullptr, contained_object, contained_object->GetArrangementId());
-			}
-
-        }
+        while (result->next()) {}
     }
 }
 void ObjectFactory::DeleteObjectFromStorage(const std::shared_ptr<Object>& object)
 {
+	// A queued change must not write the object back after it is gone
+	{
+		boost::lock_guard<boost::mutex> lg(persisted_objects_mutex_);
+		persisted_objects_.erase(object);
+	}
+
+	// Journaled rows of the object may not be in storage yet, the deletion is
+	// journaled after them and compaction drops them.
+	auto journal = object_manager_->GetObjectJournal();
+	if (journal)
+	{
+		ProcedureCall call(object->GetObjectId(), "CALL sp_DeleteObject(?,?);", MERGE_DELETE);
+		call.AddUInt64(object->GetObjectId());
+		call.AddInt(object->GetType());
+		journal->Append(call);
+		return;
+	}
+
 	try {
         auto conn = GetDatabaseManager()->getConnection("galaxy");
-        auto statement = conn->prepareStatement("CALL sp_DeleteObject(?,?);");
+        auto statement = GetDatabaseManager()->getPreparedStatement(conn, "CALL sp_DeleteObject(?,?);");
         statement->setUInt64(1, object->GetObjectId());
 		statement->setInt(2, object->GetType());
         statement->execute();                
@@ -324,12 +555,20 @@ void ObjectFactory::DeleteObjectFromStorage(const std::shared_ptr<Object>& objec
 }
 void ObjectFactory::GetClientData(const std::shared_ptr<Object>& object)
 {
+	// objects stored with a name of their own never need the template
+	if (object->GetStfNameFile().length() != 0)
+	{
+		return;
+	}
+
+	static const uint32_t object_name_attribute = ObjectVisitor::AttributeId("objectName");
+
 	try {
 
 		auto oiff = kernel_->GetResourceManager()->GetResourceByName<ObjectVisitor>(object->GetTemplate());
-		auto object_name = oiff->attribute<shared_ptr<ObjectVisitor::ClientString>>("objectName");
-		if (object->GetStfNameFile().length() == 0)
+		if (oiff && oiff->has_attribute(object_name_attribute))
 		{
+			auto object_name = oiff->attribute<shared_ptr<ObjectVisitor::ClientString>>(object_name_attribute);
 			object->SetStfName(object_name->file, object_name->entry);
 		}
 
@@ -5,9 +5,11 @@
 #define SWGANH_OBJECT_OBJECT_FACTORY_H_
 
 #include "swganh_core/object/object_factory_interface.h"
+#include "swganh_core/object/persistence_pipeline.h"
 #include "swganh/event_dispatcher.h"
 #include "swganh/app/swganh_kernel.h"
 
+#include <functional>
 #include <set>
 #include <boost/thread/mutex.hpp>
 
@@ -53,6 +55,15 @@ namespace object {
          * @param the result set from which to load the values from
          */
         void CreateBaseObjectFromStorage(const std::shared_ptr<Object>& object, const std::shared_ptr<sql::ResultSet>& result);
+
+        /**
+         * Loads in base values from the current row of a result set, without adding
+         * the object to its container or loading its attributes.
+         *
+         * @param the object which to load values into
+         * @param the result set positioned on the object's row
+         */
+        void CreateBaseObjectFromRow(const std::shared_ptr<Object>& object, sql::ResultSet& result);
         virtual uint32_t PersistObject(const std::shared_ptr<Object>& object, bool persist_inherited = false);
         
         virtual void DeleteObjectFromStorage(const std::shared_ptr<Object>& object);
@@ -60,9 +71,59 @@ namespace object {
 		virtual std::shared_ptr<Object> CreateObject() { return nullptr; }
         uint32_t LookupType(uint64_t object_id);
 		void LoadAttributes(std::shared_ptr<Object> object);
+
+		/**
+		 * Sets an attribute from its stored text form, numbers are parsed as
+		 * float or int and anything else is kept as a string.
+		 */
+		static void ApplyStoredAttribute(const std::shared_ptr<Object>& object, const std::string& name, const std::string& value);
 		void PersistAttributes(std::shared_ptr<Object> object);
 
 		virtual void PersistChangedObjects();
+		/**
+		 * Takes the queued objects and appends their rows and SnapshotTypeCalls
+		 * to the journal.
+		 */
+		virtual void JournalChangedObjects(ObjectJournal& journal);
+		virtual void RequeueChangedObject(const std::shared_ptr<Object>& object);
+		virtual void TakeChangedObjects(std::vector<std::shared_ptr<Object>>& changed);
+		virtual void PersistChangedObject(PersistencePipeline& pipeline, const std::shared_ptr<Object>& object);
+
+		typedef std::function<void (const ProcedureCall& call)> CallWriter;
+
+		/**
+		 * Hands the changed object table columns and attributes of an object to the
+		 * pipeline, followed by its SnapshotTypeCalls as tasks that run call_writer
+		 * once the row is written.
+		 */
+		void EnqueueChangedObject(PersistencePipeline& pipeline, const std::shared_ptr<Object>& object, const CallWriter& call_writer);
+
+		/**
+		 * Copies the object table columns and attributes of an object for the
+		 * PersistencePipeline.
+		 */
+		ObjectSnapshot SnapshotObject(const std::shared_ptr<Object>& object);
+
+		/**
+		 * @return How deep the object is in the containment tree, 0 for objects in
+		 *      the world. Containers are persisted before anything of a higher depth.
+		 */
+		static uint32_t GetContainmentDepth(const std::shared_ptr<Object>& object);
+
+		/**
+		 * Appends the calls of the per type persist procedures that store the
+		 * columns of the object kept outside the object table, in the order they
+		 * are to be made. Factories without a type table add nothing.
+		 */
+		virtual void SnapshotTypeCalls(const std::shared_ptr<Object>& object, std::vector<ProcedureCall>& calls) {}
+
+		/**
+		 * Makes a snapshotted procedure call on a galaxy connection, with the
+		 * statement taken from the connection's statement cache.
+		 *
+		 * @throws sql::SQLException if the call fails.
+		 */
+		static void WriteProcedureCall(swganh::database::DatabaseManager* database_manager, const ProcedureCall& call);
 		void PersistHandler(const std::shared_ptr<swganh::EventInterface>& incoming_event);
         virtual void RegisterEventHandlers();
         void SetTreArchive(swganh::tre::TreArchive* tre_archive);
@@ -72,6 +133,13 @@ namespace object {
 		swganh::database::DatabaseManager* GetDatabaseManager() { return kernel_->GetDatabaseManager(); }
 		swganh::EventDispatcher* GetEventDispatcher() { return kernel_->GetEventDispatcher(); }
     protected:
+		/**
+		 * Same as ObjectFactory::PersistChangedObjects, for the factories that
+		 * override it: hands the queued objects' rows and SnapshotTypeCalls to the
+		 * persistence pipeline, or to the journal when it is enabled.
+		 */
+		void PersistChangedTypeColumns();
+
         void LoadContainedObjects(const std::shared_ptr<Object>& object,
             const std::shared_ptr<sql::Statement>& statement);
         
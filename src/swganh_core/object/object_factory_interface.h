@@ -5,12 +5,19 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
+
+namespace sql {
+    class ResultSet;
+}
 
 namespace swganh {
 namespace object {
 
     class Object;
+    class ObjectJournal;
     class ObjectManager;
+    class PersistencePipeline;
     
     class ObjectFactoryInterface
     {
@@ -38,6 +45,29 @@ namespace object {
          * @throws InvalidObject when no object exists for the specified id.
          */
         virtual std::shared_ptr<Object> CreateObjectFromStorage(uint64_t object_id) = 0;
+
+        /**
+         * Gets the table holding the type specific columns, joined onto the object
+         * table when many objects of this type are loaded at once.
+         *
+         * @return the table name, or an empty string if objects of this type can only
+         *      be loaded one at a time through CreateObjectFromStorage.
+         */
+        virtual std::string GetBulkLoadTable() const { return ""; }
+
+        /**
+         * @return the columns of GetBulkLoadTable that CreateObjectFromRow reads.
+         */
+        virtual std::vector<std::string> GetBulkLoadColumns() const { return std::vector<std::string>(); }
+
+        /**
+         * Creates an instance of a stored object from the current row of a bulk load
+         * query (object and GetBulkLoadTable columns). Containment and attributes
+         * are applied by the caller.
+         *
+         * @return the created object instance, or nullptr if bulk loading is not supported.
+         */
+        virtual std::shared_ptr<Object> CreateObjectFromRow(sql::ResultSet& row) { return nullptr; }
                 
         /**
          * Creates an instance of an object from the specified template.
@@ -61,6 +91,31 @@ namespace object {
 		 */
 		virtual void PersistChangedObjects() = 0;
 
+		/**
+		 * Moves the objects changed since the last call that are stored in the
+		 * database into changed, for ObjectManager to queue the objects of every
+		 * factory container first.
+		 */
+		virtual void TakeChangedObjects(std::vector<std::shared_ptr<Object>>& changed) {}
+
+		/**
+		 * Queues the changed columns and type table calls of an object taken with
+		 * TakeChangedObjects, blocks while the pipeline is full.
+		 */
+		virtual void PersistChangedObject(PersistencePipeline& pipeline, const std::shared_ptr<Object>& object) {}
+
+		/**
+		 * Writes the changed object table columns and attributes to the journal,
+		 * the objects stay queued for PersistChangedObjects.
+		 */
+		virtual void JournalChangedObjects(ObjectJournal& journal) {}
+
+		/**
+		 * Queues an object for the next PersistChangedObjects again, eg. after the
+		 * write of its changes failed.
+		 */
+		virtual void RequeueChangedObject(const std::shared_ptr<Object>& object) {}
+
 		/**
 		 *  Registers events for a specific factory 
 		 */
@@ -0,0 +1,947 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "object_journal.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <boost/crc.hpp>
+#include <boost/filesystem.hpp>
+
+#include "swganh/logger.h"
+
+using namespace std;
+using namespace swganh::object;
+
+namespace {
+
+	// Every segment starts with this, the format version is the last character.
+	// Version 1 segments only held object rows and their records have no kind,
+	// version 2 calls have no key parameter count.
+	const char kSegmentMagic[8] = {'S', 'W', 'G', 'J', 'R', 'N', 'L', '3'};
+	const char kRowsOnlyVersion = '1';
+	const char kUnkeyedCallsVersion = '2';
+	const char* kSegmentPrefix = "objects.";
+	const char* kSegmentExtension = ".journal";
+
+	// A record is its payload size, the crc32 of the payload and the payload.
+	const size_t kRecordHeaderSize = 2 * sizeof(uint32_t);
+
+	// Anything bigger is a damaged size field rather than a real record.
+	const uint32_t kMaxRecordSize = 16 * 1024 * 1024;
+
+	// The first byte of a version 2 and later payload.
+	enum RecordKind
+	{
+		ROW_RECORD = 0,
+		CALL_RECORD = 1
+	};
+
+	class RecordWriter
+	{
+	public:
+		explicit RecordWriter(string& buffer) : buffer_(buffer) {}
+
+		template<typename T>
+		void Write(T value)
+		{
+			buffer_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		void WriteString(const string& value)
+		{
+			Write<uint32_t>(static_cast<uint32_t>(value.size()));
+			buffer_.append(value);
+		}
+
+	private:
+		string& buffer_;
+	};
+
+	class RecordReader
+	{
+	public:
+		RecordReader(const char* data, size_t size) : data_(data), remaining_(size) {}
+
+		template<typename T>
+		bool Read(T& value)
+		{
+			if (remaining_ < sizeof(value))
+			{
+				return false;
+			}
+			memcpy(&value, data_, sizeof(value));
+			data_ += sizeof(value);
+			remaining_ -= sizeof(value);
+			return true;
+		}
+
+		bool ReadString(string& value)
+		{
+			uint32_t size;
+			if (!Read(size) || remaining_ < size)
+			{
+				return false;
+			}
+			value.assign(data_, size);
+			data_ += size;
+			remaining_ -= size;
+			return true;
+		}
+
+		bool AtEnd() const { return remaining_ == 0; }
+
+	private:
+		const char* data_;
+		size_t remaining_;
+	};
+
+	uint32_t Checksum(const char* data, size_t size)
+	{
+		boost::crc_32_type crc;
+		crc.process_bytes(data, size);
+		return crc.checksum();
+	}
+
+	/// Writes a parameter as its type index and value.
+	class ParameterEncoder : public boost::static_visitor<>
+	{
+	public:
+		explicit ParameterEncoder(RecordWriter& writer) : writer_(writer) {}
+
+		template<typename T>
+		void operator()(T value) const { writer_.Write(value); }
+		void operator()(bool value) const { writer_.Write<uint8_t>(value ? 1 : 0); }
+		void operator()(const string& value) const { writer_.WriteString(value); }
+
+	private:
+		RecordWriter& writer_;
+	};
+
+	template<typename T>
+	bool ReadParameter(RecordReader& reader, ProcedureCall& call)
+	{
+		T value = T();
+		if (!reader.Read(value))
+		{
+			return false;
+		}
+		call.parameters.push_back(value);
+		return true;
+	}
+
+	bool DecodeCall(RecordReader& reader, ProcedureCall& call, bool keyed)
+	{
+		uint8_t merge;
+		uint32_t parameter_count;
+		if (!reader.Read(call.object_id) || !reader.Read(merge) || merge > MERGE_DELETE
+			|| (keyed && !reader.Read(call.key_parameters))
+			|| !reader.ReadString(call.statement) || !reader.Read(parameter_count)
+			|| call.key_parameters > parameter_count)
+		{
+			return false;
+		}
+		call.merge = static_cast<ProcedureCallMerge>(merge);
+
+		for (uint32_t i = 0; i < parameter_count; ++i)
+		{
+			// The index of the type in ProcedureParameter
+			uint8_t type;
+			if (!reader.Read(type))
+			{
+				return false;
+			}
+
+			bool complete = false;
+			switch (type)
+			{
+			case 0: complete = ReadParameter<int32_t>(reader, call); break;
+			case 1: complete = ReadParameter<uint32_t>(reader, call); break;
+			case 2: complete = ReadParameter<uint64_t>(reader, call); break;
+			case 3: complete = ReadParameter<double>(reader, call); break;
+			case 4:
+				{
+					uint8_t value = 0;
+					complete = reader.Read(value);
+					call.parameters.push_back(value != 0);
+					break;
+				}
+			case 5:
+				{
+					string value;
+					complete = reader.ReadString(value);
+					call.parameters.push_back(move(value));
+					break;
+				}
+			}
+			if (!complete)
+			{
+				return false;
+			}
+		}
+
+		return reader.AtEnd();
+	}
+
+	bool DecodeRow(RecordReader& reader, ObjectSnapshot& row)
+	{
+		if (!reader.Read(row.changed_fields) || !reader.Read(row.object_id))
+		{
+			return false;
+		}
+
+		uint32_t fields = row.changed_fields;
+		bool complete = true;
+		if (fields & PERSIST_SCENE) complete = complete && reader.Read(row.scene_id);
+		if (fields & PERSIST_CONTAINER) complete = complete && reader.Read(row.parent_id);
+		if (fields & PERSIST_TEMPLATE) complete = complete && reader.ReadString(row.iff_template);
+		if (fields & PERSIST_POSITION)
+		{
+			complete = complete && reader.Read(row.x_position) && reader.Read(row.y_position) && reader.Read(row.z_position);
+		}
+		if (fields & PERSIST_ORIENTATION)
+		{
+			complete = complete && reader.Read(row.x_orientation) && reader.Read(row.y_orientation)
+				&& reader.Read(row.z_orientation) && reader.Read(row.w_orientation);
+		}
+		if (fields & PERSIST_COMPLEXITY) complete = complete && reader.Read(row.complexity);
+		if (fields & PERSIST_STF_NAME)
+		{
+			complete = complete && reader.ReadString(row.stf_name_file) && reader.ReadString(row.stf_name_string);
+		}
+		if (fields & PERSIST_CUSTOM_NAME) complete = complete && reader.ReadString(row.custom_name);
+		if (fields & PERSIST_VOLUME) complete = complete && reader.Read(row.volume);
+		if (fields & PERSIST_ARRANGEMENT) complete = complete && reader.Read(row.arrangement_id);
+		if (fields == PERSIST_ALL_FIELDS)
+		{
+			complete = complete && reader.Read(row.permission_type) && reader.Read(row.type_id);
+		}
+
+		uint32_t attribute_count;
+		if (!complete || !reader.Read(attribute_count))
+		{
+			return false;
+		}
+		for (uint32_t i = 0; i < attribute_count; ++i)
+		{
+			pair<string, string> attribute;
+			if (!reader.ReadString(attribute.first) || !reader.ReadString(attribute.second))
+			{
+				return false;
+			}
+			row.attributes.push_back(move(attribute));
+		}
+
+		return reader.AtEnd();
+	}
+
+	/// Prefixes a payload with its size and checksum.
+	string FrameRecord(const string& payload)
+	{
+		string record;
+		record.reserve(kRecordHeaderSize + payload.size());
+		RecordWriter header(record);
+		header.Write<uint32_t>(static_cast<uint32_t>(payload.size()));
+		header.Write<uint32_t>(Checksum(payload.data(), payload.size()));
+		record.append(payload);
+		return record;
+	}
+
+	/**
+	 * Reads the records in data from offset on until the end or the first damaged
+	 * record, version 1 records have no kind and are all rows.
+	 *
+	 * @return The offset reading stopped at.
+	 */
+	size_t ReadRecords(const string& data, size_t offset, char version, const function<void (ObjectSnapshot)>& on_row,
+		const function<void (ProcedureCall)>& on_call, uint64_t& count)
+	{
+		while (offset < data.size())
+		{
+			uint32_t size, checksum;
+			if (data.size() - offset < kRecordHeaderSize)
+			{
+				break;
+			}
+			memcpy(&size, data.data() + offset, sizeof(size));
+			memcpy(&checksum, data.data() + offset + sizeof(size), sizeof(checksum));
+
+			const char* payload = data.data() + offset + kRecordHeaderSize;
+			if (size > kMaxRecordSize || data.size() - offset - kRecordHeaderSize < size || Checksum(payload, size) != checksum)
+			{
+				break;
+			}
+
+			RecordReader reader(payload, size);
+			uint8_t kind = ROW_RECORD;
+			if (version != kRowsOnlyVersion && !reader.Read(kind))
+			{
+				break;
+			}
+
+			if (kind == ROW_RECORD)
+			{
+				ObjectSnapshot row = ObjectSnapshot();
+				if (!DecodeRow(reader, row))
+				{
+					break;
+				}
+				on_row(move(row));
+			}
+			else if (kind == CALL_RECORD)
+			{
+				ProcedureCall call;
+				if (!DecodeCall(reader, call, version != kUnkeyedCallsVersion))
+				{
+					break;
+				}
+				if (on_call)
+				{
+					on_call(move(call));
+				}
+			}
+			else
+			{
+				break;
+			}
+
+			offset += kRecordHeaderSize + size;
+			++count;
+		}
+
+		return offset;
+	}
+
+	/// Copies the fields set in from over into.
+	void MergeRow(ObjectSnapshot& into, ObjectSnapshot& from)
+	{
+		uint32_t fields = from.changed_fields;
+		if (fields & PERSIST_SCENE) into.scene_id = from.scene_id;
+		if (fields & PERSIST_CONTAINER) into.parent_id = from.parent_id;
+		if (fields & PERSIST_TEMPLATE) into.iff_template = move(from.iff_template);
+		if (fields & PERSIST_POSITION)
+		{
+			into.x_position = from.x_position;
+			into.y_position = from.y_position;
+			into.z_position = from.z_position;
+		}
+		if (fields & PERSIST_ORIENTATION)
+		{
+			into.x_orientation = from.x_orientation;
+			into.y_orientation = from.y_orientation;
+			into.z_orientation = from.z_orientation;
+			into.w_orientation = from.w_orientation;
+		}
+		if (fields & PERSIST_COMPLEXITY) into.complexity = from.complexity;
+		if (fields & PERSIST_STF_NAME)
+		{
+			into.stf_name_file = move(from.stf_name_file);
+			into.stf_name_string = move(from.stf_name_string);
+		}
+		if (fields & PERSIST_CUSTOM_NAME) into.custom_name = move(from.custom_name);
+		if (fields & PERSIST_VOLUME) into.volume = from.volume;
+		if (fields & PERSIST_ARRANGEMENT) into.arrangement_id = from.arrangement_id;
+		if (fields == PERSIST_ALL_FIELDS)
+		{
+			into.permission_type = from.permission_type;
+			into.type_id = from.type_id;
+		}
+		into.changed_fields |= fields;
+
+		for (auto& attribute : from.attributes)
+		{
+			auto find_itr = find_if(into.attributes.begin(), into.attributes.end(),
+				[&attribute] (const pair<string, string>& existing) { return existing.first == attribute.first; });
+
+			if (find_itr != into.attributes.end())
+				find_itr->second = move(attribute.second);
+			else
+				into.attributes.push_back(move(attribute));
+		}
+	}
+
+	bool SyncFile(FILE* file)
+	{
+		if (fflush(file) != 0)
+		{
+			return false;
+		}
+#ifdef _WIN32
+		return _commit(_fileno(file)) == 0;
+#else
+		return fsync(fileno(file)) == 0;
+#endif
+	}
+
+}
+
+ObjectJournal::ObjectJournal(string directory, Applier applier, chrono::milliseconds commit_interval, chrono::milliseconds compact_interval)
+	: directory_(move(directory))
+	, applier_(move(applier))
+	, commit_interval_(commit_interval)
+	, compact_interval_(compact_interval)
+	, next_sequence_(1)
+	, durable_sequence_(0)
+	, failed_sequence_(0)
+	, stopping_(false)
+	, file_(nullptr)
+	, segment_index_(0)
+	, bytes_appended_(0)
+	, commits_(0)
+	, failed_writes_(0)
+	, records_applied_(0)
+	, compactions_(0)
+	, failed_compactions_(0)
+{
+	boost::filesystem::create_directories(directory_);
+
+	// Never append to a segment left over from an earlier run, it may end in a torn record.
+	for (auto& segment : ListSegments_())
+	{
+		auto name = boost::filesystem::path(segment).stem().string();
+		segment_index_ = max<uint64_t>(segment_index_, stoull(name.substr(strlen(kSegmentPrefix))));
+	}
+	OpenSegment_(segment_index_ + 1);
+
+	writer_ = thread([this] () { RunWriter_(); });
+	if (compact_interval_.count() > 0)
+	{
+		compactor_ = thread([this] () { RunCompactor_(); });
+	}
+}
+
+ObjectJournal::~ObjectJournal()
+{
+	Stop();
+}
+
+uint64_t ObjectJournal::Append(const ObjectSnapshot& row)
+{
+	return AppendRecord_(EncodeRecord(row), row.object_id);
+}
+
+uint64_t ObjectJournal::Append(const ProcedureCall& call)
+{
+	return AppendRecord_(EncodeRecord(call), call.object_id);
+}
+
+uint64_t ObjectJournal::AppendRecord_(const string& record, uint64_t object_id)
+{
+	uint64_t sequence;
+	{
+		lock_guard<mutex> lock(mutex_);
+		if (stopping_)
+		{
+			LOG(warning) << "Object journal is stopped, dropping a change of object " << object_id;
+			return 0;
+		}
+
+		pending_.append(record);
+		bytes_appended_ += record.size();
+		sequence = next_sequence_++;
+	}
+
+	work_available_.notify_one();
+	return sequence;
+}
+
+bool ObjectJournal::Sync()
+{
+	unique_lock<mutex> lock(mutex_);
+	uint64_t start_sequence = max(durable_sequence_, failed_sequence_);
+	uint64_t last_sequence = next_sequence_ - 1;
+	durable_.wait(lock, [this, last_sequence] () { return max(durable_sequence_, failed_sequence_) >= last_sequence; });
+	return failed_sequence_ <= start_sequence;
+}
+
+void ObjectJournal::SetLostHandler(LostHandler handler)
+{
+	lock_guard<mutex> lock(mutex_);
+	lost_handler_ = move(handler);
+}
+
+uint64_t ObjectJournal::Compact()
+{
+	lock_guard<mutex> compact_lock(compact_mutex_);
+
+	Sync();
+	auto segments = Seal_();
+	if (segments.empty())
+	{
+		return 0;
+	}
+
+	vector<ObjectSnapshot> rows;
+	vector<ProcedureCall> calls;
+	for (auto& segment : segments)
+	{
+		ReadSegment(segment, [&rows] (ObjectSnapshot row) { rows.push_back(move(row)); },
+			[&calls] (ProcedureCall call) { calls.push_back(move(call)); });
+	}
+	uint64_t record_count = rows.size() + calls.size();
+
+	auto merged = Coalesce(move(rows));
+	auto merged_calls = CoalesceCalls(move(calls), merged);
+	bool applied = true;
+	if (!merged.empty() || !merged_calls.empty())
+	{
+		try
+		{
+			applied = applier_(merged, merged_calls);
+		}
+		catch (exception& e)
+		{
+			applied = false;
+			LOG(error) << "Object journal compaction failed: " << e.what();
+		}
+	}
+
+	{
+		lock_guard<mutex> lock(mutex_);
+		++compactions_;
+		if (!applied)
+		{
+			++failed_compactions_;
+		}
+		else
+		{
+			records_applied_ += record_count;
+		}
+	}
+
+	if (!applied)
+	{
+		LOG(warning) << "Object journal kept " << segments.size() << " segments, " << record_count << " records will be retried";
+		return 0;
+	}
+
+	for (auto& segment : segments)
+	{
+		boost::system::error_code error;
+		boost::filesystem::remove(segment, error);
+		if (error)
+		{
+			LOG(warning) << "Could not remove object journal segment " << segment << ": " << error.message();
+		}
+	}
+
+	return record_count;
+}
+
+void ObjectJournal::Stop()
+{
+	{
+		lock_guard<mutex> lock(mutex_);
+		if (stopping_)
+		{
+			return;
+		}
+		stopping_ = true;
+	}
+
+	work_available_.notify_all();
+	compactor_wakeup_.notify_all();
+
+	if (compactor_.joinable())
+	{
+		compactor_.join();
+	}
+	// The writer drains what is pending before it returns.
+	writer_.join();
+
+	lock_guard<mutex> file_lock(file_mutex_);
+	CloseSegment_();
+}
+
+JournalStatistics ObjectJournal::GetStatistics() const
+{
+	lock_guard<mutex> lock(mutex_);
+
+	JournalStatistics statistics;
+	statistics.records_appended = next_sequence_ - 1;
+	statistics.bytes_appended = bytes_appended_;
+	statistics.commits = commits_;
+	statistics.failed_writes = failed_writes_;
+	statistics.records_applied = records_applied_;
+	statistics.compactions = compactions_;
+	statistics.failed_compactions = failed_compactions_;
+
+	return statistics;
+}
+
+uint64_t ObjectJournal::ReadSegment(const string& path, const function<void (ObjectSnapshot)>& on_row,
+	const function<void (ProcedureCall)>& on_call)
+{
+	ifstream input(path.c_str(), ios::binary);
+	string data((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+
+	const size_t version_offset = sizeof(kSegmentMagic) - 1;
+	char version = (data.size() >= sizeof(kSegmentMagic)) ? data[version_offset] : 0;
+	if (data.size() < sizeof(kSegmentMagic) || memcmp(data.data(), kSegmentMagic, version_offset) != 0
+		|| (version != kSegmentMagic[version_offset] && version != kRowsOnlyVersion && version != kUnkeyedCallsVersion))
+	{
+		if (!data.empty())
+		{
+			LOG(warning) << "Object journal segment " << path << " has no valid header, skipping it";
+		}
+		return 0;
+	}
+
+	uint64_t count = 0;
+	size_t offset = ReadRecords(data, sizeof(kSegmentMagic), version, on_row, on_call, count);
+
+	if (offset < data.size())
+	{
+		LOG(warning) << "Object journal segment " << path << " ends in a damaged record, "
+			<< (data.size() - offset) << " bytes ignored";
+	}
+
+	return count;
+}
+
+vector<ObjectSnapshot> ObjectJournal::Coalesce(vector<ObjectSnapshot> rows)
+{
+	vector<ObjectSnapshot> merged;
+	unordered_map<uint64_t, size_t> positions;
+
+	for (auto& row : rows)
+	{
+		auto find_itr = positions.find(row.object_id);
+		if (find_itr == positions.end())
+		{
+			positions.insert(make_pair(row.object_id, merged.size()));
+			merged.push_back(move(row));
+		}
+		else
+		{
+			MergeRow(merged[find_itr->second], row);
+		}
+	}
+
+	return merged;
+}
+
+vector<ProcedureCall> ObjectJournal::CoalesceCalls(vector<ProcedureCall> calls, vector<ObjectSnapshot>& rows)
+{
+	unordered_set<uint64_t> deleted;
+	for (auto& call : calls)
+	{
+		if (call.merge == MERGE_DELETE)
+		{
+			deleted.insert(call.object_id);
+		}
+	}
+
+	if (!deleted.empty())
+	{
+		rows.erase(remove_if(rows.begin(), rows.end(),
+			[&deleted] (const ObjectSnapshot& row) { return deleted.count(row.object_id) != 0; }), rows.end());
+	}
+
+	// Walked from the back, so of calls that replace each other the last one is kept.
+	vector<ProcedureCall> kept;
+	unordered_set<string> seen;
+	for (auto itr = calls.rbegin(); itr != calls.rend(); ++itr)
+	{
+		if (itr->merge != MERGE_DELETE && deleted.count(itr->object_id) != 0)
+		{
+			continue;
+		}
+
+		string key;
+		if (itr->merge == MERGE_IDENTICAL)
+		{
+			key = EncodeRecord(*itr);
+		}
+		else
+		{
+			key = to_string(itr->object_id) + '\0' + itr->statement;
+
+			RecordWriter writer(key);
+			ParameterEncoder encoder(writer);
+			for (uint8_t i = 0; i < itr->key_parameters && i < itr->parameters.size(); ++i)
+			{
+				writer.Write<uint8_t>(static_cast<uint8_t>(itr->parameters[i].which()));
+				boost::apply_visitor(encoder, itr->parameters[i]);
+			}
+		}
+
+		if (seen.insert(move(key)).second)
+		{
+			kept.push_back(move(*itr));
+		}
+	}
+
+	reverse(kept.begin(), kept.end());
+	return kept;
+}
+
+string ObjectJournal::EncodeRecord(const ObjectSnapshot& row)
+{
+	string payload;
+	RecordWriter writer(payload);
+
+	writer.Write<uint8_t>(ROW_RECORD);
+	writer.Write(row.changed_fields);
+	writer.Write(row.object_id);
+
+	uint32_t fields = row.changed_fields;
+	if (fields & PERSIST_SCENE) writer.Write(row.scene_id);
+	if (fields & PERSIST_CONTAINER) writer.Write(row.parent_id);
+	if (fields & PERSIST_TEMPLATE) writer.WriteString(row.iff_template);
+	if (fields & PERSIST_POSITION)
+	{
+		writer.Write(row.x_position);
+		writer.Write(row.y_position);
+		writer.Write(row.z_position);
+	}
+	if (fields & PERSIST_ORIENTATION)
+	{
+		writer.Write(row.x_orientation);
+		writer.Write(row.y_orientation);
+		writer.Write(row.z_orientation);
+		writer.Write(row.w_orientation);
+	}
+	if (fields & PERSIST_COMPLEXITY) writer.Write(row.complexity);
+	if (fields & PERSIST_STF_NAME)
+	{
+		writer.WriteString(row.stf_name_file);
+		writer.WriteString(row.stf_name_string);
+	}
+	if (fields & PERSIST_CUSTOM_NAME) writer.WriteString(row.custom_name);
+	if (fields & PERSIST_VOLUME) writer.Write(row.volume);
+	if (fields & PERSIST_ARRANGEMENT) writer.Write(row.arrangement_id);
+	if (fields == PERSIST_ALL_FIELDS)
+	{
+		writer.Write(row.permission_type);
+		writer.Write(row.type_id);
+	}
+
+	writer.Write<uint32_t>(static_cast<uint32_t>(row.attributes.size()));
+	for (auto& attribute : row.attributes)
+	{
+		writer.WriteString(attribute.first);
+		writer.WriteString(attribute.second);
+	}
+
+	return FrameRecord(payload);
+}
+
+string ObjectJournal::EncodeRecord(const ProcedureCall& call)
+{
+	string payload;
+	RecordWriter writer(payload);
+
+	writer.Write<uint8_t>(CALL_RECORD);
+	writer.Write(call.object_id);
+	writer.Write<uint8_t>(static_cast<uint8_t>(call.merge));
+	writer.Write(call.key_parameters);
+	writer.WriteString(call.statement);
+
+	writer.Write<uint32_t>(static_cast<uint32_t>(call.parameters.size()));
+	ParameterEncoder encoder(writer);
+	for (auto& parameter : call.parameters)
+	{
+		writer.Write<uint8_t>(static_cast<uint8_t>(parameter.which()));
+		boost::apply_visitor(encoder, parameter);
+	}
+
+	return FrameRecord(payload);
+}
+
+string ObjectJournal::SegmentPath_(uint64_t index) const
+{
+	stringstream ss;
+	ss << kSegmentPrefix << setw(10) << setfill('0') << index << kSegmentExtension;
+	return (boost::filesystem::path(directory_) / ss.str()).string();
+}
+
+vector<string> ObjectJournal::ListSegments_() const
+{
+	vector<string> segments;
+
+	boost::filesystem::directory_iterator end;
+	for (boost::filesystem::directory_iterator itr(directory_); itr != end; ++itr)
+	{
+		auto filename = itr->path().filename().string();
+		if (filename.compare(0, strlen(kSegmentPrefix), kSegmentPrefix) == 0 &&
+			itr->path().extension().string() == kSegmentExtension)
+		{
+			segments.push_back(itr->path().string());
+		}
+	}
+
+	// The index is zero padded, so name order is write order.
+	sort(segments.begin(), segments.end());
+	return segments;
+}
+
+vector<string> ObjectJournal::Seal_()
+{
+	lock_guard<mutex> file_lock(file_mutex_);
+
+	if (file_ == nullptr)
+	{
+		return vector<string>();
+	}
+
+	CloseSegment_();
+	auto sealed_path = SegmentPath_(segment_index_);
+	OpenSegment_(segment_index_ + 1);
+
+	// The sealed segment and anything older that an earlier compaction left behind
+	vector<string> segments;
+	for (auto& segment : ListSegments_())
+	{
+		if (segment <= sealed_path)
+		{
+			segments.push_back(segment);
+		}
+	}
+	return segments;
+}
+
+bool ObjectJournal::OpenSegment_(uint64_t index)
+{
+	segment_index_ = index;
+
+	auto path = SegmentPath_(index);
+	file_ = fopen(path.c_str(), "wb");
+	if (file_ == nullptr)
+	{
+		LOG(error) << "Could not open object journal segment " << path;
+		return false;
+	}
+
+	if (fwrite(kSegmentMagic, 1, sizeof(kSegmentMagic), file_) != sizeof(kSegmentMagic) || !SyncFile(file_))
+	{
+		LOG(error) << "Could not write the header of object journal segment " << path;
+		fclose(file_);
+		file_ = nullptr;
+		return false;
+	}
+	return true;
+}
+
+void ObjectJournal::CloseSegment_()
+{
+	if (file_ != nullptr)
+	{
+		SyncFile(file_);
+		fclose(file_);
+		file_ = nullptr;
+	}
+}
+
+void ObjectJournal::RunWriter_()
+{
+	while (true)
+	{
+		string buffer;
+		uint64_t last_sequence;
+
+		{
+			unique_lock<mutex> lock(mutex_);
+			work_available_.wait(lock, [this] () { return stopping_ || !pending_.empty(); });
+
+			if (pending_.empty())
+			{
+				return;
+			}
+
+			// Group commit, give other producers a moment to join this write.
+			if (!stopping_ && commit_interval_.count() > 0)
+			{
+				work_available_.wait_for(lock, commit_interval_, [this] () { return stopping_; });
+			}
+
+			buffer.swap(pending_);
+			last_sequence = next_sequence_ - 1;
+		}
+
+		if (WriteCommit_(buffer))
+		{
+			lock_guard<mutex> lock(mutex_);
+			durable_sequence_ = last_sequence;
+			++commits_;
+		}
+		else
+		{
+			LostHandler lost_handler;
+			{
+				lock_guard<mutex> lock(mutex_);
+				failed_sequence_ = last_sequence;
+				++failed_writes_;
+				lost_handler = lost_handler_;
+			}
+
+			LOG(error) << "Object journal write failed, " << buffer.size() << " bytes not journaled";
+			if (lost_handler)
+			{
+				vector<ObjectSnapshot> lost;
+				uint64_t count = 0;
+				ReadRecords(buffer, 0, false, [&lost] (ObjectSnapshot row) { lost.push_back(move(row)); },
+					[&lost] (ProcedureCall call) {
+						ObjectSnapshot row = ObjectSnapshot();
+						row.object_id = call.object_id;
+						lost.push_back(move(row));
+					}, count);
+				lost_handler(lost);
+			}
+		}
+		durable_.notify_all();
+	}
+}
+
+bool ObjectJournal::WriteCommit_(const string& buffer)
+{
+	lock_guard<mutex> file_lock(file_mutex_);
+
+	for (int attempt = 0; attempt < 2; ++attempt)
+	{
+		if (file_ != nullptr && fwrite(buffer.data(), 1, buffer.size(), file_) == buffer.size() && SyncFile(file_))
+		{
+			return true;
+		}
+
+		// The segment may end in part of this commit now, which ends it for
+		// reading. Anything written later goes to the next one.
+		if (file_ != nullptr)
+		{
+			fclose(file_);
+			file_ = nullptr;
+		}
+		OpenSegment_(segment_index_ + 1);
+	}
+
+	return false;
+}
+
+void ObjectJournal::RunCompactor_()
+{
+	while (true)
+	{
+		{
+			unique_lock<mutex> lock(mutex_);
+			if (compactor_wakeup_.wait_for(lock, compact_interval_, [this] () { return stopping_; }))
+			{
+				return;
+			}
+		}
+
+		Compact();
+	}
+}
@@ -0,0 +1,208 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#ifndef SWGANH_OBJECT_OBJECT_JOURNAL_H_
+#define SWGANH_OBJECT_OBJECT_JOURNAL_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "swganh_core/object/persistence_pipeline.h"
+
+namespace swganh {
+namespace object {
+
+	struct JournalStatistics
+	{
+		uint64_t records_appended;     ///< since startup
+		uint64_t bytes_appended;
+		uint64_t commits;              ///< group commits, one write and sync each
+		uint64_t failed_writes;        ///< commits lost after the retry on a new segment failed too
+		uint64_t records_applied;      ///< replayed into storage by compaction
+		uint64_t compactions;
+		uint64_t failed_compactions;   ///< the journal was kept and is retried
+	};
+
+	/**
+	 * Append-only local journal of object changes.
+	 *
+	 * Changed rows are encoded into compact binary records (only the columns of the
+	 * set PersistField bits), as are the per type procedure calls and deletions of
+	 * objects, and written sequentially by a dedicated thread. Records
+	 * appended within commit_interval of each other share one write and sync, so
+	 * producers never wait on the disk.
+	 *
+	 * The journal is split into numbered segment files. Compaction seals the current
+	 * segment, merges the records of all sealed segments per object and hands them
+	 * to the applier, the segments are only removed once it reports success. A
+	 * deletion wins over every other record of its object, so an object deleted
+	 * before compaction is never written back. Any
+	 * segment left over from a crash is replayed by the first compaction after
+	 * startup. Records carry a checksum, a record torn by a crash mid write ends the
+	 * segment it is in.
+	 */
+	class ObjectJournal : private boost::noncopyable
+	{
+	public:
+		/**
+		 * Writes merged rows to storage and then makes the calls, called on the
+		 * compacting thread. The calls may depend on the object rows existing.
+		 *
+		 * @return False if the rows may not have been written, the journal is kept.
+		 */
+		typedef std::function<bool (const std::vector<ObjectSnapshot>&, const std::vector<ProcedureCall>&)> Applier;
+
+		/**
+		 * Takes back the records of a commit that could not be written, called on
+		 * the writer thread. A procedure call comes back as a row of its object
+		 * without changed fields.
+		 */
+		typedef std::function<void (const std::vector<ObjectSnapshot>&)> LostHandler;
+
+		/**
+		 * @param directory Where the segment files live, created if missing.
+		 * @param applier Writes compacted rows to storage.
+		 * @param commit_interval How long a group commit waits for more records.
+		 * @param compact_interval How often the background compactor runs, zero to
+		 *      only compact when Compact is called.
+		 */
+		ObjectJournal(std::string directory, Applier applier,
+			std::chrono::milliseconds commit_interval = std::chrono::milliseconds(20),
+			std::chrono::milliseconds compact_interval = std::chrono::milliseconds(0));
+		~ObjectJournal();
+
+		/**
+		 * Queues a row for the next group commit.
+		 *
+		 * @return The sequence number of the record.
+		 */
+		uint64_t Append(const ObjectSnapshot& row);
+
+		/**
+		 * Queues a procedure call for the next group commit.
+		 *
+		 * @return The sequence number of the record.
+		 */
+		uint64_t Append(const ProcedureCall& call);
+
+		/**
+		 * Blocks until every record appended so far has been written and synced,
+		 * or given up on.
+		 *
+		 * @return False if a commit that finished after the call started could not
+		 *      be written, its records went to the lost handler.
+		 */
+		bool Sync();
+
+		void SetLostHandler(LostHandler handler);
+
+		/**
+		 * Replays every record appended so far, and any segment left over from an
+		 * earlier run, into storage.
+		 *
+		 * @return The number of records replayed.
+		 */
+		uint64_t Compact();
+
+		/**
+		 * Writes out the queued records and stops the writer and compactor. Called
+		 * by the destructor, records appended after this are dropped.
+		 */
+		void Stop();
+
+		JournalStatistics GetStatistics() const;
+
+		/**
+		 * Reads the records of a segment in the order they were written.
+		 *
+		 * @param on_call Receives the procedure calls, they are skipped if it is empty.
+		 * @return The number of records read, reading stops at the first damaged record.
+		 */
+		static uint64_t ReadSegment(const std::string& path, const std::function<void (ObjectSnapshot)>& on_row,
+			const std::function<void (ProcedureCall)>& on_call = nullptr);
+
+		/**
+		 * Merges rows of the same object, later rows win field by field.
+		 *
+		 * @return One row per object, in the order the objects first appear.
+		 */
+		static std::vector<ObjectSnapshot> Coalesce(std::vector<ObjectSnapshot> rows);
+
+		/**
+		 * Drops the calls a later call makes redundant, see ProcedureCallMerge, and
+		 * the rows of deleted objects.
+		 *
+		 * @return The remaining calls in the order they were made.
+		 */
+		static std::vector<ProcedureCall> CoalesceCalls(std::vector<ProcedureCall> calls, std::vector<ObjectSnapshot>& rows);
+
+		/**
+		 * @return The encoded record of a row, as it is stored in a segment.
+		 */
+		static std::string EncodeRecord(const ObjectSnapshot& row);
+		static std::string EncodeRecord(const ProcedureCall& call);
+
+	private:
+		std::string SegmentPath_(uint64_t index) const;
+		std::vector<std::string> ListSegments_() const;
+
+		/// Closes the current segment, opens the next one and returns every older segment.
+		std::vector<std::string> Seal_();
+		bool OpenSegment_(uint64_t index);
+		void CloseSegment_();
+
+		/// Writes and syncs a commit, on failure once more to a fresh segment.
+		bool WriteCommit_(const std::string& buffer);
+
+		uint64_t AppendRecord_(const std::string& record, uint64_t object_id);
+
+		void RunWriter_();
+		void RunCompactor_();
+
+		std::string directory_;
+		Applier applier_;
+		std::chrono::milliseconds commit_interval_;
+		std::chrono::milliseconds compact_interval_;
+
+		mutable std::mutex mutex_;
+		std::condition_variable work_available_;
+		std::condition_variable durable_;
+		std::condition_variable compactor_wakeup_;
+		std::string pending_;
+		uint64_t next_sequence_;
+		uint64_t durable_sequence_;   ///< last record of the last commit that was written and synced
+		uint64_t failed_sequence_;    ///< last record of the last commit that was lost
+		bool stopping_;
+		LostHandler lost_handler_;
+
+		// Held while the current segment is written or swapped for the next one.
+		std::mutex file_mutex_;
+		std::FILE* file_;
+		uint64_t segment_index_;
+
+		// One compaction at a time, the background one or an explicit call.
+		std::mutex compact_mutex_;
+
+		uint64_t bytes_appended_;
+		uint64_t commits_;
+		uint64_t failed_writes_;
+		uint64_t records_applied_;
+		uint64_t compactions_;
+		uint64_t failed_compactions_;
+
+		std::thread writer_;
+		std::thread compactor_;
+	};
+
+}}  // namespace swganh::object
+
+#endif  // SWGANH_OBJECT_OBJECT_JOURNAL_H_
@@ -0,0 +1,456 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <vector>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <boost/crc.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "swganh_core/object/object_journal.h"
+
+using namespace swganh::object;
+
+namespace {
+
+	ObjectSnapshot MakePositionRow(uint64_t object_id, double x)
+	{
+		ObjectSnapshot row = ObjectSnapshot();
+		row.changed_fields = PERSIST_POSITION;
+		row.object_id = object_id;
+		row.x_position = x;
+		return row;
+	}
+
+	ProcedureCall MakeCall(uint64_t object_id, const std::string& statement, uint32_t value,
+		ProcedureCallMerge merge = MERGE_IDENTICAL)
+	{
+		ProcedureCall call(object_id, statement, merge);
+		call.AddUInt64(object_id);
+		call.AddUInt(value);
+		return call;
+	}
+
+	/// Journal directory that is removed again when the test ends.
+	struct JournalDirectory
+	{
+		JournalDirectory()
+			: path((boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string())
+		{}
+
+		~JournalDirectory()
+		{
+			boost::system::error_code error;
+			boost::filesystem::remove_all(path, error);
+		}
+
+		std::vector<std::string> Segments() const
+		{
+			std::vector<std::string> segments;
+			boost::filesystem::directory_iterator end;
+			for (boost::filesystem::directory_iterator itr(path); itr != end; ++itr)
+			{
+				segments.push_back(itr->path().string());
+			}
+			std::sort(segments.begin(), segments.end());
+			return segments;
+		}
+
+		std::string path;
+	};
+
+	/// Applier that keeps what it was given.
+	struct RecordingApplier
+	{
+		RecordingApplier() : succeed(true) {}
+
+		ObjectJournal::Applier Get()
+		{
+			return [this] (const std::vector<ObjectSnapshot>& rows, const std::vector<ProcedureCall>& calls) {
+				applied.insert(applied.end(), rows.begin(), rows.end());
+				applied_calls.insert(applied_calls.end(), calls.begin(), calls.end());
+				return succeed;
+			};
+		}
+
+		std::vector<ObjectSnapshot> applied;
+		std::vector<ProcedureCall> applied_calls;
+		bool succeed;
+	};
+
+}
+
+BOOST_AUTO_TEST_SUITE(ObjectJournalTest)
+
+/// This test shows that appended rows are replayed with every field they carried.
+BOOST_AUTO_TEST_CASE(AppendedRowsAreReplayed) {
+	JournalDirectory directory;
+	RecordingApplier applier;
+	ObjectJournal journal(directory.path, applier.Get());
+
+	ObjectSnapshot row = MakePositionRow(1, 10.0);
+	row.changed_fields |= PERSIST_CUSTOM_NAME;
+	row.custom_name = "Han Solo";
+	row.attributes.push_back(std::make_pair("cash_credits", "5000"));
+	journal.Append(row);
+	journal.Append(MakePositionRow(2, 20.0));
+
+	BOOST_CHECK_EQUAL(2u, journal.Compact());
+	BOOST_REQUIRE_EQUAL(2u, applier.applied.size());
+	BOOST_CHECK_EQUAL(1u, applier.applied[0].object_id);
+	BOOST_CHECK_EQUAL(10.0, applier.applied[0].x_position);
+	BOOST_CHECK_EQUAL("Han Solo", applier.applied[0].custom_name);
+	BOOST_REQUIRE_EQUAL(1u, applier.applied[0].attributes.size());
+	BOOST_CHECK_EQUAL("5000", applier.applied[0].attributes[0].second);
+	BOOST_CHECK_EQUAL(20.0, applier.applied[1].x_position);
+
+	// applied segments are gone, nothing is replayed twice
+	BOOST_CHECK_EQUAL(0u, journal.Compact());
+	BOOST_CHECK_EQUAL(2u, applier.applied.size());
+}
+
+/// This test shows that changes to the same object are merged into one row, later values winning.
+BOOST_AUTO_TEST_CASE(ChangesToTheSameObjectAreCoalesced) {
+	std::vector<ObjectSnapshot> rows;
+	rows.push_back(MakePositionRow(1, 1.0));
+	rows.back().attributes.push_back(std::make_pair("cash_credits", "100"));
+	rows.push_back(MakePositionRow(2, 5.0));
+	rows.push_back(MakePositionRow(1, 2.0));
+	rows.back().changed_fields |= PERSIST_SCENE;
+	rows.back().scene_id = 3;
+	rows.back().attributes.push_back(std::make_pair("cash_credits", "250"));
+
+	auto merged = ObjectJournal::Coalesce(rows);
+
+	BOOST_REQUIRE_EQUAL(2u, merged.size());
+	BOOST_CHECK_EQUAL(1u, merged[0].object_id);
+	BOOST_CHECK_EQUAL(static_cast<uint32_t>(PERSIST_POSITION | PERSIST_SCENE), merged[0].changed_fields);
+	BOOST_CHECK_EQUAL(2.0, merged[0].x_position);
+	BOOST_CHECK_EQUAL(3u, merged[0].scene_id);
+	BOOST_REQUIRE_EQUAL(1u, merged[0].attributes.size());
+	BOOST_CHECK_EQUAL("250", merged[0].attributes[0].second);
+}
+
+/// This test shows that procedure calls are replayed with every parameter they carried.
+BOOST_AUTO_TEST_CASE(ProcedureCallsAreReplayed) {
+	JournalDirectory directory;
+	RecordingApplier applier;
+	ObjectJournal journal(directory.path, applier.Get());
+
+	ProcedureCall call(7, "CALL sp_PersistTangible(?,?,?,?,?,?,?);", MERGE_LATEST);
+	call.AddUInt64(7);
+	call.AddString("customization");
+	call.AddInt(-3);
+	call.AddUInt(4);
+	call.AddDouble(0.5);
+	call.AddBoolean(true);
+	journal.Append(MakePositionRow(7, 1.0));
+	journal.Append(call);
+
+	BOOST_CHECK_EQUAL(2u, journal.Compact());
+	BOOST_REQUIRE_EQUAL(1u, applier.applied.size());
+	BOOST_REQUIRE_EQUAL(1u, applier.applied_calls.size());
+
+	auto& replayed = applier.applied_calls[0];
+	BOOST_CHECK_EQUAL(7u, replayed.object_id);
+	BOOST_CHECK_EQUAL(call.statement, replayed.statement);
+	BOOST_CHECK_EQUAL(MERGE_LATEST, replayed.merge);
+	BOOST_REQUIRE_EQUAL(6u, replayed.parameters.size());
+	BOOST_CHECK(call.parameters == replayed.parameters);
+	BOOST_CHECK_EQUAL("customization", boost::get<std::string>(replayed.parameters[1]));
+	BOOST_CHECK_EQUAL(-3, boost::get<int32_t>(replayed.parameters[2]));
+}
+
+/// This test shows that whole row calls keep only the latest, list calls keep
+/// their last repeat, and the order of what is left is kept.
+BOOST_AUTO_TEST_CASE(CallsAreCoalesced) {
+	std::vector<ProcedureCall> calls;
+	calls.push_back(MakeCall(1, "CALL sp_PersistPlayer(?,?);", 10, MERGE_LATEST));
+	calls.push_back(MakeCall(1, "CALL sp_UpdateBadges(?, ?);", 5));
+	calls.push_back(MakeCall(1, "CALL sp_RemoveBadge(?, ?);", 5));
+	calls.push_back(MakeCall(2, "CALL sp_PersistPlayer(?,?);", 30, MERGE_LATEST));
+	calls.push_back(MakeCall(1, "CALL sp_UpdateBadges(?, ?);", 5));
+	calls.push_back(MakeCall(1, "CALL sp_PersistPlayer(?,?);", 20, MERGE_LATEST));
+
+	std::vector<ObjectSnapshot> rows;
+	auto merged = ObjectJournal::CoalesceCalls(calls, rows);
+
+	BOOST_REQUIRE_EQUAL(4u, merged.size());
+	BOOST_CHECK_EQUAL("CALL sp_RemoveBadge(?, ?);", merged[0].statement);
+	BOOST_CHECK_EQUAL(2u, merged[1].object_id);
+	BOOST_CHECK_EQUAL("CALL sp_UpdateBadges(?, ?);", merged[2].statement);
+	BOOST_CHECK_EQUAL(20u, boost::get<uint32_t>(merged[3].parameters[1]));
+}
+
+/// This test shows that latest wins calls are told apart by their key parameters,
+/// which survive the journal, so each xp type keeps its own latest value.
+BOOST_AUTO_TEST_CASE(LatestCallsAreKeptPerKeyParameters) {
+	JournalDirectory directory;
+	RecordingApplier applier;
+	ObjectJournal journal(directory.path, applier.Get());
+
+	const char* update_xp = "CALL sp_UpdateExperience(?,?);";
+	auto make_xp = [&] (const std::string& type, uint32_t value) {
+		ProcedureCall call(1, update_xp, MERGE_LATEST, 1);
+		call.AddString(type);
+		call.AddUInt(value);
+		return call;
+	};
+	journal.Append(make_xp("combat_meleespecialize_onehand", 10));
+	journal.Append(make_xp("crafting_general", 5));
+	journal.Append(make_xp("combat_meleespecialize_onehand", 20));
+
+	BOOST_CHECK_EQUAL(3u, journal.Compact());
+	BOOST_REQUIRE_EQUAL(2u, applier.applied_calls.size());
+	BOOST_CHECK_EQUAL(1u, applier.applied_calls[0].key_parameters);
+	BOOST_CHECK_EQUAL("crafting_general", boost::get<std::string>(applier.applied_calls[0].parameters[0]));
+	BOOST_CHECK_EQUAL(5u, boost::get<uint32_t>(applier.applied_calls[0].parameters[1]));
+	BOOST_CHECK_EQUAL("combat_meleespecialize_onehand", boost::get<std::string>(applier.applied_calls[1].parameters[0]));
+	BOOST_CHECK_EQUAL(20u, boost::get<uint32_t>(applier.applied_calls[1].parameters[1]));
+}
+
+/// This test shows that nothing journaled for an object that was deleted is
+/// written back, before or after the deletion.
+BOOST_AUTO_TEST_CASE(DeletedObjectsAreNotWrittenBack) {
+	JournalDirectory directory;
+	RecordingApplier applier;
+	ObjectJournal journal(directory.path, applier.Get());
+
+	journal.Append(MakePositionRow(1, 1.0));
+	journal.Append(MakeCall(1, "CALL sp_PersistTangible(?,?);", 1, MERGE_LATEST));
+	journal.Append(MakePositionRow(2, 2.0));
+	journal.Append(MakeCall(1, "CALL sp_DeleteObject(?,?);", 0, MERGE_DELETE));
+	journal.Append(MakePositionRow(1, 3.0));
+
+	BOOST_CHECK_EQUAL(5u, journal.Compact());
+	BOOST_REQUIRE_EQUAL(1u, applier.applied.size());
+	BOOST_CHECK_EQUAL(2u, applier.applied[0].object_id);
+	BOOST_REQUIRE_EQUAL(1u, applier.applied_calls.size());
+	BOOST_CHECK_EQUAL(MERGE_DELETE, applier.applied_calls[0].merge);
+}
+
+/// This test shows that segments written before procedure calls were journaled
+/// are still replayed.
+BOOST_AUTO_TEST_CASE(RowsOnlySegmentsAreReplayed) {
+	JournalDirectory directory;
+	boost::filesystem::create_directories(directory.path);
+
+	// A version 1 record is the current one without the kind byte.
+	auto record = ObjectJournal::EncodeRecord(MakePositionRow(4, 8.0));
+	std::string payload = record.substr(2 * sizeof(uint32_t) + 1);
+	boost::crc_32_type crc;
+	crc.process_bytes(payload.data(), payload.size());
+	uint32_t size = static_cast<uint32_t>(payload.size());
+	uint32_t checksum = crc.checksum();
+
+	{
+		std::ofstream segment((boost::filesystem::path(directory.path) / "objects.0000000001.journal").string().c_str(), std::ios::binary);
+		segment.write("SWGJRNL1", 8);
+		segment.write(reinterpret_cast<const char*>(&size), sizeof(size));
+		segment.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+		segment.write(payload.data(), payload.size());
+	}
+
+	RecordingApplier applier;
+	ObjectJournal journal(directory.path, applier.Get());
+	BOOST_CHECK_EQUAL(1u, journal.Compact());
+	BOOST_REQUIRE_EQUAL(1u, applier.applied.size());
+	BOOST_CHECK_EQUAL(4u, applier.applied[0].object_id);
+	BOOST_CHECK_EQUAL(8.0, applier.applied[0].x_position);
+}
+
+/// This test shows that the journal is kept when the rows could not be applied.
+BOOST_AUTO_TEST_CASE(FailedApplyKeepsTheJournal) {
+	JournalDirectory directory;
+	RecordingApplier applier;
+	ObjectJournal journal(directory.path, applier.Get());
+
+	applier.succeed = false;
+	journal.Append(MakePositionRow(1, 1.0));
+	BOOST_CHECK_EQUAL(0u, journal.Compact());
+
+	applier.succeed = true;
+	applier.applied.clear();
+	journal.Append(MakePositionRow(1, 2.0));
+	BOOST_CHECK_EQUAL(2u, journal.Compact());
+
+	BOOST_REQUIRE_EQUAL(1u, applier.applied.size());
+	BOOST_CHECK_EQUAL(2.0, applier.applied[0].x_position);
+	BOOST_CHECK_EQUAL(1u, journal.GetStatistics().failed_compactions);
+}
+
+/// This test shows that a journal left behind is replayed on startup and a torn
+/// last record is dropped rather than misread.
+BOOST_AUTO_TEST_CASE(TornTailIsIgnoredOnRecovery) {
+	JournalDirectory directory;
+	{
+		RecordingApplier unused;
+		ObjectJournal journal(directory.path, unused.Get());
+		journal.Append(MakePositionRow(1, 1.0));
+		journal.Append(MakePositionRow(2, 2.0));
+		journal.Append(MakePositionRow(3, 3.0));
+	}
+
+	auto segments = directory.Segments();
+	BOOST_REQUIRE_EQUAL(1u, segments.size());
+	boost::filesystem::resize_file(segments[0], boost::filesystem::file_size(segments[0]) - 3);
+
+	RecordingApplier applier;
+	ObjectJournal journal(directory.path, applier.Get());
+	BOOST_CHECK_EQUAL(2u, journal.Compact());
+	BOOST_REQUIRE_EQUAL(2u, applier.applied.size());
+	BOOST_CHECK_EQUAL(2u, applier.applied[1].object_id);
+}
+
+#ifndef _WIN32
+/// This test shows that every change that was reported durable survives the
+/// process being killed while it is still writing.
+BOOST_AUTO_TEST_CASE(KilledWhileFlushingRecovers) {
+	JournalDirectory directory;
+	boost::filesystem::create_directories(directory.path);
+
+	int pipe_fds[2];
+	BOOST_REQUIRE_EQUAL(0, pipe(pipe_fds));
+
+	pid_t child = fork();
+	BOOST_REQUIRE(child >= 0);
+	if (child == 0)
+	{
+		close(pipe_fds[0]);
+		ObjectJournal journal(directory.path, [] (const std::vector<ObjectSnapshot>&, const std::vector<ProcedureCall>&) { return true; },
+			std::chrono::milliseconds(1));
+
+		// Report each object once it is durable, then keep appending until killed.
+		for (uint64_t object_id = 1; ; ++object_id)
+		{
+			journal.Append(MakePositionRow(object_id, static_cast<double>(object_id)));
+			journal.Sync();
+			if (write(pipe_fds[1], &object_id, sizeof(object_id)) != sizeof(object_id))
+			{
+				_exit(1);
+			}
+		}
+	}
+
+	close(pipe_fds[1]);
+	uint64_t durable = 0;
+	while (durable < 200)
+	{
+		BOOST_REQUIRE_EQUAL(static_cast<ssize_t>(sizeof(durable)), read(pipe_fds[0], &durable, sizeof(durable)));
+	}
+	kill(child, SIGKILL);
+	waitpid(child, nullptr, 0);
+
+	// Catch up on everything the child reported before it died.
+	uint64_t reported;
+	while (read(pipe_fds[0], &reported, sizeof(reported)) == sizeof(reported))
+	{
+		durable = reported;
+	}
+	close(pipe_fds[0]);
+
+	RecordingApplier applier;
+	ObjectJournal journal(directory.path, applier.Get());
+	journal.Compact();
+
+	std::set<uint64_t> recovered;
+	for (auto& row : applier.applied)
+	{
+		BOOST_CHECK_EQUAL(static_cast<double>(row.object_id), row.x_position);
+		recovered.insert(row.object_id);
+	}
+	BOOST_CHECK(recovered.size() >= durable);
+	for (uint64_t object_id = 1; object_id <= durable; ++object_id)
+	{
+		BOOST_CHECK(recovered.count(object_id) == 1);
+	}
+}
+
+/// This test shows that a commit the disk refuses is reported by Sync and handed
+/// to the lost handler instead of being counted as durable, and that the journal
+/// keeps working on a new segment.
+BOOST_AUTO_TEST_CASE(FailedWritesAreReported) {
+	JournalDirectory directory;
+
+	// The file size limit is per process, the journal runs in a child.
+	pid_t child = fork();
+	BOOST_REQUIRE(child >= 0);
+	if (child == 0)
+	{
+		signal(SIGXFSZ, SIG_IGN);
+		struct rlimit limit;
+		limit.rlim_cur = limit.rlim_max = 4096;
+		if (setrlimit(RLIMIT_FSIZE, &limit) != 0)
+		{
+			_exit(10);
+		}
+
+		std::vector<uint64_t> lost;
+		// Long enough for the row and call below to share a commit
+		ObjectJournal journal(directory.path, [] (const std::vector<ObjectSnapshot>&, const std::vector<ProcedureCall>&) { return true; },
+			std::chrono::milliseconds(200));
+		journal.SetLostHandler([&lost] (const std::vector<ObjectSnapshot>& rows) {
+			for (auto& row : rows)
+			{
+				lost.push_back(row.object_id);
+			}
+		});
+
+		journal.Append(MakePositionRow(1, 1.0));
+		if (!journal.Sync())
+		{
+			_exit(11);
+		}
+
+		// Too big for any segment, the retry on a new segment fails as well.
+		ObjectSnapshot oversized = MakePositionRow(2, 2.0);
+		oversized.changed_fields |= PERSIST_CUSTOM_NAME;
+		oversized.custom_name.assign(8000, 'x');
+		journal.Append(oversized);
+		journal.Append(MakeCall(2, "CALL sp_PersistTangible(?,?);", 1, MERGE_LATEST));
+		if (journal.Sync() || lost.size() != 2 || lost[0] != 2 || lost[1] != 2)
+		{
+			_exit(12);
+		}
+
+		journal.Append(MakePositionRow(3, 3.0));
+		if (!journal.Sync() || journal.GetStatistics().failed_writes != 1)
+		{
+			_exit(13);
+		}
+		_exit(0);
+	}
+
+	int status = 0;
+	waitpid(child, &status, 0);
+	BOOST_REQUIRE(WIFEXITED(status));
+	BOOST_CHECK_EQUAL(0, WEXITSTATUS(status));
+
+	// Only what was reported durable is replayed.
+	RecordingApplier applier;
+	ObjectJournal journal(directory.path, applier.Get());
+	journal.Compact();
+
+	std::set<uint64_t> recovered;
+	for (auto& row : applier.applied)
+	{
+		recovered.insert(row.object_id);
+	}
+	BOOST_CHECK(recovered.count(1) == 1);
+	BOOST_CHECK(recovered.count(3) == 1);
+	BOOST_CHECK(applier.applied_calls.empty());
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
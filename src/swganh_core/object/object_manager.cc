@@ -8,10 +8,15 @@
 
 #include "swganh/logger.h"
 
+#include <algorithm>
 #include <bitset>
+#include <functional>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "object_factory.h"
+#include "bulk_object_loader.h"
 #include "swganh/event_dispatcher.h"
 #include "swganh/tre/resource_manager.h"
 #include "swganh/tre/visitors/objects/object_visitor.h"
@@ -48,6 +53,277 @@ namespace bp = boost::python;
 
 #define DYNAMIC_ID_START 17596481011712
 
+namespace {
+
+	// Rows of object_attributes written per statement
+	const size_t kAttributeChunkSize = 500;
+
+	/**
+	 * Binds the columns of the PersistField bits in changed_fields, in bit order.
+	 */
+	void BindChangedColumns(sql::PreparedStatement* statement, const ObjectSnapshot& row, uint32_t changed_fields, uint32_t& counter)
+	{
+		if (changed_fields & PERSIST_SCENE)
+		{
+			statement->setUInt(counter++, row.scene_id);
+		}
+		if (changed_fields & PERSIST_CONTAINER)
+		{
+			statement->setUInt64(counter++, row.parent_id);
+		}
+		if (changed_fields & PERSIST_TEMPLATE)
+		{
+			statement->setString(counter++, row.iff_template);
+		}
+		if (changed_fields & PERSIST_POSITION)
+		{
+			statement->setDouble(counter++, row.x_position);
+			statement->setDouble(counter++, row.y_position);
+			statement->setDouble(counter++, row.z_position);
+		}
+		if (changed_fields & PERSIST_ORIENTATION)
+		{
+			statement->setDouble(counter++, row.x_orientation);
+			statement->setDouble(counter++, row.y_orientation);
+			statement->setDouble(counter++, row.z_orientation);
+			statement->setDouble(counter++, row.w_orientation);
+		}
+		if (changed_fields & PERSIST_COMPLEXITY)
+		{
+			statement->setDouble(counter++, row.complexity);
+		}
+		if (changed_fields & PERSIST_STF_NAME)
+		{
+			statement->setString(counter++, row.stf_name_file);
+			statement->setString(counter++, row.stf_name_string);
+		}
+		if (changed_fields & PERSIST_CUSTOM_NAME)
+		{
+			statement->setString(counter++, row.custom_name);
+		}
+		if (changed_fields & PERSIST_VOLUME)
+		{
+			statement->setUInt(counter++, row.volume);
+		}
+		if (changed_fields & PERSIST_ARRANGEMENT)
+		{
+			statement->setInt(counter++, row.arrangement_id);
+		}
+	}
+
+	/**
+	 * Writes a batch of object rows and their attributes inside a single
+	 * transaction. Rows that were never written go out as one multi-row upsert,
+	 * the others as updates of only their changed columns.
+	 */
+	void WriteObjectBatch(swganh::database::DatabaseManager* database_manager, const vector<ObjectSnapshot>& rows)
+	{
+		auto conn = database_manager->getConnection("galaxy");
+		conn->setAutoCommit(false);
+
+		try
+		{
+			vector<const ObjectSnapshot*> new_rows;
+			map<uint32_t, vector<const ObjectSnapshot*>> changed_rows;
+			for (auto& row : rows)
+			{
+				if (row.changed_fields == PERSIST_ALL_FIELDS)
+				{
+					new_rows.push_back(&row);
+				}
+				else if (row.changed_fields != 0)
+				{
+					changed_rows[row.changed_fields].push_back(&row);
+				}
+			}
+
+			if (!new_rows.empty())
+			{
+				unique_ptr<sql::PreparedStatement> statement(conn->prepareStatement(PersistencePipeline::BuildObjectUpsert(new_rows.size())));
+				uint32_t counter = 1;
+				for (auto row : new_rows)
+				{
+					statement->setUInt64(counter++, row->object_id);
+					BindChangedColumns(statement.get(), *row, PERSIST_ALL_FIELDS, counter);
+					statement->setInt(counter++, row->permission_type);
+					statement->setInt(counter++, row->type_id);
+				}
+				statement->executeUpdate();
+			}
+
+			// One statement per distinct set of changed columns
+			for (auto& group : changed_rows)
+			{
+				unique_ptr<sql::PreparedStatement> statement(conn->prepareStatement(PersistencePipeline::BuildObjectUpdate(group.first)));
+				for (auto row : group.second)
+				{
+					uint32_t counter = 1;
+					BindChangedColumns(statement.get(), *row, group.first, counter);
+					statement->setUInt64(counter++, row->object_id);
+					statement->executeUpdate();
+				}
+			}
+
+			vector<pair<uint64_t, const pair<string, string>*>> attributes;
+			for (auto& row : rows)
+			{
+				for (auto& attribute : row.attributes)
+				{
+					attributes.push_back(make_pair(row.object_id, &attribute));
+				}
+			}
+
+			for (size_t offset = 0; offset < attributes.size(); offset += kAttributeChunkSize)
+			{
+				size_t count = min(kAttributeChunkSize, attributes.size() - offset);
+				unique_ptr<sql::PreparedStatement> attribute_statement(conn->prepareStatement(PersistencePipeline::BuildAttributeUpsert(count)));
+				uint32_t counter = 1;
+				for (size_t i = offset; i < offset + count; ++i)
+				{
+					attribute_statement->setUInt64(counter++, attributes[i].first);
+					attribute_statement->setString(counter++, attributes[i].second->first);
+					attribute_statement->setString(counter++, attributes[i].second->second);
+				}
+				attribute_statement->executeUpdate();
+			}
+
+			conn->commit();
+		}
+		catch(sql::SQLException &e)
+		{
+			LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
+			LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
+
+			conn->rollback();
+			conn->setAutoCommit(true);
+			throw;
+		}
+
+		// connections go back to the shared pool
+		conn->setAutoCommit(true);
+	}
+
+	/**
+	 * Builds the objects found by the BulkObjectLoader through the registered
+	 * factories and puts each one into its parent.
+	 */
+	class ObjectManagerLoadTarget : public BulkLoadTarget
+	{
+	public:
+		typedef std::function<shared_ptr<ObjectFactoryInterface>(uint32_t)> FactoryLookup;
+		typedef std::function<shared_ptr<Object>(uint64_t, uint32_t)> SingleLoader;
+
+		ObjectManagerLoadTarget(const shared_ptr<Object>& root, FactoryLookup factory_lookup, SingleLoader single_loader)
+			: factory_lookup_(factory_lookup)
+			, single_loader_(single_loader)
+		{
+			loaded_[root->GetObjectId()] = root;
+			root->ViewObjects(nullptr, 0, true, [&] (shared_ptr<Object> contained_object) {
+				loaded_[contained_object->GetObjectId()] = contained_object;
+			});
+		}
+
+		std::string GetTypeTable(uint32_t object_type)
+		{
+			auto factory = factory_lookup_(object_type);
+			return factory ? factory->GetBulkLoadTable() : "";
+		}
+
+		std::vector<std::string> GetTypeColumns(uint32_t object_type)
+		{
+			auto factory = factory_lookup_(object_type);
+			return factory ? factory->GetBulkLoadColumns() : std::vector<std::string>();
+		}
+
+		bool IsLoaded(uint64_t object_id)
+		{
+			return loaded_.find(object_id) != loaded_.end();
+		}
+
+		void LoadFromRow(uint32_t object_type, sql::ResultSet& row)
+		{
+			auto factory = factory_lookup_(object_type);
+			auto object = factory ? factory->CreateObjectFromRow(row) : nullptr;
+			if (!object)
+			{
+				LoadSingle(row.getUInt64("object_id"), object_type, row.getUInt64("parent_id"));
+				return;
+			}
+
+			from_rows_.insert(object->GetObjectId());
+			Attach_(object, row.getUInt64("parent_id"));
+		}
+
+		void LoadSingle(uint64_t object_id, uint32_t object_type, uint64_t parent_id)
+		{
+			shared_ptr<Object> object;
+			try {
+				object = single_loader_(object_id, object_type);
+			} catch(std::exception& e) {
+				LOG(warning) << e.what();
+			}
+
+			if (!object)
+			{
+				// its contents are not attached either, they have no parent to go into
+				LOG(warning) << "Could not load object " << object_id << " of type " << object_type << " in " << parent_id;
+				return;
+			}
+
+			Attach_(object, parent_id);
+		}
+
+		void LoadAttribute(uint64_t object_id, const std::string& name, const std::string& value)
+		{
+			// objects loaded one at a time already have their attributes
+			if (from_rows_.find(object_id) == from_rows_.end())
+			{
+				return;
+			}
+
+			ObjectFactory::ApplyStoredAttribute(loaded_[object_id], name, value);
+		}
+
+		/// Marks everything created so far as unchanged, it all came from storage.
+		void ClearChangedFields()
+		{
+			for (auto object_id : from_rows_)
+			{
+				loaded_[object_id]->ClearChangedFields();
+			}
+		}
+
+	private:
+		void Attach_(const shared_ptr<Object>& object, uint64_t parent_id)
+		{
+			loaded_[object->GetObjectId()] = object;
+
+			auto parent_iter = loaded_.find(parent_id);
+			if (parent_iter == loaded_.end() || object->GetContainer() != nullptr)
+			{
+				return;
+			}
+
+			if(object->GetArrangementId() == -2)
+			{
+				//This object has never been loaded before and needs to be put into the default slot.
+				parent_iter->second->AddObject(nullptr, object);
+			}
+			else 
+			{
+				//Put it back where it was persisted
+				parent_iter->second->AddObject(nullptr, object, object->GetArrangementId());
+			}
+		}
+
+		FactoryLookup factory_lookup_;
+		SingleLoader single_loader_;
+		std::unordered_map<uint64_t, shared_ptr<Object>> loaded_;
+		std::unordered_set<uint64_t> from_rows_;
+	};
+
+}
+
 void ObjectManager::AddContainerPermissionType_(PermissionType type, ContainerPermissionsInterface* ptr)
 {
 	permissions_objects_.insert(std::make_pair<int, std::shared_ptr<ContainerPermissionsInterface>>(static_cast<int>(type), 
@@ -69,9 +345,92 @@ ObjectManager::ObjectManager(swganh::app::SwganhKernel* kernel)
 	//Load slot definitions
 	slot_definition_ = kernel->GetResourceManager()->GetResourceByName<SlotDefinitionVisitor>("abstract/slot/slot_definition/slot_definitions.iff");
 
+	// Keep the custom name index in sync with renames
+	kernel_->GetEventDispatcher()->Subscribe("Object::CustomName", [this] (const shared_ptr<EventInterface>& incoming_event)
+	{
+		auto object = static_pointer_cast<ObjectEvent>(incoming_event)->Get();
+		object_registry_.UpdateCustomName(object);
+	});
+
+	// Persistence gets its share of the database connections as writer threads
+	auto& app_config = kernel_->GetAppConfig();
+	uint32_t persist_workers = max(1u, app_config.db_max_connections * min(app_config.persist_db_share, 100u) / 100);
+
+	auto database_manager = kernel_->GetDatabaseManager();
+	bool journaled = !app_config.object_journal_directory.empty();
+	persistence_pipeline_.reset(new PersistencePipeline([this, database_manager, journaled] (const vector<ObjectSnapshot>& rows) {
+		try
+		{
+			WriteObjectBatch(database_manager, rows);
+		}
+		catch(sql::SQLException&)
+		{
+			// Journaled rows stay in the journal until they are written
+			if (!journaled)
+			{
+				RequeueFailedRows_(rows);
+			}
+			throw;
+		}
+	}, persist_workers, 500, 50000, app_config.persist_rows_per_second));
+
+	// Changed objects are collected here rather than on the io_service
+	persist_scheduler_.reset(new swganh::ThreadPool(1));
+
 	persist_timer_ = std::make_shared<boost::asio::deadline_timer>(kernel_->GetIoService(), boost::posix_time::minutes(5));
 	persist_timer_->async_wait(boost::bind(&ObjectManager::PersistObjectsByTimer, this, boost::asio::placeholders::error));
 
+	if (!app_config.object_journal_directory.empty())
+	{
+		auto pipeline = persistence_pipeline_.get();
+		object_journal_.reset(new ObjectJournal(app_config.object_journal_directory, [pipeline, database_manager] (
+			const vector<ObjectSnapshot>& rows, const vector<ProcedureCall>& calls) {
+			// Any failure while these are written keeps the journal, replaying rows
+			// and calls that did make it is harmless.
+			uint64_t errors = pipeline->GetStatistics().errors;
+			auto levels = PersistencePipeline::ContainmentLevels(rows);
+
+			// Queued level by level, the workers start on a level as soon as the
+			// ones below it are written
+			vector<size_t> order(rows.size());
+			for (size_t i = 0; i < order.size(); ++i)
+			{
+				order[i] = i;
+			}
+			stable_sort(order.begin(), order.end(), [&levels] (size_t a, size_t b) { return levels[a] < levels[b]; });
+
+			uint32_t calls_level = 0;
+			for (auto i : order)
+			{
+				pipeline->Enqueue(rows[i], levels[i]);
+				calls_level = max(calls_level, levels[i]);
+			}
+			// The type tables and deletions refer to the object rows, they go after
+			// the rows of the deepest level, those of one object in journal order
+			for (auto& call : calls)
+			{
+				pipeline->EnqueueTask([database_manager, call] () { ObjectFactory::WriteProcedureCall(database_manager, call); },
+					calls_level, call.object_id);
+			}
+			pipeline->Flush();
+			return pipeline->GetStatistics().errors == errors;
+		}, std::chrono::milliseconds(20), std::chrono::seconds(app_config.object_journal_compact_interval)));
+
+		// Changes the disk refused are collected again on the next journal tick
+		object_journal_->SetLostHandler([this] (const vector<ObjectSnapshot>& rows) { RequeueFailedRows_(rows); });
+
+		// Write what an earlier run journaled but never got to the database
+		auto recovered = object_journal_->Compact();
+		if (recovered > 0)
+		{
+			LOG(warning) << "Replayed " << recovered << " journaled object changes";
+		}
+
+		journal_timer_ = std::make_shared<boost::asio::deadline_timer>(kernel_->GetIoService(),
+			boost::posix_time::milliseconds(app_config.object_journal_interval));
+		journal_timer_->async_wait(boost::bind(&ObjectManager::JournalObjectsByTimer, this, boost::asio::placeholders::error));
+	}
+
 	// Load the highest object_id from the db
 	unique_ptr<sql::Statement> statement(kernel_->GetDatabaseManager()->getConnection("galaxy")->createStatement());
 	auto result = unique_ptr<sql::ResultSet>(statement->executeQuery("CALL sp_GetHighestObjectId();"));
@@ -85,6 +444,41 @@ ObjectManager::ObjectManager(swganh::app::SwganhKernel* kernel)
 ObjectManager::~ObjectManager()
 {}
 
+void ObjectManager::RequeueFailedRows_(const vector<ObjectSnapshot>& rows)
+{
+	auto& interner = swganh::StringInterner::getInstance();
+	for (auto& row : rows)
+	{
+		auto object = GetObjectById(row.object_id);
+		if (!object)
+		{
+			continue;
+		}
+
+		vector<uint32_t> attribute_ids;
+		for (auto& attribute : row.attributes)
+		{
+			attribute_ids.push_back(interner.Intern(attribute.first));
+		}
+		object->RestoreChangedFields(row.changed_fields, attribute_ids);
+
+		std::shared_ptr<ObjectFactoryInterface> factory;
+		{
+			boost::shared_lock<boost::shared_mutex> lock(object_factories_mutex_);
+			auto find_iter = factories_.find(object->GetType());
+			if (find_iter != factories_.end())
+			{
+				factory = find_iter->second;
+			}
+		}
+
+		if (factory)
+		{
+			factory->RequeueChangedObject(object);
+		}
+	}
+}
+
 void ObjectManager::RegisterObjectType(uint32_t object_type, const shared_ptr<ObjectFactoryInterface>& factory)
 {
 	{
@@ -121,19 +515,84 @@ void ObjectManager::RegisterMessageBuilder(uint32_t object_type, std::shared_ptr
 }
 void ObjectManager::InsertObject(std::shared_ptr<swganh::object::Object> object)
 {
-	boost::lock_guard<boost::shared_mutex> lg(object_map_mutex_);
-    object_map_.insert(make_pair(object->GetObjectId(), object));
+	object_registry_.Insert(object);
 }
 
 void ObjectManager::PersistObjectsByTimer(const boost::system::error_code& e)
 {
 	if (!e)
 	{
-		boost::shared_lock<boost::shared_mutex> lock(object_factories_mutex_);
-		for (auto& factory : factories_)
+		persist_scheduler_->Schedule([this] () {
+			if (object_journal_)
+			{
+				boost::shared_lock<boost::shared_mutex> lock(object_factories_mutex_);
+				for (auto& factory : factories_)
+				{
+					factory.second->PersistChangedObjects();
+				}
+				return;
+			}
+
+			// The objects of every factory are queued level by level, so that every
+			// container goes out before its contents whichever factory they belong
+			// to, while the workers already write the levels queued before.
+			struct ChangedObject
+			{
+				uint32_t depth;
+				std::shared_ptr<ObjectFactoryInterface> factory;
+				std::shared_ptr<Object> object;
+			};
+			vector<ChangedObject> changed;
+			{
+				boost::shared_lock<boost::shared_mutex> lock(object_factories_mutex_);
+				vector<shared_ptr<Object>> objects;
+				for (auto& factory : factories_)
+				{
+					objects.clear();
+					factory.second->TakeChangedObjects(objects);
+					for (auto& object : objects)
+					{
+						ChangedObject entry = { ObjectFactory::GetContainmentDepth(object), factory.second, object };
+						changed.push_back(move(entry));
+					}
+				}
+			}
+			stable_sort(changed.begin(), changed.end(), [] (const ChangedObject& a, const ChangedObject& b) {
+				return a.depth < b.depth;
+			});
+
+			// Blocks whenever the queue is full
+			for (auto& entry : changed)
+			{
+				entry.factory->PersistChangedObject(*persistence_pipeline_, entry.object);
+			}
+		});
+
+		auto statistics = persistence_pipeline_->GetStatistics();
+		LOG(info) << "Persistence queue depth: " << statistics.queue_depth
+			<< ", rows written: " << statistics.rows_written
+			<< " (" << statistics.rows_per_second << " rows/sec, " << statistics.bytes_written << " bytes)"
+			<< ", last flush: " << statistics.last_flush_rows << " rows, " << statistics.last_flush_bytes
+			<< " bytes in " << statistics.last_flush_latency_ms << "ms"
+			<< ", errors: " << statistics.errors
+			<< ", throttled: " << statistics.throttled_ms << "ms";
+
+		if (object_journal_)
 		{
-			factory.second->PersistChangedObjects();
+			auto journal_statistics = object_journal_->GetStatistics();
+			LOG(info) << "Object journal records: " << journal_statistics.records_appended
+				<< " (" << journal_statistics.bytes_appended << " bytes in " << journal_statistics.commits << " commits, "
+				<< journal_statistics.failed_writes << " failed)"
+				<< ", applied: " << journal_statistics.records_applied
+				<< ", failed compactions: " << journal_statistics.failed_compactions;
 		}
+
+		auto database_statistics = kernel_->GetDatabaseManager()->GetStatistics();
+		LOG(info) << "Database connections open: " << database_statistics.connections_open
+			<< ", pool waits: " << database_statistics.pool_waits << " (" << database_statistics.pool_timeouts << " timed out, "
+			<< database_statistics.pool_wait_ms << "ms total)"
+			<< ", statement cache hits: " << database_statistics.statement_cache_hits
+			<< ", misses: " << database_statistics.statement_cache_misses;
 		persist_timer_->expires_from_now(boost::posix_time::minutes(5));
 		persist_timer_->async_wait(boost::bind(&ObjectManager::PersistObjectsByTimer, this, boost::asio::placeholders::error));
 		kernel_->GetEventDispatcher()->Dispatch(std::make_shared<BaseEvent>("ObjectManager::PersistObjectsByTimer"));
@@ -145,6 +604,27 @@ void ObjectManager::PersistObjectsByTimer(const boost::system::error_code& e)
 
 }
 
+void ObjectManager::JournalObjectsByTimer(const boost::system::error_code& e)
+{
+	if (!e)
+	{
+		persist_scheduler_->Schedule([this] () {
+			boost::shared_lock<boost::shared_mutex> lock(object_factories_mutex_);
+			for (auto& factory : factories_)
+			{
+				factory.second->JournalChangedObjects(*object_journal_);
+			}
+		});
+
+		journal_timer_->expires_from_now(boost::posix_time::milliseconds(kernel_->GetAppConfig().object_journal_interval));
+		journal_timer_->async_wait(boost::bind(&ObjectManager::JournalObjectsByTimer, this, boost::asio::placeholders::error));
+	}
+	else
+	{
+		LOG(warning) << "JournalObjectsByTimer error: " << e.message();
+	}
+}
+
 shared_ptr<Object> ObjectManager::LoadObjectById(uint64_t object_id)
 {
     auto object = GetObjectById(object_id);
@@ -177,68 +657,58 @@ shared_ptr<Object> ObjectManager::LoadObjectById(uint64_t object_id, uint32_t ob
 
 void ObjectManager::LoadContainedObjects(std::shared_ptr<Object> object)
 {	
+	try {
+		ObjectManagerLoadTarget target(object,
+			[this] (uint32_t object_type) -> shared_ptr<ObjectFactoryInterface> {
+				boost::shared_lock<boost::shared_mutex> lock(object_factories_mutex_);
+				auto find_iter = factories_.find(object_type);
+				return find_iter != factories_.end() ? find_iter->second : nullptr;
+			},
+			[this] (uint64_t object_id, uint32_t object_type) {
+				return CreateObjectFromStorage(object_id, object_type);
+			});
+
+		auto conn = kernel_->GetDatabaseManager()->getConnection("galaxy");
+		auto statistics = BulkObjectLoader().Load(*conn, object->GetObjectId(), target);
+		target.ClearChangedFields();
+
+		DLOG(info) << "Loaded contents of " << object->GetObjectId() << ": " << statistics.levels << " levels, "
+			<< statistics.rows_loaded + statistics.single_loads << " objects (" << statistics.single_loads << " loaded singly) in "
+			<< statistics.queries << " queries";
+	}
+	catch(sql::SQLException &e)
+	{
+		LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
+		LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
+	}
+
+	// Gather the whole tree first so the registry grows once per load rather than
+	// once per contained item.
+	std::vector<shared_ptr<Object>> contained_objects;
 	object->ViewObjects(nullptr, 0, true, [&](shared_ptr<Object> contained_object){
-		InsertObject(contained_object);
+		contained_objects.push_back(contained_object);
 	});
+
+	object_registry_.Reserve(contained_objects.size());
+	for (auto& contained_object : contained_objects)
+	{
+		InsertObject(contained_object);
+	}
 }
 
 shared_ptr<Object> ObjectManager::GetObjectById(uint64_t object_id)
 {
-    boost::shared_lock<boost::shared_mutex> lock(object_map_mutex_);
-    auto find_iter = object_map_.find(object_id);
-
-    if (find_iter == object_map_.end())
-    {
-        return nullptr;
-    }
-    return find_iter->second;
+    return object_registry_.Find(object_id);
 }
 
 void ObjectManager::RemoveObject(const shared_ptr<Object>& object)
 {
-    boost::lock_guard<boost::shared_mutex> lg(object_map_mutex_);
-    object_map_.erase(object_map_.find(object->GetObjectId()));
+    object_registry_.Remove(object->GetObjectId());
 }
 
 shared_ptr<Object> ObjectManager::GetObjectByCustomName(const wstring& custom_name)
 {
-    auto check_name = custom_name;
-    std::transform(std::begin(check_name), std::end(check_name), std::begin(check_name), ::towlower);
-
-    boost::shared_lock<boost::shared_mutex> lock(object_map_mutex_);
-	auto find_iter = std::find_if(
-        std::begin(object_map_), 
-        std::end(object_map_),
-        [&check_name] (pair<uint64_t, shared_ptr<Object>> key_value) -> bool
-    {
-        // Names are case insensitive, normalize by converting to lowercase before comparison checks
-        auto custom_name = key_value.second->GetCustomName();
-        std::transform(std::begin(custom_name), std::end(custom_name), std::begin(custom_name), ::towlower);
-
-        if (custom_name.compare(check_name) == 0)
-        {
-            return true;
-        }
-
-        // Only first names are unique, if a complete match fails then
-        // attempt to match the first name only.
-        std::size_t pos = custom_name.find(L" ");
-        std::wstring firstname = custom_name.substr(0, pos);
-
-        if (firstname.compare(check_name) == 0)
-        {
-            return true;
-        }
-
-        return false;
-	});
-
-	if (find_iter == object_map_.end())
-    {
-        return nullptr;
-    }
-
-    return find_iter->second;
+    return object_registry_.FindByCustomName(custom_name);
 }
 
 shared_ptr<Object> ObjectManager::CreateObjectFromStorage(uint64_t object_id)
@@ -295,50 +765,99 @@ shared_ptr<Object> ObjectManager::CreateObjectFromTemplate(const string& templat
 	//Then make sure we actually can create an object of this type
 	shared_ptr<Object> created_object;
 
-	// Call python To get Object
-	
+	// Clone the cached prototype when there is one, this avoids the python call
+	// and reloading the slot and collision data for every new object.
 	{
-		swganh::scripting::ScopedGilLock lock;
+		boost::shared_lock<boost::shared_mutex> lock(prototypes_mutex_);
+		auto prototype_iter = prototypes_.find(template_name);
+		if (prototype_iter != prototypes_.end())
 		{
-			boost::shared_lock<boost::shared_mutex> lock(object_factories_mutex_);
-			auto template_iter = object_templates_.find(template_name);
-			if (template_iter == object_templates_.end())
-			{
-				return nullptr;	
-			}
-			created_object = bp::call<std::shared_ptr<Object>>(template_iter->second.ptr(), boost::python::ptr(kernel_));
+			created_object = prototype_iter->second->Clone();
 		}
 	}
 
-	if(created_object != nullptr)
+	if (created_object == nullptr)
 	{
-		//Set the required stuff
-		created_object->SetPermissions(permission_itr->second);
-		created_object->SetEventDispatcher(kernel_->GetEventDispatcher());
-		created_object->SetDatabasePersisted(is_persisted);
-		LoadSlotsForObject(created_object);
-		LoadCollisionInfoForObject(created_object);
+		bool cache_prototype = false;
 
-		//Set the ID based on the inputs
-		if(is_persisted)
+		// Call python To get Object
 		{
-			created_object->SetObjectId(next_persistent_id_++);
+			swganh::scripting::ScopedGilLock lock;
+			{
+				boost::shared_lock<boost::shared_mutex> lock(object_factories_mutex_);
+				auto template_iter = object_templates_.find(template_name);
+				if (template_iter == object_templates_.end())
+				{
+					return nullptr;	
+				}
+				created_object = bp::call<std::shared_ptr<Object>>(template_iter->second.ptr(), boost::python::ptr(kernel_));
+				cache_prototype = bp::extract<bool>(bp::getattr(template_iter->second, "cache_prototype", bp::object(false)));
+			}
 		}
-		else if(object_id == 0)
+
+		if (created_object == nullptr)
 		{
-			created_object->SetObjectId(next_dynamic_id_++);
+			return nullptr;
 		}
-		else 
+
+		LoadSlotsForObject(created_object);
+		LoadCollisionInfoForObject(created_object);
+
+		// Only templates that build the same object every time opt in. Templates
+		// that already populated contents would hand the same child ids to every
+		// clone, those keep going through python.
+		bool has_contents = false;
+		created_object->ViewObjects(nullptr, 1, false, [&] (std::shared_ptr<Object>) {
+			has_contents = true;
+		});
+
+		if (cache_prototype && !has_contents)
 		{
-			created_object->SetObjectId(object_id);
+			// Only cache types that know how to clone themselves, otherwise the
+			// clone would come back as a plain Object.
+			auto prototype = created_object->Clone();
+			if (prototype->GetType() == created_object->GetType())
+			{
+				boost::lock_guard<boost::shared_mutex> lock(prototypes_mutex_);
+				if (uncached_templates_.find(template_name) == uncached_templates_.end())
+				{
+					prototypes_.insert(PrototypeMap::value_type(template_name, prototype));
+				}
+			}
 		}
+	}
+
+	//Set the required stuff
+	created_object->SetPermissions(permission_itr->second);
+	created_object->SetEventDispatcher(kernel_->GetEventDispatcher());
+	created_object->SetDatabasePersisted(is_persisted);
 
-		//Insert it into the object map
-		InsertObject(created_object);
+	//Set the ID based on the inputs
+	if(is_persisted)
+	{
+		created_object->SetObjectId(next_persistent_id_++);
+	}
+	else if(object_id == 0)
+	{
+		created_object->SetObjectId(next_dynamic_id_++);
+	}
+	else 
+	{
+		created_object->SetObjectId(object_id);
 	}
+
+	//Insert it into the object map
+	InsertObject(created_object);
 	return created_object;
 }
 
+void ObjectManager::DisablePrototypeCaching(const string& template_name)
+{
+	boost::lock_guard<boost::shared_mutex> lock(prototypes_mutex_);
+	uncached_templates_.insert(template_name);
+	prototypes_.erase(template_name);
+}
+
 void ObjectManager::DeleteObjectFromStorage(const std::shared_ptr<Object>& object)
 {
 	std::shared_ptr<ObjectFactoryInterface> factory;
@@ -418,9 +937,12 @@ void ObjectManager::LoadCollisionInfoForObject(std::shared_ptr<Object> obj)
 		auto obj_visitor = kernel_->GetResourceManager()->GetResourceByName<ObjectVisitor>(obj->GetTemplate());
 		obj_visitor->load_aggregate_data(kernel_->GetResourceManager());
 
-		if(obj_visitor->has_attribute("collisionLength") && obj_visitor->has_attribute("collisionHeight"))
+		static const uint32_t collision_length = ObjectVisitor::AttributeId("collisionLength");
+		static const uint32_t collision_height = ObjectVisitor::AttributeId("collisionHeight");
+
+		if(obj_visitor->has_attribute(collision_length) && obj_visitor->has_attribute(collision_height))
 		{
-			obj->SetCollisionBoxSize(obj_visitor->attribute<float>("collisionLength") / 2.0f, obj_visitor->attribute<float>("collisionLength") / 2.0f);
+			obj->SetCollisionBoxSize(obj_visitor->attribute<float>(collision_length) / 2.0f, obj_visitor->attribute<float>(collision_length) / 2.0f);
 			obj->SetCollidable(true);
 		}
 		else
@@ -435,19 +957,26 @@ void ObjectManager::LoadSlotsForObject(std::shared_ptr<Object> object)
 
 	oiff->load_aggregate_data(kernel_->GetResourceManager());
 
-	if(oiff->has_attribute("arrangementDescriptorFilename") &&
-		oiff->has_attribute("slotDescriptorFilename"))
+	static const uint32_t arrangement_descriptor = ObjectVisitor::AttributeId("arrangementDescriptorFilename");
+	static const uint32_t slot_descriptor = ObjectVisitor::AttributeId("slotDescriptorFilename");
+
+	if(oiff->has_attribute(arrangement_descriptor) &&
+		oiff->has_attribute(slot_descriptor))
 	{
 		auto arrangmentDescriptor = kernel_->GetResourceManager()->GetResourceByName<SlotArrangementVisitor>(
-			oiff->attribute<std::string>("arrangementDescriptorFilename"));
+			oiff->attribute<std::string>(arrangement_descriptor));
 
 		auto slotDescriptor = kernel_->GetResourceManager()->GetResourceByName<SlotDescriptorVisitor>(
-			oiff->attribute<std::string>("slotDescriptorFilename"));
+			oiff->attribute<std::string>(slot_descriptor));
 
 		ObjectArrangements arrangements;
 		
-		// arrangements
-		if (arrangmentDescriptor != nullptr)
+		// arrangements, only resolved once per template
+		if (object->GetTemplateInfo()->HasSlotArrangements())
+		{
+			arrangements = object->GetTemplateInfo()->GetSlotArrangements();
+		}
+		else if (arrangmentDescriptor != nullptr)
 		{
 			for_each(arrangmentDescriptor->begin(), arrangmentDescriptor->end(), [&](std::vector<std::string> arrangement)
 			{			
@@ -491,8 +1020,7 @@ PermissionsObjectMap& ObjectManager::GetPermissionsMap()
 
 void ObjectManager::PrepareToAccomodate(uint32_t delta)
 {
-	boost::lock_guard<boost::shared_mutex> lg(object_map_mutex_);
-	object_map_.reserve(object_map_.size() + delta);
+	object_registry_.Reserve(delta);
 }
 
 void ObjectManager::LoadPythonObjectTemplates()
@@ -11,6 +11,7 @@
 #include <memory>
 #include <string>
 #include <queue>
+#include <set>
 
 #include <boost/thread/shared_mutex.hpp>
 #include <boost/asio/deadline_timer.hpp>
@@ -28,6 +29,7 @@ namespace concurrency {
     using ::tbb::concurrent_queue;
 }
 #endif
+#include "swganh/thread_pool.h"
 #include "swganh/app/swganh_kernel.h"
 #include "swganh/tre/visitors/slots/slot_definition_visitor.h"
 
@@ -35,6 +37,9 @@ namespace concurrency {
 #include "swganh_core/object/exception.h"
 #include "swganh_core/object/object_factory_interface.h"
 #include "swganh_core/object/object_message_builder.h"
+#include "swganh_core/object/object_journal.h"
+#include "swganh_core/object/object_registry.h"
+#include "swganh_core/object/persistence_pipeline.h"
 #include "swganh_core/object/permissions/permission_type.h"
 
 namespace swganh {
@@ -271,8 +276,34 @@ namespace object {
 
 		virtual void PrepareToAccomodate(uint32_t delta);
 
+		/**
+		 * Stops CreateObjectFromTemplate from reusing a cached prototype for the given
+		 * template, every request will go through the python template instead. Only
+		 * templates that define cache_prototype = True in their module are cached.
+		 *
+		 * @param template_name The template to always build through python.
+		 */
+		void DisablePrototypeCaching(const std::string& template_name);
+
+		/**
+		 * @return The write-behind pipeline the factories hand changed objects to.
+		 */
+		PersistencePipeline* GetPersistencePipeline() { return persistence_pipeline_.get(); }
+
+		/**
+		 * @return The local journal changed objects are written to, null if the
+		 *      journal is disabled.
+		 */
+		ObjectJournal* GetObjectJournal() { return object_journal_.get(); }
+
     private:
 		void PersistObjectsByTimer(const boost::system::error_code& e);
+		void JournalObjectsByTimer(const boost::system::error_code& e);
+		/**
+		 * Marks the changes in rows that could not be written as changed again on
+		 * the objects that are still loaded, so the next round retries them.
+		 */
+		void RequeueFailedRows_(const std::vector<ObjectSnapshot>& rows);
 		void InsertObject(std::shared_ptr<swganh::object::Object> object);
 		
 		typedef std::map<
@@ -286,6 +317,7 @@ namespace object {
         > ObjectMessageBuilderMap;
 
 		typedef std::map<std::string, boost::python::object> PythonTemplateMap;
+		typedef std::map<std::string, std::shared_ptr<Object>> PrototypeMap;
 
         /**
          * Registers a message builder for a specific object type
@@ -321,13 +353,25 @@ namespace object {
         
 		PythonTemplateMap object_templates_;
 
+		// Fully initialized template instances (slots and collision info loaded),
+		// new objects are cloned from these instead of calling into python.
+		PrototypeMap prototypes_;
+		std::set<std::string> uncached_templates_;
+		boost::shared_mutex prototypes_mutex_;
+
 		uint64_t next_dynamic_id_;
 		uint64_t next_persistent_id_;
 
-        boost::shared_mutex object_map_mutex_;
 		boost::shared_mutex object_factories_mutex_;
-		std::unordered_map<uint64_t, std::shared_ptr<Object>> object_map_;
+		ObjectRegistry object_registry_;
 		std::shared_ptr<boost::asio::deadline_timer> persist_timer_;
+		// declared after the factories so it is drained while they are still alive
+		std::unique_ptr<PersistencePipeline> persistence_pipeline_;
+		// declared after the pipeline so it stops compacting before the pipeline goes
+		std::unique_ptr<ObjectJournal> object_journal_;
+		std::shared_ptr<boost::asio::deadline_timer> journal_timer_;
+		// declared last so that it stops collecting before anything it uses goes
+		std::unique_ptr<swganh::ThreadPool> persist_scheduler_;
 		
 
 		PermissionsObjectMap permissions_objects_;
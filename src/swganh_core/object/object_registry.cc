@@ -0,0 +1,278 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "object_registry.h"
+
+#include <algorithm>
+#include <cwctype>
+#include <functional>
+
+#include "swganh_core/object/object.h"
+
+using namespace std;
+using namespace swganh::object;
+
+namespace {
+
+	void AddId(std::unordered_map<std::wstring, std::vector<uint64_t>>& index, const std::wstring& key, uint64_t object_id)
+	{
+		auto& ids = index[key];
+		if (std::find(ids.begin(), ids.end(), object_id) == ids.end())
+		{
+			ids.push_back(object_id);
+		}
+	}
+
+	void RemoveId(std::unordered_map<std::wstring, std::vector<uint64_t>>& index, const std::wstring& key, uint64_t object_id)
+	{
+		auto find_iter = index.find(key);
+		if (find_iter == index.end())
+		{
+			return;
+		}
+
+		auto& ids = find_iter->second;
+		ids.erase(std::remove(ids.begin(), ids.end(), object_id), ids.end());
+		if (ids.empty())
+		{
+			index.erase(find_iter);
+		}
+	}
+
+	std::wstring FirstName(const std::wstring& folded_name)
+	{
+		return folded_name.substr(0, folded_name.find(L" "));
+	}
+
+}
+
+ObjectRegistry::ObjectRegistry(uint32_t shard_count)
+{
+	uint32_t count = 1;
+	while (count < shard_count)
+	{
+		count <<= 1;
+	}
+
+	shard_mask_ = count - 1;
+	object_shards_.reset(new ObjectShard[count]);
+	name_shards_.reset(new NameShard[count]);
+}
+
+bool ObjectRegistry::Insert(const shared_ptr<Object>& object)
+{
+	uint64_t object_id = object->GetObjectId();
+	auto folded_name = FoldName(object->GetCustomName());
+
+	auto& shard = GetObjectShard(object_id);
+	boost::lock_guard<boost::shared_mutex> lock(shard.mutex);
+
+	if (!shard.objects.insert(make_pair(object_id, object)).second)
+	{
+		return false;
+	}
+
+	if (!folded_name.empty())
+	{
+		IndexName_(object_id, folded_name);
+		shard.indexed_names[object_id] = move(folded_name);
+	}
+
+	return true;
+}
+
+shared_ptr<Object> ObjectRegistry::Remove(uint64_t object_id)
+{
+	auto& shard = GetObjectShard(object_id);
+	boost::lock_guard<boost::shared_mutex> lock(shard.mutex);
+
+	auto find_iter = shard.objects.find(object_id);
+	if (find_iter == shard.objects.end())
+	{
+		return nullptr;
+	}
+
+	auto object = find_iter->second;
+	shard.objects.erase(find_iter);
+
+	auto name_iter = shard.indexed_names.find(object_id);
+	if (name_iter != shard.indexed_names.end())
+	{
+		UnindexName_(object_id, name_iter->second);
+		shard.indexed_names.erase(name_iter);
+	}
+
+	return object;
+}
+
+shared_ptr<Object> ObjectRegistry::Find(uint64_t object_id) const
+{
+	auto& shard = GetObjectShard(object_id);
+	boost::shared_lock<boost::shared_mutex> lock(shard.mutex);
+
+	auto find_iter = shard.objects.find(object_id);
+	if (find_iter == shard.objects.end())
+	{
+		return nullptr;
+	}
+
+	return find_iter->second;
+}
+
+shared_ptr<Object> ObjectRegistry::FindByCustomName(const wstring& custom_name) const
+{
+	auto folded_name = FoldName(custom_name);
+	if (folded_name.empty())
+	{
+		return nullptr;
+	}
+
+	// Copy the candidate ids out so the name shard is not held while the
+	// object shards are locked.
+	vector<uint64_t> full_matches, first_matches;
+	{
+		auto& name_shard = GetNameShard(folded_name);
+		boost::shared_lock<boost::shared_mutex> lock(name_shard.mutex);
+
+		auto full_iter = name_shard.full_names.find(folded_name);
+		if (full_iter != name_shard.full_names.end())
+		{
+			full_matches = full_iter->second;
+		}
+
+		// Only first names are unique, if a complete match fails then
+		// attempt to match the first name only.
+		auto first_iter = name_shard.first_names.find(folded_name);
+		if (first_iter != name_shard.first_names.end())
+		{
+			first_matches = first_iter->second;
+		}
+	}
+
+	for (auto object_id : full_matches)
+	{
+		if (auto object = Find(object_id))
+		{
+			return object;
+		}
+	}
+
+	for (auto object_id : first_matches)
+	{
+		if (auto object = Find(object_id))
+		{
+			return object;
+		}
+	}
+
+	return nullptr;
+}
+
+void ObjectRegistry::UpdateCustomName(const shared_ptr<Object>& object)
+{
+	uint64_t object_id = object->GetObjectId();
+	auto folded_name = FoldName(object->GetCustomName());
+
+	auto& shard = GetObjectShard(object_id);
+	boost::lock_guard<boost::shared_mutex> lock(shard.mutex);
+
+	// Only registered objects are indexed.
+	auto find_iter = shard.objects.find(object_id);
+	if (find_iter == shard.objects.end() || find_iter->second != object)
+	{
+		return;
+	}
+
+	auto name_iter = shard.indexed_names.find(object_id);
+	if (name_iter != shard.indexed_names.end())
+	{
+		if (name_iter->second == folded_name)
+		{
+			return;
+		}
+
+		UnindexName_(object_id, name_iter->second);
+		shard.indexed_names.erase(name_iter);
+	}
+
+	if (!folded_name.empty())
+	{
+		IndexName_(object_id, folded_name);
+		shard.indexed_names[object_id] = move(folded_name);
+	}
+}
+
+void ObjectRegistry::Reserve(size_t delta)
+{
+	size_t per_shard = delta / (shard_mask_ + 1) + 1;
+	for (uint32_t i = 0; i <= shard_mask_; ++i)
+	{
+		auto& shard = object_shards_[i];
+		boost::lock_guard<boost::shared_mutex> lock(shard.mutex);
+		shard.objects.reserve(shard.objects.size() + per_shard);
+	}
+}
+
+size_t ObjectRegistry::Size() const
+{
+	size_t size = 0;
+	for (uint32_t i = 0; i <= shard_mask_; ++i)
+	{
+		auto& shard = object_shards_[i];
+		boost::shared_lock<boost::shared_mutex> lock(shard.mutex);
+		size += shard.objects.size();
+	}
+	return size;
+}
+
+wstring ObjectRegistry::FoldName(wstring name)
+{
+	// Names are case insensitive, normalize by converting to lowercase
+	std::transform(std::begin(name), std::end(name), std::begin(name), ::towlower);
+	return name;
+}
+
+ObjectRegistry::ObjectShard& ObjectRegistry::GetObjectShard(uint64_t object_id) const
+{
+	// ids are handed out sequentially so the low bits spread evenly
+	return object_shards_[static_cast<uint32_t>(object_id) & shard_mask_];
+}
+
+ObjectRegistry::NameShard& ObjectRegistry::GetNameShard(const wstring& folded_name) const
+{
+	return name_shards_[std::hash<wstring>()(folded_name) & shard_mask_];
+}
+
+void ObjectRegistry::IndexName_(uint64_t object_id, const wstring& folded_name)
+{
+	{
+		auto& name_shard = GetNameShard(folded_name);
+		boost::lock_guard<boost::shared_mutex> lock(name_shard.mutex);
+		AddId(name_shard.full_names, folded_name, object_id);
+	}
+
+	auto first_name = FirstName(folded_name);
+	if (first_name != folded_name)
+	{
+		auto& name_shard = GetNameShard(first_name);
+		boost::lock_guard<boost::shared_mutex> lock(name_shard.mutex);
+		AddId(name_shard.first_names, first_name, object_id);
+	}
+}
+
+void ObjectRegistry::UnindexName_(uint64_t object_id, const wstring& folded_name)
+{
+	{
+		auto& name_shard = GetNameShard(folded_name);
+		boost::lock_guard<boost::shared_mutex> lock(name_shard.mutex);
+		RemoveId(name_shard.full_names, folded_name, object_id);
+	}
+
+	auto first_name = FirstName(folded_name);
+	if (first_name != folded_name)
+	{
+		auto& name_shard = GetNameShard(first_name);
+		boost::lock_guard<boost::shared_mutex> lock(name_shard.mutex);
+		RemoveId(name_shard.first_names, first_name, object_id);
+	}
+}
@@ -0,0 +1,115 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#ifndef SWGANH_OBJECT_OBJECT_REGISTRY_H_
+#define SWGANH_OBJECT_OBJECT_REGISTRY_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
+namespace swganh {
+namespace object {
+
+	class Object;
+
+	/**
+	 * Concurrent id -> object map used by the ObjectManager.
+	 *
+	 * Objects are spread over a fixed number of lock-striped shards so lookups
+	 * from different services rarely contend on the same mutex. A second set of
+	 * shards indexes the case folded custom name (full name and first name) of
+	 * each registered object so lookups by name do not scan every object.
+	 */
+	class ObjectRegistry : private boost::noncopyable
+	{
+	public:
+		/**
+		 * @param shard_count Number of lock stripes, rounded up to a power of two.
+		 */
+		explicit ObjectRegistry(uint32_t shard_count = 64);
+
+		/**
+		 * Registers an object, indexing its current custom name.
+		 *
+		 * @return False if an object with the same id is already registered.
+		 */
+		bool Insert(const std::shared_ptr<Object>& object);
+
+		/**
+		 * Unregisters an object and drops it from the name index.
+		 *
+		 * @return The removed object, or nullptr if the id was not registered.
+		 */
+		std::shared_ptr<Object> Remove(uint64_t object_id);
+
+		/**
+		 * @return The registered object with the given id, or nullptr.
+		 */
+		std::shared_ptr<Object> Find(uint64_t object_id) const;
+
+		/**
+		 * Finds an object by its custom name. A full name match is preferred,
+		 * otherwise the first name alone is matched. Names are case insensitive.
+		 *
+		 * @return The registered object with the given name, or nullptr.
+		 */
+		std::shared_ptr<Object> FindByCustomName(const std::wstring& custom_name) const;
+
+		/**
+		 * Re-indexes a registered object after its custom name changed.
+		 */
+		void UpdateCustomName(const std::shared_ptr<Object>& object);
+
+		/**
+		 * Pre-allocates room for a number of additional objects.
+		 */
+		void Reserve(size_t delta);
+
+		/**
+		 * @return The number of registered objects.
+		 */
+		size_t Size() const;
+
+		/**
+		 * Folds a name to the form used as the name index key.
+		 */
+		static std::wstring FoldName(std::wstring name);
+
+	private:
+		typedef std::unordered_map<std::wstring, std::vector<uint64_t>> NameIndex;
+
+		struct ObjectShard
+		{
+			mutable boost::shared_mutex mutex;
+			std::unordered_map<uint64_t, std::shared_ptr<Object>> objects;
+			std::unordered_map<uint64_t, std::wstring> indexed_names;
+		};
+
+		struct NameShard
+		{
+			mutable boost::shared_mutex mutex;
+			NameIndex full_names;
+			NameIndex first_names;
+		};
+
+		ObjectShard& GetObjectShard(uint64_t object_id) const;
+		NameShard& GetNameShard(const std::wstring& folded_name) const;
+
+		// must be called with the owning object shard lock held
+		void IndexName_(uint64_t object_id, const std::wstring& folded_name);
+		void UnindexName_(uint64_t object_id, const std::wstring& folded_name);
+
+		uint32_t shard_mask_;
+		std::unique_ptr<ObjectShard[]> object_shards_;
+		std::unique_ptr<NameShard[]> name_shards_;
+	};
+
+}}  // namespace swganh::object
+
+#endif  // SWGANH_OBJECT_OBJECT_REGISTRY_H_
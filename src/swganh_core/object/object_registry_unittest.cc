@@ -0,0 +1,76 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <boost/test/unit_test.hpp>
+
+#include "swganh_core/object/object.h"
+#include "swganh_core/object/object_registry.h"
+
+using namespace swganh::object;
+
+namespace {
+	std::shared_ptr<Object> MakeObject(uint64_t object_id, const std::wstring& custom_name)
+	{
+		auto object = std::make_shared<Object>();
+		object->SetObjectId(object_id);
+		object->SetCustomName(custom_name);
+		return object;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(ObjectRegistryTest)
+
+/// This test shows that registered objects can be found and removed by id.
+BOOST_AUTO_TEST_CASE(CanFindAndRemoveById) {
+	ObjectRegistry registry(4);
+	auto object = MakeObject(10, L"");
+
+	BOOST_CHECK(registry.Insert(object));
+	BOOST_CHECK(!registry.Insert(object));
+	BOOST_CHECK(registry.Find(10) == object);
+	BOOST_CHECK_EQUAL(1u, registry.Size());
+
+	BOOST_CHECK(registry.Remove(10) == object);
+	BOOST_CHECK(registry.Find(10) == nullptr);
+	BOOST_CHECK(registry.Remove(10) == nullptr);
+}
+
+/// This test shows that names are matched case insensitively by full name or first name.
+BOOST_AUTO_TEST_CASE(CanFindByFullOrFirstName) {
+	ObjectRegistry registry;
+	auto object = MakeObject(1, L"Han Solo");
+	registry.Insert(object);
+
+	BOOST_CHECK(registry.FindByCustomName(L"han solo") == object);
+	BOOST_CHECK(registry.FindByCustomName(L"HAN") == object);
+	BOOST_CHECK(registry.FindByCustomName(L"solo") == nullptr);
+}
+
+/// This test shows that an exact full name match is preferred over a first name match.
+BOOST_AUTO_TEST_CASE(FullNameMatchIsPreferred) {
+	ObjectRegistry registry;
+	auto han_solo = MakeObject(1, L"Han Solo");
+	auto han = MakeObject(2, L"Han");
+	registry.Insert(han_solo);
+	registry.Insert(han);
+
+	BOOST_CHECK(registry.FindByCustomName(L"han") == han);
+
+	registry.Remove(2);
+	BOOST_CHECK(registry.FindByCustomName(L"han") == han_solo);
+}
+
+/// This test shows that the name index follows renames of registered objects.
+BOOST_AUTO_TEST_CASE(RenamesUpdateTheNameIndex) {
+	ObjectRegistry registry;
+	auto object = MakeObject(1, L"Han Solo");
+	registry.Insert(object);
+
+	object->SetCustomName(L"Luke Skywalker");
+	registry.UpdateCustomName(object);
+
+	BOOST_CHECK(registry.FindByCustomName(L"han") == nullptr);
+	BOOST_CHECK(registry.FindByCustomName(L"luke") == object);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
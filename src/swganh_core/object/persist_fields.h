@@ -0,0 +1,36 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#ifndef SWGANH_OBJECT_PERSIST_FIELDS_H_
+#define SWGANH_OBJECT_PERSIST_FIELDS_H_
+
+#include <cstdint>
+
+namespace swganh {
+namespace object {
+
+	/**
+	 * Groups of columns of the object table that have changed since an object was
+	 * last persisted. The bits are in the column order of the object table.
+	 */
+	enum PersistField : uint32_t
+	{
+		PERSIST_SCENE       = 1 << 0,   // scene_id
+		PERSIST_CONTAINER   = 1 << 1,   // parent_id
+		PERSIST_TEMPLATE    = 1 << 2,   // iff_template_id
+		PERSIST_POSITION    = 1 << 3,   // x/y/z_position
+		PERSIST_ORIENTATION = 1 << 4,   // x/y/z/w_orientation
+		PERSIST_COMPLEXITY  = 1 << 5,
+		PERSIST_STF_NAME    = 1 << 6,   // stf_name_file, stf_name_string
+		PERSIST_CUSTOM_NAME = 1 << 7,
+		PERSIST_VOLUME      = 1 << 8,
+		PERSIST_ARRANGEMENT = 1 << 9,
+
+		// Objects that were never written have every field set, they are written
+		// with a full upsert that also covers permission_type and type_id.
+		PERSIST_ALL_FIELDS  = (1 << 10) - 1
+	};
+
+}}  // namespace swganh::object
+
+#endif  // SWGANH_OBJECT_PERSIST_FIELDS_H_
@@ -0,0 +1,487 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "persistence_pipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <sstream>
+#include <unordered_map>
+
+#include "swganh/logger.h"
+
+using namespace std;
+using namespace swganh::object;
+
+PersistencePipeline::PersistencePipeline(BatchWriter writer, uint32_t worker_count, size_t batch_size, size_t max_queue_depth,
+	double max_items_per_second)
+	: writer_(move(writer))
+	, batch_size_(batch_size > 0 ? batch_size : 1)
+	, max_queue_depth_(max_queue_depth > 0 ? max_queue_depth : 1)
+	, queued_(0)
+	, in_flight_(0)
+	, stopping_(false)
+	, max_items_per_second_(max_items_per_second)
+	// a tenth of a second worth of writes may go out at once
+	, burst_(max(1.0, max_items_per_second / 10))
+	, tokens_(burst_)
+	, last_refill_(chrono::steady_clock::now())
+	, rows_written_(0)
+	, tasks_run_(0)
+	, batches_written_(0)
+	, bytes_written_(0)
+	, errors_(0)
+	, active_seconds_(0)
+	, last_flush_latency_ms_(0)
+	, last_flush_rows_(0)
+	, last_flush_bytes_(0)
+	, throttled_seconds_(0)
+{
+	uint32_t count = (worker_count > 0) ? worker_count : 1;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		workers_.emplace_back([this] () { Run_(); });
+	}
+}
+
+PersistencePipeline::~PersistencePipeline()
+{
+	Stop();
+}
+
+void PersistencePipeline::Enqueue(ObjectSnapshot row, uint32_t level)
+{
+	{
+		unique_lock<mutex> lock(mutex_);
+		space_available_.wait(lock, [this] () { return HasRoom_(); });
+
+		if (stopping_)
+		{
+			LOG(warning) << "Persistence pipeline is stopped, dropping object " << row.object_id;
+			return;
+		}
+
+		levels_[RowLevel_(level)].rows.push_back(move(row));
+		++queued_;
+	}
+
+	work_available_.notify_one();
+}
+
+void PersistencePipeline::EnqueueTask(Task task, uint32_t level, uint64_t key)
+{
+	{
+		unique_lock<mutex> lock(mutex_);
+		space_available_.wait(lock, [this] () { return HasRoom_(); });
+
+		if (stopping_)
+		{
+			LOG(warning) << "Persistence pipeline is stopped, dropping write task";
+			return;
+		}
+
+		KeyedTask keyed_task = { key, move(task) };
+		levels_[TaskLevel_(level)].tasks.push_back(move(keyed_task));
+		++queued_;
+	}
+
+	work_available_.notify_one();
+}
+
+void PersistencePipeline::Flush()
+{
+	unique_lock<mutex> lock(mutex_);
+	drained_.wait(lock, [this] () { return QueueDepth_() == 0 && in_flight_ == 0; });
+}
+
+void PersistencePipeline::Stop()
+{
+	{
+		lock_guard<mutex> lock(mutex_);
+		if (stopping_)
+		{
+			return;
+		}
+		stopping_ = true;
+	}
+
+	work_available_.notify_all();
+	space_available_.notify_all();
+
+	for (auto& worker : workers_)
+	{
+		worker.join();
+	}
+	workers_.clear();
+}
+
+PersistenceStatistics PersistencePipeline::GetStatistics() const
+{
+	lock_guard<mutex> lock(mutex_);
+
+	PersistenceStatistics statistics;
+	statistics.queue_depth = QueueDepth_();
+	statistics.rows_written = rows_written_;
+	statistics.tasks_run = tasks_run_;
+	statistics.batches_written = batches_written_;
+	statistics.bytes_written = bytes_written_;
+	statistics.errors = errors_;
+	double active_seconds = active_seconds_;
+	if (in_flight_ > 0)
+	{
+		active_seconds += chrono::duration<double>(chrono::steady_clock::now() - active_since_).count();
+	}
+	statistics.rows_per_second = (active_seconds > 0) ? rows_written_ / active_seconds : 0;
+	statistics.last_flush_latency_ms = last_flush_latency_ms_;
+	statistics.last_flush_rows = last_flush_rows_;
+	statistics.last_flush_bytes = last_flush_bytes_;
+
+	lock_guard<mutex> rate_lock(rate_mutex_);
+	statistics.throttled_ms = static_cast<uint64_t>(throttled_seconds_ * 1000.0);
+
+	return statistics;
+}
+
+string PersistencePipeline::BuildObjectUpsert(size_t rows)
+{
+	stringstream sql;
+	sql << "INSERT INTO object (id, scene_id, parent_id, iff_template_id, x_position, y_position, z_position, "
+		"x_orientation, y_orientation, z_orientation, w_orientation, complexity, stf_name_file, stf_name_string, "
+		"custom_name, volume, arrangement_id, permission_type, type_id, created_at, updated_at) VALUES ";
+
+	for (size_t i = 0; i < rows; ++i)
+	{
+		if (i != 0)
+		{
+			sql << ",";
+		}
+		sql << "(?,?,?,(SELECT id FROM swganh_static.iff_templates WHERE iff_template = ? LIMIT 1),"
+			"?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,NOW(),NOW())";
+	}
+
+	sql << " ON DUPLICATE KEY UPDATE scene_id = VALUES(scene_id), parent_id = VALUES(parent_id), "
+		"iff_template_id = VALUES(iff_template_id), x_position = VALUES(x_position), y_position = VALUES(y_position), "
+		"z_position = VALUES(z_position), x_orientation = VALUES(x_orientation), y_orientation = VALUES(y_orientation), "
+		"z_orientation = VALUES(z_orientation), w_orientation = VALUES(w_orientation), complexity = VALUES(complexity), "
+		"stf_name_file = VALUES(stf_name_file), stf_name_string = VALUES(stf_name_string), custom_name = VALUES(custom_name), "
+		"volume = VALUES(volume), arrangement_id = VALUES(arrangement_id), permission_type = VALUES(permission_type), "
+		"type_id = VALUES(type_id), updated_at = NOW();";
+
+	return sql.str();
+}
+
+string PersistencePipeline::BuildObjectUpdate(uint32_t changed_fields)
+{
+	// in PersistField bit order
+	static const char* columns[] = {
+		"scene_id = ?",
+		"parent_id = ?",
+		"iff_template_id = (SELECT id FROM swganh_static.iff_templates WHERE iff_template = ? LIMIT 1)",
+		"x_position = ?, y_position = ?, z_position = ?",
+		"x_orientation = ?, y_orientation = ?, z_orientation = ?, w_orientation = ?",
+		"complexity = ?",
+		"stf_name_file = ?, stf_name_string = ?",
+		"custom_name = ?",
+		"volume = ?",
+		"arrangement_id = ?"
+	};
+
+	stringstream sql;
+	sql << "UPDATE object SET ";
+	for (uint32_t i = 0; i < sizeof(columns) / sizeof(columns[0]); ++i)
+	{
+		if (changed_fields & (1 << i))
+		{
+			sql << columns[i] << ", ";
+		}
+	}
+	sql << "updated_at = NOW() WHERE id = ?;";
+
+	return sql.str();
+}
+
+size_t PersistencePipeline::EstimateRowBytes(const ObjectSnapshot& row)
+{
+	size_t bytes = sizeof(row.object_id);
+	uint32_t fields = row.changed_fields;
+
+	if (fields & PERSIST_SCENE) bytes += sizeof(row.scene_id);
+	if (fields & PERSIST_CONTAINER) bytes += sizeof(row.parent_id);
+	if (fields & PERSIST_TEMPLATE) bytes += row.iff_template.size();
+	if (fields & PERSIST_POSITION) bytes += 3 * sizeof(double);
+	if (fields & PERSIST_ORIENTATION) bytes += 4 * sizeof(double);
+	if (fields & PERSIST_COMPLEXITY) bytes += sizeof(row.complexity);
+	if (fields & PERSIST_STF_NAME) bytes += row.stf_name_file.size() + row.stf_name_string.size();
+	if (fields & PERSIST_CUSTOM_NAME) bytes += row.custom_name.size();
+	if (fields & PERSIST_VOLUME) bytes += sizeof(row.volume);
+	if (fields & PERSIST_ARRANGEMENT) bytes += sizeof(row.arrangement_id);
+	if (fields == PERSIST_ALL_FIELDS) bytes += sizeof(row.permission_type) + sizeof(row.type_id);
+
+	for (auto& attribute : row.attributes)
+	{
+		bytes += sizeof(row.object_id) + attribute.first.size() + attribute.second.size();
+	}
+
+	return bytes;
+}
+
+string PersistencePipeline::BuildAttributeUpsert(size_t rows)
+{
+	stringstream sql;
+	sql << "INSERT INTO object_attributes (object_id, attribute_id, attribute_value) "
+		"SELECT v.object_id, a.id, v.attribute_value FROM (";
+
+	for (size_t i = 0; i < rows; ++i)
+	{
+		if (i == 0)
+		{
+			sql << "SELECT ? AS object_id, ? AS name, ? AS attribute_value";
+		}
+		else
+		{
+			sql << " UNION ALL SELECT ?,?,?";
+		}
+	}
+
+	// Joined rather than looked up per row, an unknown name inserts nothing
+	// instead of a row with a NULL attribute_id that the unique key lets through.
+	sql << ") AS v JOIN swganh_static.attributes a ON a.name = v.name"
+		" ON DUPLICATE KEY UPDATE attribute_value = VALUES(attribute_value);";
+
+	return sql.str();
+}
+
+vector<uint32_t> PersistencePipeline::ContainmentLevels(const vector<ObjectSnapshot>& rows)
+{
+	unordered_map<uint64_t, size_t> positions;
+	for (size_t i = 0; i < rows.size(); ++i)
+	{
+		positions.insert(make_pair(rows[i].object_id, i));
+	}
+
+	vector<uint32_t> levels(rows.size(), 0);
+	for (size_t i = 0; i < rows.size(); ++i)
+	{
+		// Walk up through the containers that are part of this batch, the step
+		// limit guards against cycles in damaged data.
+		size_t current = i;
+		uint32_t level = 0;
+		while (level < rows.size() && (rows[current].changed_fields & PERSIST_CONTAINER))
+		{
+			auto find_itr = positions.find(rows[current].parent_id);
+			if (find_itr == positions.end() || find_itr->second == current)
+			{
+				break;
+			}
+			current = find_itr->second;
+			++level;
+		}
+		levels[i] = level;
+	}
+
+	return levels;
+}
+
+bool PersistencePipeline::HasRoom_() const
+{
+	return stopping_ || QueueDepth_() < max_queue_depth_;
+}
+
+bool PersistencePipeline::Runnable_() const
+{
+	if (levels_.empty())
+	{
+		return false;
+	}
+	if (!in_flight_levels_.empty() && in_flight_levels_.begin()->first < levels_.begin()->first)
+	{
+		return false;
+	}
+
+	auto& pending = levels_.begin()->second;
+	return !pending.rows.empty() || NextTask_(pending) < pending.tasks.size();
+}
+
+size_t PersistencePipeline::NextTask_(const PendingLevel& pending) const
+{
+	// A task skipped for its key keeps every later task of that key waiting too,
+	// the key stays busy until the task ahead of them is done.
+	size_t position = 0;
+	for (auto& keyed_task : pending.tasks)
+	{
+		if (keyed_task.key == 0 || busy_keys_.count(keyed_task.key) == 0)
+		{
+			break;
+		}
+		++position;
+	}
+	return position;
+}
+
+void PersistencePipeline::AcquireTokens_(size_t count)
+{
+	if (max_items_per_second_ <= 0)
+	{
+		return;
+	}
+
+	double wait_seconds;
+	{
+		lock_guard<mutex> lock(rate_mutex_);
+		auto now = chrono::steady_clock::now();
+		tokens_ = min(burst_, tokens_ + chrono::duration<double>(now - last_refill_).count() * max_items_per_second_);
+		last_refill_ = now;
+
+		// The tokens are taken right away and the wait is slept off outside the
+		// lock. The debt this leaves makes the next worker wait its turn after
+		// this one. A batch larger than the burst goes once the bucket is full.
+		wait_seconds = max(0.0, (min(static_cast<double>(count), burst_) - tokens_) / max_items_per_second_);
+		tokens_ -= count;
+		throttled_seconds_ += wait_seconds;
+	}
+
+	if (wait_seconds > 0)
+	{
+		this_thread::sleep_for(chrono::duration<double>(wait_seconds));
+	}
+}
+
+void PersistencePipeline::Run_()
+{
+	while (true)
+	{
+		vector<ObjectSnapshot> batch;
+		Task task;
+		uint64_t key = 0;
+		uint32_t level;
+		size_t count;
+
+		{
+			unique_lock<mutex> lock(mutex_);
+			work_available_.wait(lock, [this] () { return (stopping_ && QueueDepth_() == 0) || Runnable_(); });
+
+			// Drain whatever is left before honoring a stop request.
+			if (QueueDepth_() == 0)
+			{
+				return;
+			}
+
+			auto level_itr = levels_.begin();
+			level = level_itr->first;
+			auto& pending = level_itr->second;
+
+			if (!pending.rows.empty())
+			{
+				count = min(batch_size_, pending.rows.size());
+				batch.reserve(count);
+				for (size_t i = 0; i < count; ++i)
+				{
+					batch.push_back(move(pending.rows.front()));
+					pending.rows.pop_front();
+				}
+			}
+			else
+			{
+				count = 1;
+				auto task_itr = pending.tasks.begin() + NextTask_(pending);
+				key = task_itr->key;
+				task = move(task_itr->task);
+				pending.tasks.erase(task_itr);
+				if (key != 0)
+				{
+					busy_keys_.insert(key);
+				}
+			}
+
+			if (pending.rows.empty() && pending.tasks.empty())
+			{
+				levels_.erase(level_itr);
+			}
+			if (in_flight_ == 0)
+			{
+				active_since_ = chrono::steady_clock::now();
+			}
+			queued_ -= count;
+			in_flight_ += count;
+			in_flight_levels_[level] += count;
+		}
+
+		space_available_.notify_all();
+		AcquireTokens_(count);
+
+		size_t batch_bytes = 0;
+		for (auto& row : batch)
+		{
+			batch_bytes += EstimateRowBytes(row);
+		}
+
+		bool failed = false;
+		auto start = chrono::steady_clock::now();
+		try
+		{
+			if (!batch.empty())
+			{
+				writer_(batch);
+			}
+			else
+			{
+				task();
+			}
+		}
+		catch (exception& e)
+		{
+			failed = true;
+			LOG(error) << "Persistence pipeline write failed: " << e.what();
+		}
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+		{
+			lock_guard<mutex> lock(mutex_);
+			in_flight_ -= count;
+			if (in_flight_ == 0)
+			{
+				active_seconds_ += chrono::duration<double>(chrono::steady_clock::now() - active_since_).count();
+			}
+			auto in_flight_itr = in_flight_levels_.find(level);
+			in_flight_itr->second -= count;
+			if (in_flight_itr->second == 0)
+			{
+				in_flight_levels_.erase(in_flight_itr);
+			}
+			if (key != 0)
+			{
+				busy_keys_.erase(key);
+			}
+
+			if (!batch.empty())
+			{
+				if (!failed)
+				{
+					rows_written_ += batch.size();
+					bytes_written_ += batch_bytes;
+					++batches_written_;
+				}
+				last_flush_latency_ms_ = seconds * 1000.0;
+				last_flush_rows_ = batch.size();
+				last_flush_bytes_ = batch_bytes;
+			}
+			else
+			{
+				if (!failed)
+				{
+					++tasks_run_;
+				}
+			}
+
+			if (failed)
+			{
+				++errors_;
+			}
+		}
+
+		drained_.notify_all();
+		// finishing a level or a keyed task may let the workers move on
+		work_available_.notify_all();
+	}
+}
@@ -0,0 +1,289 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#ifndef SWGANH_OBJECT_PERSISTENCE_PIPELINE_H_
+#define SWGANH_OBJECT_PERSISTENCE_PIPELINE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/variant.hpp>
+
+#include "swganh_core/object/persist_fields.h"
+
+namespace swganh {
+namespace object {
+
+	/**
+	 * Plain copy of the changed columns of the object table (and the changed
+	 * attributes) of one object, taken on the game thread so the write can happen
+	 * elsewhere. Columns whose PersistField bit is not set are left unfilled.
+	 */
+	struct ObjectSnapshot
+	{
+		uint32_t changed_fields;   ///< PersistField bits
+		uint64_t object_id;
+		uint32_t scene_id;
+		uint64_t parent_id;
+		std::string iff_template;
+		double x_position, y_position, z_position;
+		double x_orientation, y_orientation, z_orientation, w_orientation;
+		double complexity;
+		std::string stf_name_file;
+		std::string stf_name_string;
+		std::string custom_name;
+		uint32_t volume;
+		int32_t arrangement_id;
+		int32_t permission_type;
+		uint32_t type_id;
+
+		/// (attribute name, attribute value) pairs
+		std::vector<std::pair<std::string, std::string>> attributes;
+	};
+
+	/// A parameter of a stored procedure call, bound with the matching setter.
+	typedef boost::variant<int32_t, uint32_t, uint64_t, double, bool, std::string> ProcedureParameter;
+
+	/// How the ObjectJournal merges a call with the other calls of its object.
+	enum ProcedureCallMerge
+	{
+		MERGE_IDENTICAL = 0,   ///< only repeats with the same parameters are dropped (list entries)
+		MERGE_LATEST,          ///< replaces earlier calls of the same statement and key parameters (whole row procedures)
+		MERGE_DELETE           ///< drops every other row and call of the object
+	};
+
+	/**
+	 * Call of one of the per type persist procedures (sp_PersistTangible, ...) with
+	 * its parameter values, taken on the game thread like ObjectSnapshot so the
+	 * workers never read live objects.
+	 */
+	struct ProcedureCall
+	{
+		ProcedureCall() : object_id(0), merge(MERGE_IDENTICAL), key_parameters(0) {}
+		ProcedureCall(uint64_t object_id_, std::string statement_, ProcedureCallMerge merge_ = MERGE_IDENTICAL,
+			uint8_t key_parameters_ = 0)
+			: object_id(object_id_)
+			, statement(std::move(statement_))
+			, merge(merge_)
+			, key_parameters(key_parameters_)
+		{}
+
+		void AddInt(int32_t value) { parameters.push_back(value); }
+		void AddUInt(uint32_t value) { parameters.push_back(value); }
+		void AddUInt64(uint64_t value) { parameters.push_back(value); }
+		void AddDouble(double value) { parameters.push_back(value); }
+		void AddBoolean(bool value) { parameters.push_back(value); }
+		void AddString(std::string value) { parameters.push_back(std::move(value)); }
+
+		uint64_t object_id;
+		std::string statement;   ///< the sql, also the key of the prepared statement cache
+		ProcedureCallMerge merge;
+		uint8_t key_parameters;  ///< leading parameters that tell MERGE_LATEST calls of one statement apart (the xp type)
+		std::vector<ProcedureParameter> parameters;   ///< in placeholder order
+	};
+
+	struct PersistenceStatistics
+	{
+		uint64_t queue_depth;          ///< rows and tasks waiting to be written
+		uint64_t rows_written;         ///< object rows written since startup
+		uint64_t tasks_run;            ///< non batched writes run since startup
+		uint64_t batches_written;
+		uint64_t bytes_written;        ///< estimated size of the column values written
+		uint64_t errors;               ///< batches or tasks that failed
+		double rows_per_second;        ///< object rows written per second of wall-clock time any worker was writing
+		double last_flush_latency_ms;  ///< time taken by the most recent batch
+		uint64_t last_flush_rows;      ///< object rows in the most recent batch
+		uint64_t last_flush_bytes;     ///< estimated bytes in the most recent batch
+		uint64_t throttled_ms;         ///< time workers spent waiting on the rate limit
+	};
+
+	/**
+	 * Write-behind persistence for objects.
+	 *
+	 * Dirty objects are snapshotted on the game thread and handed off here, a set of
+	 * dedicated worker threads then writes them in batches of up to batch_size rows.
+	 * Writes that cannot be batched (the per type procedures) are queued as tasks and
+	 * run on the same workers.
+	 *
+	 * The queue is bounded, once max_queue_depth rows and tasks are waiting the
+	 * producers block until the workers catch up.
+	 *
+	 * Every row and task carries a level, the depth of its object in the containment
+	 * tree (0 for objects in the world). A worker only starts on a level once nothing
+	 * of a lower level is queued or being written, so as long as producers queue the
+	 * lower levels first a container is always stored before its contents, no matter
+	 * how many workers there are. The tasks of a level wait for its rows, so a type
+	 * table write comes after its object row. Tasks that share a key, the calls of
+	 * one object, run one at a time in the order they were queued.
+	 *
+	 * Writes can be rate limited to max_items_per_second rows and tasks, so that
+	 * persistence never takes more than its share of the database.
+	 */
+	class PersistencePipeline : private boost::noncopyable
+	{
+	public:
+		typedef std::function<void (const std::vector<ObjectSnapshot>&)> BatchWriter;
+		typedef std::function<void ()> Task;
+
+		/**
+		 * @param writer Writes one batch of rows, called on a worker thread. Throwing
+		 *      counts the batch as failed.
+		 * @param worker_count Number of dedicated writer threads.
+		 * @param batch_size Maximum number of rows handed to a single writer call.
+		 * @param max_queue_depth Number of queued rows and tasks at which producers block.
+		 * @param max_items_per_second Rows and tasks written per second at most, zero for no limit.
+		 */
+		PersistencePipeline(BatchWriter writer, uint32_t worker_count = 2, size_t batch_size = 500, size_t max_queue_depth = 50000,
+			double max_items_per_second = 0);
+		~PersistencePipeline();
+
+		/**
+		 * Queues a row for writing, blocks while the queue is full.
+		 *
+		 * @param level Containment depth of the object.
+		 */
+		void Enqueue(ObjectSnapshot row, uint32_t level = 0);
+
+		/**
+		 * Queues a write that is run on its own, blocks while the queue is full.
+		 * It runs after the rows of its level, so it may refer to them.
+		 *
+		 * @param level Containment depth of the object written.
+		 * @param key Id of the object written, its tasks never run concurrently or
+		 *      out of order. Zero for a task that may run alongside any other.
+		 */
+		void EnqueueTask(Task task, uint32_t level = 0, uint64_t key = 0);
+
+		/**
+		 * Blocks until everything queued so far has been written.
+		 */
+		void Flush();
+
+		/**
+		 * Writes out everything that is still queued and stops the workers. Called
+		 * by the destructor, rows queued after this are dropped.
+		 */
+		void Stop();
+
+		PersistenceStatistics GetStatistics() const;
+
+		/**
+		 * @return A multi-row upsert into the object table with placeholders for the
+		 *      given number of rows, in the column order of ObjectSnapshot. Used for
+		 *      rows that have every PersistField set.
+		 */
+		static std::string BuildObjectUpsert(size_t rows);
+
+		/**
+		 * @return An update of the object table that only sets the columns of the
+		 *      given PersistField bits, followed by an id placeholder.
+		 */
+		static std::string BuildObjectUpdate(uint32_t changed_fields);
+
+		/**
+		 * @return The approximate number of bytes of column data a row writes.
+		 */
+		static size_t EstimateRowBytes(const ObjectSnapshot& row);
+
+		/**
+		 * @return A multi-row upsert into object_attributes with (object_id, name, value)
+		 *      placeholders for the given number of rows. Names missing from
+		 *      swganh_static.attributes are skipped.
+		 */
+		static std::string BuildAttributeUpsert(size_t rows);
+
+		/**
+		 * Works out the containment level of rows from their parent_id, for rows
+		 * that were not snapshotted from live objects (the journal).
+		 *
+		 * @return The level of each row, 0 unless its container is among the rows.
+		 */
+		static std::vector<uint32_t> ContainmentLevels(const std::vector<ObjectSnapshot>& rows);
+
+	private:
+		struct KeyedTask
+		{
+			uint64_t key;
+			Task task;
+		};
+
+		struct PendingLevel
+		{
+			std::deque<ObjectSnapshot> rows;
+			std::deque<KeyedTask> tasks;
+		};
+
+		void Run_();
+		size_t QueueDepth_() const { return queued_; }
+
+		/// Rows go out before the tasks of the same containment depth.
+		static uint32_t RowLevel_(uint32_t level) { return 2 * level; }
+		static uint32_t TaskLevel_(uint32_t level) { return 2 * level + 1; }
+
+		/// True if a producer may queue more.
+		bool HasRoom_() const;
+
+		/// True if the lowest queued level has nothing below it in flight and has
+		/// a row or a task whose key is free.
+		bool Runnable_() const;
+
+		/// @return The position of the first task whose key is not in flight, the
+		///      number of tasks if there is none.
+		size_t NextTask_(const PendingLevel& pending) const;
+
+		/// Blocks until the rate limit allows count more writes.
+		void AcquireTokens_(size_t count);
+
+		BatchWriter writer_;
+		size_t batch_size_;
+		size_t max_queue_depth_;
+
+		mutable std::mutex mutex_;
+		std::condition_variable work_available_;
+		std::condition_variable space_available_;
+		std::condition_variable drained_;
+
+		std::map<uint32_t, PendingLevel> levels_;
+		std::map<uint32_t, size_t> in_flight_levels_;
+		std::unordered_set<uint64_t> busy_keys_;
+		size_t queued_;
+		size_t in_flight_;
+		bool stopping_;
+
+		mutable std::mutex rate_mutex_;
+		double max_items_per_second_;
+		double burst_;
+		double tokens_;
+		std::chrono::steady_clock::time_point last_refill_;
+
+		uint64_t rows_written_;
+		uint64_t tasks_run_;
+		uint64_t batches_written_;
+		uint64_t bytes_written_;
+		uint64_t errors_;
+		/// Wall-clock time with at least one write in flight, the current stretch
+		/// started at active_since_.
+		double active_seconds_;
+		std::chrono::steady_clock::time_point active_since_;
+		double last_flush_latency_ms_;
+		uint64_t last_flush_rows_;
+		uint64_t last_flush_bytes_;
+		double throttled_seconds_;
+
+		std::vector<std::thread> workers_;
+	};
+
+}}  // namespace swganh::object
+
+#endif  // SWGANH_OBJECT_PERSISTENCE_PIPELINE_H_
@@ -0,0 +1,343 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+#include "swganh_core/object/persistence_pipeline.h"
+
+using namespace swganh::object;
+
+namespace {
+	ObjectSnapshot MakeRow(uint64_t object_id)
+	{
+		ObjectSnapshot row = ObjectSnapshot();
+		row.object_id = object_id;
+		return row;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(PersistencePipelineTest)
+
+/// This test shows that queued rows are written in batches no larger than the batch size.
+BOOST_AUTO_TEST_CASE(RowsAreWrittenInBatches) {
+	std::mutex mutex;
+	std::vector<uint64_t> written;
+	size_t largest_batch = 0;
+
+	PersistencePipeline pipeline([&] (const std::vector<ObjectSnapshot>& rows) {
+		std::lock_guard<std::mutex> lock(mutex);
+		largest_batch = std::max(largest_batch, rows.size());
+		for (auto& row : rows)
+		{
+			written.push_back(row.object_id);
+		}
+	}, 2, 10);
+
+	for (uint64_t i = 0; i < 95; ++i)
+	{
+		pipeline.Enqueue(MakeRow(i));
+	}
+	pipeline.Flush();
+
+	BOOST_CHECK_EQUAL(95u, written.size());
+	BOOST_CHECK(largest_batch <= 10);
+
+	auto statistics = pipeline.GetStatistics();
+	BOOST_CHECK_EQUAL(95u, statistics.rows_written);
+	BOOST_CHECK_EQUAL(0u, statistics.queue_depth);
+}
+
+/// This test shows that producers block once the queue is full until the workers catch up.
+BOOST_AUTO_TEST_CASE(FullQueueBlocksProducers) {
+	std::atomic<bool> release(false);
+	PersistencePipeline pipeline([&] (const std::vector<ObjectSnapshot>&) {
+		while (!release)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}, 1, 1, 2);
+
+	// one row held by the worker, two more fill the queue
+	for (uint64_t i = 0; i < 3; ++i)
+	{
+		pipeline.Enqueue(MakeRow(i));
+	}
+
+	std::atomic<bool> enqueued(false);
+	std::thread producer([&] () {
+		pipeline.Enqueue(MakeRow(3));
+		enqueued = true;
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	BOOST_CHECK(!enqueued);
+
+	release = true;
+	producer.join();
+	pipeline.Flush();
+
+	BOOST_CHECK(enqueued);
+	BOOST_CHECK_EQUAL(4u, pipeline.GetStatistics().rows_written);
+}
+
+/// This test shows that failed writes are counted and do not stop the pipeline.
+BOOST_AUTO_TEST_CASE(FailedWritesAreCounted) {
+	PersistencePipeline pipeline([] (const std::vector<ObjectSnapshot>& rows) {
+		if (rows.front().object_id == 1)
+		{
+			throw std::runtime_error("write failed");
+		}
+	}, 1, 1);
+
+	std::atomic<int> tasks(0);
+	pipeline.Enqueue(MakeRow(1));
+	pipeline.Enqueue(MakeRow(2));
+	pipeline.EnqueueTask([&] () { ++tasks; });
+	pipeline.Flush();
+
+	auto statistics = pipeline.GetStatistics();
+	BOOST_CHECK_EQUAL(1u, statistics.errors);
+	BOOST_CHECK_EQUAL(1u, statistics.rows_written);
+	BOOST_CHECK_EQUAL(1u, statistics.tasks_run);
+	BOOST_CHECK_EQUAL(1, tasks);
+}
+
+/// This test shows that the generated upserts hold one placeholder group per row.
+BOOST_AUTO_TEST_CASE(UpsertsHaveOnePlaceholderGroupPerRow) {
+	auto object_sql = PersistencePipeline::BuildObjectUpsert(3);
+	BOOST_CHECK_EQUAL(3 * 19, std::count(object_sql.begin(), object_sql.end(), '?'));
+
+	auto attribute_sql = PersistencePipeline::BuildAttributeUpsert(4);
+	BOOST_CHECK_EQUAL(4 * 3, std::count(attribute_sql.begin(), attribute_sql.end(), '?'));
+	BOOST_CHECK(attribute_sql.find("JOIN swganh_static.attributes") != std::string::npos);
+}
+
+/// This test shows that an update only sets the columns of the changed fields.
+BOOST_AUTO_TEST_CASE(UpdatesOnlySetChangedColumns) {
+	auto sql = PersistencePipeline::BuildObjectUpdate(PERSIST_POSITION);
+
+	BOOST_CHECK_EQUAL("UPDATE object SET x_position = ?, y_position = ?, z_position = ?, updated_at = NOW() WHERE id = ?;", sql);
+
+	sql = PersistencePipeline::BuildObjectUpdate(PERSIST_POSITION | PERSIST_ORIENTATION | PERSIST_CUSTOM_NAME);
+	BOOST_CHECK_EQUAL(9, std::count(sql.begin(), sql.end(), '?'));
+	BOOST_CHECK(sql.find("custom_name") != std::string::npos);
+	BOOST_CHECK(sql.find("stf_name_file") == std::string::npos);
+}
+
+/// This test shows that the bytes written per flush only count the changed columns.
+BOOST_AUTO_TEST_CASE(BytesCountOnlyChangedColumns) {
+	auto row = MakeRow(1);
+	row.custom_name = "Han Solo";
+	row.changed_fields = PERSIST_POSITION;
+
+	size_t position_bytes = PersistencePipeline::EstimateRowBytes(row);
+	BOOST_CHECK_EQUAL(sizeof(uint64_t) + 3 * sizeof(double), position_bytes);
+
+	row.changed_fields |= PERSIST_CUSTOM_NAME;
+	BOOST_CHECK_EQUAL(position_bytes + 8, PersistencePipeline::EstimateRowBytes(row));
+
+	PersistencePipeline pipeline([] (const std::vector<ObjectSnapshot>&) {}, 1, 10);
+	pipeline.Enqueue(row);
+	pipeline.Flush();
+
+	auto statistics = pipeline.GetStatistics();
+	BOOST_CHECK_EQUAL(1u, statistics.last_flush_rows);
+	BOOST_CHECK_EQUAL(position_bytes + 8, statistics.last_flush_bytes);
+}
+
+/// This test shows that levels queued lowest first are written containers first,
+/// with several workers writing at once.
+BOOST_AUTO_TEST_CASE(ContainersAreWrittenBeforeTheirContents) {
+	std::mutex mutex;
+	std::vector<uint64_t> written;
+
+	PersistencePipeline pipeline([&] (const std::vector<ObjectSnapshot>& rows) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto& row : rows)
+		{
+			written.push_back(row.object_id);
+		}
+	}, 4, 2);
+
+	// ids are 100 * level + n
+	for (uint64_t i = 0; i < 10; ++i)
+	{
+		pipeline.Enqueue(MakeRow(i), 0);
+	}
+	for (uint64_t i = 0; i < 10; ++i)
+	{
+		pipeline.Enqueue(MakeRow(100 + i), 1);
+	}
+	pipeline.EnqueueTask([&] () {
+		std::lock_guard<std::mutex> lock(mutex);
+		written.push_back(150);
+	}, 1);
+	for (uint64_t i = 0; i < 10; ++i)
+	{
+		pipeline.Enqueue(MakeRow(200 + i), 2);
+	}
+	pipeline.Flush();
+
+	BOOST_REQUIRE_EQUAL(31u, written.size());
+	for (size_t i = 1; i < written.size(); ++i)
+	{
+		BOOST_CHECK_MESSAGE(written[i - 1] / 100 <= written[i] / 100,
+			"object " << written[i] << " was written after " << written[i - 1]);
+	}
+}
+
+/// This test shows that a pass larger than the queue blocks its producer at the
+/// bound while the workers write, and that tasks follow the rows of their level.
+BOOST_AUTO_TEST_CASE(PassesLargerThanTheQueueStayBounded) {
+	std::mutex mutex;
+	std::vector<uint64_t> written;
+
+	PersistencePipeline pipeline([&] (const std::vector<ObjectSnapshot>& rows) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto& row : rows)
+		{
+			written.push_back(row.object_id);
+		}
+	}, 4, 2, 4);
+
+	// ids are 100 * level + n, tasks write 100 * level + 99
+	uint64_t deepest_queue = 0;
+	for (uint64_t level = 0; level < 3; ++level)
+	{
+		for (uint64_t i = 0; i < 10; ++i)
+		{
+			pipeline.Enqueue(MakeRow(100 * level + i), static_cast<uint32_t>(level));
+			deepest_queue = std::max(deepest_queue, pipeline.GetStatistics().queue_depth);
+		}
+		pipeline.EnqueueTask([&, level] () {
+			std::lock_guard<std::mutex> lock(mutex);
+			written.push_back(100 * level + 99);
+		}, static_cast<uint32_t>(level));
+		deepest_queue = std::max(deepest_queue, pipeline.GetStatistics().queue_depth);
+	}
+	pipeline.Flush();
+
+	BOOST_CHECK(deepest_queue <= 4);
+	BOOST_REQUIRE_EQUAL(33u, written.size());
+	for (size_t i = 1; i < written.size(); ++i)
+	{
+		BOOST_CHECK_MESSAGE(written[i - 1] / 100 < written[i] / 100
+			|| (written[i - 1] / 100 == written[i] / 100 && written[i - 1] % 100 != 99),
+			"object " << written[i] << " was written after " << written[i - 1]);
+	}
+}
+
+/// This test shows that throughput is measured over wall-clock time, workers
+/// writing side by side do not count their time twice.
+BOOST_AUTO_TEST_CASE(ThroughputIsMeasuredOverWallClockTime) {
+	PersistencePipeline pipeline([] (const std::vector<ObjectSnapshot>&) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	}, 4, 10);
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint64_t i = 0; i < 40; ++i)
+	{
+		pipeline.Enqueue(MakeRow(i));
+	}
+	pipeline.Flush();
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// four batches of 50ms each, written at once
+	auto statistics = pipeline.GetStatistics();
+	BOOST_CHECK_EQUAL(40u, statistics.rows_written);
+	BOOST_CHECK(statistics.rows_per_second >= 40 / elapsed);
+	BOOST_CHECK(statistics.rows_per_second > 40 / 0.2);
+}
+
+/// This test shows that the calls of one object run one at a time in the order they
+/// were queued with several workers, so the later of two xp values is the one kept.
+BOOST_AUTO_TEST_CASE(TasksOfOneObjectRunInOrder) {
+	std::mutex mutex;
+	std::map<uint64_t, uint32_t> combat_xp;
+	std::atomic<int> running_for_player(0);
+	std::atomic<bool> overlapped(false);
+
+	PersistencePipeline pipeline([] (const std::vector<ObjectSnapshot>&) {}, 4);
+
+	auto update_xp = [&] (uint64_t player_id, uint32_t value, int delay_ms) {
+		return [&, player_id, value, delay_ms] () {
+			if (player_id == 1 && running_for_player++ != 0)
+			{
+				overlapped = true;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				combat_xp[player_id] = value;
+			}
+			if (player_id == 1)
+			{
+				--running_for_player;
+			}
+		};
+	};
+
+	// the first value takes longest, an idle worker would otherwise overtake it
+	pipeline.EnqueueTask(update_xp(1, 100, 30), 0, 1);
+	pipeline.EnqueueTask(update_xp(2, 5, 0), 0, 2);
+	pipeline.EnqueueTask(update_xp(1, 200, 0), 0, 1);
+	pipeline.EnqueueTask(update_xp(2, 7, 0), 0, 2);
+	pipeline.Flush();
+
+	BOOST_CHECK(!overlapped);
+	BOOST_CHECK_EQUAL(200u, combat_xp[1]);
+	BOOST_CHECK_EQUAL(7u, combat_xp[2]);
+	BOOST_CHECK_EQUAL(4u, pipeline.GetStatistics().tasks_run);
+}
+
+/// This test shows that writes are held to the configured rate.
+BOOST_AUTO_TEST_CASE(WritesAreRateLimited) {
+	PersistencePipeline pipeline([] (const std::vector<ObjectSnapshot>&) {}, 2, 10, 50000, 100);
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint64_t i = 0; i < 30; ++i)
+	{
+		pipeline.Enqueue(MakeRow(i));
+	}
+	pipeline.Flush();
+	auto elapsed = std::chrono::steady_clock::now() - start;
+
+	// the first 10 rows go out at once, the other 20 at 100 per second
+	BOOST_CHECK(elapsed >= std::chrono::milliseconds(150));
+	BOOST_CHECK(pipeline.GetStatistics().throttled_ms >= 150);
+}
+
+/// This test shows that rows replayed without their objects get their level from parent_id.
+BOOST_AUTO_TEST_CASE(LevelsFollowParentIds) {
+	std::vector<ObjectSnapshot> rows;
+	rows.push_back(MakeRow(3));
+	rows.back().changed_fields = PERSIST_CONTAINER;
+	rows.back().parent_id = 2;
+	rows.push_back(MakeRow(1));
+	rows.push_back(MakeRow(2));
+	rows.back().changed_fields = PERSIST_CONTAINER;
+	rows.back().parent_id = 1;
+	rows.push_back(MakeRow(4));
+	rows.back().changed_fields = PERSIST_CONTAINER;
+	rows.back().parent_id = 99;
+
+	auto levels = PersistencePipeline::ContainmentLevels(rows);
+
+	BOOST_REQUIRE_EQUAL(4u, levels.size());
+	BOOST_CHECK_EQUAL(2u, levels[0]);
+	BOOST_CHECK_EQUAL(0u, levels[1]);
+	BOOST_CHECK_EQUAL(1u, levels[2]);
+	BOOST_CHECK_EQUAL(0u, levels[3]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
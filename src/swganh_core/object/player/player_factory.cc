@@ -15,6 +15,7 @@
 
 #include "swganh/crc.h"
 #include "swganh/database/database_manager.h"
+#include "swganh_core/object/object_manager.h"
 #include "swganh_core/object/player/player.h"
 #include "player_events.h"
 
@@ -67,61 +68,60 @@ void PlayerFactory::RegisterEventHandlers()
 }
 void PlayerFactory::PersistChangedObjects()
 {
-	std::set<shared_ptr<Object>> persisted;
-	{
-		boost::lock_guard<boost::mutex> lg(persisted_objects_mutex_);
-		persisted = move(persisted_objects_);
-	}
-	for (auto& object : persisted)
-	{
-		if(object->IsDatabasePersisted())
-			PersistObject(object);
-	}
+	PersistChangedTypeColumns();
+}
+void PlayerFactory::SnapshotTypeCalls(const shared_ptr<Object>& object, vector<ProcedureCall>& calls)
+{
+	auto player = static_pointer_cast<Player>(object);
+	ProcedureCall call(player->GetObjectId(), "CALL sp_PersistPlayer(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);", MERGE_LATEST);
+	call.AddUInt64(player->GetObjectId());
+	call.AddString(player->GetProfessionTag());
+	call.AddUInt64(player->GetTotalPlayTime());
+	call.AddUInt(player->GetAdminTag());
+	call.AddUInt(player->GetMaxForcePower());
+	call.AddUInt(player->GetExperimentationFlag());
+	call.AddUInt(player->GetCraftingStage());
+	call.AddUInt64(player->GetNearestCraftingStation());
+	call.AddUInt(player->GetExperimentationPoints());
+	call.AddUInt(player->GetAccomplishmentCounter());
+	call.AddUInt(player->GetLanguage());
+	call.AddUInt(player->GetCurrentStomach());
+	call.AddUInt(player->GetMaxStomach());
+	call.AddUInt(player->GetCurrentDrink());
+	call.AddUInt(player->GetMaxDrink());
+	call.AddUInt(player->GetJediState());
+	calls.push_back(move(call));
+
+	SnapshotFriends_(player, calls);
+	SnapshotIgnoredList_(player, calls);
+	SnapshotXP_(player, calls);
+	SnapshotDraftSchematics_(player, calls);
+	SnapshotForceSensitiveQuests_(player, calls);
+	SnapshotQuestJournal_(player, calls);
+	SnapshotBadges_(player, calls);
 }
 uint32_t PlayerFactory::PersistObject(const shared_ptr<Object>& object, bool persist_inherited)
 {
 	uint32_t counter = 1;
 	if (persist_inherited)
 		IntangibleFactory::PersistObject(object, persist_inherited);
-    try 
-    {
-        auto conn = GetDatabaseManager()->getConnection("galaxy");
-        auto statement = shared_ptr<sql::PreparedStatement>
-			(conn->prepareStatement("CALL sp_PersistPlayer(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);"));
-        
-		auto player = static_pointer_cast<Player>(object);
-		statement->setUInt64(counter++, player->GetObjectId());
-		statement->setString(counter++, player->GetProfessionTag());
-		statement->setUInt64(counter++, player->GetTotalPlayTime());
-		statement->setUInt(counter++, player->GetAdminTag());
-		statement->setUInt(counter++, player->GetMaxForcePower());
-		statement->setUInt(counter++, player->GetExperimentationFlag());
-		statement->setUInt(counter++, player->GetCraftingStage());
-		statement->setUInt64(counter++, player->GetNearestCraftingStation());
-		statement->setUInt(counter++, player->GetExperimentationPoints());
-		statement->setUInt(counter++, player->GetAccomplishmentCounter());
-		statement->setUInt(counter++, player->GetLanguage());
-		statement->setUInt(counter++, player->GetCurrentStomach());
-		statement->setUInt(counter++, player->GetMaxStomach());
-		statement->setUInt(counter++, player->GetCurrentDrink());
-		statement->setUInt(counter++, player->GetMaxDrink());
-		statement->setUInt(counter++, player->GetJediState());
-
-        statement->executeUpdate();
 
-        PersistFriends_(player);
-        PersistIgnoredList_(player);
-        PersistXP_(player);
-        PersistDraftSchematics_(player);
-        PersistForceSensitiveQuests_(player);
-        PersistQuestJournal_(player);
-		PersistBadges_(player);
-    }
-    catch(sql::SQLException &e)
-    {
-        LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
-        LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
-    }
+	vector<ProcedureCall> calls;
+	PlayerFactory::SnapshotTypeCalls(object, calls);
+	// Each list is written on its own, a failed call does not stop the rest
+	for (auto& call : calls)
+	{
+		try 
+		{
+			WriteProcedureCall(GetDatabaseManager(), call);
+			counter += call.parameters.size();
+		}
+		catch(sql::SQLException &e)
+		{
+			LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
+			LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
+		}
+	}
 	return counter;
 }
 
@@ -283,24 +283,16 @@ void PlayerFactory::LoadXP_(shared_ptr<Player> player, const std::shared_ptr<sql
         LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
     }
 }
-void PlayerFactory::PersistXP_(const shared_ptr<Player>& player)
+void PlayerFactory::SnapshotXP_(const shared_ptr<Player>& player, vector<ProcedureCall>& calls)
 {
-    try 
+    auto xp = player->GetXp();
+    for(auto& xpData : xp)
     {
-        auto conn = GetDatabaseManager()->getConnection("galaxy");
-        auto xp = player->GetXp();
-        for(auto& xpData : xp)
-        {
-            auto statement = conn->prepareStatement("CALL sp_UpdateExperience(?,?);");
-            statement->setString(1,xpData.first);
-            statement->setUInt(2,xpData.second.value);
-            auto result = unique_ptr<sql::ResultSet>(statement->executeQuery());
-        };
-    }
-        catch(sql::SQLException &e)
-    {
-        LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
-        LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
+        // the journal keeps the latest value of each xp type
+        ProcedureCall call(player->GetObjectId(), "CALL sp_UpdateExperience(?,?);", MERGE_LATEST, 1);
+        call.AddString(xpData.first);
+        call.AddUInt(xpData.second.value);
+        calls.push_back(move(call));
     }
 }
 void PlayerFactory::LoadWaypoints_(shared_ptr<Player> player, const std::shared_ptr<sql::Statement>& statement)
@@ -344,75 +336,49 @@ void PlayerFactory::LoadDraftSchematics_(shared_ptr<Player> player, const std::s
     }
 }
 
-void PlayerFactory::PersistBadges_(const shared_ptr<Player>& player)
+void PlayerFactory::SnapshotBadges_(const shared_ptr<Player>& player, vector<ProcedureCall>& calls)
 {
-	try
+	auto badges = player->GetBadgesSyncQueue();
+
+	while(badges.size())
 	{
-		auto conn = GetDatabaseManager()->getConnection("galaxy");
-		auto badges = player->GetBadgesSyncQueue();
+		auto queue_item = badges.front();
 
-		while(badges.size())
+		switch(queue_item.first)
 		{
-			auto queue_item = badges.front();
-
-			switch(queue_item.first)
+		case 0: // Remove
 			{
-			case 0: // Remove
-				{
-					auto statement = conn->prepareStatement("CALL sp_RemoveBadge(?, ?);");
-					statement->setUInt64(1, player->GetObjectId());
-					statement->setUInt(2, queue_item.second);
-					auto result = unique_ptr<sql::ResultSet>(statement->executeQuery());
-					break;
-				}
-
-			case 1: // Add
-				{
-					auto statement = conn->prepareStatement("CALL sp_UpdateBadges(?, ?);");
-					statement->setUInt64(1, player->GetObjectId());
-					statement->setUInt(2, queue_item.second);
-					auto result = unique_ptr<sql::ResultSet>(statement->executeQuery());
-					break;
-				}
+				ProcedureCall call(player->GetObjectId(), "CALL sp_RemoveBadge(?, ?);");
+				call.AddUInt64(player->GetObjectId());
+				call.AddUInt(queue_item.second);
+				calls.push_back(move(call));
+				break;
 			}
 
-			badges.pop();
+		case 1: // Add
+			{
+				ProcedureCall call(player->GetObjectId(), "CALL sp_UpdateBadges(?, ?);");
+				call.AddUInt64(player->GetObjectId());
+				call.AddUInt(queue_item.second);
+				calls.push_back(move(call));
+				break;
+			}
 		}
 
-		//for(auto& badge_id : badges)
-		//{
-		//	auto statement = conn->prepareStatement("CALL sp_UpdateBadges(?, ?);");
-		//	statement->setUInt64(1, player->GetObjectId());
-		//	statement->setUInt(2, badge_id);
-		//	auto result = unique_ptr<sql::ResultSet>(statement->executeQuery());
-		//};
+		badges.pop();
 	}
-    catch(sql::SQLException &e)
-    {
-        LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
-        LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
-    }
 }
 
-void PlayerFactory::PersistDraftSchematics_(const shared_ptr<Player>& player)
+void PlayerFactory::SnapshotDraftSchematics_(const shared_ptr<Player>& player, vector<ProcedureCall>& calls)
 {
-    try 
+    auto draft_schematics = player->GetDraftSchematics();
+    for(auto& schematic : draft_schematics)
     {
-        auto conn = GetDatabaseManager()->getConnection("galaxy");
-        auto draft_schematics = player->GetDraftSchematics();
-        for(auto& schematic : draft_schematics)
-        {
-            auto statement = conn->prepareStatement("CALL sp_UpdateDraftSchematic(?,?,?);");
-            statement->setUInt64(1, player->GetObjectId());
-            statement->setUInt(2,schematic.schematic_id);
-            statement->setUInt(3, schematic.schematic_crc);
-            auto result = unique_ptr<sql::ResultSet>(statement->executeQuery());
-        };
-    }
-        catch(sql::SQLException &e)
-    {
-        LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
-        LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
+        ProcedureCall call(player->GetObjectId(), "CALL sp_UpdateDraftSchematic(?,?,?);");
+        call.AddUInt64(player->GetObjectId());
+        call.AddUInt(schematic.schematic_id);
+        call.AddUInt(schematic.schematic_crc);
+        calls.push_back(move(call));
     }
 }
 void PlayerFactory::LoadQuestJournal_(shared_ptr<Player> player, const std::shared_ptr<sql::Statement>& statement)
@@ -440,30 +406,19 @@ void PlayerFactory::LoadQuestJournal_(shared_ptr<Player> player, const std::shar
         LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
     }
 }
-void PlayerFactory::PersistQuestJournal_(const shared_ptr<Player>& player)
+void PlayerFactory::SnapshotQuestJournal_(const shared_ptr<Player>& player, vector<ProcedureCall>& calls)
 {
-    try 
-    {
-        auto conn = GetDatabaseManager()->getConnection("galaxy");
-        auto quests = player->GetQuests();
-        
-        for(auto& quest : quests)
-        {
-            auto statement = conn->prepareStatement("CALL sp_UpdateQuestJournal(?,?,?,?,?,?);");
-            statement->setUInt64(1, player->GetObjectId());
-            statement->setUInt64(2, quest.second.owner_id);
-            statement->setUInt(3, quest.second.quest_crc);
-            statement->setUInt(4, quest.second.active_step_bitmask);
-            statement->setUInt(5, quest.second.completed_step_bitmask);
-            statement->setUInt(6, quest.second.completed_flag);
-            
-            auto result = unique_ptr<sql::ResultSet>(statement->executeQuery());
-        };
-    }
-        catch(sql::SQLException &e)
-    {
-        LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
-        LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
+    auto quests = player->GetQuests();
+    for(auto& quest : quests)
+    {
+        ProcedureCall call(player->GetObjectId(), "CALL sp_UpdateQuestJournal(?,?,?,?,?,?);");
+        call.AddUInt64(player->GetObjectId());
+        call.AddUInt64(quest.second.owner_id);
+        call.AddUInt(quest.second.quest_crc);
+        call.AddUInt(quest.second.active_step_bitmask);
+        call.AddUInt(quest.second.completed_step_bitmask);
+        call.AddUInt(quest.second.completed_flag);
+        calls.push_back(move(call));
     }
 }
 void PlayerFactory::LoadForceSensitiveQuests_(shared_ptr<Player> player, const std::shared_ptr<sql::Statement>& statement)
@@ -492,23 +447,13 @@ void PlayerFactory::LoadForceSensitiveQuests_(shared_ptr<Player> player, const s
         LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
     }
 }
-void PlayerFactory::PersistForceSensitiveQuests_(const shared_ptr<Player>& player)
+void PlayerFactory::SnapshotForceSensitiveQuests_(const shared_ptr<Player>& player, vector<ProcedureCall>& calls)
 {
-    try 
-    {
-        auto conn = GetDatabaseManager()->getConnection("galaxy");
-        auto statement = conn->prepareStatement("CALL sp_UpdateFSQuests(?,?,?);");
-        statement->setUInt64(1, player->GetObjectId());
-        statement->setUInt(2, player->GetCurrentForceSensitiveQuests());
-        statement->setUInt(3, player->GetCompletedForceSensitiveQuests());
-
-        auto result = unique_ptr<sql::ResultSet>(statement->executeQuery());
-    }
-        catch(sql::SQLException &e)
-    {
-        LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
-        LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
-    }
+    ProcedureCall call(player->GetObjectId(), "CALL sp_UpdateFSQuests(?,?,?);", MERGE_LATEST);
+    call.AddUInt64(player->GetObjectId());
+    call.AddUInt(player->GetCurrentForceSensitiveQuests());
+    call.AddUInt(player->GetCompletedForceSensitiveQuests());
+    calls.push_back(move(call));
 }
 void PlayerFactory::RemoveFriend_(const std::shared_ptr<Player>& player, uint64_t friend_id)
 {
@@ -516,7 +461,7 @@ void PlayerFactory::RemoveFriend_(const std::shared_ptr<Player>& player, uint64_
     {
         auto conn = GetDatabaseManager()->getConnection("galaxy");
         
-        auto statement = conn->prepareStatement("CALL sp_RemoveFriend(?,?);");
+        auto statement = GetDatabaseManager()->getPreparedStatement(conn, "CALL sp_RemoveFriend(?,?);");
         statement->setUInt64(1, player->GetObjectId());
         statement->setUInt64(2, friend_id);
 
@@ -528,25 +473,15 @@ void PlayerFactory::RemoveFriend_(const std::shared_ptr<Player>& player, uint64_
         LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
     }
 }
-void PlayerFactory::PersistFriends_(const shared_ptr<Player>& player)
+void PlayerFactory::SnapshotFriends_(const shared_ptr<Player>& player, vector<ProcedureCall>& calls)
 {
-    try 
-    {
-        auto conn = GetDatabaseManager()->getConnection("galaxy");
-        auto friends = player->GetFriends();
-        
-        for(auto& friend_name : friends)
-        {
-            auto statement = conn->prepareStatement("CALL sp_UpdateFriends(?,?);");
-            statement->setUInt64(1, player->GetObjectId());
-            statement->setUInt64(2, friend_name.id);
-            auto result = unique_ptr<sql::ResultSet>(statement->executeQuery());
-        };
-    }
-        catch(sql::SQLException &e)
+    auto friends = player->GetFriends();
+    for(auto& friend_name : friends)
     {
-        LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
-        LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
+        ProcedureCall call(player->GetObjectId(), "CALL sp_UpdateFriends(?,?);");
+        call.AddUInt64(player->GetObjectId());
+        call.AddUInt64(friend_name.id);
+        calls.push_back(move(call));
     }
 }
 void PlayerFactory::LoadFriends_(shared_ptr<Player> player, const std::shared_ptr<sql::Statement>& statement)
@@ -587,25 +522,15 @@ void PlayerFactory::LoadIgnoredList_(shared_ptr<Player> player, const std::share
         LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
     }
 }
-void PlayerFactory::PersistIgnoredList_(const shared_ptr<Player>& player)
+void PlayerFactory::SnapshotIgnoredList_(const shared_ptr<Player>& player, vector<ProcedureCall>& calls)
 {
-    try 
+    auto ignored_players = player->GetIgnoredPlayers();
+    for(auto& player_name : ignored_players)
     {
-        auto conn = GetDatabaseManager()->getConnection("galaxy");
-        auto ignored_players = player->GetIgnoredPlayers();
-        
-        for(auto& player_name : ignored_players)
-        {
-            auto statement = conn->prepareStatement("CALL sp_UpdateIgnoreList(?,?);");
-            statement->setUInt64(1, player->GetObjectId());
-            statement->setUInt64(2, player_name.id);
-            auto result = unique_ptr<sql::ResultSet>(statement->executeQuery());
-        };
-    }
-        catch(sql::SQLException &e)
-    {
-        LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
-        LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
+        ProcedureCall call(player->GetObjectId(), "CALL sp_UpdateIgnoreList(?,?);");
+        call.AddUInt64(player->GetObjectId());
+        call.AddUInt64(player_name.id);
+        calls.push_back(move(call));
     }
 }
 void PlayerFactory::RemoveFromIgnoredList_(const shared_ptr<Player>& player, uint64_t ignore_player_id)
@@ -614,7 +539,7 @@ void PlayerFactory::RemoveFromIgnoredList_(const shared_ptr<Player>& player, uin
     {
         auto conn = GetDatabaseManager()->getConnection("galaxy");
         
-        auto statement = conn->prepareStatement("CALL sp_RemoveIgnoredPlayer(?,?);");
+        auto statement = GetDatabaseManager()->getPreparedStatement(conn, "CALL sp_RemoveIgnoredPlayer(?,?);");
         statement->setUInt64(1, player->GetObjectId());
         statement->setUInt64(2, ignore_player_id);
 
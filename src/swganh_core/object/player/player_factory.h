@@ -29,6 +29,7 @@ namespace object {
 
         void DeleteObjectFromStorage(const std::shared_ptr<swganh::object::Object>& object);
 		virtual void PersistChangedObjects();
+		virtual void SnapshotTypeCalls(const std::shared_ptr<swganh::object::Object>& object, std::vector<ProcedureCall>& calls);
         std::shared_ptr<swganh::object::Object> CreateObjectFromStorage(uint64_t object_id);
 
         std::shared_ptr<swganh::object::Object> CreateObject();
@@ -39,23 +40,23 @@ namespace object {
         void LoadStatusFlags_(std::shared_ptr<Player> player, const std::shared_ptr<sql::Statement>& statement);
         void LoadProfileFlags_(std::shared_ptr<Player> player, const std::shared_ptr<sql::Statement>& statement);
         void LoadBadges_(std::shared_ptr<Player> player, const std::shared_ptr<sql::Statement>& statement);
-		void PersistBadges_(const std::shared_ptr<Player>& player);
+		void SnapshotBadges_(const std::shared_ptr<Player>& player, std::vector<ProcedureCall>& calls);
 		void LoadXP_(std::shared_ptr<Player> player, const std::shared_ptr<sql::Statement>& statement);
-        void PersistXP_(const std::shared_ptr<Player>& player);
+        void SnapshotXP_(const std::shared_ptr<Player>& player, std::vector<ProcedureCall>& calls);
         void LoadWaypoints_(std::shared_ptr<Player> player, const std::shared_ptr<sql::Statement>& statement);
         void PersistWaypoints_(const std::shared_ptr<Player>& player);
         void LoadDraftSchematics_(std::shared_ptr<Player> player, const std::shared_ptr<sql::Statement>& statement);
-        void PersistDraftSchematics_(const std::shared_ptr<Player>& player);
+        void SnapshotDraftSchematics_(const std::shared_ptr<Player>& player, std::vector<ProcedureCall>& calls);
         void LoadQuestJournal_(std::shared_ptr<Player> player, const std::shared_ptr<sql::Statement>& statement);
-        void PersistQuestJournal_(const std::shared_ptr<Player>& player);
+        void SnapshotQuestJournal_(const std::shared_ptr<Player>& player, std::vector<ProcedureCall>& calls);
         void LoadForceSensitiveQuests_(std::shared_ptr<Player> player, const std::shared_ptr<sql::Statement>& statement);
-        void PersistForceSensitiveQuests_(const std::shared_ptr<Player>& player);
+        void SnapshotForceSensitiveQuests_(const std::shared_ptr<Player>& player, std::vector<ProcedureCall>& calls);
         void LoadFriends_(std::shared_ptr<Player> player, const std::shared_ptr<sql::Statement>& statement);
-        void PersistFriends_(const std::shared_ptr<Player>& player);
+        void SnapshotFriends_(const std::shared_ptr<Player>& player, std::vector<ProcedureCall>& calls);
         void RemoveFriend_(const std::shared_ptr<Player>& player, uint64_t friend_id);
         void LoadIgnoredList_(std::shared_ptr<Player> player, const std::shared_ptr<sql::Statement>& statement);
         void RemoveFromIgnoredList_(const std::shared_ptr<Player>& player, uint64_t ignore_player_id);
-        void PersistIgnoredList_(const std::shared_ptr<Player>& player);
+        void SnapshotIgnoredList_(const std::shared_ptr<Player>& player, std::vector<ProcedureCall>& calls);
     };
 
 }}  // namespace swganh::object
@@ -19,6 +19,7 @@ namespace object {
 		virtual bool is_filled() { return false; }
 		virtual void view_objects(std::function<void(const std::shared_ptr<swganh::object::Object>&)> walkerFunction);
 		virtual void view_objects_if(std::function<bool(std::shared_ptr<swganh::object::Object>)> walkerFunction);
+		virtual std::shared_ptr<SlotInterface> clone_empty() { return std::make_shared<SlotContainer>(); }
 
 	private:
 		std::set<std::shared_ptr<swganh::object::Object>> held_objects_;
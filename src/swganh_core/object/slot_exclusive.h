@@ -16,6 +16,7 @@ namespace object {
 		virtual bool is_filled() { return held_object_ != nullptr; }
 		virtual void view_objects(std::function<void(const std::shared_ptr<swganh::object::Object>&)> walkerFunction);
 		virtual void view_objects_if(std::function<bool(std::shared_ptr<swganh::object::Object>)> walkerFunction);
+		virtual std::shared_ptr<SlotInterface> clone_empty() { return std::make_shared<SlotExclusive>(); }
 
 	private:
 		std::shared_ptr<swganh::object::Object> held_object_;
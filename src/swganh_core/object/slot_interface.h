@@ -18,6 +18,8 @@ namespace object {
 		virtual void view_objects(std::function<void(const std::shared_ptr<swganh::object::Object>&)> walkerFunction) = 0;
 		virtual void view_objects_if(std::function<bool(std::shared_ptr<swganh::object::Object>)> walkerFunction) = 0;
 		virtual bool is_filled() = 0;
+		// creates a new, empty slot of the same kind
+		virtual std::shared_ptr<SlotInterface> clone_empty() = 0;
 	};
 
 }
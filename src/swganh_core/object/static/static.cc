@@ -10,3 +10,17 @@ uint32_t Static::GetType() const
 { 
     return Static::type; 
 }
+
+std::shared_ptr<Object> Static::Clone()
+{
+	boost::lock_guard<boost::mutex> lock(object_mutex_);
+	auto other = make_shared<Static>();
+	Clone(other);
+	return other;
+}
+
+void Static::Clone(std::shared_ptr<Static> other)
+{
+	//Call the method in the super class
+	Object::Clone(other);
+}
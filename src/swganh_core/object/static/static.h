@@ -20,6 +20,9 @@ public:
     // STAO
     uint32_t GetType() const;
     const static uint32_t type = 0x5354414F;
+
+	virtual std::shared_ptr<Object> Clone();
+	void Clone(std::shared_ptr<Static> other);
 };
 
 }}  // namespace swganh::object_obj
@@ -3,6 +3,8 @@
 
 #include "tangible.h"
 
+#include "swganh/pool_allocator.h"
+
 #include "swganh_core/object/object_events.h"
 using namespace std;
 using namespace swganh::object;
@@ -267,7 +269,7 @@ void Tangible::CreateBaselines(std::shared_ptr<swganh::observer::ObserverInterfa
 std::shared_ptr<Object> Tangible::Clone()
 {
 	boost::lock_guard<boost::mutex> lock(object_mutex_);
-	auto other = make_shared<Tangible>();
+	auto other = swganh::MakePooled<Tangible>();
 	Clone(other);
 	return other;
 }
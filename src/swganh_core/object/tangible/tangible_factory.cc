@@ -2,6 +2,8 @@
 // See file LICENSE or go to http://swganh.com/LICENSE
 
 #include "swganh_core/object/tangible/tangible_factory.h"
+
+#include "swganh/pool_allocator.h"
 #include <sstream>
 
 #include <cppconn/exception.h>
@@ -13,6 +15,7 @@
 #include "swganh/logger.h"
 
 #include "swganh/database/database_manager.h"
+#include "swganh_core/object/object_manager.h"
 #include "swganh_core/object/tangible/tangible.h"
 #include "swganh_core/object/exception.h"
 #include "swganh_core/simulation/simulation_service_interface.h"
@@ -44,16 +47,21 @@ using namespace swganh::simulation;
  
 void TangibleFactory::PersistChangedObjects()
 {
-	std::set<shared_ptr<Object>> persisted;
-	{
-		boost::lock_guard<boost::mutex> lg(persisted_objects_mutex_);
-		persisted = move(persisted_objects_);
-	}
-	for (auto& object : persisted)
-	{
-		if(object->IsDatabasePersisted())
-			PersistObject(object);
-	}
+	PersistChangedTypeColumns();
+}
+
+void TangibleFactory::SnapshotTypeCalls(const shared_ptr<Object>& object, vector<ProcedureCall>& calls)
+{
+	auto tangible = static_pointer_cast<Tangible>(object);
+	ProcedureCall call(tangible->GetObjectId(), "CALL sp_PersistTangible(?,?,?,?,?,?,?);", MERGE_LATEST);
+	call.AddUInt64(tangible->GetObjectId());
+	call.AddString(tangible->GetCustomization());
+	call.AddInt(tangible->GetOptionsMask());
+	call.AddInt(tangible->GetCounter());
+	call.AddInt(tangible->GetCondition());
+	call.AddInt(tangible->GetMaxCondition());
+	call.AddBoolean(tangible->IsStatic());
+	calls.push_back(move(call));
 }
 
 uint32_t TangibleFactory::PersistObject(const shared_ptr<Object>& object, bool persist_inherited)
@@ -63,20 +71,13 @@ uint32_t TangibleFactory::PersistObject(const shared_ptr<Object>& object, bool p
 		ObjectFactory::PersistObject(object, persist_inherited);
     try 
     {
-        auto conn = GetDatabaseManager()->getConnection("galaxy");
-        auto statement = shared_ptr<sql::PreparedStatement>
-            (conn->prepareStatement("CALL sp_PersistTangible(?,?,?,?,?,?,?);"));
-        // cast to tangible
-        auto tangible = static_pointer_cast<Tangible>(object);
-		statement->setUInt64(counter++, tangible->GetObjectId());
-        statement->setString(counter++, tangible->GetCustomization());
-        statement->setInt(counter++, tangible->GetOptionsMask());
-        statement->setInt(counter++, tangible->GetCounter());
-        statement->setInt(counter++, tangible->GetCondition());
-        statement->setInt(counter++, tangible->GetMaxCondition());
-        statement->setBoolean(counter++, tangible->IsStatic());
-        statement->executeUpdate();
-		
+		vector<ProcedureCall> calls;
+		TangibleFactory::SnapshotTypeCalls(object, calls);
+		for (auto& call : calls)
+		{
+			WriteProcedureCall(GetDatabaseManager(), call);
+			counter += call.parameters.size();
+		}
     }
     catch(sql::SQLException &e)
     {
@@ -100,12 +101,7 @@ void TangibleFactory::CreateTangible(const shared_ptr<Tangible>& tangible, const
             result.reset(statement->getResultSet());
             while (result->next())
             {
-                tangible->SetCustomization(result->getString("customization"));
-                tangible->SetOptionsMask(result->getUInt("options_bitmask"));
-                tangible->SetCounter(result->getUInt("incap_timer"));
-                tangible->SetConditionDamage(result->getUInt("condition_damage"));
-                tangible->SetMaxCondition(result->getUInt("max_condition"));
-                tangible->SetStatic(result->getBoolean("is_static"));
+                LoadTangibleColumns_(tangible, *result);
             }
         }
 
@@ -123,7 +119,7 @@ void TangibleFactory::CreateTangible(const shared_ptr<Tangible>& tangible, const
 }
 shared_ptr<Object> TangibleFactory::CreateObjectFromStorage(uint64_t object_id)
 {
-   auto tangible = make_shared<Tangible>();
+   auto tangible = swganh::MakePooled<Tangible>();
    tangible->SetObjectId(object_id);
    CreateTangibleFromStorage(tangible);
    return tangible;
@@ -150,5 +146,49 @@ void TangibleFactory::CreateTangibleFromStorage(shared_ptr<Tangible> tangible)
 
 shared_ptr<Object> TangibleFactory::CreateObject()
 {
-	return make_shared<Tangible>();
+	return swganh::MakePooled<Tangible>();
+}
+
+std::string TangibleFactory::GetBulkLoadTable() const
+{
+    return "tangible";
+}
+
+std::vector<std::string> TangibleFactory::GetBulkLoadColumns() const
+{
+    // read by LoadTangibleColumns_
+    static const char* const columns[] = {
+        "customization", "options_bitmask", "incap_timer", "condition_damage", "max_condition", "is_static"
+    };
+    return std::vector<std::string>(std::begin(columns), std::end(columns));
+}
+
+shared_ptr<Object> TangibleFactory::CreateObjectFromRow(sql::ResultSet& row)
+{
+    auto tangible = swganh::MakePooled<Tangible>();
+    tangible->SetObjectId(row.getUInt64("object_id"));
+    CreateTangibleFromRow(tangible, row);
+    return tangible;
+}
+
+void TangibleFactory::CreateTangibleFromRow(const shared_ptr<Tangible>& tangible, sql::ResultSet& row)
+{
+    CreateBaseObjectFromRow(tangible, row);
+    LoadTangibleColumns_(tangible, row);
+
+    //Clear us from the db persist update queue.
+    boost::lock_guard<boost::mutex> lock(persisted_objects_mutex_);
+    auto find_itr = persisted_objects_.find(tangible);
+    if(find_itr != persisted_objects_.end())
+        persisted_objects_.erase(find_itr);
+}
+
+void TangibleFactory::LoadTangibleColumns_(const shared_ptr<Tangible>& tangible, sql::ResultSet& row)
+{
+    tangible->SetCustomization(row.getString("customization"));
+    tangible->SetOptionsMask(row.getUInt("options_bitmask"));
+    tangible->SetCounter(row.getUInt("incap_timer"));
+    tangible->SetConditionDamage(row.getUInt("condition_damage"));
+    tangible->SetMaxCondition(row.getUInt("max_condition"));
+    tangible->SetStatic(row.getBoolean("is_static"));
 }
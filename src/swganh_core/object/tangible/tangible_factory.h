@@ -13,6 +13,7 @@ class DatabaseManagerInterface;
 
 namespace sql {
 class Statement;
+class ResultSet;
 }
 
 namespace swganh {
@@ -30,14 +31,23 @@ namespace object {
 
         void DeleteObjectFromStorage(const std::shared_ptr<swganh::object::Object>& object);
 		virtual void PersistChangedObjects();
+		virtual void SnapshotTypeCalls(const std::shared_ptr<swganh::object::Object>& object, std::vector<ProcedureCall>& calls);
         std::shared_ptr<swganh::object::Object> CreateObjectFromStorage(uint64_t object_id);
 		void CreateTangibleFromStorage(std::shared_ptr<swganh::object::Tangible> tangible);
         void CreateTangible(const std::shared_ptr<Tangible>& tangible, const std::shared_ptr<sql::Statement>& statement);
 
         std::shared_ptr<swganh::object::Object> CreateObject();
+
+        virtual std::string GetBulkLoadTable() const;
+        virtual std::vector<std::string> GetBulkLoadColumns() const;
+        virtual std::shared_ptr<swganh::object::Object> CreateObjectFromRow(sql::ResultSet& row);
         
         virtual void RegisterEventHandlers();
+    protected:
+        /// Loads the base and tangible columns of a bulk loaded row into the tangible.
+        void CreateTangibleFromRow(const std::shared_ptr<Tangible>& tangible, sql::ResultSet& row);
     private:
+        void LoadTangibleColumns_(const std::shared_ptr<Tangible>& tangible, sql::ResultSet& row);
     };
 
 }}  // namespace swganh::object
@@ -0,0 +1,55 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "swganh_core/object/persistence_pipeline.h"
+#include "swganh_core/object/tangible/tangible.h"
+#include "swganh_core/object/tangible/tangible_factory.h"
+
+using namespace swganh::object;
+
+BOOST_AUTO_TEST_SUITE(TangibleFactoryTest)
+
+/// This test shows that a changed tangible hands the pipeline its object row before its type call.
+BOOST_AUTO_TEST_CASE(ChangedTangibleWritesItsRowBeforeItsTypeCall) {
+	std::mutex mutex;
+	std::vector<std::string> written;
+	std::vector<ObjectSnapshot> rows;
+
+	PersistencePipeline pipeline([&] (const std::vector<ObjectSnapshot>& batch) {
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto& row : batch)
+		{
+			rows.push_back(row);
+			written.push_back("row");
+		}
+	}, 2);
+
+	auto tangible = std::make_shared<Tangible>();
+	tangible->SetObjectId(8589934593);
+	tangible->TakeChangedFields();
+	tangible->SetPosition(glm::vec3(10.0f, 5.0f, -20.0f));
+
+	TangibleFactory factory(nullptr);
+	factory.EnqueueChangedObject(pipeline, tangible, [&] (const ProcedureCall& call) {
+		std::lock_guard<std::mutex> lock(mutex);
+		written.push_back(call.statement);
+	});
+	pipeline.Flush();
+
+	BOOST_REQUIRE_EQUAL(2u, written.size());
+	BOOST_CHECK_EQUAL("row", written[0]);
+	BOOST_CHECK_EQUAL("CALL sp_PersistTangible(?,?,?,?,?,?,?);", written[1]);
+
+	BOOST_REQUIRE_EQUAL(1u, rows.size());
+	BOOST_CHECK_EQUAL(8589934593u, rows[0].object_id);
+	BOOST_CHECK(rows[0].changed_fields & PERSIST_POSITION);
+	BOOST_CHECK_EQUAL(-20.0f, rows[0].z_position);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,83 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "template_registry.h"
+
+#include <boost/thread/locks.hpp>
+
+#include "swganh/crc.h"
+
+using namespace std;
+using namespace swganh::object;
+
+TemplateInfo::TemplateInfo(const string& name)
+	: name_(name)
+	, crc_(swganh::memcrc(name))
+	, object_type_(0)
+	, has_slot_arrangements_(false)
+{}
+
+const ObjectArrangements& TemplateInfo::GetSlotArrangements() const
+{
+	static const ObjectArrangements empty;
+	return HasSlotArrangements() ? slot_arrangements_ : empty;
+}
+
+TemplateRegistry& TemplateRegistry::getInstance()
+{
+	static TemplateRegistry instance;
+	return instance;
+}
+
+TemplateRegistry::TemplateRegistry()
+{}
+
+const TemplateInfo* TemplateRegistry::Intern(const string& name)
+{
+	{
+		boost::shared_lock<boost::shared_mutex> lock(mutex_);
+		auto find_iter = templates_.find(name);
+		if (find_iter != templates_.end())
+		{
+			return find_iter->second.get();
+		}
+	}
+
+	boost::unique_lock<boost::shared_mutex> lock(mutex_);
+	auto& info = templates_[name];
+	if (!info)
+	{
+		info.reset(new TemplateInfo(name));
+	}
+
+	return info.get();
+}
+
+void TemplateRegistry::SetObjectType(const TemplateInfo* info, uint32_t object_type)
+{
+	uint32_t unset = 0;
+	const_cast<TemplateInfo*>(info)->object_type_.compare_exchange_strong(unset, object_type);
+}
+
+void TemplateRegistry::SetSlotArrangements(const TemplateInfo* info, const ObjectArrangements& arrangements)
+{
+	if (info->HasSlotArrangements())
+	{
+		return;
+	}
+
+	// Filled in completely before the flag is set, readers go by the flag.
+	boost::unique_lock<boost::shared_mutex> lock(mutex_);
+	if (!info->has_slot_arrangements_.load(memory_order_relaxed))
+	{
+		auto record = const_cast<TemplateInfo*>(info);
+		record->slot_arrangements_ = arrangements;
+		record->has_slot_arrangements_.store(true, memory_order_release);
+	}
+}
+
+size_t TemplateRegistry::Size() const
+{
+	boost::shared_lock<boost::shared_mutex> lock(mutex_);
+	return templates_.size();
+}
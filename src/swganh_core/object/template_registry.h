@@ -0,0 +1,101 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#ifndef SWGANH_OBJECT_TEMPLATE_REGISTRY_H_
+#define SWGANH_OBJECT_TEMPLATE_REGISTRY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
+namespace swganh {
+namespace object {
+
+	typedef std::vector<std::vector<int32_t>> ObjectArrangements;
+
+	/**
+	 * Data shared by every object created from the same iff template.
+	 *
+	 * Records are owned by the TemplateRegistry and live for the lifetime of the
+	 * process, objects keep a plain pointer to theirs.
+	 */
+	class TemplateInfo : private boost::noncopyable
+	{
+	public:
+		explicit TemplateInfo(const std::string& name);
+
+		/// The iff template file name.
+		const std::string& GetName() const { return name_; }
+
+		/// The crc of the template name, as sent in SceneCreateObjectByCrc.
+		uint32_t GetCrc() const { return crc_; }
+
+		/// The type of the first object bound to this template, 0 if none was yet.
+		uint32_t GetObjectType() const { return object_type_.load(); }
+
+		/// True once the slot arrangements of the template have been loaded.
+		bool HasSlotArrangements() const { return has_slot_arrangements_.load(std::memory_order_acquire); }
+
+		/**
+		 * The slot arrangements of the template, empty until they are loaded. Safe
+		 * to call while another thread publishes them, they are only read once the
+		 * flag says they are complete.
+		 */
+		const ObjectArrangements& GetSlotArrangements() const;
+
+	private:
+		friend class TemplateRegistry;
+
+		std::string name_;
+		uint32_t crc_;
+		std::atomic<uint32_t> object_type_;
+		std::atomic<bool> has_slot_arrangements_;
+		ObjectArrangements slot_arrangements_;
+	};
+
+	/**
+	 * Interns object template names, keeping one TemplateInfo record per template
+	 * with the data that would otherwise be recomputed for every object.
+	 */
+	class TemplateRegistry : private boost::noncopyable
+	{
+	public:
+		static TemplateRegistry& getInstance();
+
+		/**
+		 * Returns the record for the given template, creating it if needed.
+		 * The returned pointer stays valid for the lifetime of the process.
+		 */
+		const TemplateInfo* Intern(const std::string& name);
+
+		/**
+		 * Records the object type of a template, only the first call has any effect.
+		 */
+		void SetObjectType(const TemplateInfo* info, uint32_t object_type);
+
+		/**
+		 * Publishes the slot arrangements of a template, only the first call has any
+		 * effect. Once published the arrangements are never modified again so they
+		 * can be read without locking.
+		 */
+		void SetSlotArrangements(const TemplateInfo* info, const ObjectArrangements& arrangements);
+
+		/// Returns the number of distinct templates registered.
+		size_t Size() const;
+
+	private:
+		TemplateRegistry();
+
+		mutable boost::shared_mutex mutex_;
+		std::unordered_map<std::string, std::unique_ptr<TemplateInfo>> templates_;
+	};
+
+}}  // namespace swganh::object
+
+#endif  // SWGANH_OBJECT_TEMPLATE_REGISTRY_H_
@@ -0,0 +1,84 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "swganh/crc.h"
+#include "swganh_core/object/template_registry.h"
+
+using namespace swganh::object;
+
+BOOST_AUTO_TEST_SUITE(TemplateRegistryTest)
+
+/// This test shows that interning the same template twice returns the same record.
+BOOST_AUTO_TEST_CASE(InterningIsIdempotent) {
+	auto& registry = TemplateRegistry::getInstance();
+	std::string name = "object/tangible/test/shared_template_registry_test.iff";
+
+	auto info = registry.Intern(name);
+	BOOST_CHECK(info == registry.Intern(name));
+	BOOST_CHECK_EQUAL(name, info->GetName());
+	BOOST_CHECK_EQUAL(swganh::memcrc(name), info->GetCrc());
+}
+
+/// This test shows that the object type and slot arrangements are only recorded once.
+BOOST_AUTO_TEST_CASE(FirstPublishedDataWins) {
+	auto& registry = TemplateRegistry::getInstance();
+	auto info = registry.Intern("object/tangible/test/shared_template_registry_slots.iff");
+
+	BOOST_CHECK_EQUAL(0u, info->GetObjectType());
+	BOOST_CHECK(!info->HasSlotArrangements());
+
+	registry.SetObjectType(info, 1);
+	registry.SetObjectType(info, 2);
+	BOOST_CHECK_EQUAL(1u, info->GetObjectType());
+
+	ObjectArrangements arrangements(1, std::vector<int32_t>(1, 4));
+	registry.SetSlotArrangements(info, arrangements);
+	registry.SetSlotArrangements(info, ObjectArrangements());
+
+	BOOST_CHECK(info->HasSlotArrangements());
+	BOOST_CHECK(arrangements == info->GetSlotArrangements());
+}
+
+/// This test shows that readers racing the first publish see either no arrangements
+/// or all of them, never a partly copied set.
+BOOST_AUTO_TEST_CASE(ArrangementsAreReadWhilePublished) {
+	auto& registry = TemplateRegistry::getInstance();
+	auto info = registry.Intern("object/tangible/test/shared_template_registry_race.iff");
+
+	ObjectArrangements arrangements(64, std::vector<int32_t>(4, 7));
+	std::atomic<bool> partial(false);
+	std::atomic<bool> published(false);
+
+	std::vector<std::thread> readers;
+	for (int i = 0; i < 4; ++i)
+	{
+		readers.emplace_back([&] () {
+			while (!published)
+			{
+				auto& seen = info->GetSlotArrangements();
+				if (!seen.empty() && seen != arrangements)
+				{
+					partial = true;
+				}
+			}
+		});
+	}
+
+	registry.SetSlotArrangements(info, arrangements);
+	published = true;
+	for (auto& reader : readers)
+	{
+		reader.join();
+	}
+
+	BOOST_CHECK(!partial);
+	BOOST_CHECK(arrangements == info->GetSlotArrangements());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,8 @@
 
 #include "swganh_core/object/waypoint/waypoint.h"
 
+#include "swganh/pool_allocator.h"
+
 #include "swganh/crc.h"
 
 using namespace std;
@@ -176,7 +178,7 @@ const std::string& Waypoint::GetColor()
 std::shared_ptr<Object> Waypoint::Clone()
 {
 	boost::lock_guard<boost::mutex> lock(object_mutex_);
-	auto other = std::make_shared<Waypoint>();
+	auto other = swganh::MakePooled<Waypoint>();
 	Clone(other);
 	return other;
 }
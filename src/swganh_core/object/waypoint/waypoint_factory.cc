@@ -3,6 +3,8 @@
 
 #include "waypoint_factory.h"
 
+#include "swganh/pool_allocator.h"
+
 #include <cppconn/exception.h>
 #include <cppconn/connection.h>
 #include <cppconn/resultset.h>
@@ -12,6 +14,7 @@
 #include "swganh/logger.h"
 
 #include "swganh/database/database_manager.h"
+#include "swganh_core/object/object_manager.h"
 #include "swganh_core/object/waypoint/waypoint.h"
 #include "swganh_core/object/player/player_events.h"
 #include "swganh_core/object/player/player.h"
@@ -38,23 +41,37 @@ void WaypointFactory::RegisterEventHandlers()
 }
 void WaypointFactory::PersistChangedObjects()
 {
-	std::set<shared_ptr<Object>> persisted;
-	{
-		boost::lock_guard<boost::mutex> lg(persisted_objects_mutex_);
-		persisted = move(persisted_objects_);
-	}
-	for (auto& object : persisted)
-	{
-		if(object->IsDatabasePersisted())
-			PersistObject(object);
-	}
+	PersistChangedTypeColumns();
+}
+void WaypointFactory::SnapshotTypeCalls(const shared_ptr<Object>& object, vector<ProcedureCall>& calls)
+{
+	auto waypoint = static_pointer_cast<Waypoint>(object);
+	ProcedureCall call(waypoint->GetObjectId(), "CALL sp_PersistWaypoint(?,?,?,?,?,?,?,?,?,?,?,?,?);", MERGE_LATEST);
+	call.AddDouble(waypoint->GetComplexity());
+	call.AddString(waypoint->GetStfNameFile());
+	call.AddString(waypoint->GetStfNameString());
+
+	auto custom_name = waypoint->GetCustomName();
+	call.AddString(string(begin(custom_name), end(custom_name)));
+
+	call.AddUInt(waypoint->GetVolume());
+
+	auto coords = waypoint->GetCoordinates();
+	call.AddDouble(coords.x);
+	call.AddDouble(coords.y);
+	call.AddDouble(coords.z);
+	call.AddUInt(waypoint->GetActiveFlag());
+	call.AddString(waypoint->GetPlanet());
+	call.AddString(waypoint->GetNameStandard());
+	call.AddString(waypoint->GetColor());
+	calls.push_back(move(call));
 }
 
 void WaypointFactory::LoadWaypoints(const shared_ptr<Player>& player, const shared_ptr<sql::ResultSet> result_set)
 {
     while (result_set->next())
     {
-        auto waypoint = make_shared<Waypoint>();
+        auto waypoint = swganh::MakePooled<Waypoint>();
         waypoint->SetObjectId(result_set->getUInt64("id"));
         waypoint->SetCoordinates( glm::vec3(
             result_set->getDouble("x_position"),
@@ -81,28 +98,13 @@ uint32_t WaypointFactory::PersistObject(const shared_ptr<Object>& object, bool p
     {
         try 
         {			
-            auto waypoint = static_pointer_cast<Waypoint>(object);
-            auto conn = GetDatabaseManager()->getConnection("galaxy");
-            auto statement = conn->prepareStatement("CALL sp_PersistWaypoint(?,?,?,?,?,?,?,?,?,?,?,?,?);");
-            statement->setDouble(counter++,waypoint->GetComplexity());
-            statement->setString(counter++, waypoint->GetStfNameFile());
-            statement->setString(counter++, waypoint->GetStfNameString());
-
-            auto custom_name = waypoint->GetCustomName();
-            statement->setString(counter++, string(begin(custom_name), end(custom_name)));
-
-            statement->setUInt(counter++, waypoint->GetVolume());
-
-            auto coords = waypoint->GetCoordinates();
-            statement->setDouble(counter++, coords.x);
-            statement->setDouble(counter++, coords.y);
-            statement->setDouble(counter++, coords.z);
-            statement->setUInt(counter++, waypoint->GetActiveFlag());
-            statement->setString(counter++, waypoint->GetPlanet());
-            statement->setString(counter++, waypoint->GetNameStandard());
-            statement->setString(counter++, waypoint->GetColor());
-            statement->execute();
-						
+            vector<ProcedureCall> calls;
+            WaypointFactory::SnapshotTypeCalls(object, calls);
+            for (auto& call : calls)
+            {
+                WriteProcedureCall(GetDatabaseManager(), call);
+                counter += call.parameters.size();
+            }
         }
             catch(sql::SQLException &e)
         {
@@ -120,7 +122,7 @@ void WaypointFactory::DeleteObjectFromStorage(const shared_ptr<Object>& object)
 
 shared_ptr<Object> WaypointFactory::CreateObjectFromStorage(uint64_t object_id)
 {
-    auto waypoint = make_shared<Waypoint>();
+    auto waypoint = swganh::MakePooled<Waypoint>();
     waypoint->SetObjectId(object_id);
     try{
         auto conn = GetDatabaseManager()->getConnection("galaxy");
@@ -156,5 +158,5 @@ shared_ptr<Object> WaypointFactory::CreateObjectFromStorage(uint64_t object_id)
 
 shared_ptr<Object> WaypointFactory::CreateObject()
 {
-	return make_shared<Waypoint>();
+	return swganh::MakePooled<Waypoint>();
 }
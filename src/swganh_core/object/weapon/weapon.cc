@@ -3,6 +3,8 @@
 
 #include "swganh_core/object/weapon/weapon.h"
 
+#include "swganh/pool_allocator.h"
+
 #include "swganh_core/messages/deltas_message.h"
 
 using namespace std;
@@ -21,7 +23,7 @@ uint32_t Weapon::GetType() const
 std::shared_ptr<Object> Weapon::Clone()
 {
 	boost::lock_guard<boost::mutex> lock(object_mutex_);
-	auto other = std::make_shared<Weapon>();
+	auto other = swganh::MakePooled<Weapon>();
 	Clone(other);
 	return other;
 }
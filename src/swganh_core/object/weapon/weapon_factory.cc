@@ -3,7 +3,12 @@
 
 #include "weapon_factory.h"
 
+#include <cppconn/resultset.h>
+
+#include "swganh/pool_allocator.h"
+
 #include "swganh_core/object/weapon/weapon.h"
+#include "swganh_core/object/object_manager.h"
 
 using namespace std;
 using namespace swganh::object;
@@ -14,20 +19,6 @@ WeaponFactory::WeaponFactory(swganh::app::SwganhKernel* kernel)
 {
 }
 
-void WeaponFactory::PersistChangedObjects()
-{
-	std::set<shared_ptr<Object>> persisted;
-	{
-		boost::lock_guard<boost::mutex> lg(persisted_objects_mutex_);
-		persisted = move(persisted_objects_);
-	}
-	for (auto& object : persisted)
-	{
-		if(object->IsDatabasePersisted())
-			PersistObject(object);
-	}
-}
-
 uint32_t WeaponFactory::PersistObject(const shared_ptr<Object>& object, bool persist_inherited)
 {
 	return TangibleFactory::PersistObject(object, persist_inherited);
@@ -40,7 +31,7 @@ void WeaponFactory::DeleteObjectFromStorage(const shared_ptr<Object>& object)
 
 shared_ptr<Object> WeaponFactory::CreateObjectFromStorage(uint64_t object_id)
 {
-	auto weapon = make_shared<Weapon>();
+	auto weapon = swganh::MakePooled<Weapon>();
 	weapon->SetObjectId(object_id);
 	TangibleFactory::CreateTangibleFromStorage(weapon);
 	return weapon;
@@ -48,5 +39,13 @@ shared_ptr<Object> WeaponFactory::CreateObjectFromStorage(uint64_t object_id)
 
 shared_ptr<Object> WeaponFactory::CreateObject()
 {
-    return make_shared<Weapon>();
+    return swganh::MakePooled<Weapon>();
+}
+
+shared_ptr<Object> WeaponFactory::CreateObjectFromRow(sql::ResultSet& row)
+{
+	auto weapon = swganh::MakePooled<Weapon>();
+	weapon->SetObjectId(row.getUInt64("object_id"));
+	TangibleFactory::CreateTangibleFromRow(weapon, row);
+	return weapon;
 }
@@ -17,12 +17,13 @@ namespace object {
 		 WeaponFactory(swganh::app::SwganhKernel* kernel);
 
         virtual uint32_t PersistObject(const std::shared_ptr<swganh::object::Object>& object, bool persist_inherited = false);
-		virtual void PersistChangedObjects();
         void DeleteObjectFromStorage(const std::shared_ptr<swganh::object::Object>& object);
 
         std::shared_ptr<swganh::object::Object> CreateObjectFromStorage(uint64_t object_id);
 
         std::shared_ptr<swganh::object::Object> CreateObject();
+
+        virtual std::shared_ptr<swganh::object::Object> CreateObjectFromRow(sql::ResultSet& row);
     };
 
 }}  // namespace swganh::object
@@ -48,6 +48,33 @@ void QuadtreeSpatialProvider::AddObject(std::shared_ptr<swganh::object::Object>
 	});
 }
 
+void QuadtreeSpatialProvider::BulkInsert(const std::vector<std::shared_ptr<Object>>& objects)
+{
+	boost::unique_lock<boost::shared_mutex> lock(global_container_lock_);
+	for (auto& object : objects)
+	{
+		root_node_.InsertObject(object);
+		object->SetContainer(__this);
+		object->SetArrangementId(-2);
+	}
+}
+
+void QuadtreeSpatialProvider::ResolveAwareness(const std::vector<std::shared_ptr<Object>>& objects)
+{
+	for (auto& object : objects)
+	{
+		// Lock per object so movement updates are not held off for the whole batch
+		boost::upgrade_lock<boost::shared_mutex> uplock(global_container_lock_);
+
+		CheckCollisions(object);
+
+		__InternalViewObjects(object, 0, true, [&](shared_ptr<Object> found_object){
+			found_object->__InternalAddAwareObject(object);
+			object->__InternalAddAwareObject(found_object);
+		});
+	}
+}
+
 void QuadtreeSpatialProvider::RemoveObject(std::shared_ptr<swganh::object::Object> requester,shared_ptr<Object> object)
 {
 	boost::upgrade_lock<boost::shared_mutex> uplock(global_container_lock_);
@@ -37,6 +37,9 @@ public:
 
 	virtual void ViewObjectsInRange(glm::vec3 position, float radius, uint32_t max_depth, bool topDown, std::function<void(std::shared_ptr<swganh::object::Object>)> func);
 
+	virtual void BulkInsert(const std::vector<std::shared_ptr<swganh::object::Object>>& objects);
+	virtual void ResolveAwareness(const std::vector<std::shared_ptr<swganh::object::Object>>& objects);
+
 	// FOR USE BY TRANSFER OBJECT DO NOT CALL IN OUTSIDE CODE
 	virtual int32_t __InternalInsert(std::shared_ptr<swganh::object::Object> object, int32_t arrangement_id=-2);
 	virtual void __InternalViewObjects(std::shared_ptr<swganh::object::Object> requester, uint32_t max_depth, bool topDown, std::function<void(std::shared_ptr<swganh::object::Object>)> func);
@@ -5,6 +5,8 @@
 
 #include <algorithm>
 
+#include <boost/thread/mutex.hpp>
+
 #include "swganh/plugin/plugin_manager.h"
 #include "swganh/observer/observer_interface.h"
 
@@ -31,6 +33,7 @@ public:
     SceneImpl(SceneDescription description, swganh::app::SwganhKernel* kernel)
         : kernel_(kernel)
         , description_(move(description))
+        , open_(false)
 		
     {
 		auto tmp = kernel_->GetPluginManager()->CreateObject<swganh::simulation::QuadtreeSpatialProvider>("Simulation::SpatialProvider");
@@ -63,6 +66,51 @@ public:
 		});
 		spatial_index_->AddObject(nullptr, object);
     }
+
+    void AddObjects(const vector<shared_ptr<Object>>& objects)
+    {
+		for (auto& object : objects)
+		{
+			InsertObject(object);
+			object->SetSceneId(description_.id);
+			object->ViewObjects(object, 1, true, [=] (shared_ptr<Object> contained){
+				if (contained->GetSceneId() != description_.id)
+					contained->SetSceneId(description_.id);
+			});
+		}
+
+		spatial_index_->BulkInsert(objects);
+
+		boost::lock_guard<boost::mutex> lock(open_mutex_);
+		if (open_)
+		{
+			spatial_index_->ResolveAwareness(objects);
+		}
+		else
+		{
+			deferred_awareness_.insert(deferred_awareness_.end(), objects.begin(), objects.end());
+		}
+    }
+
+    void Open()
+    {
+		boost::lock_guard<boost::mutex> lock(open_mutex_);
+		if (open_)
+		{
+			return;
+		}
+
+		spatial_index_->ResolveAwareness(deferred_awareness_);
+		deferred_awareness_.clear();
+		deferred_awareness_.shrink_to_fit();
+		open_ = true;
+    }
+
+    bool IsOpen()
+    {
+		boost::lock_guard<boost::mutex> lock(open_mutex_);
+		return open_;
+    }
     
     void RemoveObject(shared_ptr<Object> object)
     {
@@ -130,6 +178,9 @@ private:
 
     SceneDescription description_;
 
+	boost::mutex open_mutex_;
+	bool open_;
+	vector<shared_ptr<Object>> deferred_awareness_;
 };
 
 Scene::Scene(SceneDescription description, swganh::app::SwganhKernel* kernel)
@@ -177,6 +228,21 @@ void Scene::AddObject(std::shared_ptr<swganh::object::Object> object)
     impl_->AddObject(object);
 }
 
+void Scene::AddObjects(const std::vector<std::shared_ptr<swganh::object::Object>>& objects)
+{
+    impl_->AddObjects(objects);
+}
+
+void Scene::Open()
+{
+    impl_->Open();
+}
+
+bool Scene::IsOpen() const
+{
+    return impl_->IsOpen();
+}
+
 void Scene::RemoveObject(std::shared_ptr<swganh::object::Object> object)
 {
     impl_->RemoveObject(object);
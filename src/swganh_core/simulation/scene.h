@@ -44,6 +44,9 @@ namespace simulation {
 		const std::string& GetTerrainMap() const;
 
         void AddObject(std::shared_ptr<swganh::object::Object> object);
+        void AddObjects(const std::vector<std::shared_ptr<swganh::object::Object>>& objects);
+        void Open();
+        bool IsOpen() const;
         void RemoveObject(std::shared_ptr<swganh::object::Object> object);
 		virtual void ViewObjects(std::shared_ptr<swganh::object::Object> requester, uint32_t max_depth, 
 			bool topDown, std::function<void(std::shared_ptr<swganh::object::Object>)> func);
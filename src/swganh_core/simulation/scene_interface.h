@@ -8,6 +8,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
@@ -49,6 +50,20 @@ public:
 	virtual const std::string& GetTerrainMap() const =  0;
 
     virtual void AddObject(std::shared_ptr<swganh::object::Object> object) = 0;
+
+	/**
+	 * Adds a batch of objects. Until the scene is opened their awareness and
+	 * collision checks are deferred to Open.
+	 */
+	virtual void AddObjects(const std::vector<std::shared_ptr<swganh::object::Object>>& objects) = 0;
+
+	/**
+	 * Resolves the awareness of everything added through AddObjects while loading,
+	 * later batches are resolved as they are added.
+	 */
+	virtual void Open() = 0;
+
+	virtual bool IsOpen() const = 0;
         
 	virtual void RemoveObject(std::shared_ptr<swganh::object::Object> object) = 0;
 		
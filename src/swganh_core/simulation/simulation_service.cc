@@ -3,11 +3,18 @@
 
 #include "simulation_service.h"
 
+#include <chrono>
+#include <set>
+
 #include <boost/algorithm/string.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/thread/mutex.hpp>
 
 #include "swganh/byte_buffer.h"
 #include "swganh/crc.h"
 #include "swganh/event_dispatcher.h"
+#include "swganh/latency_histogram.h"
+#include "swganh/logger.h"
 #include "swganh/service/service_manager.h"
 #include "swganh/database/database_manager.h"
 #include "swganh/network/soe/server_interface.h"
@@ -23,6 +30,7 @@
 #include "swganh_core/connection/connection_client_interface.h"
 #include "swganh_core/connection/connection_service_interface.h"
 
+#include "swganh_core/messages/error_message.h"
 #include "swganh_core/messages/select_character.h"
 
 #include "swganh_core/player/player_service_interface.h"
@@ -77,6 +85,7 @@ class SimulationServiceImpl {
 public:
     SimulationServiceImpl(SwganhKernel* kernel)
         : kernel_(kernel)
+        , strand_(kernel->GetIoService())
     {			
     }
 
@@ -150,6 +159,24 @@ public:
 			scene->AddObject(object);
         }		
 	}	
+
+	void AddObjectsToScene(const std::vector<std::shared_ptr<swganh::object::Object>>& objects, const std::string& scene_label)
+	{
+		auto scene = scene_manager_->GetScene(scene_label);
+		if (scene)
+		{
+			scene->AddObjects(objects);
+		}
+	}
+
+	void OpenScene(const std::string& scene_label)
+	{
+		auto scene = scene_manager_->GetScene(scene_label);
+		if (scene)
+		{
+			scene->Open();
+		}
+	}
 	
     void PersistObject(uint64_t object_id, bool persist_inherited)
     {
@@ -369,61 +396,68 @@ public:
         const shared_ptr<ConnectionClientInterface>& client,
         SelectCharacter* message)
     {
-        auto object = LoadObjectById(message->character_id, Creature::type);        
+        auto select_time = chrono::steady_clock::now();
+        uint64_t character_id = message->character_id;
 
-        auto event_dispatcher = kernel_->GetEventDispatcher();
-		auto player = GetEquipmentService()->GetEquippedObject<Player>(object, "ghost");
-		
-		//Should be done on this thread to avoid issues with interleaving
-		auto player_service = kernel_->GetServiceManager()->GetService<PlayerServiceInterface>("PlayerService");
-		player_service->OnPlayerEnter(player);
-
-        auto scene = scene_manager_->GetScene(object->GetSceneId());
-        if (!scene)
+        // The client resends SelectCharacter while it waits, only the first one
+        // loads the character and enters the scene.
+        auto controller = client->GetController();
+        if (controller && controller->GetId() == character_id)
         {
-            throw std::runtime_error("Invalid scene selected for object");
+            DLOG(info) << "Ignoring SelectCharacter, character " << character_id << " is already in the scene";
+            return;
         }
 
-		// CmdStartScene
-        CmdStartScene start_scene;
-        start_scene.ignore_layout = 0;
-        start_scene.character_id = object->GetObjectId();
-
-        start_scene.terrain_map = scene->GetTerrainMap();
-        start_scene.position = object->GetPosition();
-        start_scene.shared_race_template = object->GetTemplate();
-        start_scene.galaxy_time = 0;
-        client->SendTo(start_scene);
-
-		object->SetCollidable(false);
-
-		if(object->GetContainer() == nullptr)
-		{
-			scene->AddObject(object);
-		}
+        {
+            boost::lock_guard<boost::mutex> lock(pending_selects_mutex_);
+            if (!pending_selects_.insert(character_id).second)
+            {
+                DLOG(info) << "Ignoring SelectCharacter, character " << character_id << " is already being selected";
+                return;
+            }
+        }
 
-		//Attach the controller
-		StartControllingObject(object, client);
+        // A reconnecting player is still loaded, there is nothing to fetch.
+        auto object = object_manager_->GetObjectById(character_id);
+        if (object)
+        {
+            strand_.post([this, client, object, select_time] () {
+                CompleteSelect_(client, object, select_time);
+            });
+            return;
+        }
 
-		//Make sure the controller gets his awareness creates
-		//regardless of the current state of awareness.
-		auto controller = object->GetController();
-		scene->ViewObjects(object, 0, true, [&] (std::shared_ptr<swganh::object::Object> aware) {
-			if(aware->__HasAwareObject(object) && !aware->IsInSnapshot())
-			{
-				//Send create manually
-				aware->Subscribe(controller);
-				aware->SendCreateByCrc(controller);
-				aware->CreateBaselines(controller);
-			}
-			else
-			{
-				aware->AddAwareObject(object);
-				object->AddAwareObject(aware);
-			}
-		});
+        // Loading walks the character's multi-result sets and its whole inventory,
+        // keep that off the network threads.
+        kernel_->GetDatabaseManager()->ExecuteAsync([this, client, character_id, select_time] () {
+            shared_ptr<Object> object;
+            try
+            {
+                object = object_manager_->LoadObjectById(character_id, Creature::type);
+            }
+            catch (std::exception& e)
+            {
+                LOG(error) << "Failed to load character " << character_id << ": " << e.what();
+            }
+
+            if (!object)
+            {
+                LOG(error) << "Character " << character_id << " could not be loaded";
+                strand_.post([this, client, character_id] () {
+                    FailSelect_(client, character_id);
+                });
+                return;
+            }
+
+            strand_.post([this, client, object, select_time] () {
+                CompleteSelect_(client, object, select_time);
+            });
+        });
+    }
 
-		object->SetCollidable(true);
+    const LatencyHistogram& GetZoneInLatency() const
+    {
+        return zone_in_latency_;
     }
 
 	void SendToAll(swganh::messages::BaseSwgMessage* message)
@@ -474,6 +508,113 @@ public:
 	}
 
 private:
+    void CompleteSelect_(const shared_ptr<ConnectionClientInterface>& client, const shared_ptr<Object>& object,
+        chrono::steady_clock::time_point select_time)
+    {
+        if (!EnterScene_(client, object, select_time))
+        {
+            FailSelect_(client, object->GetObjectId());
+            return;
+        }
+
+        boost::lock_guard<boost::mutex> lock(pending_selects_mutex_);
+        pending_selects_.erase(object->GetObjectId());
+    }
+
+    /**
+     * Tells the client its character can not enter the scene and drops the session,
+     * otherwise it would wait on a CmdStartScene that never comes.
+     */
+    void FailSelect_(const shared_ptr<ConnectionClientInterface>& client, uint64_t character_id)
+    {
+        {
+            boost::lock_guard<boost::mutex> lock(pending_selects_mutex_);
+            pending_selects_.erase(character_id);
+        }
+
+        ErrorMessage error;
+        error.type = "Zone In Failed";
+        error.message = "Your character could not be loaded, please try again later.";
+        error.force_fatal = false;
+        client->SendTo(error);
+
+        client->Close();
+    }
+
+    /**
+     * Second half of a zone-in, run on the simulation strand once the character
+     * has been loaded.
+     *
+     * @return false if the character has no scene to enter.
+     */
+    bool EnterScene_(const shared_ptr<ConnectionClientInterface>& client, const shared_ptr<Object>& object,
+        chrono::steady_clock::time_point select_time)
+    {
+        auto scene = scene_manager_->GetScene(object->GetSceneId());
+        if (!scene)
+        {
+            LOG(error) << "Invalid scene selected for object " << object->GetObjectId();
+            return false;
+        }
+
+        auto player = GetEquipmentService()->GetEquippedObject<Player>(object, "ghost");
+		
+		//Should be done on this thread to avoid issues with interleaving
+		auto player_service = kernel_->GetServiceManager()->GetService<PlayerServiceInterface>("PlayerService");
+		player_service->OnPlayerEnter(player);
+
+		// CmdStartScene
+        CmdStartScene start_scene;
+        start_scene.ignore_layout = 0;
+        start_scene.character_id = object->GetObjectId();
+
+        start_scene.terrain_map = scene->GetTerrainMap();
+        start_scene.position = object->GetPosition();
+        start_scene.shared_race_template = object->GetTemplate();
+        start_scene.galaxy_time = 0;
+        client->SendTo(start_scene);
+
+        auto latency = chrono::steady_clock::now() - select_time;
+        zone_in_latency_.Record(latency);
+        DLOG(info) << "Character " << object->GetObjectId() << " selected to CmdStartScene in "
+            << chrono::duration_cast<chrono::milliseconds>(latency).count() << "ms";
+        if (zone_in_latency_.Count() % 50 == 0)
+        {
+            LOG(info) << "Zone-in latency " << zone_in_latency_.ToString();
+        }
+
+		object->SetCollidable(false);
+
+		if(object->GetContainer() == nullptr)
+		{
+			scene->AddObject(object);
+		}
+
+		//Attach the controller
+		StartControllingObject(object, client);
+
+		//Make sure the controller gets his awareness creates
+		//regardless of the current state of awareness.
+		auto controller = object->GetController();
+		scene->ViewObjects(object, 0, true, [&] (std::shared_ptr<swganh::object::Object> aware) {
+			if(aware->__HasAwareObject(object) && !aware->IsInSnapshot())
+			{
+				//Send create manually
+				aware->Subscribe(controller);
+				aware->SendCreateByCrc(controller);
+				aware->CreateBaselines(controller);
+			}
+			else
+			{
+				aware->AddAwareObject(object);
+				object->AddAwareObject(aware);
+			}
+		});
+
+		object->SetCollidable(true);
+        return true;
+    }
+
     shared_ptr<ObjectManager> object_manager_;
     shared_ptr<SceneManagerInterface> scene_manager_;
     shared_ptr<MovementManagerInterface> movement_manager_;
@@ -485,6 +626,14 @@ private:
 
     Concurrency::concurrent_unordered_map<uint64_t, shared_ptr<ObjectController>> controlled_objects_;
 	Concurrency::concurrent_unordered_map<uint64_t, shared_ptr<boost::asio::deadline_timer>> delayed_update_;
+
+	// serializes zone-in attaches that complete on the database workers
+	boost::asio::strand strand_;
+	LatencyHistogram zone_in_latency_;
+
+    // characters between SelectCharacter and CmdStartScene
+    boost::mutex pending_selects_mutex_;
+    std::set<uint64_t> pending_selects_;
 };
 
 }}  // namespace swganh::simulation
@@ -645,6 +794,21 @@ void SimulationService::AddObjectToScene(std::shared_ptr<swganh::object::Object>
 	impl_->AddObjectToScene(object, scene_label);
 }
 
+void SimulationService::AddObjectsToScene(const std::vector<std::shared_ptr<swganh::object::Object>>& objects, const std::string& scene_label)
+{
+	impl_->AddObjectsToScene(objects, scene_label);
+}
+
+void SimulationService::OpenScene(const std::string& scene_label)
+{
+	impl_->OpenScene(scene_label);
+}
+
+const LatencyHistogram& SimulationService::GetZoneInLatency() const
+{
+	return impl_->GetZoneInLatency();
+}
+
 std::set<std::pair<float, std::shared_ptr<swganh::object::Object>>> SimulationService::FindObjectsInRangeByTag(const std::shared_ptr<swganh::object::Object> requester, const std::string& tag, float range)
 {
 	return impl_->FindObjectsInRangeByTag(requester, tag, range);
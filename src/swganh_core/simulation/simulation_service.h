@@ -5,6 +5,8 @@
 #include "swganh_core/simulation/simulation_service_interface.h"
 
 namespace swganh {
+	class LatencyHistogram;
+
 namespace object {
 	class ObjectManager;
 }
@@ -29,6 +31,11 @@ namespace simulation {
 
 		std::set<std::pair<float, std::shared_ptr<swganh::object::Object>>> FindObjectsInRangeByTag(const std::shared_ptr<swganh::object::Object> requester, const std::string& tag, float range=-1);
 
+		/**
+		 * Time from a client selecting a character to CmdStartScene being sent.
+		 */
+		const swganh::LatencyHistogram& GetZoneInLatency() const;
+
 		bool SceneExists(const std::string& scene_label);
 		bool SceneExists(uint32_t scene_id);
 
@@ -41,6 +48,8 @@ namespace simulation {
 		void PersistRelatedObjects(uint64_t parent_object_id, bool persist_inherited = false);
 
 		void AddObjectToScene(std::shared_ptr<swganh::object::Object> object, const std::string& scene_label);
+		void AddObjectsToScene(const std::vector<std::shared_ptr<swganh::object::Object>>& objects, const std::string& scene_label);
+		void OpenScene(const std::string& scene_label);
         
         std::shared_ptr<swganh::object::Object> LoadObjectById(uint64_t object_id);
         std::shared_ptr<swganh::object::Object> LoadObjectById(uint64_t object_id, uint32_t type);
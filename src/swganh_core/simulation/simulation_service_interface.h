@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <vector>
 
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
@@ -64,6 +65,16 @@ namespace simulation {
 
 		virtual void AddObjectToScene(std::shared_ptr<swganh::object::Object> object, const std::string& scene_label) = 0;
 
+		/*
+		*	\brief adds a batch of objects to a scene, awareness is deferred until the scene is opened
+		*/
+		virtual void AddObjectsToScene(const std::vector<std::shared_ptr<swganh::object::Object>>& objects, const std::string& scene_label) = 0;
+
+		/*
+		*	\brief resolves the awareness of everything added while the scene was loading
+		*/
+		virtual void OpenScene(const std::string& scene_label) = 0;
+
         virtual void RegisterObjectFactories() = 0;
 
         virtual void PersistObject(uint64_t object_id, bool persist_inherited = false) = 0;
@@ -4,6 +4,7 @@
 
 #include <list>
 #include <memory>
+#include <vector>
 #include <glm/glm.hpp>
 
 #include "swganh_core/object/container_interface.h"
@@ -24,6 +25,18 @@ public:
 	virtual void ViewObjectsInRange(glm::vec3 position, float radius, uint32_t max_depth, bool topDown, std::function<void(std::shared_ptr<swganh::object::Object>)> func) = 0;
 	virtual std::list<std::shared_ptr<swganh::object::Object>> Query(boost::geometry::model::polygon<swganh::object::Point> query_box) = 0;
 	virtual std::set<std::pair<float, std::shared_ptr<swganh::object::Object>>> FindObjectsInRangeByTag(const std::shared_ptr<swganh::object::Object> requester, const std::string& tag, float range=-1)=0;
+
+	/**
+	 * Inserts a batch of objects under a single lock without collision or awareness
+	 * checks. ResolveAwareness has to be called for the batch before it is visible
+	 * to anything already in the index.
+	 */
+	virtual void BulkInsert(const std::vector<std::shared_ptr<swganh::object::Object>>& objects) = 0;
+
+	/**
+	 * Runs the collision and awareness checks that BulkInsert skipped.
+	 */
+	virtual void ResolveAwareness(const std::vector<std::shared_ptr<swganh::object::Object>>& objects) = 0;
 };
 
 }} // namespace swganh::simulation
@@ -10,6 +10,15 @@
 using namespace swganh;
 using namespace swganh::spawn;
 
+namespace {
+	// a function local static is initialized on first use, not in static initialization order
+	uint32_t FsmNameAttribute()
+	{
+		static const uint32_t fsm_name_attribute = swganh::StringInterner::Hash("fsm_name");
+		return fsm_name_attribute;
+	}
+}
+
 FsmManager::FsmManager(EventDispatcher* event_dispatch)
 	: dispatch_(event_dispatch)
 {
@@ -54,7 +63,13 @@ void FsmManager::StartManagingObject(std::shared_ptr<swganh::object::Object> obj
 
 void FsmManager::StopManagingObject(std::shared_ptr<swganh::object::Object> object)
 {
-	std::wstring machine_name = object->GetAttribute<std::wstring>("fsm_name");
+	auto fsm_name = object->GetAttribute(FsmNameAttribute());
+	if(fsm_name.which() != 2)
+	{
+		return;
+	}
+
+	const std::wstring& machine_name = boost::get<std::wstring>(fsm_name);
 	boost::shared_lock<boost::shared_mutex> lock(mutex_);
 	auto find_itr = machines_.find(machine_name);
 	if(find_itr != machines_.end())
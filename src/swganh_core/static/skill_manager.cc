@@ -130,14 +130,22 @@ SkillModsMap SkillManager::GetSkillMods(const std::shared_ptr<Creature>& creatur
 		}
 	}
 
+	//Hash the mod names once rather than once per equipped child
+	std::vector<std::pair<uint32_t, std::pair<uint32_t, uint32_t>*>> mod_ids;
+	mod_ids.reserve(result.size());
+	for(auto& mod : result)
+	{
+		mod_ids.push_back(std::make_pair(swganh::StringInterner::Hash(mod.first), &mod.second));
+	}
+
 	//Add the mod values
 	creature->ViewObjects(creature, 1, true, [&] (std::shared_ptr<Object> child) {
-		for(auto& mod : result)
+		for(auto& mod : mod_ids)
 		{
 			auto modifier = child->GetAttributeRecursive(mod.first);
 			if(modifier.which() == 1)
 			{
-				mod.second.second += boost::get<int32_t>(modifier);
+				mod.second->second += boost::get<int32_t>(modifier);
 			}
 		}
 	});
@@ -5,8 +5,13 @@
 
 #include "swganh/event_dispatcher.h"
 
+#include <algorithm>
 #include <memory>
 #include <exception>
+#include <sstream>
+#include <thread>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
 
 #include "swganh/logger.h"
 
@@ -19,6 +24,7 @@
 #include <cppconn/sqlstring.h>
 
 #include "swganh/service/service_manager.h"
+#include "swganh/tre/resource_manager.h"
 #include "swganh_core/object/permissions/permission_type.h"
 
 #include "swganh_core/simulation/simulation_service_interface.h"
@@ -30,6 +36,8 @@
 #include "swganh_core/object/creature/creature.h"
 #include "swganh_core/object/tangible/tangible.h"
 
+#include "swganh_core/static/static_snapshot.h"
+
 using namespace swganh::object;
 using namespace swganh::statics;
 using namespace swganh::service;
@@ -37,6 +45,258 @@ using namespace swganh::app;
 using namespace swganh::simulation;
 using namespace swganh::spawn;
 
+namespace {
+
+	/**
+	 * Times each phase of loading a scene's static objects.
+	 */
+	class StaticLoadReport
+	{
+	public:
+		explicit StaticLoadReport(std::string scene_label)
+			: scene_label_(std::move(scene_label))
+			, started_(boost::posix_time::microsec_clock::local_time())
+			, phase_started_(started_)
+			, rows_(0)
+		{}
+
+		void EndPhase(const std::string& phase, uint32_t rows)
+		{
+			auto now = boost::posix_time::microsec_clock::local_time();
+
+			if (phases_.tellp() > 0)
+			{
+				phases_ << ", ";
+			}
+			phases_ << phase << " " << (now - phase_started_).total_milliseconds() << "ms";
+			if (rows > 0)
+			{
+				phases_ << " (" << rows << ")";
+			}
+
+			rows_ += rows;
+			phase_started_ = now;
+		}
+
+		std::string ToString() const
+		{
+			std::stringstream ss;
+			ss << "Static load for " << scene_label_ << ": " << rows_ << " rows in "
+				<< (phase_started_ - started_).total_milliseconds() << "ms [" << phases_.str() << "]";
+			return ss.str();
+		}
+
+	private:
+		std::string scene_label_;
+		boost::posix_time::ptime started_;
+		boost::posix_time::ptime phase_started_;
+		std::stringstream phases_;
+		uint32_t rows_;
+	};
+
+	glm::quat ReadOrientation(sql::ResultSet& result, uint32_t w, uint32_t x, uint32_t y, uint32_t z)
+	{
+		return glm::quat(
+			static_cast<float>(result.getDouble(w)),
+			static_cast<float>(result.getDouble(x)),
+			static_cast<float>(result.getDouble(y)),
+			static_cast<float>(result.getDouble(z)));
+	}
+
+	glm::vec3 ReadPosition(sql::ResultSet& result, uint32_t x)
+	{
+		return glm::vec3(result.getDouble(x), result.getDouble(x+1), result.getDouble(x+2));
+	}
+
+	void ReadBuildings(sql::ResultSet& result, std::vector<StaticObjectRow>& rows)
+	{
+		while(result.next())
+		{
+			StaticObjectRow row = StaticObjectRow();
+			row.object_id = result.getInt64(1);
+			row.orientation = ReadOrientation(result, 5, 2, 3, 4);
+			row.position = ReadPosition(result, 6);
+			row.template_name = result.getString(9).asStdString();
+			row.stf_file = result.getString(12).asStdString();
+			row.stf_name = result.getString(13).asStdString();
+			rows.push_back(std::move(row));
+		}
+	}
+
+	void ReadCells(sql::ResultSet& result, std::vector<StaticObjectRow>& rows)
+	{
+		while(result.next())
+		{
+			StaticObjectRow row = StaticObjectRow();
+			row.object_id = result.getInt64(1);
+			row.parent_id = result.getInt64(2);
+			rows.push_back(std::move(row));
+		}
+	}
+
+	void ReadTerminals(sql::ResultSet& result, std::vector<StaticObjectRow>& rows)
+	{
+		while(result.next())
+		{
+			StaticObjectRow row = StaticObjectRow();
+			row.object_id = result.getInt64(1);
+			row.parent_id = result.getUInt64(2);
+			row.orientation = ReadOrientation(result, 6, 3, 4, 5);
+			row.position = ReadPosition(result, 7);
+			row.template_name = result.getString(11).asStdString();
+			row.stf_file = result.getString(13).asStdString();
+			row.stf_name = result.getString(12).asStdString();
+			row.data = result.getString(14).asStdString();
+			row.custom_name = result.getString(16).asStdString();
+			rows.push_back(std::move(row));
+		}
+	}
+
+	void ReadElevators(sql::ResultSet& result, std::vector<StaticElevatorRow>& rows)
+	{
+		while(result.next())
+		{
+			StaticElevatorRow row = StaticElevatorRow();
+			row.terminal_id = result.getUInt64(1);
+			row.dst_cell = result.getUInt64(2);
+			row.dst_orientation = ReadOrientation(result, 6, 3, 4, 5);
+			row.dst_position = ReadPosition(result, 7);
+			row.effect_id = result.getUInt(10);
+			row.going_down = result.getUInt(11) != 0;
+			rows.push_back(std::move(row));
+		}
+	}
+
+	void ReadTicketCollectors(sql::ResultSet& result, std::vector<StaticObjectRow>& rows)
+	{
+		while(result.next())
+		{
+			StaticObjectRow row = StaticObjectRow();
+			row.object_id = result.getInt64(1);
+			row.parent_id = result.getUInt64(2);
+			row.template_name = result.getString(3).asStdString();
+			row.orientation = ReadOrientation(result, 7, 4, 5, 6);
+			row.position = ReadPosition(result, 8);
+			row.stf_file = result.getString(13).asStdString();
+			row.stf_name = result.getString(12).asStdString();
+			row.data = result.getString(14).asStdString();
+			rows.push_back(std::move(row));
+		}
+	}
+
+	void ReadNPCS(sql::ResultSet& result, std::vector<StaticObjectRow>& rows)
+	{
+		while(result.next())
+		{
+			StaticObjectRow row = StaticObjectRow();
+			row.object_id = result.getUInt64(1);
+			row.parent_id = result.getUInt64(2);
+
+			std::string firstname = result.getString(3).asStdString(), lastname = result.getString(4).asStdString();
+			if(firstname.size() != 0)
+				row.custom_name = firstname + " " + lastname;
+
+			row.posture = result.getUInt(5);
+			row.state_bitmask = result.getUInt(6);
+			row.combat_level = result.getUInt(7);
+			row.orientation = ReadOrientation(result, 11, 8, 9, 10);
+			row.position = ReadPosition(result, 12);
+			row.template_name = result.getString(15).asStdString();
+			row.stf_file = result.getString(17).asStdString();
+			row.stf_name = result.getString(16).asStdString();
+			row.mood_id = result.getUInt(19);
+			row.npc_type = result.getUInt(20);
+			row.scale = static_cast<float>(result.getDouble(21));
+			rows.push_back(std::move(row));
+		}
+	}
+
+	void ReadShuttles(sql::ResultSet& result, std::vector<StaticObjectRow>& rows)
+	{
+		while(result.next())
+		{
+			StaticObjectRow row = StaticObjectRow();
+			row.object_id = result.getInt64(1);
+			row.parent_id = result.getUInt64(2);
+			row.orientation = ReadOrientation(result, 8, 5, 6, 7);
+			row.position = ReadPosition(result, 9);
+			row.template_name = result.getString(12).asStdString();
+			row.stf_file = result.getString(14).asStdString();
+			row.stf_name = result.getString(13).asStdString();
+			rows.push_back(std::move(row));
+		}
+	}
+
+	void ReadCloneLocations(sql::ResultSet& result, std::vector<StaticCloneLocationRow>& rows)
+	{
+		while(result.next())
+		{
+			StaticCloneLocationRow row = StaticCloneLocationRow();
+			row.cell_id = result.getUInt64(1);
+			row.orientation = ReadOrientation(result, 5, 2, 3, 4);
+			row.position = ReadPosition(result, 6);
+			row.city = result.getString(9).asStdString();
+			rows.push_back(std::move(row));
+		}
+	}
+
+	void ReadContainers(sql::ResultSet& result, std::vector<StaticObjectRow>& rows)
+	{
+		// Only the ids are returned, the rows are kept for the snapshot
+		while(result.next())
+		{
+			StaticObjectRow row = StaticObjectRow();
+			row.object_id = result.getUInt64(1);
+			rows.push_back(std::move(row));
+		}
+	}
+
+	/**
+	 * Reads the result sets of sp_GetStaticObjects in the order the procedure
+	 * returns them.
+	 */
+	void ReadSceneData(sql::Statement& statement, StaticSceneData& data)
+	{
+		std::unique_ptr<sql::ResultSet> result(statement.getResultSet());
+		ReadBuildings(*result, data.buildings);
+
+		statement.getMoreResults();
+		result.reset(statement.getResultSet());
+		ReadCells(*result, data.cells);
+
+		statement.getMoreResults();
+		result.reset(statement.getResultSet());
+		ReadCloneLocations(*result, data.clone_locations);
+
+		statement.getMoreResults();
+		result.reset(statement.getResultSet());
+		ReadTerminals(*result, data.terminals);
+
+		statement.getMoreResults();
+		result.reset(statement.getResultSet());
+		ReadElevators(*result, data.elevators);
+
+		statement.getMoreResults();
+		result.reset(statement.getResultSet());
+		ReadContainers(*result, data.containers);
+
+		statement.getMoreResults();
+		result.reset(statement.getResultSet());
+		ReadTicketCollectors(*result, data.ticket_collectors);
+
+		statement.getMoreResults();
+		result.reset(statement.getResultSet());
+		ReadNPCS(*result, data.npcs);
+
+		statement.getMoreResults();
+		result.reset(statement.getResultSet());
+		ReadShuttles(*result, data.shuttles);
+
+		while(statement.getMoreResults());
+	}
+
+}
+
 enum PERSISTENT_NPC_TYPE
 {
 	TRAINER = 1,
@@ -49,89 +309,136 @@ enum PERSISTENT_NPC_TYPE
 
 StaticService::StaticService(SwganhKernel* kernel)
 	: kernel_(kernel)
-    , active_(kernel->GetIoService())
+	, load_pool_(std::min(8u, std::max(2u, std::thread::hardware_concurrency())))
+	, tre_fingerprint_(0)
 {
+	auto& snapshot_directory = kernel_->GetAppConfig().static_snapshot_directory;
+	if (!snapshot_directory.empty())
+	{
+		snapshot_.reset(new StaticSnapshot(snapshot_directory));
+		tre_fingerprint_ = StaticSnapshot::FingerprintFiles(kernel_->GetResourceManager()->GetArchive()->GetTreFilenames());
+	}
+
 	//Static Objects
 	kernel_->GetEventDispatcher()->Subscribe("SceneManager:NewScene", [&] (const std::shared_ptr<swganh::EventInterface>& newEvent)
 	{
-        active_.Async([=] () {
-            auto real_event = std::static_pointer_cast<swganh::simulation::NewSceneEvent>(newEvent);
-            
-            auto database_manager = kernel_->GetDatabaseManager();
-            auto conn = database_manager->getConnection("swganh_static");
-            
-            auto simulation_service = kernel_->GetServiceManager()->GetService<SimulationServiceInterface>("SimulationService");
-            auto spawn_service = kernel_->GetServiceManager()->GetService<SpawnServiceInterface>("SpawnService");
-            
-            try {
-            	std::stringstream ss;
-            	ss << "CALL sp_GetStaticObjects(0," << real_event->scene_id-1 << ");";
-            
-            	auto statement = std::shared_ptr<sql::Statement>(conn->createStatement());
-            	statement->execute(ss.str());
-            
-            	std::unique_ptr<sql::ResultSet> result;
-            
-            	LOG(warning) << "Loading static data for: " << real_event->scene_label;
-            	_loadBuildings(simulation_service, std::unique_ptr<sql::ResultSet>(statement->getResultSet()), 
-            		real_event->scene_id, real_event->scene_label);
-            
-            	statement->getMoreResults();
-            	_loadCells(simulation_service, std::unique_ptr<sql::ResultSet>(statement->getResultSet()), 
-            		real_event->scene_id, real_event->scene_label);
-            
-            	statement->getMoreResults();
-            	_loadCloneLocations(simulation_service, std::unique_ptr<sql::ResultSet>(statement->getResultSet()), 
-            		real_event->scene_id, real_event->scene_label);
-            
-            	statement->getMoreResults();
-            	_loadTerminals(simulation_service, std::unique_ptr<sql::ResultSet>(statement->getResultSet()),
-            		real_event->scene_id, real_event->scene_label);
-            
-            	statement->getMoreResults();
-            	_loadElevatorData(simulation_service, std::unique_ptr<sql::ResultSet>(statement->getResultSet()), 
-            		real_event->scene_id, real_event->scene_label);
-            
-            	statement->getMoreResults();
-            	_loadContainers(simulation_service, std::unique_ptr<sql::ResultSet>(statement->getResultSet()), 
-            		real_event->scene_id, real_event->scene_label);
-            
-            	statement->getMoreResults();
-            	_loadTicketCollectors(simulation_service, std::unique_ptr<sql::ResultSet>(statement->getResultSet()),
-            		real_event->scene_id, real_event->scene_label);
-            
-                statement->getMoreResults();
-                _loadNPCS(simulation_service, spawn_service,  std::unique_ptr<sql::ResultSet>(statement->getResultSet()), 
-                    real_event->scene_id, real_event->scene_label);
-                
-                statement->getMoreResults();
-                _loadShuttles(simulation_service, spawn_service, std::unique_ptr<sql::ResultSet>(statement->getResultSet()),
-            	real_event->scene_id, real_event->scene_label);
-            
-            } catch(std::exception& e) {
-            	LOG(warning) << e.what();
-            }
-            if (real_event->scene_id-1 == 0)
-            {
-            	// Create a combat dummy
-            	auto simulation_service = kernel_->GetServiceManager()->GetService<SimulationServiceInterface>("SimulationService");
-            	auto combat_dummy = simulation_service->CreateObjectFromTemplate("object/mobile/shared_r2d2.iff", CREATURE_PERMISSION, false, true);
-            	if (combat_dummy)
-            	{
-            		auto creature_dummy = std::static_pointer_cast<Creature>(combat_dummy);
-            		creature_dummy->SetCustomName(L"R2 D2 Combat Trainer");
-            		creature_dummy->SetPvPStatus(PvPStatus_Attackable);
-            		creature_dummy->SetAllStats(50000);
-            		creature_dummy->SetPosition(glm::vec3(-146.0f, 28.0f, -4702.0f));
-            		creature_dummy->SetOrientation(glm::quat(0.0f, 1.0f, 0.0f, -0.0016f));
-            		creature_dummy->SetScale(3);
-            		simulation_service->AddObjectToScene(combat_dummy, "corellia");
-            	}
-            }
-        });
+		auto real_event = std::static_pointer_cast<swganh::simulation::NewSceneEvent>(newEvent);
+		uint32_t scene_id = real_event->scene_id;
+		std::string scene_label = real_event->scene_label;
+
+		load_pool_.Schedule([this, scene_id, scene_label] () {
+			LoadScene_(scene_id, scene_label);
+		});
 	});
 }
 
+void StaticService::LoadScene_(uint32_t scene_id, std::string scene_label)
+{
+	auto database_manager = kernel_->GetDatabaseManager();
+	auto simulation_service = kernel_->GetServiceManager()->GetService<SimulationServiceInterface>("SimulationService");
+	auto spawn_service = kernel_->GetServiceManager()->GetService<SpawnServiceInterface>("SpawnService");
+
+	StaticLoadReport report(scene_label);
+
+	try {
+		StaticSceneData data;
+		StaticSnapshotKey snapshot_key;
+		bool use_snapshot = false;
+		bool from_snapshot = false;
+
+		{
+			auto conn = database_manager->getConnection("swganh_static");
+
+			use_snapshot = snapshot_ && GetSnapshotKey_(conn, snapshot_key);
+			if (use_snapshot && snapshot_->Load(scene_id, snapshot_key, data))
+			{
+				from_snapshot = true;
+				report.EndPhase("snapshot", 0);
+			}
+			else
+			{
+				std::stringstream ss;
+				ss << "CALL sp_GetStaticObjects(0," << scene_id-1 << ");";
+
+				auto statement = std::shared_ptr<sql::Statement>(conn->createStatement());
+				statement->execute(ss.str());
+				report.EndPhase("query", 0);
+
+				ReadSceneData(*statement, data);
+				report.EndPhase("read", 0);
+			}
+		}
+
+		LOG(warning) << "Loading static data for: " << scene_label << (from_snapshot ? " (snapshot)" : "");
+		report.EndPhase("buildings", _loadBuildings(simulation_service, data.buildings, scene_id, scene_label));
+		report.EndPhase("cells", _loadCells(simulation_service, data.cells, scene_id, scene_label));
+		report.EndPhase("terminals", _loadTerminals(simulation_service, data.terminals, scene_id, scene_label));
+		report.EndPhase("elevators", _loadElevatorData(simulation_service, data.elevators, scene_id, scene_label));
+		report.EndPhase("ticket collectors", _loadTicketCollectors(simulation_service, data.ticket_collectors, scene_id, scene_label));
+		report.EndPhase("npcs", _loadNPCS(simulation_service, spawn_service, data.npcs, scene_id, scene_label));
+		report.EndPhase("shuttles", _loadShuttles(simulation_service, spawn_service, data.shuttles, scene_id, scene_label));
+
+		if (use_snapshot && !from_snapshot)
+		{
+			if (!snapshot_->Save(scene_id, snapshot_key, data))
+			{
+				LOG(warning) << "Could not write static snapshot " << snapshot_->GetPath(scene_id);
+			}
+			report.EndPhase("snapshot save", 0);
+		}
+	} catch(std::exception& e) {
+		LOG(warning) << e.what();
+	}
+
+	// Everything is in the spatial index, work out who can see what in one pass
+	simulation_service->OpenScene(scene_label);
+	report.EndPhase("awareness", 0);
+
+	LOG(info) << report.ToString();
+
+	if (scene_id-1 == 0)
+	{
+		// Create a combat dummy
+		auto combat_dummy = simulation_service->CreateObjectFromTemplate("object/mobile/shared_r2d2.iff", CREATURE_PERMISSION, false, true);
+		if (combat_dummy)
+		{
+			auto creature_dummy = std::static_pointer_cast<Creature>(combat_dummy);
+			creature_dummy->SetCustomName(L"R2 D2 Combat Trainer");
+			creature_dummy->SetPvPStatus(PvPStatus_Attackable);
+			creature_dummy->SetAllStats(50000);
+			creature_dummy->SetPosition(glm::vec3(-146.0f, 28.0f, -4702.0f));
+			creature_dummy->SetOrientation(glm::quat(0.0f, 1.0f, 0.0f, -0.0016f));
+			creature_dummy->SetScale(3);
+			simulation_service->AddObjectToScene(combat_dummy, "corellia");
+		}
+	}
+}
+
+bool StaticService::GetSnapshotKey_(const std::shared_ptr<sql::Connection>& connection, StaticSnapshotKey& key)
+{
+	try {
+		auto statement = std::unique_ptr<sql::Statement>(connection->createStatement());
+		auto result = std::unique_ptr<sql::ResultSet>(statement->executeQuery("CALL sp_GetStaticDataVersion();"));
+
+		bool found = result->next();
+		if (found)
+		{
+			key.static_data_version = result->getUInt(1);
+			key.tre_fingerprint = tre_fingerprint_;
+		}
+		while (statement->getMoreResults());
+
+		return found;
+	}
+	catch(sql::SQLException &e)
+	{
+		LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
+		LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
+	}
+
+	return false;
+}
+
 void StaticService::Startup()
 {
 	auto database_manager = kernel_->GetDatabaseManager();
@@ -164,45 +471,47 @@ ServiceDescription StaticService::GetServiceDescription()
     return service_description;
 }
 
-void StaticService::_loadBuildings(SimulationServiceInterface* simulation_service, std::unique_ptr<sql::ResultSet> result,
+uint32_t StaticService::_loadBuildings(SimulationServiceInterface* simulation_service, const std::vector<StaticObjectRow>& rows,
 	uint32_t scene_id, std::string scene_name)
 {
-	simulation_service->PrepareToAccomodate(result->rowsCount());
+	simulation_service->PrepareToAccomodate(static_cast<uint32_t>(rows.size()));
+
+	std::vector<std::shared_ptr<Object>> scene_objects;
+	scene_objects.reserve(rows.size());
 
-	while (result->next())
+	for (auto& row : rows)
 	{
 		//Load Building Row
-		auto object = simulation_service->CreateObjectFromTemplate(result->getString(9), 
-			STATIC_CONTAINER_PERMISSION, false, result->getInt64(1));
+		auto object = simulation_service->CreateObjectFromTemplate(row.template_name, 
+			STATIC_CONTAINER_PERMISSION, false, row.object_id);
 		
 		if(object == nullptr)
 			continue;
 
-		object->SetOrientation(glm::quat(
-			static_cast<float>(result->getDouble(5)),
-			static_cast<float>(result->getDouble(2)),
-			static_cast<float>(result->getDouble(3)),
-			static_cast<float>(result->getDouble(4))));
-
-		object->SetPosition(glm::vec3(result->getDouble(6), result->getDouble(7), result->getDouble(8)));
-		object->SetStfName(result->getString(12), result->getString(13));
+		object->SetOrientation(row.orientation);
+		object->SetPosition(row.position);
+		object->SetStfName(row.stf_file, row.stf_name);
 		object->SetSceneId(scene_id);
 		object->SetInSnapshot(true);
 		object->SetDatabasePersisted(false);
 			
-		//Put it into the scene
-		simulation_service->AddObjectToScene(object, scene_name);
+		scene_objects.push_back(object);
 	}
+
+	//Put them into the scene
+	simulation_service->AddObjectsToScene(scene_objects, scene_name);
+	return static_cast<uint32_t>(scene_objects.size());
 }
 
-void StaticService::_loadCells(SimulationServiceInterface* simulation_service, std::unique_ptr<sql::ResultSet> result,
+uint32_t StaticService::_loadCells(SimulationServiceInterface* simulation_service, const std::vector<StaticObjectRow>& rows,
 	uint32_t scene_id, std::string scene_name)
 {
-	while(result->next())
+	uint32_t count = 0;
+	for (auto& row : rows)
 	{
 		//Load Cells
 		auto object = simulation_service->CreateObjectFromTemplate("object/cell/shared_cell.iff",
-			WORLD_CELL_PERMISSION, false, result->getInt64(1));
+			WORLD_CELL_PERMISSION, false, row.object_id);
 
 		if(object == nullptr)
 			continue;
@@ -211,49 +520,37 @@ void StaticService::_loadCells(SimulationServiceInterface* simulation_service, s
 		object->SetInSnapshot(true);
 		object->SetDatabasePersisted(false);
 
-		auto parent = simulation_service->GetObjectById(result->getInt64(2));
+		auto parent = simulation_service->GetObjectById(row.parent_id);
 		if(parent != nullptr)
 		{
 			parent->AddObject(nullptr, object);
 		}
 
+		++count;
 	}
+	return count;
 }
 
-void StaticService::_loadCloneLocations(SimulationServiceInterface* simulation_service, std::unique_ptr<sql::ResultSet> result,
+uint32_t StaticService::_loadTerminals(SimulationServiceInterface* simulation_service, const std::vector<StaticObjectRow>& rows,
 	uint32_t scene_id, std::string scene_name)
 {
-	while(result->next())
-	{
-		//TODO: Fill me in
-	}
-}
+	simulation_service->PrepareToAccomodate(static_cast<uint32_t>(rows.size()));
 
-void StaticService::_loadTerminals(SimulationServiceInterface* simulation_service, std::unique_ptr<sql::ResultSet> result,
-	uint32_t scene_id, std::string scene_name)
-{
-	simulation_service->PrepareToAccomodate(result->rowsCount());
+	uint32_t count = 0;
+	std::vector<std::shared_ptr<Object>> scene_objects;
 
-	while(result->next())
+	for (auto& row : rows)
 	{
-		auto object = std::static_pointer_cast<Tangible>(simulation_service->CreateObjectFromTemplate(result->getString(11),
-			DEFAULT_PERMISSION, false, result->getInt64(1)));
+		auto object = std::static_pointer_cast<Tangible>(simulation_service->CreateObjectFromTemplate(row.template_name,
+			DEFAULT_PERMISSION, false, row.object_id));
 
 		if(object == nullptr)
 			continue;
 
-		object->SetOrientation(glm::quat(
-			static_cast<float>(result->getDouble(6)),
-			static_cast<float>(result->getDouble(3)),
-			static_cast<float>(result->getDouble(4)),
-			static_cast<float>(result->getDouble(5))));
-
-		object->SetPosition(glm::vec3(result->getDouble(7),result->getDouble(8),result->getDouble(9)));
-
-		object->SetStfName(result->getString(13), result->getString(12)); 
-
-		std::string name = result->getString(16);
-		object->SetCustomName(std::wstring(name.begin(), name.end()));
+		object->SetOrientation(row.orientation);
+		object->SetPosition(row.position);
+		object->SetStfName(row.stf_file, row.stf_name); 
+		object->SetCustomName(std::wstring(row.custom_name.begin(), row.custom_name.end()));
 
 		if(object->GetObjectId() < 4294967297)
 			object->SetInSnapshot(true);
@@ -261,14 +558,13 @@ void StaticService::_loadTerminals(SimulationServiceInterface* simulation_servic
 		object->SetDatabasePersisted(false);
 
 		//Put it into the scene
-		uint64_t parent_id = result->getUInt64(2);
-		if(parent_id == 0)
+		if(row.parent_id == 0)
 		{
-			simulation_service->AddObjectToScene(object, scene_name);
+			scene_objects.push_back(object);
 		}
 		else
 		{
-			auto parent = simulation_service->GetObjectById(parent_id);
+			auto parent = simulation_service->GetObjectById(row.parent_id);
 			if(parent != nullptr)
 			{
 				parent->AddObject(nullptr, object);
@@ -283,144 +579,133 @@ void StaticService::_loadTerminals(SimulationServiceInterface* simulation_servic
 		if (object->GetTemplate().compare("object/tangible/terminal/shared_terminal_travel.iff") == 0)
 		{
 			object->SetFlag("travel_terminal");
-			auto location_descriptor = result->getString(14).asStdString();
-			object->SetAttribute("location_descriptor", std::wstring(location_descriptor.begin(), location_descriptor.end()));
+			object->SetAttribute("location_descriptor", std::wstring(row.data.begin(), row.data.end()));
 			object->SetAttribute("radial_filename", L"radials.travel");
 		}
+
+		++count;
 	}
+
+	simulation_service->AddObjectsToScene(scene_objects, scene_name);
+	return count;
 }
 
-void StaticService::_loadElevatorData(SimulationServiceInterface* simulation_service, std::unique_ptr<sql::ResultSet> result,
+uint32_t StaticService::_loadElevatorData(SimulationServiceInterface* simulation_service, const std::vector<StaticElevatorRow>& rows,
 	uint32_t scene_id, std::string scene_name)
 {
-	while(result->next())
+	uint32_t count = 0;
+	for (auto& row : rows)
 	{
 		std::shared_ptr<ElevatorData> elevator_data = std::make_shared<ElevatorData>();
 
-		uint64_t terminal_id = result->getUInt64(1);
-		auto terminal = simulation_service->GetObjectById(terminal_id);
+		auto terminal = simulation_service->GetObjectById(row.terminal_id);
 		if(terminal == nullptr)
 			continue;
 		
 		terminal->SetAttribute<std::wstring>("radial_filename", L"radials.elevator");
 
-		elevator_data->dst_cell = result->getUInt64(2);
-		elevator_data->dst_orientation = glm::quat(
-			static_cast<float>(result->getDouble(6)),
-			static_cast<float>(result->getDouble(3)),
-			static_cast<float>(result->getDouble(4)),
-			static_cast<float>(result->getDouble(5)));
-		elevator_data->dst_position = glm::vec3(result->getDouble(7),result->getDouble(8),result->getDouble(9));
-		elevator_data->effect_id = result->getUInt(10);
-		elevator_data->going_down = result->getUInt(11) != 0;
+		elevator_data->dst_cell = row.dst_cell;
+		elevator_data->dst_orientation = row.dst_orientation;
+		elevator_data->dst_position = row.dst_position;
+		elevator_data->effect_id = row.effect_id;
+		elevator_data->going_down = row.going_down;
 
 		if(elevator_data->going_down)
 			terminal->SetAttribute<int32_t>("elevator_can_go_down", 0);
 		else
 			terminal->SetAttribute<int32_t>("elevator_can_go_up", 0);
 
-		auto find_itr = elevator_lookup_.find(terminal_id);
+		boost::lock_guard<boost::mutex> lock(elevator_mutex_);
+		auto find_itr = elevator_lookup_.find(row.terminal_id);
 		if(find_itr == elevator_lookup_.end())
-			find_itr = elevator_lookup_.insert(std::make_pair(terminal_id, std::vector<std::shared_ptr<ElevatorData>>())).first;
+			find_itr = elevator_lookup_.insert(std::make_pair(row.terminal_id, std::vector<std::shared_ptr<ElevatorData>>())).first;
 
 		find_itr->second.push_back(elevator_data);
+		++count;
 	}
+	return count;
 }
 
-void StaticService::_loadContainers(SimulationServiceInterface* simulation_service, std::unique_ptr<sql::ResultSet> result,
+uint32_t StaticService::_loadTicketCollectors(SimulationServiceInterface* simulation_service, const std::vector<StaticObjectRow>& rows,
 	uint32_t scene_id, std::string scene_name)
 {
-	while(result->next())
-	{
-	}
-}
+	simulation_service->PrepareToAccomodate(static_cast<uint32_t>(rows.size()));
 
-void StaticService::_loadTicketCollectors(SimulationServiceInterface* simulation_service, std::unique_ptr<sql::ResultSet> result,
-	uint32_t scene_id, std::string scene_name)
-{
-	simulation_service->PrepareToAccomodate(result->rowsCount());
+	uint32_t count = 0;
+	std::vector<std::shared_ptr<Object>> scene_objects;
 
-	while(result->next())
+	for (auto& row : rows)
 	{
-		auto object = std::static_pointer_cast<Tangible>(simulation_service->CreateObjectFromTemplate(result->getString(3),
-			DEFAULT_PERMISSION, false, result->getInt64(1)));
+		auto object = std::static_pointer_cast<Tangible>(simulation_service->CreateObjectFromTemplate(row.template_name,
+			DEFAULT_PERMISSION, false, row.object_id));
 
 		if(object == nullptr)
 			continue;
 
-		object->SetOrientation(glm::quat(
-			static_cast<float>(result->getDouble(7)),
-			static_cast<float>(result->getDouble(4)),
-			static_cast<float>(result->getDouble(5)),
-			static_cast<float>(result->getDouble(6))));
-
-		object->SetPosition(glm::vec3(result->getDouble(8),result->getDouble(9),result->getDouble(10)));
-
-		object->SetStfName(result->getString(13), result->getString(12));
-
+		object->SetOrientation(row.orientation);
+		object->SetPosition(row.position);
+		object->SetStfName(row.stf_file, row.stf_name);
 		object->SetDatabasePersisted(false);
 
-		uint64_t parent_id = result->getUInt64(2);
-		if(parent_id == 0)
+		if(row.parent_id == 0)
 		{
-			simulation_service->AddObjectToScene(object, scene_name);
+			scene_objects.push_back(object);
 		}
 		else
 		{
-			auto parent = simulation_service->GetObjectById(parent_id);
+			auto parent = simulation_service->GetObjectById(row.parent_id);
 			if(parent != nullptr)
 			{
 				parent->AddObject(nullptr, object);
 			}
 		}
 
-		auto travel_point = result->getString(14).asStdString();
-		object->SetAttribute("travel_point", std::wstring(travel_point.begin(), travel_point.end()));
+		object->SetAttribute("travel_point", std::wstring(row.data.begin(), row.data.end()));
 		object->SetFlag("ticket_collector");
 		object->SetAttribute("radial_filename", L"radials.ticket_collector");
+
+		++count;
 	}
+
+	simulation_service->AddObjectsToScene(scene_objects, scene_name);
+	return count;
 }
 
-void StaticService::_loadNPCS(SimulationServiceInterface* simulation_service, SpawnServiceInterface* spawn_service, std::unique_ptr<sql::ResultSet> result,
+uint32_t StaticService::_loadNPCS(SimulationServiceInterface* simulation_service, SpawnServiceInterface* spawn_service, const std::vector<StaticObjectRow>& rows,
 	uint32_t scene_id, std::string scene_name)
 {
-	simulation_service->PrepareToAccomodate(result->rowsCount());
+	simulation_service->PrepareToAccomodate(static_cast<uint32_t>(rows.size()));
+
+	uint32_t count = 0;
+	std::vector<std::shared_ptr<Object>> scene_objects;
 
-	while(result->next())
+	for (auto& row : rows)
 	{
 		//Load NPCS
-		auto object = std::static_pointer_cast<Creature>(simulation_service->CreateObjectFromTemplate(result->getString(15),
-			CREATURE_PERMISSION, false, result->getUInt64(1)));
+		auto object = std::static_pointer_cast<Creature>(simulation_service->CreateObjectFromTemplate(row.template_name,
+			CREATURE_PERMISSION, false, row.object_id));
 
 		if(object == nullptr)
 			continue;
 
-		std::string firstname = result->getString(3).asStdString(), lastname = result->getString(4).asStdString();
-
-		if(firstname.size() != 0) {
-			std::string name(firstname + " " + lastname);
-			object->SetCustomName(std::wstring(name.begin(), name.end()));
+		if(row.custom_name.size() != 0) {
+			object->SetCustomName(std::wstring(row.custom_name.begin(), row.custom_name.end()));
 		}
 
-		object->SetStfName(result->getString(17), result->getString(16));
-
-		object->SetPosture((Posture)result->getUInt(5));
-		object->SetStateBitmask(result->getUInt(6));
-		object->SetCombatLevel(result->getUInt(7));
+		object->SetStfName(row.stf_file, row.stf_name);
 
-		object->SetOrientation(glm::quat(
-			static_cast<float>(result->getDouble(11)),
-			static_cast<float>(result->getDouble(8)),
-			static_cast<float>(result->getDouble(9)),
-			static_cast<float>(result->getDouble(10))));
+		object->SetPosture((Posture)row.posture);
+		object->SetStateBitmask(row.state_bitmask);
+		object->SetCombatLevel(row.combat_level);
 
-		object->SetPosition(glm::vec3(result->getDouble(12),result->getDouble(13),result->getDouble(14)));
-		object->SetMoodId(result->getUInt(19));
-		object->SetScale(static_cast<float>(result->getDouble(21)));
+		object->SetOrientation(row.orientation);
+		object->SetPosition(row.position);
+		object->SetMoodId(row.mood_id);
+		object->SetScale(row.scale);
 
 		object->SetPvPStatus(PvPStatus_None);
 
-		switch(result->getUInt(20))
+		switch(row.npc_type)
 		{
 		case TRAINER:
 			object->SetOptionsMask(OPTION_TRAINER | OPTION_NO_HAM);
@@ -442,62 +727,59 @@ void StaticService::_loadNPCS(SimulationServiceInterface* simulation_service, Sp
 		object->SetDatabasePersisted(false);
 		
 		//Put it into the scene
-		uint64_t parent_id = result->getUInt64(2);
-		if(parent_id == 0)
+		if(row.parent_id == 0)
 		{
-			simulation_service->AddObjectToScene(object, scene_name);
+			scene_objects.push_back(object);
 		}
 		else
 		{
-			auto parent = simulation_service->GetObjectById(parent_id);
+			auto parent = simulation_service->GetObjectById(row.parent_id);
 			if(parent != nullptr)
 			{
 				parent->AddObject(nullptr, object);
 			}
 		}
+
+		++count;
 	}
+
+	simulation_service->AddObjectsToScene(scene_objects, scene_name);
+	return count;
 }
 
-void StaticService::_loadShuttles(SimulationServiceInterface* simulation_service, SpawnServiceInterface* spawn_service, std::unique_ptr<sql::ResultSet> result,
+uint32_t StaticService::_loadShuttles(SimulationServiceInterface* simulation_service, SpawnServiceInterface* spawn_service, const std::vector<StaticObjectRow>& rows,
 	uint32_t scene_id, std::string scene_name)
 {
-	simulation_service->PrepareToAccomodate(result->rowsCount());
+	simulation_service->PrepareToAccomodate(static_cast<uint32_t>(rows.size()));
+
+	uint32_t count = 0;
+	std::vector<std::shared_ptr<Object>> scene_objects;
+	std::vector<std::shared_ptr<Creature>> shuttles;
 
-	while(result->next())
+	for (auto& row : rows)
 	{
-		auto object = std::static_pointer_cast<Creature>(simulation_service->CreateObjectFromTemplate(result->getString(12),
-			DEFAULT_PERMISSION, false, result->getInt64(1)));
+		auto object = std::static_pointer_cast<Creature>(simulation_service->CreateObjectFromTemplate(row.template_name,
+			DEFAULT_PERMISSION, false, row.object_id));
 
 		if(object == nullptr)
 			continue;
 
-		object->SetOrientation(glm::quat(
-			static_cast<float>(result->getDouble(8)),
-			static_cast<float>(result->getDouble(5)),
-			static_cast<float>(result->getDouble(6)),
-			static_cast<float>(result->getDouble(7))));
-
-		object->SetPosition(glm::vec3(result->getDouble(9),result->getDouble(10),result->getDouble(11)));
-
-		object->SetStfName(result->getString(14), result->getString(13));
-
-		uint64_t awayTime = result->getUInt64(15);
-		uint64_t inPortTime = result->getUInt64(16);
-		uint64_t collectorId = result->getUInt64(17);
+		object->SetOrientation(row.orientation);
+		object->SetPosition(row.position);
+		object->SetStfName(row.stf_file, row.stf_name);
 
 		object->SetPvPStatus(PvPStatus_None);
 		object->SetOptionsMask(OPTION_NO_HAM);
 		
 		object->SetDatabasePersisted(false);
 
-		uint64_t parent_id = result->getUInt64(2);
-		if(parent_id == 0)
+		if(row.parent_id == 0)
 		{
-			simulation_service->AddObjectToScene(object, scene_name);
+			scene_objects.push_back(object);
 		}
 		else
 		{
-			auto parent = simulation_service->GetObjectById(parent_id);
+			auto parent = simulation_service->GetObjectById(row.parent_id);
 			if(parent != nullptr)
 			{
 				parent->AddObject(nullptr, object);
@@ -506,12 +788,23 @@ void StaticService::_loadShuttles(SimulationServiceInterface* simulation_service
 
 		object->SetFlag("shuttle");
 
-		spawn_service->StartManagingObject(object, L"shuttle");
+		shuttles.push_back(object);
+		++count;
+	}
+
+	simulation_service->AddObjectsToScene(scene_objects, scene_name);
+
+	// Only start the flight schedule once the shuttles are in the scene
+	for (auto& shuttle : shuttles)
+	{
+		spawn_service->StartManagingObject(shuttle, L"shuttle");
 	}
+	return count;
 }
 
 std::vector<std::shared_ptr<ElevatorData>> StaticService::GetElevatorDataForObject(uint64_t terminal_id)
 {
+	boost::lock_guard<boost::mutex> lock(elevator_mutex_);
 	auto find_itr = elevator_lookup_.find(terminal_id);
 	if(find_itr != elevator_lookup_.end())
 	{
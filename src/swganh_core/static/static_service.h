@@ -4,16 +4,20 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <vector>
 
-#include "swganh/active_object.h"
+#include <boost/thread/mutex.hpp>
+
+#include "swganh/thread_pool.h"
 #include "swganh/app/swganh_kernel.h"
 #include "swganh_core/static/static_service_interface.h"
 #include "swganh_core/static/skill_manager.h"
+#include "swganh_core/static/static_snapshot.h"
 
 namespace sql
 {
-	class ResultSet;
+	class Connection;
 }
 
 namespace swganh
@@ -32,6 +36,7 @@ namespace spawn
 
 namespace object
 {
+	class Object;
 	class Creature;
 }
 
@@ -64,30 +69,45 @@ namespace statics
 
 	private:
 
-		void _loadBuildings(swganh::simulation::SimulationServiceInterface* simulation_service, std::unique_ptr<sql::ResultSet> result,
-			uint32_t scene_id, std::string scene_name);
-		void _loadCells(swganh::simulation::SimulationServiceInterface* simulation_service, std::unique_ptr<sql::ResultSet> result,
-			uint32_t scene_id, std::string scene_name);
-		void _loadCloneLocations(swganh::simulation::SimulationServiceInterface* simulation_service, std::unique_ptr<sql::ResultSet> result,
+		/**
+		 * Loads the static objects of a scene, runs on the load pool so that every
+		 * planet loads in parallel. The scene is opened once everything is in.
+		 */
+		void LoadScene_(uint32_t scene_id, std::string scene_label);
+
+		/**
+		 * Reads the key the snapshots of this server are checked against.
+		 *
+		 * @return False if the static data version could not be read, the
+		 *      snapshot is not used then.
+		 */
+		bool GetSnapshotKey_(const std::shared_ptr<sql::Connection>& connection, StaticSnapshotKey& key);
+
+		// Each returns the number of rows it loaded.
+		uint32_t _loadBuildings(swganh::simulation::SimulationServiceInterface* simulation_service, const std::vector<StaticObjectRow>& rows,
 			uint32_t scene_id, std::string scene_name);
-		void _loadTerminals(swganh::simulation::SimulationServiceInterface* simulation_service, std::unique_ptr<sql::ResultSet> result,
+		uint32_t _loadCells(swganh::simulation::SimulationServiceInterface* simulation_service, const std::vector<StaticObjectRow>& rows,
 			uint32_t scene_id, std::string scene_name);
-		void _loadElevatorData(swganh::simulation::SimulationServiceInterface* simulation_service, std::unique_ptr<sql::ResultSet> result,
+		uint32_t _loadTerminals(swganh::simulation::SimulationServiceInterface* simulation_service, const std::vector<StaticObjectRow>& rows,
 			uint32_t scene_id, std::string scene_name);
-		void _loadContainers(swganh::simulation::SimulationServiceInterface* simulation_service, std::unique_ptr<sql::ResultSet> result,
+		uint32_t _loadElevatorData(swganh::simulation::SimulationServiceInterface* simulation_service, const std::vector<StaticElevatorRow>& rows,
 			uint32_t scene_id, std::string scene_name);
-		void _loadTicketCollectors(swganh::simulation::SimulationServiceInterface* simulation_service, std::unique_ptr<sql::ResultSet> result,
+		uint32_t _loadTicketCollectors(swganh::simulation::SimulationServiceInterface* simulation_service, const std::vector<StaticObjectRow>& rows,
 			uint32_t scene_id, std::string scene_name);
-		void _loadNPCS(swganh::simulation::SimulationServiceInterface* simulation_service, swganh::spawn::SpawnServiceInterface* spawn_service,
-			std::unique_ptr<sql::ResultSet> result, uint32_t scene_id, std::string scene_name);
-		void _loadShuttles(swganh::simulation::SimulationServiceInterface* simulation_service, swganh::spawn::SpawnServiceInterface* spawn_service,
-			std::unique_ptr<sql::ResultSet> result, uint32_t scene_id, std::string scene_name);
+		uint32_t _loadNPCS(swganh::simulation::SimulationServiceInterface* simulation_service, swganh::spawn::SpawnServiceInterface* spawn_service,
+			const std::vector<StaticObjectRow>& rows, uint32_t scene_id, std::string scene_name);
+		uint32_t _loadShuttles(swganh::simulation::SimulationServiceInterface* simulation_service, swganh::spawn::SpawnServiceInterface* spawn_service,
+			const std::vector<StaticObjectRow>& rows, uint32_t scene_id, std::string scene_name);
 
 		swganh::app::SwganhKernel* kernel_;
 
+		boost::mutex elevator_mutex_;
 		std::map<uint64_t, std::vector<std::shared_ptr<ElevatorData>>> elevator_lookup_;
 		SkillManager skill_mod_manager_;
-        swganh::ActiveObject active_;
+		swganh::ThreadPool load_pool_;
+
+		std::unique_ptr<StaticSnapshot> snapshot_;	///< null if snapshots are disabled
+		uint64_t tre_fingerprint_;
 	};
 }
 }
\ No newline at end of file
@@ -0,0 +1,455 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "static_snapshot.h"
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+using namespace swganh::statics;
+
+namespace {
+
+	const char kMagic[8] = {'S', 'W', 'G', 'S', 'T', 'A', 'T', '\0'};
+
+	enum SnapshotObjectKind
+	{
+		KIND_BUILDING = 1,
+		KIND_CELL,
+		KIND_TERMINAL,
+		KIND_TICKET_COLLECTOR,
+		KIND_NPC,
+		KIND_SHUTTLE,
+		KIND_CONTAINER,
+		KIND_CLONE_LOCATION	// parent_id is the cell, data the city
+	};
+
+	struct SnapshotHeader
+	{
+		char magic[8];
+		uint32_t format_version;
+		uint32_t scene_id;
+		uint32_t static_data_version;
+		uint32_t reserved;
+		uint64_t tre_fingerprint;
+		uint32_t object_count;
+		uint32_t elevator_count;
+		uint64_t strings_size;
+	};
+
+	struct StringRef
+	{
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	struct ObjectRecord
+	{
+		uint64_t object_id;
+		uint64_t parent_id;
+		uint32_t kind;
+		StringRef template_name;
+		StringRef stf_file;
+		StringRef stf_name;
+		StringRef custom_name;
+		StringRef data;
+		float position[3];
+		float orientation[4];	// w, x, y, z
+		uint32_t posture;
+		uint32_t state_bitmask;
+		uint32_t combat_level;
+		uint32_t mood_id;
+		uint32_t npc_type;
+		float scale;
+	};
+
+	struct ElevatorRecord
+	{
+		uint64_t terminal_id;
+		uint64_t dst_cell;
+		float dst_orientation[4];	// w, x, y, z
+		float dst_position[3];
+		uint32_t effect_id;
+		uint32_t going_down;
+		uint32_t reserved;
+	};
+
+	// The layout is part of the file format, bump kFormatVersion when changing it.
+	static_assert(sizeof(SnapshotHeader) == 48, "snapshot header layout changed");
+	static_assert(sizeof(ObjectRecord) == 112, "snapshot object record layout changed");
+	static_assert(sizeof(ElevatorRecord) == 56, "snapshot elevator record layout changed");
+
+	class StringTable
+	{
+	public:
+		StringRef Add(const std::string& value)
+		{
+			StringRef ref;
+			ref.offset = static_cast<uint32_t>(data_.size());
+			ref.size = static_cast<uint32_t>(value.size());
+			data_.append(value);
+			return ref;
+		}
+
+		const std::string& Data() const { return data_; }
+
+	private:
+		std::string data_;
+	};
+
+	ObjectRecord MakeRecord(uint32_t kind, const StaticObjectRow& row, StringTable& strings)
+	{
+		ObjectRecord record;
+		std::memset(&record, 0, sizeof(record));
+
+		record.object_id = row.object_id;
+		record.parent_id = row.parent_id;
+		record.kind = kind;
+		record.template_name = strings.Add(row.template_name);
+		record.stf_file = strings.Add(row.stf_file);
+		record.stf_name = strings.Add(row.stf_name);
+		record.custom_name = strings.Add(row.custom_name);
+		record.data = strings.Add(row.data);
+		record.position[0] = row.position.x;
+		record.position[1] = row.position.y;
+		record.position[2] = row.position.z;
+		record.orientation[0] = row.orientation.w;
+		record.orientation[1] = row.orientation.x;
+		record.orientation[2] = row.orientation.y;
+		record.orientation[3] = row.orientation.z;
+		record.posture = row.posture;
+		record.state_bitmask = row.state_bitmask;
+		record.combat_level = row.combat_level;
+		record.mood_id = row.mood_id;
+		record.npc_type = row.npc_type;
+		record.scale = row.scale;
+
+		return record;
+	}
+
+	ObjectRecord MakeCloneLocationRecord(const StaticCloneLocationRow& row, StringTable& strings)
+	{
+		StaticObjectRow object_row = StaticObjectRow();
+		object_row.parent_id = row.cell_id;
+		object_row.orientation = row.orientation;
+		object_row.position = row.position;
+		object_row.data = row.city;
+
+		return MakeRecord(KIND_CLONE_LOCATION, object_row, strings);
+	}
+
+	bool ReadString(const StringRef& ref, const char* strings, uint64_t strings_size, std::string& value)
+	{
+		if (static_cast<uint64_t>(ref.offset) + ref.size > strings_size)
+		{
+			return false;
+		}
+
+		value.assign(strings + ref.offset, ref.size);
+		return true;
+	}
+
+	bool WriteBytes(FILE* file, const void* data, size_t size)
+	{
+		return size == 0 || fwrite(data, 1, size, file) == size;
+	}
+
+	/// Flushes the file all the way to the disk.
+	bool SyncFile(FILE* file)
+	{
+		if (fflush(file) != 0)
+		{
+			return false;
+		}
+#ifdef _WIN32
+		return _commit(_fileno(file)) == 0;
+#else
+		return fsync(fileno(file)) == 0;
+#endif
+	}
+
+	/// Makes a rename in the directory durable, there is nothing to do on Windows.
+	void SyncDirectory(const std::string& directory)
+	{
+#ifndef _WIN32
+		int fd = open(directory.c_str(), O_RDONLY);
+		if (fd >= 0)
+		{
+			fsync(fd);
+			close(fd);
+		}
+#endif
+	}
+
+	void HashBytes(uint64_t& hash, const void* data, size_t size)
+	{
+		// FNV-1a
+		auto bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ULL;
+		}
+	}
+
+}
+
+StaticSnapshot::StaticSnapshot(std::string directory)
+	: directory_(std::move(directory))
+{}
+
+std::string StaticSnapshot::GetPath(uint32_t scene_id) const
+{
+	std::stringstream filename;
+	filename << "static_scene_" << scene_id << ".snapshot";
+
+	return (boost::filesystem::path(directory_) / filename.str()).string();
+}
+
+bool StaticSnapshot::Load(uint32_t scene_id, const StaticSnapshotKey& key, StaticSceneData& data) const
+{
+	data = StaticSceneData();
+
+	auto path = GetPath(scene_id);
+	boost::system::error_code error;
+	if (!boost::filesystem::exists(path, error) || boost::filesystem::file_size(path, error) < sizeof(SnapshotHeader))
+	{
+		return false;
+	}
+
+	try {
+		boost::interprocess::file_mapping file(path.c_str(), boost::interprocess::read_only);
+		boost::interprocess::mapped_region region(file, boost::interprocess::read_only);
+
+		auto base = static_cast<const char*>(region.get_address());
+		uint64_t size = region.get_size();
+
+		SnapshotHeader header;
+		std::memcpy(&header, base, sizeof(header));
+
+		if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+			header.format_version != kFormatVersion ||
+			header.scene_id != scene_id ||
+			header.static_data_version != key.static_data_version ||
+			header.tre_fingerprint != key.tre_fingerprint)
+		{
+			return false;
+		}
+
+		uint64_t objects_offset = sizeof(SnapshotHeader);
+		uint64_t elevators_offset = objects_offset + uint64_t(header.object_count) * sizeof(ObjectRecord);
+		uint64_t strings_offset = elevators_offset + uint64_t(header.elevator_count) * sizeof(ElevatorRecord);
+		if (strings_offset + header.strings_size != size)
+		{
+			return false;
+		}
+
+		auto objects = reinterpret_cast<const ObjectRecord*>(base + objects_offset);
+		auto elevators = reinterpret_cast<const ElevatorRecord*>(base + elevators_offset);
+		auto strings = base + strings_offset;
+
+		for (uint32_t i = 0; i < header.object_count; ++i)
+		{
+			const ObjectRecord& record = objects[i];
+
+			std::vector<StaticObjectRow>* target = nullptr;
+			switch (record.kind)
+			{
+			case KIND_BUILDING: target = &data.buildings; break;
+			case KIND_CELL: target = &data.cells; break;
+			case KIND_TERMINAL: target = &data.terminals; break;
+			case KIND_TICKET_COLLECTOR: target = &data.ticket_collectors; break;
+			case KIND_NPC: target = &data.npcs; break;
+			case KIND_SHUTTLE: target = &data.shuttles; break;
+			case KIND_CONTAINER: target = &data.containers; break;
+			case KIND_CLONE_LOCATION: break;
+			default:
+				data = StaticSceneData();
+				return false;
+			}
+
+			StaticObjectRow row;
+			row.object_id = record.object_id;
+			row.parent_id = record.parent_id;
+			if (!ReadString(record.template_name, strings, header.strings_size, row.template_name) ||
+				!ReadString(record.stf_file, strings, header.strings_size, row.stf_file) ||
+				!ReadString(record.stf_name, strings, header.strings_size, row.stf_name) ||
+				!ReadString(record.custom_name, strings, header.strings_size, row.custom_name) ||
+				!ReadString(record.data, strings, header.strings_size, row.data))
+			{
+				data = StaticSceneData();
+				return false;
+			}
+			row.position = glm::vec3(record.position[0], record.position[1], record.position[2]);
+			row.orientation = glm::quat(record.orientation[0], record.orientation[1], record.orientation[2], record.orientation[3]);
+			row.posture = record.posture;
+			row.state_bitmask = record.state_bitmask;
+			row.combat_level = record.combat_level;
+			row.mood_id = record.mood_id;
+			row.npc_type = record.npc_type;
+			row.scale = record.scale;
+
+			if (record.kind == KIND_CLONE_LOCATION)
+			{
+				StaticCloneLocationRow clone_location;
+				clone_location.cell_id = row.parent_id;
+				clone_location.orientation = row.orientation;
+				clone_location.position = row.position;
+				clone_location.city = std::move(row.data);
+				data.clone_locations.push_back(std::move(clone_location));
+				continue;
+			}
+
+			target->push_back(std::move(row));
+		}
+
+		data.elevators.reserve(header.elevator_count);
+		for (uint32_t i = 0; i < header.elevator_count; ++i)
+		{
+			const ElevatorRecord& record = elevators[i];
+
+			StaticElevatorRow row;
+			row.terminal_id = record.terminal_id;
+			row.dst_cell = record.dst_cell;
+			row.dst_orientation = glm::quat(record.dst_orientation[0], record.dst_orientation[1], record.dst_orientation[2], record.dst_orientation[3]);
+			row.dst_position = glm::vec3(record.dst_position[0], record.dst_position[1], record.dst_position[2]);
+			row.effect_id = record.effect_id;
+			row.going_down = record.going_down != 0;
+
+			data.elevators.push_back(row);
+		}
+	}
+	catch (boost::interprocess::interprocess_exception&)
+	{
+		data = StaticSceneData();
+		return false;
+	}
+
+	return true;
+}
+
+bool StaticSnapshot::Save(uint32_t scene_id, const StaticSnapshotKey& key, const StaticSceneData& data) const
+{
+	StringTable strings;
+	std::vector<ObjectRecord> objects;
+	objects.reserve(data.buildings.size() + data.cells.size() + data.clone_locations.size() + data.terminals.size() +
+		data.containers.size() + data.ticket_collectors.size() + data.npcs.size() + data.shuttles.size());
+
+	for (auto& row : data.buildings) objects.push_back(MakeRecord(KIND_BUILDING, row, strings));
+	for (auto& row : data.cells) objects.push_back(MakeRecord(KIND_CELL, row, strings));
+	for (auto& row : data.clone_locations) objects.push_back(MakeCloneLocationRecord(row, strings));
+	for (auto& row : data.terminals) objects.push_back(MakeRecord(KIND_TERMINAL, row, strings));
+	for (auto& row : data.containers) objects.push_back(MakeRecord(KIND_CONTAINER, row, strings));
+	for (auto& row : data.ticket_collectors) objects.push_back(MakeRecord(KIND_TICKET_COLLECTOR, row, strings));
+	for (auto& row : data.npcs) objects.push_back(MakeRecord(KIND_NPC, row, strings));
+	for (auto& row : data.shuttles) objects.push_back(MakeRecord(KIND_SHUTTLE, row, strings));
+
+	std::vector<ElevatorRecord> elevators;
+	elevators.reserve(data.elevators.size());
+	for (auto& row : data.elevators)
+	{
+		ElevatorRecord record;
+		std::memset(&record, 0, sizeof(record));
+
+		record.terminal_id = row.terminal_id;
+		record.dst_cell = row.dst_cell;
+		record.dst_orientation[0] = row.dst_orientation.w;
+		record.dst_orientation[1] = row.dst_orientation.x;
+		record.dst_orientation[2] = row.dst_orientation.y;
+		record.dst_orientation[3] = row.dst_orientation.z;
+		record.dst_position[0] = row.dst_position.x;
+		record.dst_position[1] = row.dst_position.y;
+		record.dst_position[2] = row.dst_position.z;
+		record.effect_id = row.effect_id;
+		record.going_down = row.going_down ? 1 : 0;
+
+		elevators.push_back(record);
+	}
+
+	SnapshotHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, kMagic, sizeof(kMagic));
+	header.format_version = kFormatVersion;
+	header.scene_id = scene_id;
+	header.static_data_version = key.static_data_version;
+	header.tre_fingerprint = key.tre_fingerprint;
+	header.object_count = static_cast<uint32_t>(objects.size());
+	header.elevator_count = static_cast<uint32_t>(elevators.size());
+	header.strings_size = strings.Data().size();
+
+	boost::system::error_code error;
+	boost::filesystem::create_directories(directory_, error);
+
+	auto path = GetPath(scene_id);
+	auto temp_path = path + ".tmp";
+	FILE* file = fopen(temp_path.c_str(), "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	// The data has to be on the disk before the rename, or a crash could leave
+	// the new name pointing at an empty file.
+	bool written = WriteBytes(file, &header, sizeof(header)) &&
+		WriteBytes(file, objects.data(), objects.size() * sizeof(ObjectRecord)) &&
+		WriteBytes(file, elevators.data(), elevators.size() * sizeof(ElevatorRecord)) &&
+		WriteBytes(file, strings.Data().data(), strings.Data().size()) &&
+		SyncFile(file);
+	written = (fclose(file) == 0) && written;
+
+	if (!written)
+	{
+		boost::filesystem::remove(temp_path, error);
+		return false;
+	}
+
+	// Replaces the old snapshot in one step, there is always a whole file at path.
+	boost::filesystem::rename(temp_path, path, error);
+	if (error)
+	{
+		boost::filesystem::remove(temp_path, error);
+		return false;
+	}
+
+	SyncDirectory(directory_);
+	return true;
+}
+
+uint64_t StaticSnapshot::FingerprintFiles(const std::vector<std::string>& filenames)
+{
+	uint64_t hash = 14695981039346656037ULL;
+
+	for (auto& filename : filenames)
+	{
+		HashBytes(hash, filename.data(), filename.size());
+
+		boost::system::error_code error;
+		uint64_t size = boost::filesystem::file_size(filename, error);
+		if (error)
+		{
+			size = 0;
+		}
+		int64_t modified = static_cast<int64_t>(boost::filesystem::last_write_time(filename, error));
+		if (error)
+		{
+			modified = 0;
+		}
+
+		HashBytes(hash, &size, sizeof(size));
+		HashBytes(hash, &modified, sizeof(modified));
+	}
+
+	return hash;
+}
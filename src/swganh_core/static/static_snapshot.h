@@ -0,0 +1,135 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+namespace swganh
+{
+namespace statics
+{
+	/**
+	 * One static object as read from sp_GetStaticObjects. Not every kind of object
+	 * uses every field.
+	 */
+	struct StaticObjectRow
+	{
+		uint64_t object_id;
+		uint64_t parent_id;
+		std::string template_name;
+		std::string stf_file;
+		std::string stf_name;
+		std::string custom_name;
+		std::string data;	///< location descriptor of terminals, travel point of ticket collectors
+		glm::vec3 position;
+		glm::quat orientation;
+		uint32_t posture;
+		uint32_t state_bitmask;
+		uint32_t combat_level;
+		uint32_t mood_id;
+		uint32_t npc_type;
+		float scale;
+	};
+
+	struct StaticElevatorRow
+	{
+		uint64_t terminal_id;
+		uint64_t dst_cell;
+		glm::quat dst_orientation;
+		glm::vec3 dst_position;
+		uint32_t effect_id;
+		bool going_down;
+	};
+
+	struct StaticCloneLocationRow
+	{
+		uint64_t cell_id;
+		glm::quat orientation;
+		glm::vec3 position;		///< in the cell
+		std::string city;
+	};
+
+	/**
+	 * Everything the StaticService loads for one scene, in load order. The clone
+	 * locations and containers are only kept so the snapshot holds every result
+	 * of sp_GetStaticObjects, nothing is built from them yet.
+	 */
+	struct StaticSceneData
+	{
+		std::vector<StaticObjectRow> buildings;
+		std::vector<StaticObjectRow> cells;
+		std::vector<StaticCloneLocationRow> clone_locations;
+		std::vector<StaticObjectRow> terminals;
+		std::vector<StaticElevatorRow> elevators;
+		std::vector<StaticObjectRow> containers;
+		std::vector<StaticObjectRow> ticket_collectors;
+		std::vector<StaticObjectRow> npcs;
+		std::vector<StaticObjectRow> shuttles;
+	};
+
+	/**
+	 * What a snapshot was built from, a snapshot is only used when both match.
+	 */
+	struct StaticSnapshotKey
+	{
+		uint32_t static_data_version;	///< from sp_GetStaticDataVersion
+		uint64_t tre_fingerprint;		///< see FingerprintFiles
+	};
+
+	/**
+	 * Binary cache of the static world, one file per scene.
+	 *
+	 * A file is a fixed header followed by fixed size object and elevator records
+	 * and a string table the records point into. Files are mapped rather than read
+	 * and are written to a temporary file first, so a crash while saving never
+	 * leaves a half written snapshot behind. Records are stored in host byte order,
+	 * snapshots are not meant to be moved between machines.
+	 *
+	 * Only the rows of swganh_static are cached. Templates, slot layouts and
+	 * collision still come from the tre files when the objects are built, which
+	 * is why the tre fingerprint is part of the key.
+	 */
+	class StaticSnapshot
+	{
+	public:
+		static const uint32_t kFormatVersion = 2;
+
+		/**
+		 * @param directory Where the snapshot files live, created on the first save.
+		 */
+		explicit StaticSnapshot(std::string directory);
+
+		std::string GetPath(uint32_t scene_id) const;
+
+		/**
+		 * Loads the snapshot of a scene.
+		 *
+		 * @return False if there is no snapshot, it was built from a different key
+		 *      or it is damaged. data is left empty in that case.
+		 */
+		bool Load(uint32_t scene_id, const StaticSnapshotKey& key, StaticSceneData& data) const;
+
+		/**
+		 * Writes the snapshot of a scene, replacing any older one.
+		 *
+		 * @return False if the file could not be written.
+		 */
+		bool Save(uint32_t scene_id, const StaticSnapshotKey& key, const StaticSceneData& data) const;
+
+		/**
+		 * @return A hash over the names, sizes and modification times of the files,
+		 *      changes whenever one of them is added, removed or replaced.
+		 */
+		static uint64_t FingerprintFiles(const std::vector<std::string>& filenames);
+
+	private:
+		std::string directory_;
+	};
+
+}}  // namespace swganh::statics
@@ -0,0 +1,153 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "swganh_core/static/static_snapshot.h"
+
+using namespace swganh::statics;
+
+namespace {
+
+	StaticObjectRow MakeRow(uint64_t object_id, uint64_t parent_id, const std::string& template_name)
+	{
+		StaticObjectRow row = StaticObjectRow();
+		row.object_id = object_id;
+		row.parent_id = parent_id;
+		row.template_name = template_name;
+		row.position = glm::vec3(1.0f, 2.0f, 3.0f);
+		row.orientation = glm::quat(1.0f, 0.0f, 0.5f, 0.0f);
+		return row;
+	}
+
+	StaticSnapshotKey MakeKey(uint32_t static_data_version, uint64_t tre_fingerprint)
+	{
+		StaticSnapshotKey key;
+		key.static_data_version = static_data_version;
+		key.tre_fingerprint = tre_fingerprint;
+		return key;
+	}
+
+	/// Snapshot directory that is removed again when the test ends.
+	struct SnapshotDirectory
+	{
+		SnapshotDirectory()
+			: path((boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string())
+		{}
+
+		~SnapshotDirectory()
+		{
+			boost::system::error_code error;
+			boost::filesystem::remove_all(path, error);
+		}
+
+		std::string path;
+	};
+
+}
+
+BOOST_AUTO_TEST_SUITE(StaticSnapshotTest)
+
+/// This test shows that a saved scene loads back with the same rows in the same order.
+BOOST_AUTO_TEST_CASE(SavedSceneLoadsBack) {
+	SnapshotDirectory directory;
+	StaticSnapshot snapshot(directory.path);
+
+	StaticSceneData data;
+	data.buildings.push_back(MakeRow(10, 0, "object/building/tatooine/shared_cantina_tatooine.iff"));
+	data.cells.push_back(MakeRow(11, 10, "object/cell/shared_cell.iff"));
+	data.cells.push_back(MakeRow(12, 10, "object/cell/shared_cell.iff"));
+	data.npcs.push_back(MakeRow(20, 11, "object/mobile/shared_dressed_tatooine_jabba_thug.iff"));
+	data.npcs.back().custom_name = "Wuher";
+	data.npcs.back().scale = 1.5f;
+
+	StaticElevatorRow elevator = StaticElevatorRow();
+	elevator.terminal_id = 30;
+	elevator.dst_cell = 12;
+	elevator.going_down = true;
+	data.elevators.push_back(elevator);
+
+	data.containers.push_back(MakeRow(40, 11, "object/tangible/container/drum/shared_treasure_drum.iff"));
+
+	StaticCloneLocationRow clone_location = StaticCloneLocationRow();
+	clone_location.cell_id = 12;
+	clone_location.position = glm::vec3(-4.0f, 0.1f, 2.5f);
+	clone_location.city = "mos_eisley";
+	data.clone_locations.push_back(clone_location);
+
+	BOOST_REQUIRE(snapshot.Save(8, MakeKey(3, 42), data));
+
+	StaticSceneData loaded;
+	BOOST_REQUIRE(snapshot.Load(8, MakeKey(3, 42), loaded));
+
+	BOOST_CHECK_EQUAL(1u, loaded.buildings.size());
+	BOOST_REQUIRE_EQUAL(2u, loaded.cells.size());
+	BOOST_CHECK_EQUAL(12u, loaded.cells[1].object_id);
+	BOOST_CHECK_EQUAL(10u, loaded.cells[1].parent_id);
+	BOOST_REQUIRE_EQUAL(1u, loaded.npcs.size());
+	BOOST_CHECK_EQUAL("Wuher", loaded.npcs[0].custom_name);
+	BOOST_CHECK_EQUAL(1.5f, loaded.npcs[0].scale);
+	BOOST_CHECK_EQUAL(data.npcs[0].template_name, loaded.npcs[0].template_name);
+	BOOST_CHECK(loaded.npcs[0].orientation == data.npcs[0].orientation);
+	BOOST_REQUIRE_EQUAL(1u, loaded.elevators.size());
+	BOOST_CHECK(loaded.elevators[0].going_down);
+	BOOST_REQUIRE_EQUAL(1u, loaded.containers.size());
+	BOOST_CHECK_EQUAL(11u, loaded.containers[0].parent_id);
+	BOOST_REQUIRE_EQUAL(1u, loaded.clone_locations.size());
+	BOOST_CHECK_EQUAL(12u, loaded.clone_locations[0].cell_id);
+	BOOST_CHECK_EQUAL("mos_eisley", loaded.clone_locations[0].city);
+	BOOST_CHECK(loaded.clone_locations[0].position == clone_location.position);
+}
+
+/// This test shows that a snapshot built from other static data or tre files is not used.
+BOOST_AUTO_TEST_CASE(StaleSnapshotIsRejected) {
+	SnapshotDirectory directory;
+	StaticSnapshot snapshot(directory.path);
+
+	StaticSceneData data;
+	data.buildings.push_back(MakeRow(10, 0, "object/building/shared_test.iff"));
+	BOOST_REQUIRE(snapshot.Save(1, MakeKey(3, 42), data));
+
+	StaticSceneData loaded;
+	BOOST_CHECK(!snapshot.Load(1, MakeKey(4, 42), loaded));
+	BOOST_CHECK(!snapshot.Load(1, MakeKey(3, 43), loaded));
+	BOOST_CHECK(!snapshot.Load(2, MakeKey(3, 42), loaded));
+	BOOST_CHECK(loaded.buildings.empty());
+}
+
+/// This test shows that a truncated snapshot is rejected rather than half loaded.
+BOOST_AUTO_TEST_CASE(TruncatedSnapshotIsRejected) {
+	SnapshotDirectory directory;
+	StaticSnapshot snapshot(directory.path);
+
+	StaticSceneData data;
+	data.buildings.push_back(MakeRow(10, 0, "object/building/shared_test.iff"));
+	BOOST_REQUIRE(snapshot.Save(1, MakeKey(3, 42), data));
+
+	auto path = snapshot.GetPath(1);
+	boost::filesystem::resize_file(path, boost::filesystem::file_size(path) - 4);
+
+	StaticSceneData loaded;
+	BOOST_CHECK(!snapshot.Load(1, MakeKey(3, 42), loaded));
+}
+
+/// This test shows that replacing one of the files changes the fingerprint.
+BOOST_AUTO_TEST_CASE(FingerprintChangesWithFiles) {
+	SnapshotDirectory directory;
+	boost::filesystem::create_directories(directory.path);
+
+	std::vector<std::string> files;
+	files.push_back((boost::filesystem::path(directory.path) / "patch_00.tre").string());
+	std::ofstream(files[0].c_str()) << "abc";
+
+	uint64_t before = StaticSnapshot::FingerprintFiles(files);
+	BOOST_CHECK_EQUAL(before, StaticSnapshot::FingerprintFiles(files));
+
+	std::ofstream(files[0].c_str()) << "abcdef";
+	BOOST_CHECK(before != StaticSnapshot::FingerprintFiles(files));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
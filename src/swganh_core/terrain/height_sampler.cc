@@ -0,0 +1,342 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "height_sampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "swganh/tre/visitors/terrain/terrain_visitor.h"
+
+#include "swganh/tre/visitors/terrain/detail/container_layer.h"
+#include "swganh/tre/visitors/terrain/detail/boundary_layer.h"
+#include "swganh/tre/visitors/terrain/detail/height_layer.h"
+#include "swganh/tre/visitors/terrain/detail/filter_layer.h"
+
+using namespace swganh::terrain;
+using namespace swganh::tre;
+
+namespace {
+
+	const size_t BATCH_SIZE = 256;
+
+}
+
+HeightSampler::HeightSampler(std::shared_ptr<TerrainVisitor> terrain_visitor)
+	: terrain_visitor_(std::move(terrain_visitor))
+{
+}
+
+float HeightSampler::GetHeight(float x, float z)
+{
+	auto& layers = terrain_visitor_->GetLayers();
+	auto& fractals = terrain_visitor_->GetFractals();
+
+	float affector_transform = 1.0f;
+	float height_result = 0.0f;
+
+	for(auto& layer : layers)
+	{
+		if(layer->enabled)
+		{
+			processLayerHeight(layer, x, z, height_result, affector_transform, fractals);
+		}
+	}
+
+	return height_result;
+}
+
+void HeightSampler::GetHeights(const float* x, const float* z, size_t count, float* heights)
+{
+	auto& layers = terrain_visitor_->GetLayers();
+	auto& fractals = terrain_visitor_->GetFractals();
+
+	// the layer tree is walked for a few hundred points at a time, so the
+	// scratch arrays of every level stay in the cache
+	PointBatch batch;
+
+	for(size_t first = 0; first < count; first += BATCH_SIZE)
+	{
+		size_t batch_count = std::min(BATCH_SIZE, count - first);
+
+		batch.x.assign(x + first, x + first + batch_count);
+		batch.z.assign(z + first, z + first + batch_count);
+		batch.base_values.assign(batch_count, 0.0f);
+		batch.transform_values.resize(batch_count);
+
+		for(auto& layer : layers)
+		{
+			if(layer->enabled)
+			{
+				processLayerHeights(layer, batch, fractals);
+			}
+		}
+
+		std::copy(batch.base_values.begin(), batch.base_values.end(), heights + first);
+	}
+}
+
+void HeightSampler::SampleGrid(float origin_x, float origin_z, float spacing, uint32_t samples, float* heights)
+{
+	std::vector<float> x(samples * samples), z(samples * samples);
+	for(uint32_t row = 0; row < samples; ++row)
+	{
+		for(uint32_t column = 0; column < samples; ++column)
+		{
+			x[row * samples + column] = origin_x + column * spacing;
+			z[row * samples + column] = origin_z + row * spacing;
+		}
+	}
+
+	GetHeights(x.data(), z.data(), x.size(), heights);
+}
+
+float HeightSampler::processLayerHeight(ContainerLayer* layer, float x, float z, float& base_value, float affector_transform, const std::map<uint32_t,Fractal*>& fractals)
+{
+	std::vector<BoundaryLayer*>& boundaries = layer->boundaries;
+	std::vector<HeightLayer*>& heights = layer->heights;
+	std::vector<FilterLayer*>& filters = layer->filters;
+
+	float transform_value = 0.0f;
+	bool has_boundaries = false;
+
+	for (unsigned int i = 0; i < boundaries.size(); i++)
+	{
+		BoundaryLayer* boundary = (BoundaryLayer*)boundaries.at(i);
+
+		if (!boundary->enabled)
+			continue;
+		else
+			has_boundaries = true;
+
+		float result = (float) boundary->Process(x, z);
+
+		result = calculateFeathering(result, boundary->feather_type);
+
+		if (result > transform_value)
+			transform_value = result;
+
+		if (transform_value >= 1)
+			break;
+	}
+
+	if (has_boundaries == false)
+		transform_value = 1.0f;
+
+	if (layer->invert_boundaries)
+		transform_value = 1.0f - transform_value;
+
+	if (transform_value != 0)
+	{
+		for (unsigned int i = 0; i < filters.size(); ++i)
+		{
+			FilterLayer* filter = (FilterLayer*)filters.at(i);
+
+			if (!filter->enabled)
+				continue;
+
+			float result = (float) filter->Process(x, z, transform_value, base_value, fractals);
+
+			result = calculateFeathering(result, filter->feather_type);
+
+			if (transform_value > result)
+				transform_value = result;
+
+			if (transform_value == 0)
+				break;
+		}
+
+		if (layer->invert_filters)
+			transform_value = 1.0f - transform_value;
+
+		if (transform_value != 0)
+		{
+			for (unsigned int i = 0; i < heights.size(); i++)
+			{
+				HeightLayer* affector = (HeightLayer*)heights.at(i);
+
+				if (affector->enabled)
+				{
+					affector->GetBaseHeight(x, z, transform_value, base_value, fractals);
+				}
+			}
+
+			std::vector<ContainerLayer*>& children = layer->children;
+
+			for (unsigned int i = 0; i < children.size(); i++)
+			{
+				ContainerLayer* child = children.at(i);
+
+				if (child->enabled)
+					processLayerHeight(child, x, z, base_value, affector_transform * transform_value, fractals);
+			}
+		}
+	}
+
+	return transform_value;
+}
+
+void HeightSampler::PointBatch::Resize(size_t count)
+{
+	x.resize(count);
+	z.resize(count);
+	base_values.resize(count);
+	transform_values.resize(count);
+	source.resize(count);
+}
+
+void HeightSampler::selectActive(const PointBatch& batch, PointBatch& active)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < batch.x.size(); ++i)
+	{
+		count += (batch.transform_values[i] != 0) ? 1 : 0;
+	}
+
+	active.Resize(count);
+
+	size_t next = 0;
+	for (size_t i = 0; i < batch.x.size(); ++i)
+	{
+		if (batch.transform_values[i] != 0)
+		{
+			active.x[next] = batch.x[i];
+			active.z[next] = batch.z[i];
+			active.base_values[next] = batch.base_values[i];
+			active.transform_values[next] = batch.transform_values[i];
+			active.source[next] = static_cast<uint32_t>(i);
+			++next;
+		}
+	}
+}
+
+// The batched form of processLayerHeight, every point goes through the same
+// steps in the same order as it would on its own. Points drop out of the batch
+// where processLayerHeight stops for them.
+void HeightSampler::processLayerHeights(ContainerLayer* layer, PointBatch& batch, const std::map<uint32_t,Fractal*>& fractals)
+{
+	size_t count = batch.x.size();
+	std::vector<float> results(count);
+
+	std::fill(batch.transform_values.begin(), batch.transform_values.end(), 0.0f);
+	bool has_boundaries = false;
+
+	for (auto boundary : layer->boundaries)
+	{
+		if (!boundary->enabled)
+			continue;
+
+		has_boundaries = true;
+
+		boundary->ProcessBatch(batch.x.data(), batch.z.data(), count, results.data());
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			// processLayerHeight stops at the first boundary that gives 1
+			if (batch.transform_values[i] >= 1)
+				continue;
+
+			float result = calculateFeathering(results[i], boundary->feather_type);
+
+			if (result > batch.transform_values[i])
+				batch.transform_values[i] = result;
+		}
+	}
+
+	if (has_boundaries == false)
+		std::fill(batch.transform_values.begin(), batch.transform_values.end(), 1.0f);
+
+	if (layer->invert_boundaries)
+	{
+		for (auto& transform_value : batch.transform_values)
+			transform_value = 1.0f - transform_value;
+	}
+
+	PointBatch filtered;
+	selectActive(batch, filtered);
+	if (filtered.x.empty())
+		return;
+
+	count = filtered.x.size();
+	results.resize(count);
+
+	for (auto filter : layer->filters)
+	{
+		if (!filter->enabled)
+			continue;
+
+		filter->ProcessBatch(filtered.x.data(), filtered.z.data(), filtered.transform_values.data(), filtered.base_values.data(), count, results.data(), fractals);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			// processLayerHeight stops at the first filter that gives 0
+			if (filtered.transform_values[i] == 0)
+				continue;
+
+			float result = calculateFeathering(results[i], filter->feather_type);
+
+			if (filtered.transform_values[i] > result)
+				filtered.transform_values[i] = result;
+		}
+	}
+
+	if (layer->invert_filters)
+	{
+		for (auto& transform_value : filtered.transform_values)
+			transform_value = 1.0f - transform_value;
+	}
+
+	PointBatch affected;
+	selectActive(filtered, affected);
+
+	if (!affected.x.empty())
+	{
+		for (auto affector : layer->heights)
+		{
+			if (affector->enabled)
+			{
+				affector->GetBaseHeights(affected.x.data(), affected.z.data(), affected.transform_values.data(), affected.base_values.data(), affected.x.size(), fractals);
+			}
+		}
+
+		for (auto child : layer->children)
+		{
+			if (child->enabled)
+				processLayerHeights(child, affected, fractals);
+		}
+
+		for (size_t i = 0; i < affected.x.size(); ++i)
+		{
+			filtered.base_values[affected.source[i]] = affected.base_values[i];
+		}
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		batch.base_values[filtered.source[i]] = filtered.base_values[i];
+	}
+}
+
+float HeightSampler::calculateFeathering(float value, int featheringType) {
+	float result = value;
+
+	switch (featheringType) {
+	case 1:
+		result = result * result;
+		break;
+	case 2:
+		result = sqrt(result);
+		break;
+	case 3:
+		result = result * result * (3 - 2 * result);
+		break;
+	case 0:
+		break;
+	default:
+		result = 0;
+		break;
+	}
+
+	return result;
+}
@@ -0,0 +1,81 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace swganh
+{
+namespace tre
+{
+	class TerrainVisitor;
+	class Fractal;
+	class ContainerLayer;
+}
+}
+
+namespace swganh
+{
+namespace terrain
+{
+	/**
+	 * Evaluates the layer stack of a terrain (height layers, fractals, boundaries
+	 * and feathering) for single points or whole grids.
+	 *
+	 * The layers are only read and the fractals set up their noise tables when
+	 * they are loaded, so any number of threads may sample at once.
+	 */
+	class HeightSampler
+	{
+	public:
+		explicit HeightSampler(std::shared_ptr<swganh::tre::TerrainVisitor> terrain_visitor);
+
+		/**
+		 * @return The exact height at x, z.
+		 */
+		float GetHeight(float x, float z);
+
+		/**
+		 * Exact heights of count points given as separate x and z arrays. The
+		 * layer tree is walked once for the whole batch, the results are the same
+		 * as those of GetHeight for every point.
+		 */
+		void GetHeights(const float* x, const float* z, size_t count, float* heights);
+
+		/**
+		 * Fills a grid of samples * samples heights, row by row along x.
+		 *
+		 * @param origin_x, origin_z The position of the first sample.
+		 * @param spacing Distance between neighbouring samples.
+		 * @param heights Receives samples * samples heights.
+		 */
+		void SampleGrid(float origin_x, float origin_z, float spacing, uint32_t samples, float* heights);
+
+		const std::shared_ptr<swganh::tre::TerrainVisitor>& GetTerrainVisitor() const { return terrain_visitor_; }
+
+	private:
+		float processLayerHeight(swganh::tre::ContainerLayer* layer, float x, float z, float& base_value, float affector_transform, const std::map<uint32_t,swganh::tre::Fractal*>& fractals);
+		float calculateFeathering(float value, int featheringType);
+
+		/// The points of a batch that are still affected by a layer.
+		struct PointBatch
+		{
+			void Resize(size_t count);
+
+			std::vector<float> x, z, base_values, transform_values;
+			std::vector<uint32_t> source;	///< index of each point in the parent batch
+		};
+
+		void processLayerHeights(swganh::tre::ContainerLayer* layer, PointBatch& batch, const std::map<uint32_t,swganh::tre::Fractal*>& fractals);
+
+		/// Copies the points of batch whose transform value is not 0 into active.
+		static void selectActive(const PointBatch& batch, PointBatch& active);
+
+		std::shared_ptr<swganh::tre::TerrainVisitor> terrain_visitor_;
+	};
+}
+}
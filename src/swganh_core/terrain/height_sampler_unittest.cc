@@ -0,0 +1,116 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "swganh_core/terrain/height_sampler.h"
+#include "swganh_core/terrain/mock_terrain_builder.h"
+
+using namespace swganh::terrain;
+using namespace swganh::tre;
+
+namespace {
+
+	/// Uses every fractal combination, bias and gain, both feathered boundary
+	/// shapes, both filter kinds, inverted containers and nested children.
+	std::shared_ptr<TerrainVisitor> MakeTerrain()
+	{
+		MockTerrainBuilder builder;
+		builder.AddFractal(1, 1, 1234, 0.004f)
+			.AddFractal(2, 2, 99, 0.01f, 3, true, false)
+			.AddFractal(3, 3, 7, 0.02f, 2, false, true)
+			.AddFractal(4, 4, 4242, 0.008f, 5, true, true)
+			.AddFractal(5, 5, 31337, 0.003f, 4);
+
+		auto hills = builder.AddContainer();
+		builder.AddHeightFractal(hills, 1, 1, 120.0f);
+
+		auto valleys = builder.AddContainer(hills, true, false);
+		builder.AddRectangle(valleys, -200.0f, -150.0f, 250.0f, 300.0f, 1, 0.25f);
+		builder.AddHeightFractal(valleys, 2, 2, 30.0f);
+		builder.AddHeightFilter(valleys, 20.0f, 90.0f, 3, 0.3f);
+
+		auto plateau = builder.AddContainer(hills);
+		builder.AddCircle(plateau, 100.0f, -50.0f, 350.0f, 3, 0.5f);
+		builder.AddFractalFilter(plateau, 3, 0.1f, 0.9f, 1.0f, 2, 0.4f);
+		builder.AddHeightConstant(plateau, 0, 40.0f);
+
+		auto ridges = builder.AddContainer(plateau, false, true);
+		builder.AddCircle(ridges, -100.0f, 120.0f, 200.0f, 2, 0.2f);
+		builder.AddHeightFractal(ridges, 4, 3, 1.5f);
+
+		auto dunes = builder.AddContainer();
+		builder.AddRectangle(dunes, -600.0f, -600.0f, 0.0f, 600.0f, 0, 0.1f);
+		builder.AddFractalFilter(dunes, 5, 0.2f, 0.8f, 1.0f, 0, 0.5f);
+		builder.AddHeightFractal(dunes, 5, 0, 60.0f);
+
+		return builder.Build();
+	}
+
+}
+
+BOOST_AUTO_TEST_SUITE(HeightSamplerTest)
+
+#if !defined(__FAST_MATH__) && !defined(__FMA__)
+// Fast math, or fused multiply-adds contracted differently in the two paths,
+// leave the batched results close to the scalar ones but not identical.
+BOOST_AUTO_TEST_CASE(BatchedHeightsMatchScalarHeightsExactly)
+{
+	HeightSampler sampler(MakeTerrain());
+
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<float> coordinate(-800.0f, 800.0f);
+
+	std::vector<float> x(4096), z(4096), heights(4096);
+	for (size_t i = 0; i < x.size(); ++i)
+	{
+		x[i] = coordinate(generator);
+		z[i] = coordinate(generator);
+	}
+
+	sampler.GetHeights(x.data(), z.data(), x.size(), heights.data());
+
+	for (size_t i = 0; i < x.size(); ++i)
+	{
+		float expected = sampler.GetHeight(x[i], z[i]);
+		BOOST_REQUIRE_MESSAGE(std::memcmp(&expected, &heights[i], sizeof(float)) == 0,
+			"height at " << x[i] << ", " << z[i] << " is " << heights[i] << " instead of " << expected);
+	}
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(SampledGridMatchesSinglePoints)
+{
+	HeightSampler sampler(MakeTerrain());
+
+	const uint32_t samples = 17;
+	std::vector<float> heights(samples * samples);
+	sampler.SampleGrid(-64.0f, 32.0f, 4.0f, samples, heights.data());
+
+	for (uint32_t row = 0; row < samples; ++row)
+	{
+		for (uint32_t column = 0; column < samples; ++column)
+		{
+			float expected = sampler.GetHeight(-64.0f + column * 4.0f, 32.0f + row * 4.0f);
+			BOOST_CHECK_SMALL(heights[row * samples + column] - expected, 0.001f);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(EmptyBatchIsANoOp)
+{
+	HeightSampler sampler(MakeTerrain());
+
+	float height = 123.0f;
+	sampler.GetHeights(nullptr, nullptr, 0, &height);
+
+	BOOST_CHECK_EQUAL(height, 123.0f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,188 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "height_tile_cache.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <boost/thread/lock_guard.hpp>
+
+using namespace swganh::terrain;
+
+namespace {
+
+	// a power of two, enough that threads looking up different tiles rarely share one
+	const uint32_t SHARD_COUNT = 16;
+
+	uint64_t TileKey(int32_t tile_x, int32_t tile_z)
+	{
+		return (static_cast<uint64_t>(static_cast<uint32_t>(tile_x)) << 32) | static_cast<uint32_t>(tile_z);
+	}
+
+}
+
+HeightTileCache::HeightTileCache(TileSampler sampler, float tile_size, float resolution, uint64_t byte_budget)
+	: sampler_(std::move(sampler))
+	, tile_size_(std::max(tile_size, 1.0f))
+	, cells_(static_cast<uint32_t>(std::ceil(tile_size_ / std::max(resolution, 0.01f))))
+	, spacing_(tile_size_ / cells_)
+	, tile_bytes_((cells_ + 1) * (cells_ + 1) * sizeof(float) + sizeof(Entry) + sizeof(uint64_t) * 4)
+	, byte_budget_(byte_budget)
+	, shard_mask_(SHARD_COUNT - 1)
+	, shards_(new Shard[SHARD_COUNT])
+	, hand_(0)
+	, misses_(0)
+	, evictions_(0)
+{
+}
+
+float HeightTileCache::GetHeight(float x, float z)
+{
+	float tile_x = std::floor(x / tile_size_);
+	float tile_z = std::floor(z / tile_size_);
+
+	auto tile = FindTile_(static_cast<int32_t>(tile_x), static_cast<int32_t>(tile_z));
+
+	// position within the tile in cells, points on the far edge use the last cell
+	float u = (x - tile_x * tile_size_) / spacing_;
+	float v = (z - tile_z * tile_size_) / spacing_;
+
+	uint32_t column = std::min(static_cast<uint32_t>(std::max(u, 0.0f)), cells_ - 1);
+	uint32_t row = std::min(static_cast<uint32_t>(std::max(v, 0.0f)), cells_ - 1);
+
+	float fx = std::min(std::max(u - column, 0.0f), 1.0f);
+	float fz = std::min(std::max(v - row, 0.0f), 1.0f);
+
+	const float* near_row = &(*tile)[row * (cells_ + 1) + column];
+	const float* far_row = near_row + cells_ + 1;
+
+	float near_height = near_row[0] + (near_row[1] - near_row[0]) * fx;
+	float far_height = far_row[0] + (far_row[1] - far_row[0]) * fx;
+
+	return near_height + (far_height - near_height) * fz;
+}
+
+void HeightTileCache::Clear()
+{
+	boost::lock_guard<boost::mutex> lock(mutex_);
+
+	for (uint32_t i = 0; i < SHARD_COUNT; ++i)
+	{
+		boost::lock_guard<boost::shared_mutex> shard_lock(shards_[i].mutex);
+		shards_[i].tiles.clear();
+	}
+
+	clock_.clear();
+	hand_ = 0;
+}
+
+HeightTileCacheStatistics HeightTileCache::GetStatistics() const
+{
+	boost::lock_guard<boost::mutex> lock(mutex_);
+
+	HeightTileCacheStatistics statistics;
+	statistics.hits = 0;
+	for (uint32_t i = 0; i < SHARD_COUNT; ++i)
+	{
+		statistics.hits += shards_[i].hits.load(std::memory_order_relaxed);
+	}
+	statistics.misses = misses_;
+	statistics.evictions = evictions_;
+	statistics.tiles = clock_.size();
+	statistics.bytes = clock_.size() * tile_bytes_;
+	return statistics;
+}
+
+HeightTileCache::Shard& HeightTileCache::GetShard_(uint64_t key) const
+{
+	// neighbouring tiles differ in the low bits of either half of the key
+	return shards_[static_cast<uint32_t>((key >> 32) * 31 + key) & shard_mask_];
+}
+
+std::shared_ptr<const HeightTileCache::Tile> HeightTileCache::FindTile_(int32_t tile_x, int32_t tile_z)
+{
+	uint64_t key = TileKey(tile_x, tile_z);
+	auto& shard = GetShard_(key);
+
+	{
+		boost::shared_lock<boost::shared_mutex> lock(shard.mutex);
+
+		auto found = shard.tiles.find(key);
+		if (found != shard.tiles.end())
+		{
+			shard.hits.fetch_add(1, std::memory_order_relaxed);
+
+			// only written when it changes, a hot tile's line is not bounced between cores
+			if (!found->second.referenced.load(std::memory_order_relaxed))
+			{
+				found->second.referenced.store(true, std::memory_order_relaxed);
+			}
+			return found->second.tile;
+		}
+	}
+
+	// filled without any lock, a tile missed by two threads at once is sampled twice
+	auto tile = std::make_shared<Tile>((cells_ + 1) * (cells_ + 1));
+	sampler_(tile_x * tile_size_, tile_z * tile_size_, spacing_, cells_ + 1, tile->data());
+
+	boost::lock_guard<boost::mutex> lock(mutex_);
+	++misses_;
+
+	{
+		boost::lock_guard<boost::shared_mutex> shard_lock(shard.mutex);
+
+		auto inserted = shard.tiles.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(tile));
+		if (!inserted.second)
+		{
+			return inserted.first->second.tile;
+		}
+	}
+
+	// just behind the hand, the last tile it comes to
+	if (hand_ > clock_.size())
+	{
+		hand_ = 0;
+	}
+	clock_.insert(clock_.begin() + hand_, key);
+	++hand_;
+
+	// the tile just filled is handed out even if it does not fit the budget
+	while (byte_budget_ && clock_.size() * tile_bytes_ > byte_budget_)
+	{
+		EvictOne_();
+	}
+
+	return tile;
+}
+
+void HeightTileCache::EvictOne_()
+{
+	// every tile is passed over at most once, the second lap drops one
+	for (;;)
+	{
+		if (hand_ >= clock_.size())
+		{
+			hand_ = 0;
+		}
+
+		uint64_t key = clock_[hand_];
+		auto& shard = GetShard_(key);
+
+		boost::lock_guard<boost::shared_mutex> shard_lock(shard.mutex);
+
+		auto found = shard.tiles.find(key);
+		if (found->second.referenced.exchange(false, std::memory_order_relaxed))
+		{
+			++hand_;
+			continue;
+		}
+
+		shard.tiles.erase(found);
+
+		// a miss already costs a tile of samples, moving the keys after it is cheap
+		clock_.erase(clock_.begin() + hand_);
+		++evictions_;
+		return;
+	}
+}
@@ -0,0 +1,125 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
+namespace swganh
+{
+namespace terrain
+{
+	struct HeightTileCacheStatistics
+	{
+		uint64_t hits;
+		uint64_t misses;		///< lookups that filled a tile
+		uint64_t evictions;
+		uint64_t tiles;
+		uint64_t bytes;
+	};
+
+	/**
+	 * Lazily filled grid of terrain heights for one scene.
+	 *
+	 * The terrain is split into square tiles, a tile is filled with one call to
+	 * the sampler the first time a point in it is asked for, later lookups
+	 * interpolate bilinearly between the four surrounding samples. Neighbouring
+	 * tiles share their edge samples, so the interpolated surface is continuous.
+	 *
+	 * Once the tiles take more than the byte budget tiles are dropped with the
+	 * CLOCK policy: a hit only sets the tile's reference bit, and the eviction
+	 * hand passes over referenced tiles once, clearing the bit, before it drops
+	 * one. The tiles are spread over shards, a hit takes only the read lock of
+	 * its shard so lookups from many threads do not queue on one mutex. Misses
+	 * and evictions are serialized by one mutex, the budget holds for the cache
+	 * as a whole.
+	 */
+	class HeightTileCache : private boost::noncopyable
+	{
+	public:
+		/**
+		 * Fills samples * samples heights, row by row along x, starting at
+		 * origin_x, origin_z with spacing between neighbouring samples.
+		 */
+		typedef std::function<void (float origin_x, float origin_z, float spacing, uint32_t samples, float* heights)> TileSampler;
+
+		/**
+		 * @param sampler Evaluates the terrain, called without any lock held.
+		 * @param tile_size Edge length of a tile in meters.
+		 * @param resolution Largest distance between samples in meters.
+		 * @param byte_budget Bytes of tiles to keep, 0 for no limit.
+		 */
+		HeightTileCache(TileSampler sampler, float tile_size = 64.0f, float resolution = 2.0f, uint64_t byte_budget = 0);
+
+		/**
+		 * @return The height at x, z interpolated from the tile holding it.
+		 */
+		float GetHeight(float x, float z);
+
+		/// Drops every tile, eg. after the terrain changed.
+		void Clear();
+
+		HeightTileCacheStatistics GetStatistics() const;
+
+		float GetTileSize() const { return tile_size_; }
+		float GetSpacing() const { return spacing_; }
+
+	private:
+		typedef std::vector<float> Tile;
+
+		struct Entry
+		{
+			explicit Entry(std::shared_ptr<const Tile> tile)
+				: tile(std::move(tile))
+				, referenced(false)
+			{}
+
+			std::shared_ptr<const Tile> tile;
+			std::atomic<bool> referenced;	// set by hits under the shard read lock
+		};
+
+		struct Shard
+		{
+			Shard() : hits(0) {}
+
+			mutable boost::shared_mutex mutex;
+			std::unordered_map<uint64_t, Entry> tiles;
+			std::atomic<uint64_t> hits;
+		};
+
+		Shard& GetShard_(uint64_t key) const;
+
+		std::shared_ptr<const Tile> FindTile_(int32_t tile_x, int32_t tile_z);
+
+		// must be called with mutex_ held
+		void EvictOne_();
+
+		TileSampler sampler_;
+		float tile_size_;
+		uint32_t cells_;		// cells along one edge of a tile, samples are cells_ + 1
+		float spacing_;
+		uint64_t tile_bytes_;
+		uint64_t byte_budget_;
+
+		uint32_t shard_mask_;
+		std::unique_ptr<Shard[]> shards_;
+
+		// guards the clock, the miss and eviction counts and every insert or erase,
+		// taken before a shard lock
+		mutable boost::mutex mutex_;
+		std::vector<uint64_t> clock_;	// keys of every cached tile in the order the hand visits them
+		size_t hand_;					// next key the hand looks at
+		uint64_t misses_;
+		uint64_t evictions_;
+	};
+}
+}
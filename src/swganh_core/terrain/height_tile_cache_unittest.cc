@@ -0,0 +1,234 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "swganh_core/terrain/height_sampler.h"
+#include "swganh_core/terrain/height_tile_cache.h"
+#include "swganh_core/terrain/mock_terrain_builder.h"
+
+using namespace swganh::terrain;
+using namespace swganh::tre;
+
+namespace {
+
+	// Interpolating between samples 2 m apart stays this close to the exact
+	// height of the test terrain, whose hills are a few hundred meters across.
+	const float HEIGHT_TOLERANCE = 0.1f;
+
+	const float PLATEAU_RADIUS = 300.0f;
+
+	const int LOOKUP_THREADS = 4;
+	const int LOOKUPS = 20000;
+
+	/// Rolling hills with a plateau around the origin, its edge feathered over
+	/// plateau_feathering of the radius.
+	std::shared_ptr<TerrainVisitor> MakeTerrain(float plateau_feathering = 0.5f)
+	{
+		MockTerrainBuilder builder;
+		builder.AddFractal(1, 1, 1234, 0.004f);
+
+		auto hills = builder.AddContainer();
+		builder.AddHeightFractal(hills, 1, 1, 120.0f);
+
+		auto plateau = builder.AddContainer(hills);
+		builder.AddCircle(plateau, 0.0f, 0.0f, PLATEAU_RADIUS, 3, plateau_feathering);
+		builder.AddHeightConstant(plateau, 0, 40.0f);
+
+		return builder.Build();
+	}
+
+	HeightTileCache::TileSampler SamplerFor(const std::shared_ptr<HeightSampler>& sampler)
+	{
+		return [sampler] (float origin_x, float origin_z, float spacing, uint32_t samples, float* heights) {
+			sampler->SampleGrid(origin_x, origin_z, spacing, samples, heights);
+		};
+	}
+
+}
+
+BOOST_AUTO_TEST_SUITE(HeightTileCacheTest)
+
+/// This test shows that heights interpolated from the tiles stay within
+/// HEIGHT_TOLERANCE of the exact heights of the layer stack.
+BOOST_AUTO_TEST_CASE(InterpolatedHeightsStayCloseToExactHeights) {
+	auto sampler = std::make_shared<HeightSampler>(MakeTerrain());
+	HeightTileCache cache(SamplerFor(sampler), 64.0f, 2.0f);
+
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+
+	float largest_error = 0.0f, lowest = 1e9f, highest = -1e9f;
+	for (int i = 0; i < 5000; ++i)
+	{
+		float x = position(random);
+		float z = position(random);
+
+		float exact = sampler->GetHeight(x, z);
+		largest_error = std::max(largest_error, std::fabs(cache.GetHeight(x, z) - exact));
+		lowest = std::min(lowest, exact);
+		highest = std::max(highest, exact);
+	}
+
+	BOOST_TEST_MESSAGE("largest error " << largest_error << " m over heights from " << lowest << " to " << highest);
+	BOOST_CHECK_GT(highest - lowest, 20.0f);
+	BOOST_CHECK_LE(largest_error, HEIGHT_TOLERANCE);
+
+	// sample positions, including tile edges and negative tiles, are exact
+	BOOST_CHECK_CLOSE(sampler->GetHeight(128.0f, -64.0f), cache.GetHeight(128.0f, -64.0f), 0.001f);
+	BOOST_CHECK_CLOSE(sampler->GetHeight(-2.0f, 6.0f), cache.GetHeight(-2.0f, 6.0f), 0.001f);
+}
+
+/// This test shows that an unfeathered edge is only approximated by the cells
+/// it crosses: elsewhere the interpolated heights stay within HEIGHT_TOLERANCE,
+/// on the edge they stay between the exact heights of the cell's corners.
+BOOST_AUTO_TEST_CASE(HardEdgesAreApproximatedWithinTheirCells) {
+	auto sampler = std::make_shared<HeightSampler>(MakeTerrain(0.0f));
+	HeightTileCache cache(SamplerFor(sampler), 64.0f, 2.0f);
+
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+	std::uniform_real_distribution<float> offset(-20.0f, 20.0f);
+
+	// a cell is spacing wide, its corners lie at most a diagonal from any point in it
+	float cell_diagonal = cache.GetSpacing() * 1.5f;
+
+	float largest_error = 0.0f, largest_edge_error = 0.0f;
+	int edge_points = 0;
+	for (int i = 0; i < 5000; ++i)
+	{
+		// points within 20 m of the plateau edge
+		float radius = PLATEAU_RADIUS + offset(random);
+		float a = angle(random);
+		float x = radius * std::cos(a);
+		float z = radius * std::sin(a);
+
+		float height = cache.GetHeight(x, z);
+		float error = std::fabs(height - sampler->GetHeight(x, z));
+
+		if (std::fabs(std::sqrt(x * x + z * z) - PLATEAU_RADIUS) > cell_diagonal)
+		{
+			largest_error = std::max(largest_error, error);
+			continue;
+		}
+
+		++edge_points;
+		largest_edge_error = std::max(largest_edge_error, error);
+
+		float corner_x = std::floor(x / cache.GetSpacing()) * cache.GetSpacing();
+		float corner_z = std::floor(z / cache.GetSpacing()) * cache.GetSpacing();
+		float corners[] = {
+			sampler->GetHeight(corner_x, corner_z),
+			sampler->GetHeight(corner_x + cache.GetSpacing(), corner_z),
+			sampler->GetHeight(corner_x, corner_z + cache.GetSpacing()),
+			sampler->GetHeight(corner_x + cache.GetSpacing(), corner_z + cache.GetSpacing())
+		};
+
+		BOOST_CHECK_GE(height, *std::min_element(corners, corners + 4) - 0.001f);
+		BOOST_CHECK_LE(height, *std::max_element(corners, corners + 4) + 0.001f);
+	}
+
+	BOOST_TEST_MESSAGE("largest error " << largest_error << " m away from the edge, "
+		<< largest_edge_error << " m at " << edge_points << " points on it");
+	BOOST_CHECK_GT(edge_points, 0);
+	BOOST_CHECK_LE(largest_error, HEIGHT_TOLERANCE);
+	BOOST_CHECK_GT(largest_edge_error, HEIGHT_TOLERANCE);
+
+	// the exact path has the edge where the boundary puts it
+	BOOST_CHECK_EQUAL(40.0f, sampler->GetHeight(PLATEAU_RADIUS - 0.01f, 0.0f));
+}
+
+/// This test shows that tiles are filled once and, when they no longer fit
+/// the budget, the clock hand drops the tiles not used since it last passed.
+BOOST_AUTO_TEST_CASE(LeastRecentlyUsedTilesAreEvicted) {
+	int fills = 0;
+	auto sampler = [&fills] (float origin_x, float origin_z, float spacing, uint32_t samples, float* heights) {
+		++fills;
+		for (uint32_t i = 0; i < samples * samples; ++i)
+		{
+			heights[i] = origin_x + (i % samples) * spacing;
+		}
+	};
+
+	// room for two tiles of 33 * 33 samples
+	HeightTileCache cache(sampler, 64.0f, 2.0f, 2 * 33 * 33 * sizeof(float) + 1024);
+
+	BOOST_CHECK_CLOSE(10.5f, cache.GetHeight(10.5f, 3.0f), 0.001f);
+	BOOST_CHECK_CLOSE(70.0f, cache.GetHeight(70.0f, 3.0f), 0.001f);
+	BOOST_CHECK_CLOSE(20.0f, cache.GetHeight(20.0f, 63.0f), 0.001f);
+	BOOST_CHECK_EQUAL(2, fills);
+
+	// the tile at x 64 is now the least recently used one
+	BOOST_CHECK_CLOSE(-30.0f, cache.GetHeight(-30.0f, 3.0f), 0.001f);
+	BOOST_CHECK_EQUAL(3, fills);
+	cache.GetHeight(20.0f, 20.0f);
+	BOOST_CHECK_EQUAL(3, fills);
+	cache.GetHeight(70.0f, 20.0f);
+	BOOST_CHECK_EQUAL(4, fills);
+
+	auto statistics = cache.GetStatistics();
+	BOOST_CHECK_EQUAL(2u, statistics.tiles);
+	BOOST_CHECK_EQUAL(4u, statistics.misses);
+	BOOST_CHECK_EQUAL(2u, statistics.hits);
+	BOOST_CHECK_EQUAL(2u, statistics.evictions);
+}
+
+/// This test shows that lookups from several threads, with tiles evicted and
+/// filled under them, return the right heights and keep to the budget.
+BOOST_AUTO_TEST_CASE(ConcurrentLookupsWhileTilesAreEvicted) {
+	auto sampler = [] (float origin_x, float origin_z, float spacing, uint32_t samples, float* heights) {
+		for (uint32_t i = 0; i < samples * samples; ++i)
+		{
+			heights[i] = origin_x + (i % samples) * spacing + (origin_z + (i / samples) * spacing) * 1000.0f;
+		}
+	};
+
+	// room for eight tiles out of the hundred looked up
+	HeightTileCache cache(sampler, 64.0f, 2.0f, 8 * 33 * 33 * sizeof(float) + 4096);
+
+	// Boost.Test assertions are not thread safe, the threads only count
+	std::atomic<int> mismatches(0);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < LOOKUP_THREADS; ++t)
+	{
+		threads.push_back(std::thread([&cache, &mismatches, t] {
+			std::mt19937 random(t);
+			std::uniform_int_distribution<int> position(0, 639);
+
+			for (int i = 0; i < LOOKUPS; ++i)
+			{
+				// whole meters are sample positions, their heights are exact
+				float x = static_cast<float>(position(random) & ~1);
+				float z = static_cast<float>(position(random) & ~1);
+
+				if (cache.GetHeight(x, z) != x + z * 1000.0f)
+				{
+					++mismatches;
+				}
+			}
+		}));
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	auto statistics = cache.GetStatistics();
+	BOOST_TEST_MESSAGE(statistics.hits << " hits, " << statistics.misses << " misses");
+	BOOST_CHECK_EQUAL(0, mismatches.load());
+	BOOST_CHECK_EQUAL(static_cast<uint64_t>(LOOKUP_THREADS * LOOKUPS), statistics.hits + statistics.misses);
+	BOOST_CHECK_LE(statistics.tiles, 8u);
+	BOOST_CHECK_GT(statistics.evictions, 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,175 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "swganh/byte_buffer.h"
+#include "swganh/tre/visitors/terrain/terrain_visitor.h"
+#include "swganh/tre/visitors/terrain/detail/boundary_circle.h"
+#include "swganh/tre/visitors/terrain/detail/boundary_polygon.h"
+#include "swganh/tre/visitors/terrain/detail/boundary_rectangle.h"
+#include "swganh/tre/visitors/terrain/detail/container_layer.h"
+#include "swganh/tre/visitors/terrain/detail/filter_fractal.h"
+#include "swganh/tre/visitors/terrain/detail/filter_height.h"
+#include "swganh/tre/visitors/terrain/detail/fractal.h"
+#include "swganh/tre/visitors/terrain/detail/header.h"
+#include "swganh/tre/visitors/terrain/detail/height_constant.h"
+#include "swganh/tre/visitors/terrain/detail/height_fractal.h"
+
+namespace swganh
+{
+namespace terrain
+{
+	/**
+	 * Builds terrain layer stacks for tests, the layers are fed the same data
+	 * they would read from a .trn file and are owned by the TerrainVisitor.
+	 */
+	class MockTerrainBuilder
+	{
+	public:
+		MockTerrainBuilder()
+			: terrain_(std::make_shared<swganh::tre::TerrainVisitor>())
+		{}
+
+		MockTerrainBuilder& AddFractal(int32_t fractal_id, uint32_t combination, int32_t seed, float frequency,
+			uint32_t octaves = 4, bool use_bias = false, bool use_gain = false)
+		{
+			swganh::ByteBuffer header;
+			header.write<int32_t>(fractal_id);
+			for (char c : std::string("fractal"))
+			{
+				header.write<char>(c);
+			}
+			header.write<char>(0);
+
+			swganh::ByteBuffer data;
+			data.write<int32_t>(seed);
+			data.write<int32_t>(use_bias ? 1 : 0).write<float>(0.6f);
+			data.write<int32_t>(use_gain ? 1 : 0).write<float>(0.7f);
+			data.write<uint32_t>(octaves).write<float>(2.0f);
+			data.write<float>(0.5f);	// amplitude
+			data.write<float>(frequency).write<float>(frequency);
+			data.write<float>(13.0f).write<float>(-7.0f);	// offset
+			data.write<uint32_t>(combination);
+
+			auto fractal = new swganh::tre::Fractal(header);
+			fractal->Deserialize(data);
+			terrain_->GetFractals().insert(swganh::tre::FractalMap::value_type(fractal_id, fractal));
+			return *this;
+		}
+
+		/// Adds a container to parent, or a top level one if parent is null.
+		swganh::tre::ContainerLayer* AddContainer(swganh::tre::ContainerLayer* parent = nullptr,
+			bool invert_boundaries = false, bool invert_filters = false)
+		{
+			swganh::ByteBuffer data;
+			data.write<uint32_t>(invert_boundaries ? 1 : 0).write<uint32_t>(invert_filters ? 1 : 0);
+
+			auto container = Make<swganh::tre::ContainerLayer>(data);
+			if (parent)
+			{
+				parent->InsertLayer(container);
+			}
+			else
+			{
+				terrain_->GetLayers().push_back(container);
+			}
+			return container;
+		}
+
+		void AddCircle(swganh::tre::ContainerLayer* parent, float x, float z, float radius, uint32_t feather_type, float feather_amount)
+		{
+			swganh::ByteBuffer data;
+			data.write<float>(x).write<float>(z).write<float>(radius);
+			data.write<uint32_t>(feather_type).write<float>(feather_amount);
+			parent->InsertLayer(Make<swganh::tre::BoundaryCircle>(data));
+		}
+
+		void AddRectangle(swganh::tre::ContainerLayer* parent, float x1, float z1, float x2, float z2, uint32_t feather_type, float feather_amount)
+		{
+			swganh::ByteBuffer data;
+			data.write<float>(x1).write<float>(z1).write<float>(x2).write<float>(z2);
+			data.write<uint32_t>(feather_type).write<float>(feather_amount);
+			parent->InsertLayer(Make<swganh::tre::BoundaryRectangle>(data));
+		}
+
+		void AddWaterPolygon(swganh::tre::ContainerLayer* parent, const std::vector<glm::vec2>& vertices, float water_height)
+		{
+			swganh::ByteBuffer data;
+			data.write<uint32_t>(static_cast<uint32_t>(vertices.size()));
+			for (auto& vertex : vertices)
+			{
+				data.write<float>(vertex.x).write<float>(vertex.y);
+			}
+			data.write<uint32_t>(0).write<float>(0.0f);	// feathering
+			data.write<uint32_t>(1).write<float>(water_height);
+			data.write<float>(2.0f);	// water shader size
+			for (char c : std::string("water"))
+			{
+				data.write<char>(c);
+			}
+			data.write<char>(0);
+			parent->InsertLayer(Make<swganh::tre::BoundaryPolygon>(data));
+		}
+
+		void SetGlobalWaterHeight(float water_height)
+		{
+			terrain_->GetHeader()->use_global_water_height = 1;
+			terrain_->GetHeader()->global_water_height = water_height;
+		}
+
+		void AddHeightFractal(swganh::tre::ContainerLayer* parent, uint32_t fractal_id, uint32_t transform_type, float height)
+		{
+			swganh::ByteBuffer data;
+			data.write<uint32_t>(fractal_id).write<uint32_t>(transform_type).write<float>(height);
+			parent->InsertLayer(Make<swganh::tre::HeightFractal>(data));
+		}
+
+		void AddHeightConstant(swganh::tre::ContainerLayer* parent, uint32_t transform_type, float height)
+		{
+			swganh::ByteBuffer data;
+			data.write<uint32_t>(transform_type).write<float>(height);
+			parent->InsertLayer(Make<swganh::tre::HeightConstant>(data));
+		}
+
+		void AddFractalFilter(swganh::tre::ContainerLayer* parent, uint32_t fractal_id, float min, float max, float step,
+			uint32_t feather_type, float feather_amount)
+		{
+			swganh::ByteBuffer data;
+			data.write<uint32_t>(fractal_id);
+			data.write<uint32_t>(feather_type).write<float>(feather_amount);
+			data.write<float>(min).write<float>(max).write<float>(step);
+			parent->InsertLayer(Make<swganh::tre::FractalFilter>(data));
+		}
+
+		void AddHeightFilter(swganh::tre::ContainerLayer* parent, float min_height, float max_height, uint32_t feather_type, float feather_amount)
+		{
+			swganh::ByteBuffer data;
+			data.write<float>(min_height).write<float>(max_height);
+			data.write<uint32_t>(feather_type).write<float>(feather_amount);
+			parent->InsertLayer(Make<swganh::tre::HeightFilter>(data));
+		}
+
+		std::shared_ptr<swganh::tre::TerrainVisitor> Build() { return terrain_; }
+
+	private:
+		template<typename T>
+		T* Make(swganh::ByteBuffer& data)
+		{
+			auto layer = new T();
+			layer->enabled = true;
+			layer->Deserialize(data);
+			return layer;
+		}
+
+		std::shared_ptr<swganh::tre::TerrainVisitor> terrain_;
+	};
+}
+}
@@ -0,0 +1,68 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "terrain_scene.h"
+
+#include <cfloat>
+
+#include "swganh/tre/visitors/terrain/terrain_visitor.h"
+#include "swganh/tre/visitors/terrain/detail/header.h"
+
+using namespace swganh::terrain;
+using namespace swganh::tre;
+
+TerrainScene::TerrainScene(std::shared_ptr<TerrainVisitor> terrain_visitor, float tile_size, float resolution, uint64_t byte_budget)
+	: terrain_visitor_(std::move(terrain_visitor))
+	, height_sampler_(std::make_shared<HeightSampler>(terrain_visitor_))
+	, water_index_(*terrain_visitor_)
+{
+	auto sampler = height_sampler_;
+	height_cache_.reset(new HeightTileCache(
+		[sampler] (float origin_x, float origin_z, float spacing, uint32_t samples, float* heights) {
+			sampler->SampleGrid(origin_x, origin_z, spacing, samples, heights);
+		},
+		tile_size,
+		resolution,
+		byte_budget));
+}
+
+float TerrainScene::GetHeight(float x, float z, bool raw) const
+{
+	if(raw)
+	{
+		return height_sampler_->GetHeight(x, z);
+	}
+
+	return height_cache_->GetHeight(x, z);
+}
+
+void TerrainScene::GetHeights(const float* x, const float* z, size_t count, float* heights, bool raw) const
+{
+	if(raw)
+	{
+		height_sampler_->GetHeights(x, z, count, heights);
+		return;
+	}
+
+	for(size_t i = 0; i < count; ++i)
+	{
+		heights[i] = height_cache_->GetHeight(x[i], z[i]);
+	}
+}
+
+float TerrainScene::GetWaterHeight(float x, float z) const
+{
+	float result;
+	if(water_index_.GetWaterHeight(x, z, result))
+	{
+		return result;
+	}
+
+	auto header = terrain_visitor_->GetHeader();
+	if(header->use_global_water_height)
+	{
+		return header->global_water_height;
+	}
+
+	return FLT_MIN;
+}
@@ -0,0 +1,66 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include <boost/noncopyable.hpp>
+
+#include "height_sampler.h"
+#include "height_tile_cache.h"
+#include "water_index.h"
+
+namespace swganh
+{
+namespace tre
+{
+	class TerrainVisitor;
+}
+}
+
+namespace swganh
+{
+namespace terrain
+{
+	/**
+	 * The loaded terrain of one scene.
+	 *
+	 * Nothing changes once the scene is built, apart from the height cache which
+	 * guards itself, so any number of threads may query it at once.
+	 */
+	class TerrainScene : private boost::noncopyable
+	{
+	public:
+		/**
+		 * @param tile_size, resolution, byte_budget The height cache settings, see HeightTileCache.
+		 */
+		TerrainScene(std::shared_ptr<swganh::tre::TerrainVisitor> terrain_visitor, float tile_size, float resolution, uint64_t byte_budget);
+
+		/**
+		 * @param raw Evaluate the terrain layers at this exact point instead of
+		 *	interpolating from the cached height tiles, which approximate
+		 *	unfeathered boundary edges (see TerrainService::GetHeight).
+		 */
+		float GetHeight(float x, float z, bool raw) const;
+
+		void GetHeights(const float* x, const float* z, size_t count, float* heights, bool raw) const;
+
+		/**
+		 * @return The height of the water polygon holding x, z, otherwise the
+		 *	global water height of the terrain if it has one, else FLT_MIN.
+		 */
+		float GetWaterHeight(float x, float z) const;
+
+		const std::shared_ptr<swganh::tre::TerrainVisitor>& GetTerrainVisitor() const { return terrain_visitor_; }
+		HeightTileCache& GetHeightCache() const { return *height_cache_; }
+
+	private:
+		std::shared_ptr<swganh::tre::TerrainVisitor> terrain_visitor_;
+		std::shared_ptr<HeightSampler> height_sampler_;
+		std::unique_ptr<HeightTileCache> height_cache_;
+		WaterIndex water_index_;
+	};
+}
+}
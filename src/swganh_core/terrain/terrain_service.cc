@@ -3,7 +3,12 @@
 
 #include "terrain_service.h"
 
-#include <map>
+#include <algorithm>
+#include <cfloat>
+
+#include <boost/thread/lock_guard.hpp>
+
+#include "terrain_scene.h"
 
 #include "swganh_core/simulation/scene_events.h"
 
@@ -11,31 +16,28 @@
 #include <swganh/logger.h>
 
 #include "swganh/tre/resource_manager.h"
-//#include "swganh/tre/visitors/terrain/layer_visitor.h"
 #include "swganh/tre/visitors/terrain/terrain_visitor.h"
 
-#include "swganh/tre/visitors/terrain/detail/container_layer.h"
-#include "swganh/tre/visitors/terrain/detail/boundary_layer.h"
-#include "swganh/tre/visitors/terrain/detail/height_layer.h"
-#include "swganh/tre/visitors/terrain/detail/filter_layer.h"
-#include "swganh/tre/visitors/terrain/detail/boundary_polygon.h"
-#include "swganh/tre/visitors/terrain/detail/header.h"
-
 using namespace swganh::terrain;
 using namespace swganh::tre;
 
-TerrainService::TerrainService(swganh::app::SwganhKernel* kernel) : kernel_(kernel)
+TerrainService::TerrainService(swganh::app::SwganhKernel* kernel)
+	: scenes_(std::make_shared<SceneMap>())
+	, kernel_(kernel)
 {
 	kernel_->GetEventDispatcher()->Subscribe("SceneManager:NewScene", [&] (const std::shared_ptr<swganh::EventInterface>& newEvent)
 	{
 		auto real_event = std::static_pointer_cast<swganh::simulation::NewSceneEvent>(newEvent);
 		try
 		{
-			SceneEntry entry;
-			entry.terrain_visitor_ = kernel_->GetResourceManager()->GetResourceByName<TerrainVisitor>(real_event->terrain_filename, false);
-			
-			boost::lock_guard<boost::mutex> lock(terrain_mutex_);
-			scenes_.insert(SceneMap::value_type(real_event->scene_id, std::move(entry)));
+			auto terrain_visitor = kernel_->GetResourceManager()->GetResourceByName<TerrainVisitor>(real_event->terrain_filename, false);
+
+			auto& config = kernel_->GetAppConfig();
+			AddScene(real_event->scene_id, std::make_shared<TerrainScene>(
+				terrain_visitor,
+				config.terrain_tile_size,
+				config.terrain_tile_resolution,
+				static_cast<uint64_t>(config.terrain_cache_size) * 1024 * 1024));
 		}
 		catch(...)
 		{
@@ -46,9 +48,7 @@ TerrainService::TerrainService(swganh::app::SwganhKernel* kernel) : kernel_(kern
 	kernel_->GetEventDispatcher()->Subscribe("SceneManager:DestroyScene", [&] (const std::shared_ptr<swganh::EventInterface>& newEvent)
 	{
 		auto real_event = std::static_pointer_cast<swganh::simulation::DestroySceneEvent>(newEvent);
-		
-		boost::lock_guard<boost::mutex> lock(terrain_mutex_);
-		this->scenes_.erase(real_event->scene_id);
+		RemoveScene(real_event->scene_id);
 	});
 }
 
@@ -65,211 +65,99 @@ swganh::service::ServiceDescription TerrainService::GetServiceDescription()
 	return service_description;
 }
 
-bool TerrainService::waterHeightHelper(swganh::tre::ContainerLayer* layer, float x, float z, float& result)
+void TerrainService::AddScene(uint32_t scene_id, std::shared_ptr<TerrainScene> scene)
 {
-	//Check our boundaries
-	for(auto& boundary : layer->boundaries)
-	{
-		if(boundary->GetType() == LAYER_TYPE_BOUNDARY_POLYGON)
-		{
-			BoundaryPolygon* bpol = (BoundaryPolygon*)boundary;
-			if(bpol->use_water_height && bpol->IsContained(x, z))
-			{
-				result = bpol->water_height;
-				return true;
-			}
-		}
-	}
-
-	//Check our children recursively
-	for(auto& child : layer->children)
-	{
-		if(waterHeightHelper(child, x, z, result))
-		{
-			return true;
-		}
-	}
+	boost::lock_guard<boost::mutex> lock(terrain_mutex_);
 
-	return false;
+	auto scenes = std::make_shared<SceneMap>(*scenes_);
+	(*scenes)[scene_id] = std::move(scene);
+	std::atomic_store(&scenes_, std::shared_ptr<const SceneMap>(std::move(scenes)));
 }
 
-float TerrainService::GetWaterHeight(uint32_t scene_id, float x, float z, float raw)
+void TerrainService::RemoveScene(uint32_t scene_id)
 {
 	boost::lock_guard<boost::mutex> lock(terrain_mutex_);
-	auto itr = scenes_.find(scene_id);
-	if(itr != scenes_.end())
-	{
-		for(auto& child : itr->second.terrain_visitor_->GetLayers())
-		{
-			float result;
-			if(waterHeightHelper(child, x, z, result))
-			{
-				return result;
-			}
-		}
 
-		if(!raw)
-		{
-			//Todo:Apply any necessary layer modifications
-		}
-		
-		auto header = itr->second.terrain_visitor_->GetHeader();
-		if(header->use_global_water_height)
-		{
-			return header->global_water_height;
-		}
-	}
-	return FLT_MIN;
+	auto scenes = std::make_shared<SceneMap>(*scenes_);
+	scenes->erase(scene_id);
+	std::atomic_store(&scenes_, std::shared_ptr<const SceneMap>(std::move(scenes)));
 }
 
-float TerrainService::GetHeight(uint32_t scene_id, float x, float z, bool raw)
+std::shared_ptr<TerrainScene> TerrainService::FindScene_(uint32_t scene_id) const
 {
-	boost::lock_guard<boost::mutex> lock(terrain_mutex_);
-	auto itr = scenes_.find(scene_id);
-	if(itr != scenes_.end())
-	{
-		//Read in height at this point
-		auto& layers = itr->second.terrain_visitor_->GetLayers();
-		auto& fractals = itr->second.terrain_visitor_->GetFractals();
+	auto scenes = std::atomic_load(&scenes_);
 
-		float affector_transform = 1.0f;
-		float height_result = 0.0f;
+	auto itr = scenes->find(scene_id);
+	if(itr == scenes->end())
+	{
+		return nullptr;
+	}
 
-		for(auto& layer : layers)
-		{
-			if(layer->enabled)
-			{
-				processLayerHeight(layer, x, z, height_result, affector_transform, fractals);
-			}
-		}
+	return itr->second;
+}
 
-		if(!raw)
-		{
-			//Todo:Apply any necessary layer modifications
-		}
+float TerrainService::GetWaterHeight(uint32_t scene_id, float x, float z, float raw)
+{
+	auto scene = FindScene_(scene_id);
+	if(!scene)
+	{
+		return FLT_MIN;
+	}
 
-		return (float) height_result;
+	if(!raw)
+	{
+		//Todo:Apply any necessary layer modifications
 	}
-	return FLT_MIN;
+
+	return scene->GetWaterHeight(x, z);
 }
 
-bool TerrainService::IsWater(uint32_t scene_id, float x, float z, bool raw)
+float TerrainService::GetHeight(uint32_t scene_id, float x, float z, bool raw)
 {
-	float water_height = GetWaterHeight(scene_id, x, z, raw);
-	if (water_height != FLT_MIN)
+	auto scene = FindScene_(scene_id);
+	if(!scene)
 	{
-		float height = GetHeight(scene_id, x, z);
-		if (height <= water_height)
-			return true;
+		return FLT_MIN;
 	}
-	return false;
+
+	return scene->GetHeight(x, z, raw);
 }
 
-float TerrainService::processLayerHeight(ContainerLayer* layer, float x, float z, float& base_value, float affector_transform, std::map<uint32_t,Fractal*>& fractals)
+void TerrainService::GetHeights(uint32_t scene_id, const std::vector<glm::vec2>& points, std::vector<float>& heights, bool raw)
 {
-	std::vector<BoundaryLayer*> boundaries = layer->boundaries;
-	std::vector<HeightLayer*> heights = layer->heights;
-	std::vector<FilterLayer*> filters = layer->filters;
-
-	float transform_value = 0.0f;
-	bool has_boundaries = false;	
+	heights.resize(points.size());
 
-	for (unsigned int i = 0; i < boundaries.size(); i++)
+	auto scene = FindScene_(scene_id);
+	if(!scene)
 	{
-		BoundaryLayer* boundary = (BoundaryLayer*)boundaries.at(i);
-
-		if (!boundary->enabled)
-			continue;
-		else
-			has_boundaries = true;
-
-		float result = (float) boundary->Process(x, z);
-
-		result = calculateFeathering(result, boundary->feather_type);
-
-		if (result > transform_value)
-			transform_value = result;
-
-		if (transform_value >= 1)
-			break;
+		std::fill(heights.begin(), heights.end(), FLT_MIN);
+		return;
 	}
 
-	if (has_boundaries == false)
-		transform_value = 1.0f;
-
-	if (layer->invert_boundaries)
-		transform_value = 1.0f - transform_value;
-
-	if (transform_value != 0) 
+	std::vector<float> x(points.size()), z(points.size());
+	for(size_t i = 0; i < points.size(); ++i)
 	{
-		for (unsigned int i = 0; i < filters.size(); ++i) 
-		{
-			FilterLayer* filter = (FilterLayer*)filters.at(i);
-
-			if (!filter->enabled)
-				continue;
-
-			float result = (float) filter->Process(x, z, transform_value, base_value, fractals);
-
-			result = calculateFeathering(result, filter->feather_type);
-
-			if (transform_value > result)
-				transform_value = result;
-
-			if (transform_value == 0)
-				break;
-		}
-
-		if (layer->invert_filters)
-			transform_value = 1.0f - transform_value;
-
-		if (transform_value != 0)
-		{
-			for (unsigned int i = 0; i < heights.size(); i++)
-			{
-				HeightLayer* affector = (HeightLayer*)heights.at(i);
-			
-				if (affector->enabled)
-				{
-					affector->GetBaseHeight(x, z, transform_value, base_value, fractals);
-				}
-			}
-
-			std::vector<ContainerLayer*> children = layer->children;
-
-			for (unsigned int i = 0; i < children.size(); i++)
-			{
-				ContainerLayer* child = children.at(i);
-
-				if (child->enabled)
-					processLayerHeight(child, x, z, base_value, affector_transform * transform_value, fractals);
-			}
-		}
+		x[i] = points[i].x;
+		z[i] = points[i].y;
 	}
 
-	return transform_value;
+	scene->GetHeights(x.data(), z.data(), points.size(), heights.data(), raw);
 }
 
-float TerrainService::calculateFeathering(float value, int featheringType) {
-	float result = value;
-
-	switch (featheringType) {
-	case 1:
-		result = result * result;
-		break;
-	case 2:
-		result = sqrt(result);
-		break;
-	case 3:
-		result = result * result * (3 - 2 * result);
-		break;
-	case 0:
-		result = result;
-		break;
-	default:
-		result = 0;
-		break;
+bool TerrainService::IsWater(uint32_t scene_id, float x, float z, bool raw)
+{
+	auto scene = FindScene_(scene_id);
+	if(!scene)
+	{
+		return false;
 	}
 
-	return result;
-}
\ No newline at end of file
+	float water_height = scene->GetWaterHeight(x, z);
+	if (water_height != FLT_MIN)
+	{
+		float height = scene->GetHeight(x, z, raw);
+		if (height <= water_height)
+			return true;
+	}
+	return false;
+}
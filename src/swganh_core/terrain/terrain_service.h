@@ -8,42 +8,23 @@
 
 #include <boost/thread/mutex.hpp>
 #include <map>
-#include <list>
 #include <memory>
 
 namespace swganh
 {
-namespace tre
-{
-	class TerrainVisitor;
-	//class LayerVisitor;
-	class Fractal;
-
-	class ContainerLayer;
-}
-}
-
-
-namespace swganh
-{
-
-
 namespace terrain
 {
-	struct LayerEntry
-	{
-		//std::shared_ptr<swganh::tre::LayerVisitor> layer_visitor_;
-		float offset_x, offset_z;
-	};
-
-	struct SceneEntry
-	{
-		std::shared_ptr<swganh::tre::TerrainVisitor> terrain_visitor_;
-		//std::list<LayerEntry> layers_;
-	};
+	class TerrainScene;
 
-	typedef std::map<uint32_t, SceneEntry> SceneMap;
+	typedef std::map<uint32_t, std::shared_ptr<TerrainScene>> SceneMap;
 
+	/**
+	 * Answers terrain queries for the loaded scenes.
+	 *
+	 * The scenes are published as an immutable SceneMap that is swapped as a
+	 * whole when a scene is loaded or destroyed, queries take their own
+	 * reference to the current map and never wait on a load.
+	 */
 	class TerrainService : public swganh::terrain::TerrainServiceInterface
 	{
 	public:
@@ -52,22 +33,41 @@ namespace terrain
 
 		virtual float GetWaterHeight(uint32_t scene_id, float x, float z, float raw=false);
 
+		/**
+		 * Interpolated heights follow the terrain closely where it is smooth, but
+		 * an unfeathered boundary edge (eg. a hard flatten) becomes a slope across
+		 * the cache cells it crosses, up to one resolution wide. Use raw where the
+		 * exact height near such an edge matters.
+		 *
+		 * @param raw Evaluate the terrain layers at this exact point instead of
+		 *	interpolating from the cached height tiles.
+		 */
 		virtual float GetHeight(uint32_t scene_id, float x, float z, bool raw=false);
 
+		virtual void GetHeights(uint32_t scene_id, const std::vector<glm::vec2>& points, std::vector<float>& heights, bool raw=false);
+
+		/**
+		 * @param raw Compare the water with the exact terrain height, see GetHeight.
+		 */
 		virtual bool IsWater(uint32_t scene_id, float x, float z, bool raw=false);
 
+		/// Publishes scene, replacing any scene loaded with the same id.
+		void AddScene(uint32_t scene_id, std::shared_ptr<TerrainScene> scene);
+
+		void RemoveScene(uint32_t scene_id);
+
 		swganh::service::ServiceDescription GetServiceDescription();
         
 
 	private:
 
-		bool waterHeightHelper(swganh::tre::ContainerLayer* layer, float x, float z, float& result);
-
-		float processLayerHeight(swganh::tre::ContainerLayer* layer, float x, float z, float& base_value, float affector_transform, std::map<uint32_t, swganh::tre::Fractal*>& fractals);
-		float calculateFeathering(float value, int featheringType);
+		std::shared_ptr<TerrainScene> FindScene_(uint32_t scene_id) const;
 
+		// Serializes loads and unloads only, queries go through scenes_.
 		boost::mutex terrain_mutex_;
-		SceneMap scenes_;
+
+		// Replaced as a whole, readers take their own reference with std::atomic_load.
+		std::shared_ptr<const SceneMap> scenes_;
 		swganh::app::SwganhKernel* kernel_;
 	};
 }
@@ -2,6 +2,10 @@
 // See file LICENSE or go to http://swganh.com/LICENSE
 #pragma once
 
+#include <vector>
+
+#include <glm/glm.hpp>
+
 #include "swganh/service/service_interface.h"
 
 namespace swganh
@@ -14,6 +18,13 @@ namespace terrain
 
 		virtual float GetHeight(uint32_t scene_id, float x, float z, bool raw=false) = 0;
 
+		/**
+		 * Heights of many points at once, heights[i] receives the height of points[i]
+		 * (x, z). Cheaper than calling GetHeight for every point, the layers are
+		 * evaluated once for the whole batch.
+		 */
+		virtual void GetHeights(uint32_t scene_id, const std::vector<glm::vec2>& points, std::vector<float>& heights, bool raw=false) = 0;
+
 		virtual float GetWaterHeight(uint32_t scene_id, float x, float z, float raw=false) = 0;
 
 		virtual bool IsWater(uint32_t scene_id, float x, float z, bool raw=false) = 0;
@@ -0,0 +1,189 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <atomic>
+#include <cfloat>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "swganh/app/swganh_kernel.h"
+
+#include "swganh_core/terrain/mock_terrain_builder.h"
+#include "swganh_core/terrain/terrain_scene.h"
+#include "swganh_core/terrain/terrain_service.h"
+
+using namespace swganh::terrain;
+using namespace swganh::tre;
+
+namespace {
+
+	const int READER_THREADS = 4;
+	const int READER_ROUNDS = 20;
+
+	std::vector<glm::vec2> Square(float x, float z, float size)
+	{
+		std::vector<glm::vec2> vertices;
+		vertices.push_back(glm::vec2(x, z));
+		vertices.push_back(glm::vec2(x + size, z));
+		vertices.push_back(glm::vec2(x + size, z + size));
+		vertices.push_back(glm::vec2(x, z + size));
+		return vertices;
+	}
+
+	/// Hills around a lake, with the sea level below them.
+	std::shared_ptr<TerrainVisitor> MakeTerrain()
+	{
+		MockTerrainBuilder builder;
+		builder.AddFractal(1, 1, 1234, 0.004f);
+		builder.SetGlobalWaterHeight(-200.0f);
+
+		auto hills = builder.AddContainer();
+		builder.AddHeightFractal(hills, 1, 1, 120.0f);
+		builder.AddWaterPolygon(hills, Square(-100.0f, -100.0f, 200.0f), 90.0f);
+
+		return builder.Build();
+	}
+
+	std::shared_ptr<TerrainScene> MakeScene(const std::shared_ptr<TerrainVisitor>& terrain)
+	{
+		return std::make_shared<TerrainScene>(terrain, 64.0f, 2.0f, 0);
+	}
+
+	struct TerrainServiceFixture
+	{
+		TerrainServiceFixture()
+			: kernel(io_service)
+			, service(&kernel)
+		{}
+
+		boost::asio::io_service io_service;
+		swganh::app::SwganhKernel kernel;
+		TerrainService service;
+	};
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(TerrainServiceTest, TerrainServiceFixture)
+
+BOOST_AUTO_TEST_CASE(UnknownScenesHaveNoTerrain) {
+	std::vector<glm::vec2> points(3);
+	std::vector<float> heights;
+
+	service.GetHeights(7, points, heights);
+
+	BOOST_CHECK_EQUAL(FLT_MIN, service.GetHeight(7, 0.0f, 0.0f));
+	BOOST_CHECK_EQUAL(FLT_MIN, service.GetWaterHeight(7, 0.0f, 0.0f));
+	BOOST_CHECK(!service.IsWater(7, 0.0f, 0.0f));
+	BOOST_REQUIRE_EQUAL(3u, heights.size());
+	BOOST_CHECK_EQUAL(FLT_MIN, heights[2]);
+}
+
+BOOST_AUTO_TEST_CASE(QueriesUseTheLoadedScene) {
+	auto terrain = MakeTerrain();
+	HeightSampler sampler(terrain);
+
+	service.AddScene(1, MakeScene(terrain));
+
+	BOOST_CHECK_EQUAL(sampler.GetHeight(300.0f, -20.0f), service.GetHeight(1, 300.0f, -20.0f, true));
+	BOOST_CHECK_EQUAL(90.0f, service.GetWaterHeight(1, 0.0f, 0.0f));
+	BOOST_CHECK_EQUAL(-200.0f, service.GetWaterHeight(1, 500.0f, 500.0f));
+	BOOST_CHECK_EQUAL(service.GetHeight(1, 0.0f, 0.0f) <= 90.0f, service.IsWater(1, 0.0f, 0.0f));
+	BOOST_CHECK_EQUAL(service.GetHeight(1, 0.0f, 0.0f, true) <= 90.0f, service.IsWater(1, 0.0f, 0.0f, true));
+	BOOST_CHECK(!service.IsWater(1, 500.0f, 500.0f));
+
+	service.RemoveScene(1);
+
+	BOOST_CHECK_EQUAL(FLT_MIN, service.GetHeight(1, 300.0f, -20.0f, true));
+}
+
+/// This test shows that queries from several threads see either a whole scene
+/// or none while another thread keeps loading and unloading scenes.
+BOOST_AUTO_TEST_CASE(ConcurrentQueriesWhileScenesChange) {
+	auto terrain = MakeTerrain();
+	service.AddScene(1, MakeScene(terrain));
+
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> position(-400.0f, 400.0f);
+
+	std::vector<glm::vec2> points(256);
+	std::vector<float> expected_heights(points.size()), expected_water(points.size());
+	{
+		auto reference = MakeScene(terrain);
+		for (size_t i = 0; i < points.size(); ++i)
+		{
+			points[i] = glm::vec2(position(random), position(random));
+			expected_heights[i] = reference->GetHeight(points[i].x, points[i].y, true);
+			expected_water[i] = reference->GetWaterHeight(points[i].x, points[i].y);
+		}
+	}
+
+	std::atomic<int> mismatches(0);
+	std::atomic<int> readers_done(0);
+	std::atomic<int> scene_swaps(0);
+
+	// Boost.Test assertions are not thread safe, the threads only count
+	std::vector<std::thread> readers;
+	for (int reader = 0; reader < READER_THREADS; ++reader)
+	{
+		readers.push_back(std::thread([&] {
+			std::vector<float> heights;
+			for (int round = 0; round < READER_ROUNDS; ++round)
+			{
+				for (size_t i = 0; i < points.size(); ++i)
+				{
+					float x = points[i].x, z = points[i].y;
+
+					if (service.GetHeight(1, x, z, true) != expected_heights[i]
+						|| service.GetWaterHeight(1, x, z) != expected_water[i])
+					{
+						++mismatches;
+					}
+
+					// scene 2 comes and goes, but is never half loaded
+					float height = service.GetHeight(2, x, z, true);
+					if (height != FLT_MIN && height != expected_heights[i])
+					{
+						++mismatches;
+					}
+
+					service.GetHeight(1, x, z);
+					service.IsWater(2, x, z);
+				}
+
+				service.GetHeights(1, points, heights, true);
+				if (heights != expected_heights)
+				{
+					++mismatches;
+				}
+			}
+			++readers_done;
+		}));
+	}
+
+	std::thread loader([&] {
+		while (readers_done < READER_THREADS)
+		{
+			service.AddScene(2, MakeScene(terrain));
+			service.RemoveScene(2);
+			++scene_swaps;
+		}
+	});
+
+	for (auto& reader : readers)
+	{
+		reader.join();
+	}
+	loader.join();
+
+	BOOST_TEST_MESSAGE(scene_swaps << " scene loads while reading");
+	BOOST_CHECK_EQUAL(0, mismatches.load());
+	BOOST_CHECK_GT(scene_swaps.load(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,117 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include "water_index.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/geometries/box.hpp>
+#include <boost/geometry/geometries/point.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "swganh/tre/visitors/terrain/terrain_visitor.h"
+
+#include "swganh/tre/visitors/terrain/detail/container_layer.h"
+#include "swganh/tre/visitors/terrain/detail/boundary_polygon.h"
+
+using namespace swganh::terrain;
+using namespace swganh::tre;
+
+namespace bgi = boost::geometry::index;
+
+namespace {
+
+	typedef boost::geometry::model::point<float, 2, boost::geometry::cs::cartesian> Point;
+	typedef boost::geometry::model::box<Point> Box;
+	typedef std::pair<Box, uint32_t> Value;	// second is the index in polygons_
+
+}
+
+struct WaterIndex::Tree
+{
+	template<typename Iterator>
+	Tree(Iterator begin, Iterator end)
+		: rtree(begin, end)
+	{}
+
+	bgi::rtree<Value, bgi::quadratic<16>> rtree;
+};
+
+WaterIndex::WaterIndex(TerrainVisitor& terrain_visitor)
+{
+	for(auto& layer : terrain_visitor.GetLayers())
+	{
+		AddWaterPolygons_(layer);
+	}
+
+	std::vector<Value> values;
+	values.reserve(polygons_.size());
+
+	for(uint32_t i = 0; i < polygons_.size(); ++i)
+	{
+		auto& vertices = polygons_[i]->GetVertices();
+
+		float min_x = vertices[0].x, max_x = vertices[0].x;
+		float min_z = vertices[0].y, max_z = vertices[0].y;
+		for(auto& vertex : vertices)
+		{
+			min_x = std::min(min_x, vertex.x);
+			max_x = std::max(max_x, vertex.x);
+			min_z = std::min(min_z, vertex.y);
+			max_z = std::max(max_z, vertex.y);
+		}
+
+		values.push_back(Value(Box(Point(min_x, min_z), Point(max_x, max_z)), i));
+	}
+
+	// packing the whole set at once gives a better tree than inserting one by one
+	tree_.reset(new Tree(values.begin(), values.end()));
+}
+
+WaterIndex::~WaterIndex()
+{
+}
+
+void WaterIndex::AddWaterPolygons_(ContainerLayer* layer)
+{
+	for(auto& boundary : layer->boundaries)
+	{
+		if(boundary->GetType() == LAYER_TYPE_BOUNDARY_POLYGON)
+		{
+			auto polygon = static_cast<BoundaryPolygon*>(boundary);
+			if(polygon->use_water_height && !polygon->GetVertices().empty())
+			{
+				polygons_.push_back(polygon);
+			}
+		}
+	}
+
+	for(auto& child : layer->children)
+	{
+		AddWaterPolygons_(child);
+	}
+}
+
+bool WaterIndex::GetWaterHeight(float x, float z, float& height) const
+{
+	uint32_t first = std::numeric_limits<uint32_t>::max();
+
+	for(auto itr = tree_->rtree.qbegin(bgi::intersects(Point(x, z))); itr != tree_->rtree.qend(); ++itr)
+	{
+		if(itr->second < first && polygons_[itr->second]->IsContained(x, z))
+		{
+			first = itr->second;
+		}
+	}
+
+	if(first == std::numeric_limits<uint32_t>::max())
+	{
+		return false;
+	}
+
+	height = polygons_[first]->water_height;
+	return true;
+}
@@ -0,0 +1,59 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+namespace swganh
+{
+namespace tre
+{
+	class TerrainVisitor;
+	class ContainerLayer;
+	class BoundaryPolygon;
+}
+}
+
+namespace swganh
+{
+namespace terrain
+{
+	/**
+	 * R-tree over the bounding boxes of the water polygons of a terrain.
+	 *
+	 * Where water polygons overlap the one found first walking the layers (a
+	 * layer's boundaries before its children) wins, as it did when every layer
+	 * was scanned for each lookup. The index only reads the polygons, concurrent
+	 * lookups are safe.
+	 */
+	class WaterIndex : private boost::noncopyable
+	{
+	public:
+		explicit WaterIndex(swganh::tre::TerrainVisitor& terrain_visitor);
+		~WaterIndex();
+
+		/**
+		 * @param height Receives the water height if x, z lies in a water polygon.
+		 * @return True if x, z lies in a water polygon.
+		 */
+		bool GetWaterHeight(float x, float z, float& height) const;
+
+		size_t size() const { return polygons_.size(); }
+
+	private:
+		// kept out of the header, the terrain layer headers define macros that
+		// break boost.geometry when included before it
+		struct Tree;
+
+		void AddWaterPolygons_(swganh::tre::ContainerLayer* layer);
+
+		std::vector<swganh::tre::BoundaryPolygon*> polygons_;	// in the order the layers are walked
+		std::unique_ptr<Tree> tree_;
+	};
+}
+}
@@ -0,0 +1,146 @@
+// This file is part of SWGANH which is released under the MIT license.
+// See file LICENSE or go to http://swganh.com/LICENSE
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "swganh_core/terrain/mock_terrain_builder.h"
+#include "swganh_core/terrain/water_index.h"
+
+using namespace swganh::terrain;
+using namespace swganh::tre;
+
+namespace {
+
+	std::vector<glm::vec2> Square(float x, float z, float size)
+	{
+		std::vector<glm::vec2> vertices;
+		vertices.push_back(glm::vec2(x, z));
+		vertices.push_back(glm::vec2(x + size, z));
+		vertices.push_back(glm::vec2(x + size, z + size));
+		vertices.push_back(glm::vec2(x, z + size));
+		return vertices;
+	}
+
+	/// Lakes in nested containers, some of them overlapping.
+	std::shared_ptr<TerrainVisitor> MakeTerrain()
+	{
+		MockTerrainBuilder builder;
+
+		auto root = builder.AddContainer();
+		builder.AddWaterPolygon(root, Square(-100.0f, -100.0f, 150.0f), 10.0f);
+
+		auto shore = builder.AddContainer(root);
+		builder.AddWaterPolygon(shore, Square(0.0f, 0.0f, 200.0f), 20.0f);
+
+		std::vector<glm::vec2> triangle;
+		triangle.push_back(glm::vec2(300.0f, -400.0f));
+		triangle.push_back(glm::vec2(600.0f, -400.0f));
+		triangle.push_back(glm::vec2(450.0f, -100.0f));
+		builder.AddWaterPolygon(builder.AddContainer(shore), triangle, 30.0f);
+
+		auto other = builder.AddContainer();
+		builder.AddWaterPolygon(other, Square(-500.0f, 200.0f, 300.0f), 40.0f);
+		builder.AddWaterPolygon(other, Square(-50.0f, -50.0f, 500.0f), 50.0f);
+
+		return builder.Build();
+	}
+
+	/// Walks the layers the way lookups did before the index.
+	bool ScanLayer(ContainerLayer* layer, float x, float z, float& result)
+	{
+		for (auto& boundary : layer->boundaries)
+		{
+			if (boundary->GetType() == LAYER_TYPE_BOUNDARY_POLYGON)
+			{
+				auto polygon = static_cast<BoundaryPolygon*>(boundary);
+				if (polygon->use_water_height && polygon->IsContained(x, z))
+				{
+					result = polygon->water_height;
+					return true;
+				}
+			}
+		}
+
+		for (auto& child : layer->children)
+		{
+			if (ScanLayer(child, x, z, result))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+}
+
+BOOST_AUTO_TEST_SUITE(WaterIndexTest)
+
+/// This test shows that the index finds the same water as scanning every layer,
+/// including where lakes overlap.
+BOOST_AUTO_TEST_CASE(FindsTheSameWaterAsScanningTheLayers) {
+	auto terrain = MakeTerrain();
+	WaterIndex index(*terrain);
+
+	BOOST_CHECK_EQUAL(5u, index.size());
+
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> position(-800.0f, 800.0f);
+
+	int wet = 0;
+	for (int i = 0; i < 20000; ++i)
+	{
+		float x = position(random);
+		float z = position(random);
+
+		float expected = 0.0f;
+		bool expected_found = false;
+		for (auto& layer : terrain->GetLayers())
+		{
+			if (ScanLayer(layer, x, z, expected))
+			{
+				expected_found = true;
+				break;
+			}
+		}
+
+		float found = 0.0f;
+		BOOST_REQUIRE_EQUAL(expected_found, index.GetWaterHeight(x, z, found));
+		if (expected_found)
+		{
+			BOOST_REQUIRE_EQUAL(expected, found);
+			++wet;
+		}
+	}
+
+	BOOST_CHECK_GT(wet, 1000);
+
+	// the first lake walked wins where lakes overlap
+	float height = 0.0f;
+	BOOST_CHECK(index.GetWaterHeight(25.0f, 25.0f, height));
+	BOOST_CHECK_EQUAL(10.0f, height);
+	BOOST_CHECK(index.GetWaterHeight(100.0f, 100.0f, height));
+	BOOST_CHECK_EQUAL(20.0f, height);
+	BOOST_CHECK(index.GetWaterHeight(300.0f, 300.0f, height));
+	BOOST_CHECK_EQUAL(50.0f, height);
+	BOOST_CHECK(!index.GetWaterHeight(700.0f, 700.0f, height));
+}
+
+BOOST_AUTO_TEST_CASE(TerrainWithoutWaterHasAnEmptyIndex) {
+	MockTerrainBuilder builder;
+	builder.AddContainer();
+	auto terrain = builder.Build();
+
+	WaterIndex index(*terrain);
+
+	float height = 0.0f;
+	BOOST_CHECK_EQUAL(0u, index.size());
+	BOOST_CHECK(!index.GetWaterHeight(0.0f, 0.0f, height));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -39,7 +39,9 @@ using namespace swganh::command;
 using namespace swganh::equipment;
 
 TravelService::TravelService(swganh::app::SwganhKernel* kernel)
-	: kernel_(kernel)
+	: planetary_travel_routes_(std::make_shared<std::vector<PlanetaryTravelRoute>>())
+	, kernel_(kernel)
+	, strand_(kernel->GetIoService())
 {
 }
 
@@ -54,7 +56,7 @@ void TravelService::Startup()
 	equipment_ = kernel_->GetServiceManager()->GetService<EquipmentService>("EquipmentService");
 
 	kernel_->GetDatabaseManager()->ExecuteAsync(&TravelService::LoadStaticTravelPoints, this, "swganh_static").get();
-	kernel_->GetDatabaseManager()->ExecuteAsync(&TravelService::LoadPlanetaryRouteMap, this, "swganh_static").get();
+	LoadPlanetaryRouteMap();
 
 	// Register message handler.
 	auto connection_service = kernel_->GetServiceManager()->GetService<ConnectionServiceInterface>("ConnectionService");
@@ -98,26 +100,27 @@ void TravelService::BeginTicketTransaction(std::shared_ptr<Object> object)
 	object->GetController()->Notify(&enter_ticket);
 }
 
-void TravelService::LoadPlanetaryRouteMap(const std::shared_ptr<sql::Connection>& connection)
+void TravelService::LoadPlanetaryRouteMap()
 {
-	try
+	kernel_->GetDatabaseManager()->QueryAsync("swganh_static", "CALL sp_GetPlanetaryTravelRoutes();",
+		[] (sql::PreparedStatement&) {},
+		[] (sql::ResultSet& result) -> PlanetaryTravelRoute
 	{
-		auto statement = std::shared_ptr<sql::Statement>(connection->createStatement());
-		auto result = std::shared_ptr<sql::ResultSet>(statement->executeQuery("CALL sp_GetPlanetaryTravelRoutes();"));
-
-		while(result->next())
+		PlanetaryTravelRoute route;
+		route.departure_planet_id = result.getInt("srcId");
+		route.arrival_planet_id = result.getInt("destId");
+		route.price = result.getInt("price");
+		return route;
+	},
+	strand_,
+	[this] (std::exception_ptr error, std::vector<PlanetaryTravelRoute> routes)
+	{
+		if (!error)
 		{
-			PlanetaryTravelRoute route;
-			route.departure_planet_id = result->getInt("srcId");
-			route.arrival_planet_id = result->getInt("destId");
-			route.price = result->getInt("price");
-			planetary_travel_routes_.push_back(route);
+			std::shared_ptr<const std::vector<PlanetaryTravelRoute>> loaded = std::make_shared<std::vector<PlanetaryTravelRoute>>(std::move(routes));
+			std::atomic_store(&planetary_travel_routes_, loaded);
 		}
-	}
-	catch(sql::SQLException &e) {
-		LOG(error) << "SQLException at " << __FILE__ << " (" << __LINE__ << ": " << __FUNCTION__ << ")";
-		LOG(error) << "MySQL Error: (" << e.getErrorCode() << ": " << e.getSQLState() << ") " << e.what();
-	}
+	});
 }
 
 void TravelService::LoadStaticTravelPoints(const std::shared_ptr<sql::Connection>& connection)
@@ -207,8 +210,9 @@ void TravelService::PurchaseTicket(std::shared_ptr<swganh::object::Object> objec
 	}
 
 	// Verify Planetary Route and make sure route is online.
-	PlanetaryTravelRoute* planetary_travel_route = nullptr;
-	for(auto& route : planetary_travel_routes_)
+	auto planetary_travel_routes = std::atomic_load(&planetary_travel_routes_);
+	const PlanetaryTravelRoute* planetary_travel_route = nullptr;
+	for(auto& route : *planetary_travel_routes)
 	{
 		if((route.departure_planet_id == source_location_tp.scene_id) && (route.arrival_planet_id == target_location_tp.scene_id))
 		{
@@ -5,6 +5,7 @@
 #include <swganh_core/travel/travel_service_interface.h>
 
 #include <glm/glm.hpp>
+#include <boost/asio/strand.hpp>
 #include "swganh/database/database_manager.h"
 #include <swganh/app/swganh_kernel.h>
 #include <swganh_core/connection/connection_client_interface.h>
@@ -80,12 +81,20 @@ namespace travel {
 
 		void LoadStaticTravelPoints(const std::shared_ptr<sql::Connection>& connection);
 		void LoadDynamicTravelPoints(const std::shared_ptr<sql::Connection>& connection);
-		void LoadPlanetaryRouteMap(const std::shared_ptr<sql::Connection>& connection);
+
+		/**
+		 * Queries the route map on a database worker, the routes are swapped in on
+		 * the strand once loaded. Until then no route is available.
+		 */
+		void LoadPlanetaryRouteMap();
 
 		std::vector<TravelPoint> travel_points_;
-		std::vector<PlanetaryTravelRoute> planetary_travel_routes_;
+
+		// Replaced as a whole, readers take their own reference with std::atomic_load.
+		std::shared_ptr<const std::vector<PlanetaryTravelRoute>> planetary_travel_routes_;
 
 		swganh::app::SwganhKernel* kernel_;
+		boost::asio::strand strand_;
 		swganh::simulation::SimulationService* simulation_;
 		swganh::command::CommandService* command_;
 		swganh::equipment::EquipmentService* equipment_;
@@ -65,6 +65,10 @@ def main(force):
 		if saved:
 			continue
 		
+		#Templates with hand written modifications may randomize what they build,
+		#only the plain generated ones are cached as prototypes by the server
+		cache_prototype = not any(replace and replace.strip() for replace in replaces)
+		
 		#Open output file for writing
 		with open(output_filename, 'w') as output:
 			#print('GENERATING', output_filename)
@@ -79,6 +83,8 @@ def main(force):
 					output.write(line)
 					continue
 				else:
+					line = line.replace("@CACHE_PROTOTYPE@", str(cache_prototype))
+					
 					#Replace CSV Targets
 					for target, index, func in csv_replace_targets:
 						if line.find(target) != -1: